@@ -0,0 +1,61 @@
+#include "BackgroundSave.h"
+#include "FileWriter.h"
+
+BackgroundSave::BackgroundSave(const std::filesystem::path& filePath, std::vector<std::shared_ptr<const LineGapBuffer>>&& snapshot, uint64_t generation,
+    std::vector<char>&& undoHistory, bool mayWriteInPlace)
+    : m_filePath(filePath), m_lines(std::move(snapshot)), m_generation(generation), m_mayWriteInPlace(mayWriteInPlace), m_undoHistory(std::move(undoHistory)), m_linesWritten(0), m_finished(false),
+    m_result{ false, "", 0, 0.0 }, m_thread(&BackgroundSave::run, this)
+{
+}
+
+BackgroundSave::~BackgroundSave()
+{
+    if (m_thread.joinable()) { m_thread.join(); }
+}
+
+void BackgroundSave::run()
+{
+    std::chrono::time_point<std::chrono::steady_clock> start = std::chrono::steady_clock::now();
+
+    FileWriter writer(m_filePath, m_mayWriteInPlace);
+
+    // The undo history is tied to the text it was saved with
+    bool hashing = !m_undoHistory.empty();
+    ContentHash contentHash;
+
+    for (size_t row = 0; row < m_lines.size(); row++)
+    {
+        if (row) { writer.write('\n'); }
+
+        writer.write(m_lines[row]->preGapSpan());
+        writer.write(m_lines[row]->postGapSpan());
+
+        if (hashing)
+        {
+            if (row) { contentHash.update("\n", 1); }
+
+            contentHash.update(m_lines[row]->preGapSpan());
+            contentHash.update(m_lines[row]->postGapSpan());
+        }
+
+        m_linesWritten.store(row + 1, std::memory_order_relaxed);
+    }
+
+    bool succeeded = writer.commit();
+
+    // Losing the undo file only loses history, the save itself stands
+    if (succeeded && hashing) { UndoFile::write(UndoFile::undoFilePath(m_filePath), m_undoHistory, contentHash); }
+
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+    m_result = SaveResult{ succeeded, writer.error(), writer.bytesWritten(), duration.count() };
+
+    m_finished.store(true, std::memory_order_release);
+}
+
+const SaveResult& BackgroundSave::wait()
+{
+    if (m_thread.joinable()) { m_thread.join(); }
+
+    return m_result;
+}
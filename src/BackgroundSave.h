@@ -0,0 +1,58 @@
+#pragma once
+
+#include "LineGapBuffer.h"
+#include "UndoFile.h"
+
+struct SaveResult
+{
+    bool succeeded;
+    std::string error;
+    size_t bytesWritten;
+    double seconds;
+};
+
+// Writes a snapshot of a file's lines on a worker thread. The snapshot shares the lines with the buffer the way the one
+// of a SnapshotScan does, so the worker only ever sees the text as of the save.
+class BackgroundSave
+{
+
+private:
+
+    std::filesystem::path m_filePath;
+    std::vector<std::shared_ptr<const LineGapBuffer>> m_lines;
+    uint64_t m_generation;
+
+    // Cleared while the file is still mapped, so the save fails rather than truncating it
+    bool m_mayWriteInPlace;
+
+    // Serialized undo history written beside the file once it is saved, if there is any
+    std::vector<char> m_undoHistory;
+
+    std::atomic<size_t> m_linesWritten;
+    std::atomic<bool> m_finished;
+    SaveResult m_result;
+
+    std::thread m_thread;
+
+    void run();
+
+public:
+
+    BackgroundSave(const std::filesystem::path& filePath, std::vector<std::shared_ptr<const LineGapBuffer>>&& snapshot, uint64_t generation,
+        std::vector<char>&& undoHistory = std::vector<char>(), bool mayWriteInPlace = true);
+    ~BackgroundSave();
+
+    BackgroundSave(const BackgroundSave&) = delete;
+    BackgroundSave& operator=(const BackgroundSave&) = delete;
+
+    // Blocks until the worker is done and returns the outcome of the save
+    const SaveResult& wait();
+
+    // Getters
+    const std::filesystem::path& filePath() const { return m_filePath; }
+    uint64_t generation() const { return m_generation; }
+    bool finished() const { return m_finished.load(std::memory_order_acquire); }
+    size_t linesWritten() const { return m_linesWritten.load(std::memory_order_relaxed); }
+    size_t numberOfLines() const { return m_lines.size(); }
+
+};
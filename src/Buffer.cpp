@@ -1,139 +1,106 @@
 #include "Buffer.h"
+#include "CharacterScanner.h"
+#include "FileWriter.h"
 #include "LineGapBuffer.h"
 #include "View.h"
 #include <filesystem>
 
-Buffer::Buffer(const std::string& fileName)
-    : m_filePath(fileName), m_file(1), m_cursorX(0), m_cursorY(0), m_lastXSinceYMove(0)
+Buffer::Buffer(const std::string& fileName, FILE_BACKEND fileBackend)
+    : m_filePath(fileName), m_fileBackend(fileBackend), m_scans{ &m_searchIndex.scan(), &m_syntaxHighlighter.scan() }, m_cursorX(0),
+    m_cursorY(0), m_lastXSinceYMove(0)
 {
-    if (fileName == "NO_NAME")
+    if (fileName != "NO_NAME" && std::filesystem::exists(m_filePath))
     {
-        m_file.insertLine(std::make_shared<LineGapBuffer>(LineGapBuffer::initialBufferSize));
+        readFromFile(fileName);
+
+        // Only mapped and checked against its header here, the history itself is read if undoing ever reaches it
+        m_undoFile = std::make_unique<UndoFile>(UndoFile::undoFilePath(m_filePath));
+
+        if (!m_undoFile->valid()) { m_undoFile.reset(); }
     }
     else
     {
-        if (std::filesystem::exists(m_filePath))
-        {
-            readFromFile(fileName);
-        }
-        else
-        {
-            m_file.insertLine(std::make_shared<LineGapBuffer>(LineGapBuffer::initialBufferSize));
-        }
+        std::vector<std::shared_ptr<LineGapBuffer>> emptyFile;
+        emptyFile.push_back(std::make_shared<LineGapBuffer>(LineGapBuffer::initialBufferSize));
+
+        m_file = createFile(std::move(emptyFile));
     }
+
+    m_syntaxHighlighter.start(*m_file, m_filePath);
 }
 
-void Buffer::readFromFile(const std::string& fileName)
+std::unique_ptr<FileBackend> Buffer::createFile(std::vector<std::shared_ptr<LineGapBuffer>>&& loadedLines) const
 {
-    std::ifstream infile(fileName);
-
-    std::string line;
-
-    int lineIter = 0;
-    while (getline(infile, line))
+    if (m_fileBackend == ROPE_BACKEND)
     {
-        m_file.insertLine(std::make_shared<LineGapBuffer>(LineGapBuffer::initialBufferSize, line));
-        while (m_file[lineIter]->preGapIndex() > 0) { m_file[lineIter]->left(); }
-        lineIter++;
+        return std::make_unique<FileRope>(std::move(loadedLines));
     }
-
-    while (m_file.preGapIndex() > 0)
+    else
     {
-        m_file.up();
+        return std::make_unique<FileGapBuffer>(std::move(loadedLines));
     }
 }
 
-void Buffer::moveCursor(int y, int x)
+void Buffer::readFromFile(const std::string& fileName)
 {
-    int moveY = std::clamp(y, 0, static_cast<int>(m_file.numberOfLines()));
+    std::vector<std::shared_ptr<LineGapBuffer>> loadedLines;
 
-    int relativeYDistance = moveY - m_file.preGapIndex();
+    m_mappedFile = std::make_unique<MappedFile>(fileName);
 
-    if (relativeYDistance > 0)
+    if (m_mappedFile->isMapped())
     {
-        for (int i = 0; i < relativeYDistance; i++) { m_file.down(); }
-    }
-    else
-    {
-        for (int i = 0; i < abs(relativeYDistance); i++) { m_file.up(); }
-    }
-
-    if (y == static_cast<int>(m_file.numberOfLines())) { return; }
+        const char* data = m_mappedFile->data();
+        const char* end = data + m_mappedFile->size();
 
-    m_cursorY = moveY;
-
-    int moveX = std::clamp(x, 0, static_cast<int>(m_file[m_cursorY]->lineSize()));
+        while (data < end)
+        {
+            const char* lineBreak = static_cast<const char*>(memchr(data, '\n', end - data));
+            const char* lineEnd = (lineBreak) ? lineBreak : end;
 
-    int relativeXDistance = moveX - m_file[y]->preGapIndex();
+            loadedLines.push_back(std::make_shared<LineGapBuffer>(data, lineEnd - data));
 
-    if (relativeXDistance > 0)
-    {
-        for (int i = 0; i < relativeXDistance; i++) { m_file[m_cursorY]->right(); }
+            data = lineEnd + 1;
+        }
     }
     else
     {
-        for (int i = 0; i < abs(relativeXDistance); i++) { m_file[m_cursorY]->left(); }
-    }
+        m_mappedFile.reset();
 
-    m_cursorX = moveX;
-    m_lastXSinceYMove = moveX;
-}
+        std::ifstream infile(fileName);
 
-void Buffer::shiftCursorX(int x)
-{
-    int moveX = std::clamp(m_cursorX + x, 0, std::max(0, static_cast<int>(m_file[m_cursorY]->lineSize()) - 1));
-
-    if (moveX == m_cursorX) { return; }
+        std::string line;
 
-    m_cursorX = moveX;
-    m_lastXSinceYMove = moveX;
-
-    if (x > 0)
-    {
-        for (int i = 0; i < x; i++) { m_file[m_cursorY]->right(); }
+        while (getline(infile, line))
+        {
+            loadedLines.push_back(std::make_shared<LineGapBuffer>(LineGapBuffer::initialBufferSize, line));
+        }
     }
-    else
+
+    if (loadedLines.empty())
     {
-        for (int i = 0; i < abs(x); i++) { m_file[m_cursorY]->left(); }
+        loadedLines.push_back(std::make_shared<LineGapBuffer>(LineGapBuffer::initialBufferSize));
     }
+
+    m_file = createFile(std::move(loadedLines));
 }
 
-void Buffer::shiftCursorY(int y)
+void Buffer::moveCursor(int y, int x)
 {
-    int moveY = std::clamp(m_cursorY + y, 0, static_cast<int>(m_file.numberOfLines()) - 1);
+    int moveY = std::clamp(y, 0, static_cast<int>(m_file->numberOfLines()));
 
-    int relativeMoveY = moveY - m_file.preGapIndex();
-
-    if (relativeMoveY > 0)
-    {
-        for (int i = 0; i < relativeMoveY; i++) { m_file.down(); }
-    }
-    else
-    {
-        for (int i = 0; i < abs(relativeMoveY); i++) { m_file.up(); }
-    }
+    if (y == static_cast<int>(m_file->numberOfLines())) { return; }
 
     m_cursorY = moveY;
 
-    int moveX = std::clamp(m_lastXSinceYMove, 0, std::max(0, static_cast<int>(m_file[m_cursorY]->lineSize()) - 1));
-
-    int relativeMoveX = moveX - m_file[m_cursorY]->preGapIndex();
+    int moveX = std::clamp(x, 0, static_cast<int>((*m_file)[m_cursorY]->lineSize()));
 
     m_cursorX = moveX;
-
-    if (relativeMoveX > 0)
-    {
-        for (int i = 0; i < relativeMoveX; i++) { m_file[m_cursorY]->right(); }
-    }
-    else
-    {
-        for (int i = 0; i < abs(relativeMoveX); i++) { m_file[m_cursorY]->left(); }
-    }
+    m_lastXSinceYMove = moveX;
 }
 
-void Buffer::shiftCursorXWithoutGapBuffer(int x)
+void Buffer::shiftCursorX(int x)
 {
-    int moveX = std::clamp(m_cursorX + x, 0, std::max(0, static_cast<int>(m_file[m_cursorY]->lineSize()) - 1));
+    int moveX = std::clamp(m_cursorX + x, 0, std::max(0, static_cast<int>((*m_file)[m_cursorY]->lineSize()) - 1));
 
     if (moveX == m_cursorX) { return; }
 
@@ -141,39 +108,39 @@ void Buffer::shiftCursorXWithoutGapBuffer(int x)
     m_lastXSinceYMove = moveX;
 }
 
+void Buffer::shiftCursorY(int y)
+{
+    int moveY = std::clamp(m_cursorY + y, 0, static_cast<int>(m_file->numberOfLines()) - 1);
+
+    m_cursorY = moveY;
+
+    m_cursorX = std::clamp(m_lastXSinceYMove, 0, std::max(0, static_cast<int>((*m_file)[m_cursorY]->lineSize()) - 1));
+}
+
 int Buffer::getXPositionOfFirstCharacter(int y)
 {
     y = std::max(0, y);
 
-    int lineSize = static_cast<int>(m_file[y]->lineSize());
-    for (int i = 0; i < lineSize; i++)
-    {
-        if (m_file[y]->at(i) != ' ')
-        {
-            return i;
-        }
-    }
+    const std::shared_ptr<LineGapBuffer>& line = (*m_file)[y];
 
-    return m_cursorX;
+    if (line->firstNonSpaceIndex() == line->lineSize()) { return m_cursorX; }
+
+    return static_cast<int>(line->firstNonSpaceIndex());
 }
 
 void Buffer::shiftCursorFullRight()
 {
-    shiftCursorX(static_cast<int>(m_file[m_cursorY]->lineSize()) - 1 - m_cursorX);
+    shiftCursorX(static_cast<int>((*m_file)[m_cursorY]->lineSize()) - 1 - m_cursorX);
 }
 
 void Buffer::shiftCursorFullLeft()
 {
-    for (int i = 0; i < static_cast<int>(m_file[m_cursorY]->lineSize()); i++)
-    {
-        if (m_file[m_cursorY]->at(i) != ' ')
-        {
-            moveCursor(m_cursorY, i);
-            break;
-        }
+    const std::shared_ptr<LineGapBuffer>& line = (*m_file)[m_cursorY];
 
-        moveCursor(m_cursorY, 0);
-    }
+    if (line->lineSize() == 0) { return; }
+
+    // A line of only spaces puts the cursor at its start
+    moveCursor(m_cursorY, (line->firstNonSpaceIndex() == line->lineSize()) ? 0 : static_cast<int>(line->firstNonSpaceIndex()));
 }
 
 void Buffer::shiftCursorFullTop()
@@ -183,13 +150,13 @@ void Buffer::shiftCursorFullTop()
 
 void Buffer::shiftCursorFullBottom()
 {
-    int fullBottomIndex = std::max(0, static_cast<int>(m_file.numberOfLines() - 1));
+    int fullBottomIndex = std::max(0, static_cast<int>(m_file->numberOfLines() - 1));
     shiftCursorY(fullBottomIndex - m_cursorY);
 }
 
 int Buffer::findCharacterIndex(char character, bool findForwards)
 {
-    const std::shared_ptr<LineGapBuffer>& lineGapBuffer = m_file[m_cursorY];
+    const std::shared_ptr<LineGapBuffer>& lineGapBuffer = (*m_file)[m_cursorY];
 
     if (findForwards)
     {
@@ -215,80 +182,336 @@ int Buffer::findCharacterIndex(char character, bool findForwards)
     return m_cursorX;
 }
 
-void Buffer::insertCharacter(char character)
+void Buffer::damageLines(size_t first, size_t last)
 {
-    m_file[m_cursorY]->insertChar(character);
-    m_file[m_cursorY]->left();
-    moveCursor(m_cursorY, m_cursorX + 1);
+    m_firstDamagedLine = std::min(m_firstDamagedLine, first);
+    m_lastDamagedLine = std::max(m_lastDamagedLine, last);
 }
 
-char Buffer::removeCharacter(bool cursorHeadingLeft)
+void Buffer::recordLineEdit(LINE_EDIT_TYPE type, size_t index, size_t count)
+{
+    m_lineEdits.record(type, index, count);
+    m_searchIndex.recordLineEdit(type, index, count);
+    m_syntaxHighlighter.recordLineEdit(type, index, count);
+}
+
+void Buffer::clearDamage()
+{
+    m_firstDamagedLine = std::numeric_limits<size_t>::max();
+    m_lastDamagedLine = 0;
+
+    m_lineEdits.clear();
+}
+
+bool Buffer::snapshotMayHold(const LineGapBuffer& line) const
+{
+    if (m_backgroundSave && !m_backgroundSave->finished() && line.generation() <= m_backgroundSave->generation()) { return true; }
+
+    return std::any_of(m_scans.begin(), m_scans.end(), [&line](const SnapshotScan* scan) { return scan->mayHold(line); });
+}
+
+const std::shared_ptr<LineGapBuffer>& Buffer::editableLine(int y)
 {
-    if (cursorHeadingLeft)
+    damageLines(y, y);
+    recordLineEdit(LINE_CHANGED, y);
+
+    const std::shared_ptr<LineGapBuffer>& line = (*m_file)[y];
+
+    if (snapshotMayHold(*line))
     {
-        shiftCursorXWithoutGapBuffer(-1);
+        m_file->replaceLine(y, line->clone());
+
+        return (*m_file)[y];
+    }
+
+    return line;
+}
+
+void Buffer::insertText(int y, int x, std::string_view text)
+{
+    if (text.empty()) { return; }
 
-        char character = m_file[m_cursorY]->getLine()[m_cursorX];
-        m_file[m_cursorY]->deleteChar();
+    const std::shared_ptr<LineGapBuffer>& line = editableLine(y);
+
+    line->moveGap(x);
+    line->insertText(text);
+
+    if (m_undoJournal) { m_undoJournal->recordInsertText(y, x, text); }
+}
 
-        return character;
+void Buffer::eraseText(int y, int x, int count)
+{
+    if (count <= 0) { return; }
+
+    const std::shared_ptr<LineGapBuffer>& line = editableLine(y);
+
+    if (m_undoJournal) { m_undoJournal->recordEraseText(y, x, line->spans(x, count)); }
+
+    line->eraseText(x, count);
+}
+
+void Buffer::insertLineAt(int y, const std::shared_ptr<LineGapBuffer>& line)
+{
+    damageLines(y, std::numeric_limits<size_t>::max());
+    recordLineEdit(LINES_INSERTED, y);
+
+    m_file->insertLine(y, line);
+
+    if (m_undoJournal) { m_undoJournal->recordInsertLine(y, *line); }
+}
+
+std::shared_ptr<LineGapBuffer> Buffer::removeLineAt(int y)
+{
+    damageLines(y, std::numeric_limits<size_t>::max());
+    recordLineEdit(LINES_REMOVED, y);
+
+    if (m_undoJournal) { m_undoJournal->recordRemoveLine(y, *(*m_file)[y]); }
+
+    return m_file->deleteLine(y);
+}
+
+void Buffer::moveLine(int from, int to)
+{
+    damageLines(std::min(from, to), std::max(from, to));
+    recordLineEdit(LINES_REMOVED, from);
+    recordLineEdit(LINES_INSERTED, to);
+
+    m_file->insertLine(to, m_file->deleteLine(from));
+
+    if (m_undoJournal) { m_undoJournal->recordMoveLine(from, to); }
+}
+
+void Buffer::insertLinesAt(int y, const std::vector<std::shared_ptr<LineGapBuffer>>& insertedLines)
+{
+    if (insertedLines.empty()) { return; }
+
+    damageLines(y, std::numeric_limits<size_t>::max());
+    recordLineEdit(LINES_INSERTED, y, insertedLines.size());
+
+    m_file->insertLines(y, insertedLines);
+
+    if (m_undoJournal)
+    {
+        for (size_t i = 0; i < insertedLines.size(); i++) { m_undoJournal->recordInsertLine(y + i, *insertedLines[i]); }
     }
-    else
+}
+
+std::vector<std::shared_ptr<LineGapBuffer>> Buffer::removeLinesAt(int y, int count)
+{
+    count = std::min(count, static_cast<int>(m_file->numberOfLines()) - y);
+
+    if (count <= 0) { return std::vector<std::shared_ptr<LineGapBuffer>>(); }
+
+    damageLines(y, std::numeric_limits<size_t>::max());
+    recordLineEdit(LINES_REMOVED, y, count);
+
+    std::vector<std::shared_ptr<LineGapBuffer>> removedLines = m_file->deleteLines(y, count);
+
+    if (m_undoJournal)
     {
-        m_file[m_cursorY]->right();
+        for (const std::shared_ptr<LineGapBuffer>& line : removedLines) { m_undoJournal->recordRemoveLine(y, *line); }
+    }
+
+    return removedLines;
+}
+
+void Buffer::editLines(int first, int last, const std::function<LineTextEdit(int y, const std::shared_ptr<LineGapBuffer>& line)>& edit)
+{
+    if (first > last) { return; }
+
+    damageLines(first, last);
+    recordLineEdit(LINE_CHANGED, first, last - first + 1);
+
+    int y = first;
+
+    m_file->transformLines(first, last, [this, &edit, &y](std::shared_ptr<LineGapBuffer>& line)
+    {
+        LineTextEdit textEdit = edit(y, line);
+
+        if (textEdit.erasedCharacters > 0 || !textEdit.insertedText.empty())
+        {
+            // Same copy on write as editableLine
+            if (snapshotMayHold(*line)) { line = line->clone(); }
+
+            if (textEdit.erasedCharacters > 0)
+            {
+                if (m_undoJournal) { m_undoJournal->recordEraseText(y, textEdit.x, line->spans(textEdit.x, textEdit.erasedCharacters)); }
+
+                line->eraseText(textEdit.x, textEdit.erasedCharacters);
+            }
+
+            if (!textEdit.insertedText.empty())
+            {
+                line->moveGap(textEdit.x);
+                line->insertText(textEdit.insertedText);
 
-        char character = m_file[m_cursorY]->getLine()[m_cursorX];
-        m_file[m_cursorY]->deleteChar();
+                if (m_undoJournal) { m_undoJournal->recordInsertText(y, textEdit.x, textEdit.insertedText); }
+            }
+        }
+
+        y++;
+    });
+}
+
+void Buffer::insertCharacter(char character)
+{
+    insertText(m_cursorY, m_cursorX, std::string_view(&character, 1));
+
+    moveCursor(m_cursorY, m_cursorX + 1);
+}
+
+char Buffer::removeCharacter(bool cursorHeadingLeft)
+{
+    const std::shared_ptr<LineGapBuffer>& line = (*m_file)[m_cursorY];
 
-        int cursorBeforeMove = m_cursorX;
-        shiftCursorXWithoutGapBuffer(0);
-        if (m_cursorX != cursorBeforeMove)
+    if (line->lineSize() == 0 || (cursorHeadingLeft && m_cursorX == 0)) { return '\0'; }
+
+    // With the cursor past the end of the line, the character before it is removed instead
+    int index = (cursorHeadingLeft) ? m_cursorX - 1 : std::min(m_cursorX, static_cast<int>(line->lineSize()) - 1);
+    char character = line->at(index);
+
+    if (cursorHeadingLeft) { shiftCursorX(-1); }
+
+    eraseText(m_cursorY, index, 1);
+
+    if (!cursorHeadingLeft) { shiftCursorX(0); }
+
+    return character;
+}
+
+void Buffer::insertCharacters(std::string_view characters)
+{
+    if (characters.empty()) { return; }
+
+    insertText(m_cursorY, m_cursorX, characters);
+
+    moveCursor(m_cursorY, m_cursorX + static_cast<int>(characters.size()));
+}
+
+void Buffer::insertCharacters(const LineGapBuffer& source, size_t index, size_t count)
+{
+    std::pair<std::string_view, std::string_view> spans = source.spans(index, count);
+
+    insertCharacters(spans.first);
+    insertCharacters(spans.second);
+}
+
+void Buffer::removeCharacters(int count, std::vector<char>* removedCharacters)
+{
+    if (count <= 0) { return; }
+
+    // Past the end of the line removeCharacter starts eating leftwards, which only the slow path reproduces
+    if (m_cursorX + count > static_cast<int>((*m_file)[m_cursorY]->lineSize()))
+    {
+        for (int i = 0; i < count; i++)
         {
-            m_file[m_cursorY]->left();
+            char character = removeCharacter(false);
+
+            if (removedCharacters) { removedCharacters->push_back(character); }
         }
 
-        return character;
+        return;
     }
+
+    if (removedCharacters)
+    {
+        std::pair<std::string_view, std::string_view> spans = (*m_file)[m_cursorY]->spans(m_cursorX, count);
+
+        removedCharacters->insert(removedCharacters->end(), spans.first.begin(), spans.first.end());
+        removedCharacters->insert(removedCharacters->end(), spans.second.begin(), spans.second.end());
+    }
+
+    eraseText(m_cursorY, m_cursorX, count);
+
+    shiftCursorX(0);
 }
 
 void Buffer::insertLine(bool down)
 {
-    if (down) { m_file.down(); }
+    insertLineAt(m_cursorY + down, std::make_shared<LineGapBuffer>(1));
 
-    m_file.insertLine(std::make_shared<LineGapBuffer>(1));
-
-    m_file.up();
-    moveCursor(m_cursorY + 1 * down, m_cursorX);
+    moveCursor(m_cursorY + down, m_cursorX);
 }
 
 void Buffer::insertLine(std::shared_ptr<LineGapBuffer> line, bool down)
 {
-    if (down) { m_file.down(); }
-
-    m_file.insertLine(line);
+    insertLineAt(m_cursorY + down, line);
 
-    m_file.up();
-    moveCursor(m_cursorY + 1 * down, m_cursorX);
+    moveCursor(m_cursorY + down, m_cursorX);
 }
 
 std::shared_ptr<LineGapBuffer> Buffer::removeLine()
 {
-    moveCursor(m_cursorY + 1, m_cursorX);
-    std::shared_ptr<LineGapBuffer> line = m_file.deleteLine();
+    std::shared_ptr<LineGapBuffer> line = removeLineAt(m_cursorY);
 
-    if (m_file.numberOfLines() != 0)
+    if (m_file->numberOfLines() == 0)
+    {
+        insertLineAt(0, std::make_shared<LineGapBuffer>(1));
+        moveCursor(0, 0);
+    }
+    else if (m_cursorY == static_cast<int>(m_file->numberOfLines()))
     {
         moveCursor(m_cursorY - 1, m_cursorX);
     }
     else
     {
-        insertLine(true);
-        moveCursor(0, 0);
+        moveCursor(m_cursorY, m_cursorX);
     }
 
     return line;
 }
 
+void Buffer::insertLines(const std::vector<std::shared_ptr<LineGapBuffer>>& insertedLines)
+{
+    if (insertedLines.empty()) { return; }
+
+    insertLinesAt(m_cursorY + 1, insertedLines);
+
+    // Moving down one inserted line at a time clamps the column to each line on the way
+    int x = m_cursorX;
+
+    for (const std::shared_ptr<LineGapBuffer>& line : insertedLines) { x = std::min(x, static_cast<int>(line->lineSize())); }
+
+    moveCursor(m_cursorY + static_cast<int>(insertedLines.size()), x);
+}
+
+std::vector<std::shared_ptr<LineGapBuffer>> Buffer::removeLines(int count)
+{
+    std::vector<std::shared_ptr<LineGapBuffer>> removedLines = removeLinesAt(m_cursorY, count);
+
+    if (m_file->numberOfLines() == 0)
+    {
+        insertLineAt(0, std::make_shared<LineGapBuffer>(1));
+        moveCursor(0, 0);
+    }
+    else if (m_cursorY == static_cast<int>(m_file->numberOfLines()))
+    {
+        moveCursor(m_cursorY - 1, m_cursorX);
+    }
+    else
+    {
+        moveCursor(m_cursorY, m_cursorX);
+    }
+
+    return removedLines;
+}
+
+void Buffer::swapLinesInRange(bool down, int start, int end)
+{
+    if (down)
+    {
+        if (end + 1 >= static_cast<int>(m_file->numberOfLines())) { return; }
+
+        moveLine(end + 1, start);
+    }
+    else
+    {
+        if (start <= 0) { return; }
+
+        moveLine(start - 1, end);
+    }
+}
+
 char Buffer::replaceCharacter(char character)
 {
     moveCursor(m_cursorY, m_cursorX + 1);
@@ -300,428 +523,346 @@ char Buffer::replaceCharacter(char character)
     return replacedChar;
 }
 
-void Buffer::writeToFile(const std::filesystem::path& filePath)
+ContentHash Buffer::openedContentHash() const
 {
-    std::ofstream fout;
-
-    fout.open(filePath);
+    ContentHash contentHash;
 
-    for (size_t row = 0; row < m_file.numberOfLines(); row++)
+    if (m_mappedFile)
     {
-        const std::shared_ptr<LineGapBuffer> lineGapBuffer = m_file[row];
+        size_t size = m_mappedFile->size();
 
-        for (size_t column = 0; column < lineGapBuffer->lineSize(); column++)
-        {
-            fout << lineGapBuffer->at(column);
-        }
+        // Loading drops the newline ending the last line, which saving does not write back
+        if (size > 0 && m_mappedFile->data()[size - 1] == '\n') { size--; }
+
+        contentHash.update(m_mappedFile->data(), size);
+    }
+
+    return contentHash;
+}
+
+bool Buffer::loadUndoHistory()
+{
+    std::unique_ptr<UndoFile> undoFile = std::move(m_undoFile);
+
+    if (!undoFile || !m_undoJournal || m_undoJournal->firstState() != 0) { return false; }
+
+    return undoFile->load(*m_undoJournal, openedContentHash());
+}
+
+void Buffer::startSave(const std::filesystem::path& filePath)
+{
+    // Saves are written one at a time so two writers never race for the same target
+    if (m_backgroundSave) { m_backgroundSave->wait(); }
 
-        if (row < m_file.numberOfLines() - 1) { fout << '\n'; }
+    std::vector<char> undoHistory;
+
+    if (m_undoJournal)
+    {
+        // History of earlier sessions is carried over into the new undo file
+        if (m_undoFile) { loadUndoHistory(); }
+
+        if (m_undoJournal->currentState() != m_undoJournal->rootState()) { undoHistory = UndoFile::serialize(*m_undoJournal); }
     }
 
-    fout.close();
+    // Overwriting the file in place would change the text of the lines still pointing into its mapping. Where that can be
+    // told ahead, the mapping is copied first. Where it cannot, or the copy fails, the save fails instead.
+    std::error_code errorCode;
+    bool mapsTarget = m_mappedFile && !m_mappedFile->detached() && std::filesystem::equivalent(filePath, m_filePath, errorCode);
+
+    if (mapsTarget && FileWriter::writesInPlace(filePath)) { mapsTarget = !m_mappedFile->detachFromFile(); }
+
+    std::vector<std::shared_ptr<const LineGapBuffer>> snapshot;
+    uint64_t generation = SnapshotScan::takeSnapshot(*m_file, snapshot);
+
+    m_backgroundSave = std::make_unique<BackgroundSave>(filePath, std::move(snapshot), generation, std::move(undoHistory), !mapsTarget);
 }
 
-void Buffer::saveCurrentFile()
+SaveResult Buffer::finishSave()
 {
-    writeToFile(m_filePath);
+    if (!m_backgroundSave) { return SaveResult{ false, "No save in progress", 0, 0.0 }; }
+
+    SaveResult result = m_backgroundSave->wait();
+    m_backgroundSave.reset();
+
+    return result;
+}
+
+SaveResult Buffer::writeToFile(const std::filesystem::path& filePath)
+{
+    startSave(filePath);
+
+    return finishSave();
+}
+
+SaveResult Buffer::saveCurrentFile()
+{
+    return writeToFile(m_filePath);
+}
+
+size_t Buffer::lineMemoryUsage() const
+{
+    size_t bytes = m_file->numberOfLines() * sizeof(std::shared_ptr<LineGapBuffer>);
+
+    m_file->forEachLine([&bytes](const std::shared_ptr<LineGapBuffer>& line)
+    {
+        bytes += sizeof(LineGapBuffer) + line->getLine().capacity();
+    });
+
+    return bytes;
+}
+
+void Buffer::releaseMappedPages() const
+{
+    if (m_mappedFile) { m_mappedFile->releasePages(); }
+}
+
+void Buffer::setSearchPattern(std::shared_ptr<const SearchPattern> pattern)
+{
+    if (pattern == m_searchIndex.pattern()) { return; }
+
+    m_searchIndex.setPattern(std::move(pattern), *m_file);
+}
+
+bool Buffer::findMatch(bool forward, SearchMatch& match, bool& wrapped)
+{
+    return m_searchIndex.findNext(*m_file, getCursorPos(), forward, match, wrapped);
+}
+
+void Buffer::updateSyntaxHighlighting(size_t lastLine)
+{
+    size_t firstRestyledLine;
+    size_t lastRestyledLine;
+
+    if (m_syntaxHighlighter.update(*m_file, lastLine, firstRestyledLine, lastRestyledLine) && firstRestyledLine <= lastRestyledLine)
+    {
+        damageLines(firstRestyledLine, lastRestyledLine);
+    }
 }
 
 bool Buffer::isCharacterSymbolic(char character)
 {
-    if ((character >= 'A' && character <= 'Z') || (character >= 'a' && character <= 'z') || (character == '_') || (character >= '0' && character <= '9')) { return false; }
-    else { return true; }
+    return CharacterScanner::characterClass(character) != WORD_CHARACTER;
 }
 
+// The motions below scan the line with CharacterScanner. Where the old character loops read one character past either end of
+// the line, the missing character is treated the same way: '\0' past the end is punctuation for word motions and 'a' is a
+// word character for symbol motions.
+
 int Buffer::beginningNextWordIndex()
 {
-    const std::shared_ptr<LineGapBuffer>& lineGapBuffer = m_file[m_cursorY];
+    const std::shared_ptr<LineGapBuffer>& lineGapBuffer = (*m_file)[m_cursorY];
     if (lineGapBuffer->lineSize() == 0) { return m_cursorX; }
     else if (static_cast<int>(lineGapBuffer->lineSize()) == m_cursorX - 1) { return m_cursorX - 1; }
 
-    char currentCharacter = m_file[m_cursorY]->at(m_cursorX);
-    bool currentCharacterSymbolic = isCharacterSymbolic(currentCharacter);
-    bool foundSymbol = false;
+    bool currentCharacterSymbolic = isCharacterSymbolic(lineGapBuffer->at(m_cursorX));
+    size_t index = m_cursorX + 1;
 
-    for (size_t index = m_cursorX + 1; index < lineGapBuffer->lineSize(); index++)
+    // A word under the cursor is skipped up to the first symbol after it
+    if (!currentCharacterSymbolic)
     {
-        char character = lineGapBuffer->at(index);
+        index = CharacterScanner::findNext(*lineGapBuffer, index, SYMBOLIC_CHARACTER);
+        if (index == std::string_view::npos) { return m_cursorX; }
 
-        if (currentCharacterSymbolic)
-        {
-            if (!isCharacterSymbolic(character))
-            {
-                return index;
-            }
-        }
-        else
-        {
-            if (foundSymbol)
-            {
-                if (!isCharacterSymbolic(character))
-                {
-                    return index;
-                }
-            }
-            else
-            {
-                foundSymbol = (isCharacterSymbolic(character));
-            }
-        }
+        index++;
     }
 
-    return m_cursorX;
+    index = CharacterScanner::findNext(*lineGapBuffer, index, WORD_CHARACTER);
+
+    return (index == std::string_view::npos) ? m_cursorX : static_cast<int>(index);
 }
 
 int Buffer::beginningNextSymbolIndex()
 {
-    const std::shared_ptr<LineGapBuffer>& lineGapBuffer = m_file[m_cursorY];
+    const std::shared_ptr<LineGapBuffer>& lineGapBuffer = (*m_file)[m_cursorY];
     if (lineGapBuffer->lineSize() == 0) { return m_cursorX; }
     else if (static_cast<int>(lineGapBuffer->lineSize()) == m_cursorX - 1) { return m_cursorX - 1; }
 
-    char currentCharacter = m_file[m_cursorY]->at(m_cursorX);
-    bool currentCharacterSymbolic = isCharacterSymbolic(currentCharacter);
-    bool foundSpaceOrCharacter = false;
+    bool currentCharacterSymbolic = isCharacterSymbolic(lineGapBuffer->at(m_cursorX));
+    size_t index = m_cursorX + 1;
 
-    for (size_t index = m_cursorX + 1; index < lineGapBuffer->lineSize(); index++)
+    // A symbol or space under the cursor is skipped up to the first word character or space after it
+    if (currentCharacterSymbolic)
     {
-        char character = lineGapBuffer->at(index);
+        index = CharacterScanner::findNext(*lineGapBuffer, index, WORD_CHARACTER | SPACE_CHARACTER);
+        if (index == std::string_view::npos) { return m_cursorX; }
 
-        if (!currentCharacterSymbolic)
-        {
-            if (isCharacterSymbolic(character) && character != ' ')
-            {
-                return index;
-            }
-        }
-        else
-        {
-            if (foundSpaceOrCharacter)
-            {
-                if (isCharacterSymbolic(character) && character != ' ')
-                {
-                    return index;
-                }
-            }
-            else
-            {
-                foundSpaceOrCharacter = (!isCharacterSymbolic(character) || character == ' ');
-            }
-        }
+        index++;
     }
 
-    return m_cursorX;
+    index = CharacterScanner::findNext(*lineGapBuffer, index, PUNCTUATION_CHARACTER);
+
+    return (index == std::string_view::npos) ? m_cursorX : static_cast<int>(index);
 }
 
 int Buffer::endNextWordIndex()
 {
-    const std::shared_ptr<LineGapBuffer>& lineGapBuffer = m_file[m_cursorY];
+    const std::shared_ptr<LineGapBuffer>& lineGapBuffer = (*m_file)[m_cursorY];
     size_t lineSize = lineGapBuffer->lineSize();
     if (lineSize == 0) { return m_cursorX; }
     else if (static_cast<int>(lineGapBuffer->lineSize()) == m_cursorX - 1) { return m_cursorX - 1; }
 
-    char currentCharacter = m_file[m_cursorY]->at(std::min(m_cursorX + 1, static_cast<int>(lineSize) - 1));
-    bool currentCharacterSymbolic = isCharacterSymbolic(currentCharacter);
-    bool foundSymbol = false;
-    bool foundCharacterOrSpace = false;
+    bool currentCharacterSymbolic = isCharacterSymbolic(lineGapBuffer->at(std::min(m_cursorX + 1, static_cast<int>(lineSize) - 1)));
+    size_t index = m_cursorX + 2;
 
-    for (size_t index = m_cursorX + 2; index <= lineSize; index++)
-    {
-        char character = '\0';
-        if (index != lineSize) { character = lineGapBuffer->at(index); }
+    if (index > lineSize) { return m_cursorX; }
 
-        if (currentCharacterSymbolic)
-        {
-            if (foundCharacterOrSpace)
-            {
-                if (isCharacterSymbolic(character))
-                {
-                    return index - 1;
-                }
-            }
-            else
-            {
-                foundCharacterOrSpace = (!isCharacterSymbolic(character));
-            }
-        }
-        else
-        {
-            if (isCharacterSymbolic(character))
-            {
-                return index - 1;
-            }
+    if (currentCharacterSymbolic)
+    {
+        index = CharacterScanner::findNext(*lineGapBuffer, index, WORD_CHARACTER);
+        if (index == std::string_view::npos) { return m_cursorX; }
 
-            if (foundSymbol)
-            {
-                if (!isCharacterSymbolic(character))
-                {
-                    return index;
-                }
-            }
-            else
-            {
-                foundSymbol = (isCharacterSymbolic(character));
-            }
-        }
+        index++;
     }
 
-    return m_cursorX;
+    index = CharacterScanner::findNext(*lineGapBuffer, index, SYMBOLIC_CHARACTER);
+
+    return static_cast<int>(std::min(index, lineSize)) - 1;
 }
 
 int Buffer::endNextSymbolIndex()
 {
-    const std::shared_ptr<LineGapBuffer>& lineGapBuffer = m_file[m_cursorY];
+    const std::shared_ptr<LineGapBuffer>& lineGapBuffer = (*m_file)[m_cursorY];
     size_t lineSize = lineGapBuffer->lineSize();
     if (lineSize == 0) { return m_cursorX; }
     else if (static_cast<int>(lineGapBuffer->lineSize()) == m_cursorX - 1) { return m_cursorX - 1; }
 
-    char currentCharacter = m_file[m_cursorY]->at(std::min(m_cursorX + 1, static_cast<int>(lineSize) - 1));
-    bool currentCharacterSymbolic = isCharacterSymbolic(currentCharacter) && currentCharacter != ' ';
-    bool foundTarget = false;
+    char currentCharacter = lineGapBuffer->at(std::min(m_cursorX + 1, static_cast<int>(lineSize) - 1));
+    bool currentCharacterSymbolic = CharacterScanner::characterClass(currentCharacter) == PUNCTUATION_CHARACTER;
+    size_t index = m_cursorX + 2;
+
+    if (index > lineSize) { return m_cursorX; }
 
-    for (size_t index = m_cursorX + 2; index <= lineSize; index++)
+    if (!currentCharacterSymbolic)
     {
-        char character = 'a';
-        if (index != lineSize) { character = lineGapBuffer->at(index); }
+        index = CharacterScanner::findNext(*lineGapBuffer, index, PUNCTUATION_CHARACTER);
+        if (index == std::string_view::npos) { return m_cursorX; }
 
-        if (!currentCharacterSymbolic)
-        {
-            if (foundTarget)
-            {
-                if (!isCharacterSymbolic(character) || character == ' ')
-                {
-                    return index - 1;
-                }
-            }
-            else
-            {
-                foundTarget = (isCharacterSymbolic(character) && character != ' ');
-            }
-        }
-        else
-        {
-            if (!isCharacterSymbolic(character))
-            {
-                return index - 1;
-            }
+        index = CharacterScanner::findNext(*lineGapBuffer, index + 1, WORD_CHARACTER | SPACE_CHARACTER);
 
-            if (foundTarget)
-            {
-                if (isCharacterSymbolic(character) && character != ' ')
-                {
-                    return index;
-                }
-            }
-            else
-            {
-                foundTarget = (!isCharacterSymbolic(character) || character == ' ');
-            }
-        }
+        return static_cast<int>(std::min(index, lineSize)) - 1;
     }
 
-    return m_cursorX;
+    // Symbols run up to the next word character, or across spaces to the start of the next run of symbols
+    index = CharacterScanner::findNext(*lineGapBuffer, index, WORD_CHARACTER | SPACE_CHARACTER);
+
+    if (index != std::string_view::npos && lineGapBuffer->at(index) == ' ')
+    {
+        index = CharacterScanner::findNext(*lineGapBuffer, index + 1, WORD_CHARACTER | PUNCTUATION_CHARACTER);
+
+        if (index != std::string_view::npos && CharacterScanner::characterClass(lineGapBuffer->at(index)) == PUNCTUATION_CHARACTER) { return static_cast<int>(index); }
+    }
+
+    return static_cast<int>(std::min(index, lineSize)) - 1;
 }
 
 int Buffer::endPreviousWordIndex()
 {
-    const std::shared_ptr<LineGapBuffer>& lineGapBuffer = m_file[m_cursorY];
+    const std::shared_ptr<LineGapBuffer>& lineGapBuffer = (*m_file)[m_cursorY];
     if (lineGapBuffer->lineSize() == 0) { return m_cursorX; }
     else if (static_cast<int>(lineGapBuffer->lineSize()) == m_cursorX - 1) { return m_cursorX - 1; }
-    char currentCharacter = m_file[m_cursorY]->at(m_cursorX);
-    bool currentCharacterSymbolic = isCharacterSymbolic(currentCharacter);
-    bool foundSpaceOrSymbol = false;
 
-    int startingIndex = std::max(0, m_cursorX - 1);
-    for (int index = startingIndex; index >= -1; index--)
+    bool currentCharacterSymbolic = isCharacterSymbolic(lineGapBuffer->at(m_cursorX));
+    size_t index = std::max(0, m_cursorX - 1);
+
+    // A word under the cursor is skipped back past the first symbol or space before it
+    if (!currentCharacterSymbolic)
     {
-        char character = '\0';
-        if (index != -1) { character = lineGapBuffer->at(index); };
+        index = CharacterScanner::findPrevious(*lineGapBuffer, index, SYMBOLIC_CHARACTER);
+        if (index == std::string_view::npos || index == 0) { return m_cursorX; }
 
-        if (currentCharacterSymbolic)
-        {
-            if (!isCharacterSymbolic(character) && character != ' ')
-            {
-                return index;
-            }
-        }
-        else
-        {
-            if (foundSpaceOrSymbol)
-            {
-                if (!isCharacterSymbolic(character))
-                {
-                    return index;
-                }
-            }
-            else
-            {
-                foundSpaceOrSymbol = (isCharacterSymbolic(character) || character == ' ');
-            }
-        }
+        index--;
     }
 
-    return m_cursorX;
+    index = CharacterScanner::findPrevious(*lineGapBuffer, index, WORD_CHARACTER);
+
+    return (index == std::string_view::npos) ? m_cursorX : static_cast<int>(index);
 }
 
 int Buffer::endPreviousSymbolIndex()
 {
-    const std::shared_ptr<LineGapBuffer>& lineGapBuffer = m_file[m_cursorY];
+    const std::shared_ptr<LineGapBuffer>& lineGapBuffer = (*m_file)[m_cursorY];
     if (lineGapBuffer->lineSize() == 0) { return m_cursorX; }
     else if (static_cast<int>(lineGapBuffer->lineSize()) == m_cursorX - 1) { return m_cursorX - 1; }
 
-    char currentCharacter = m_file[m_cursorY]->at(m_cursorX);
-    bool currentCharacterSymbolic = isCharacterSymbolic(currentCharacter);
-    bool foundSpaceOrCharacter = false;
+    bool currentCharacterSymbolic = isCharacterSymbolic(lineGapBuffer->at(m_cursorX));
+    size_t index = std::max(0, m_cursorX - 1);
 
-    int startingIndex = std::max(0, m_cursorX - 1);
-    for (int index = startingIndex; index >= -1; index--)
+    // A symbol or space under the cursor is skipped back past the first word character or space before it
+    if (currentCharacterSymbolic)
     {
-        char character = 'a';
-        if (index != -1) { character = lineGapBuffer->at(index); }
+        index = CharacterScanner::findPrevious(*lineGapBuffer, index, WORD_CHARACTER | SPACE_CHARACTER);
+        if (index == std::string_view::npos || index == 0) { return m_cursorX; }
 
-        if (!currentCharacterSymbolic)
-        {
-            if (isCharacterSymbolic(character) && character != ' ')
-            {
-                return index;
-            }
-        }
-        else
-        {
-            if (foundSpaceOrCharacter)
-            {
-                if (isCharacterSymbolic(character) && character != ' ')
-                {
-                    return index;
-                }
-            }
-            else
-            {
-                foundSpaceOrCharacter = (!isCharacterSymbolic(character) || character == ' ');
-            }
-        }
+        index--;
     }
 
-    return m_cursorX;
+    index = CharacterScanner::findPrevious(*lineGapBuffer, index, PUNCTUATION_CHARACTER);
+
+    return (index == std::string_view::npos) ? m_cursorX : static_cast<int>(index);
 }
 
 int Buffer::beginningPreviousWordIndex()
 {
     if (m_cursorX == 0) { return m_cursorX; }
 
-    const std::shared_ptr<LineGapBuffer>& lineGapBuffer = m_file[m_cursorY];
+    const std::shared_ptr<LineGapBuffer>& lineGapBuffer = (*m_file)[m_cursorY];
     if (static_cast<int>(lineGapBuffer->lineSize()) == m_cursorX - 1) { return m_cursorX - 1; }
 
-    char currentCharacter = m_file[m_cursorY]->at(std::max(0, m_cursorX - 1));
-    bool currentCharacterSymbolic = isCharacterSymbolic(currentCharacter);
-    bool foundSymbol = false;
-    bool foundCharacterOrSpace = false;
+    bool currentCharacterSymbolic = isCharacterSymbolic(lineGapBuffer->at(std::max(0, m_cursorX - 1)));
+    size_t index = std::max(0, m_cursorX - 2);
 
-    size_t startingIndex = std::max(0, m_cursorX - 2);
-    for (int index = startingIndex; index >= -1; index--)
+    if (currentCharacterSymbolic)
     {
-        char character = '\0';
-        if (index != -1) { character = lineGapBuffer->at(index); }
-
-        if (currentCharacterSymbolic)
-        {
-            if (foundCharacterOrSpace)
-            {
-                if (isCharacterSymbolic(character))
-                {
-                    return index + 1;
-                }
-            }
-            else
-            {
-                foundCharacterOrSpace = (!isCharacterSymbolic(character));
-            }
-        }
-        else
-        {
-            if (isCharacterSymbolic(character))
-            {
-                return index + 1;
-            }
+        index = CharacterScanner::findPrevious(*lineGapBuffer, index, WORD_CHARACTER);
+        if (index == std::string_view::npos) { return m_cursorX; }
+        if (index == 0) { return 0; }
 
-            if (foundSymbol)
-            {
-                if (!isCharacterSymbolic(character))
-                {
-                    return index;
-                }
-            }
-            else
-            {
-                foundSymbol = (isCharacterSymbolic(character));
-            }
-        }
+        index--;
     }
 
-    return m_cursorX;
+    index = CharacterScanner::findPrevious(*lineGapBuffer, index, SYMBOLIC_CHARACTER);
+
+    return (index == std::string_view::npos) ? 0 : static_cast<int>(index) + 1;
 }
 
 int Buffer::beginningPreviousSymbolIndex()
 {
     if (m_cursorX == 0) { return m_cursorX; }
 
-    const std::shared_ptr<LineGapBuffer>& lineGapBuffer = m_file[m_cursorY];
+    const std::shared_ptr<LineGapBuffer>& lineGapBuffer = (*m_file)[m_cursorY];
     if (static_cast<int>(lineGapBuffer->lineSize()) == m_cursorX - 1) { return m_cursorX - 1; }
 
+    char currentCharacter = lineGapBuffer->at(std::max(m_cursorX - 1, 0));
+    bool currentCharacterSymbolic = CharacterScanner::characterClass(currentCharacter) == PUNCTUATION_CHARACTER;
+    size_t index = std::max(0, m_cursorX - 2);
 
-    char currentCharacter = m_file[m_cursorY]->at(std::max(m_cursorX - 1, 0));
-    bool currentCharacterSymbolic = isCharacterSymbolic(currentCharacter) && currentCharacter != ' ';
-    bool foundTarget = false;
-
-    size_t startingIndex = std::max(0, m_cursorX - 2);
-    for (int index = startingIndex; index >= -1; index--)
+    if (!currentCharacterSymbolic)
     {
-        char character = 'a';
-        if (index != -1) { character = lineGapBuffer->at(index); }
+        index = CharacterScanner::findPrevious(*lineGapBuffer, index, PUNCTUATION_CHARACTER);
+        if (index == std::string_view::npos) { return m_cursorX; }
+        if (index == 0) { return 0; }
 
-        if (!currentCharacterSymbolic)
-        {
-            if (foundTarget)
-            {
-                if (!isCharacterSymbolic(character) || character == ' ')
-                {
-                    return index + 1;
-                }
-            }
-            else
-            {
-                foundTarget = (isCharacterSymbolic(character) && character != ' ');
-            }
-        }
-        else
-        {
-            if (!isCharacterSymbolic(character))
-            {
-                return index + 1;
-            }
+        index = CharacterScanner::findPrevious(*lineGapBuffer, index - 1, WORD_CHARACTER | SPACE_CHARACTER);
 
-            if (foundTarget)
-            {
-                if (isCharacterSymbolic(character) && character != ' ')
-                {
-                    return index;
-                }
-            }
-            else
-            {
-                foundTarget = (!isCharacterSymbolic(character) || character == ' ');
-            }
-        }
+        return (index == std::string_view::npos) ? 0 : static_cast<int>(index) + 1;
     }
 
-    return m_cursorX;
+    // Symbols run back to the previous word character, or across spaces to the end of the previous run of symbols
+    index = CharacterScanner::findPrevious(*lineGapBuffer, index, WORD_CHARACTER | SPACE_CHARACTER);
+
+    if (index != std::string_view::npos && lineGapBuffer->at(index) == ' ')
+    {
+        index = (index == 0) ? std::string_view::npos : CharacterScanner::findPrevious(*lineGapBuffer, index - 1, WORD_CHARACTER | PUNCTUATION_CHARACTER);
+
+        if (index != std::string_view::npos && CharacterScanner::characterClass(lineGapBuffer->at(index)) == PUNCTUATION_CHARACTER) { return static_cast<int>(index); }
+    }
+
+    return (index == std::string_view::npos) ? 0 : static_cast<int>(index) + 1;
 }
 
 int Buffer::indexOfFirstNonSpaceCharacter(const std::shared_ptr<LineGapBuffer>& line) const
 {
-    for (size_t i = 0; i < line->lineSize(); i++)
-    {
-        if (line->at(i) != ' ') { return static_cast<int>(i); }
-    }
+    if (line->firstNonSpaceIndex() == line->lineSize()) { return 0; }
 
-    return 0;
+    return static_cast<int>(line->firstNonSpaceIndex());
 }
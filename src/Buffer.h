@@ -1,6 +1,21 @@
 #pragma once
 
 #include "FileGapBuffer.h"
+#include "FileRope.h"
+#include "MappedFile.h"
+#include "BackgroundSave.h"
+#include "UndoJournal.h"
+#include "LineEditLog.h"
+#include "SearchIndex.h"
+#include "SyntaxHighlighter.h"
+
+// What editLines does to one line: erases some characters at x, then inserts text there
+struct LineTextEdit
+{
+    int x = 0;
+    int erasedCharacters = 0;
+    std::string insertedText;
+};
 
 class Buffer
 {
@@ -9,7 +24,22 @@ private:
 
     std::filesystem::path m_filePath;
 
-    FileGapBuffer m_file;
+    std::unique_ptr<MappedFile> m_mappedFile;
+
+    FILE_BACKEND m_fileBackend;
+    std::unique_ptr<FileBackend> m_file;
+
+    // Save running on a worker thread, if any
+    std::unique_ptr<BackgroundSave> m_backgroundSave;
+
+    // Matches of the last search pattern
+    SearchIndex m_searchIndex;
+
+    // Lexer states of the lines, for coloring them
+    SyntaxHighlighter m_syntaxHighlighter;
+
+    // Scans of the search index and the syntax highlighter
+    std::vector<const SnapshotScan*> m_scans;
 
     int m_cursorX;
     int m_cursorY;
@@ -18,22 +48,45 @@ private:
     std::pair<int, int> m_lastYankInitialPos;
     std::pair<int, int> m_lastYankFinalPos;
 
+    // Lines changed since the view last drew them. Starts out covering the whole file.
+    size_t m_firstDamagedLine = 0;
+    size_t m_lastDamagedLine = std::numeric_limits<size_t>::max();
+
+    // Line edits since the view last caught up, so caches indexed by line can be shifted instead of rebuilt
+    LineEditLog m_lineEdits = LineEditLog(true);
+
+    // Where the primitive edits below are recorded for undo, if anywhere
+    UndoJournal* m_undoJournal = nullptr;
+
+    // Undo history saved with the file by an earlier session, until it is loaded or turns out not to match
+    std::unique_ptr<UndoFile> m_undoFile;
+
 private:
 
     void readFromFile(const std::string& fileName);
+    std::unique_ptr<FileBackend> createFile(std::vector<std::shared_ptr<LineGapBuffer>>&& loadedLines) const;
+
+    void damageLines(size_t first, size_t last);
+    void recordLineEdit(LINE_EDIT_TYPE type, size_t index, size_t count = 1);
+
+    // Hash of the text as it was opened, before any edits
+    ContentHash openedContentHash() const;
+
+    // Whether a running save, search scan or highlighting pass may still read line, which then has to be copied before it is edited
+    bool snapshotMayHold(const LineGapBuffer& line) const;
+
+    // Line y, marked as damaged and first swapped for a copy if a snapshot may still hold the original
+    const std::shared_ptr<LineGapBuffer>& editableLine(int y);
 
 public:
 
-    Buffer();
-    Buffer(const std::string& fileName);
+    Buffer(const std::string& fileName, FILE_BACKEND fileBackend = GAP_BUFFER_BACKEND);
 
     void moveCursor(int y, int x);
 
     void shiftCursorX(int x);
     void shiftCursorY(int y);
 
-    void shiftCursorXWithoutGapBuffer(int x);
-
     int getXPositionOfFirstCharacter(int y);
 
     void shiftCursorFullRight();
@@ -60,29 +113,91 @@ public:
 
     int indexOfFirstNonSpaceCharacter(const std::shared_ptr<LineGapBuffer>& line) const;
 
+    // Every change to the text goes through these, so damage, line edits and the undo journal see all of it.
+    // They leave the cursor where it is.
+    void insertText(int y, int x, std::string_view text);
+    void eraseText(int y, int x, int count);
+    void insertLineAt(int y, const std::shared_ptr<LineGapBuffer>& line);
+    std::shared_ptr<LineGapBuffer> removeLineAt(int y);
+    void moveLine(int from, int to);
+
+    // Range versions of the above for edits spanning many lines. The file moves its lines once for the whole range and
+    // the view is told about the range at once, while the undo journal still gets an operation per line.
+    void insertLinesAt(int y, const std::vector<std::shared_ptr<LineGapBuffer>>& insertedLines);
+    std::vector<std::shared_ptr<LineGapBuffer>> removeLinesAt(int y, int count);
+
+    // Applies the edit returned for each line from first to last in one pass over the file. edit is only shown the line
+    // it is asked about, the other lines of the range may be out of the file while it runs.
+    void editLines(int first, int last, const std::function<LineTextEdit(int y, const std::shared_ptr<LineGapBuffer>& line)>& edit);
 
     void insertCharacter(char character);
     char removeCharacter(bool cursorHeadingLeft = true);
+
+    // Same as repeated insertCharacter and removeCharacter(false) calls, but the line is edited once
+    void insertCharacters(std::string_view characters);
+    void insertCharacters(const LineGapBuffer& source, size_t index, size_t count);
+    void removeCharacters(int count, std::vector<char>* removedCharacters = nullptr);
     char replaceCharacter(char character);
 
     void insertLine(bool down);
     void insertLine(std::shared_ptr<LineGapBuffer> line, bool down);
     std::shared_ptr<LineGapBuffer> removeLine();
 
-    void writeToFile(const std::filesystem::path& filePath);
-    void saveCurrentFile();
+    // Same as repeated insertLine(line, true) and removeLine calls, with the lines moved in one go
+    void insertLines(const std::vector<std::shared_ptr<LineGapBuffer>>& insertedLines);
+    std::vector<std::shared_ptr<LineGapBuffer>> removeLines(int count);
+
+    // Moves the lines from start to end one line up or down, past the line next to them
+    void swapLinesInRange(bool down, int start, int end);
+
+    // Puts the undo history saved with the file in front of the journal. Only tried once, and only while the journal
+    // still reaches back to the text as it was opened.
+    bool loadUndoHistory();
+
+    // Snapshots the lines, and the undo history leading to them, and writes them on a worker thread while editing goes on
+    void startSave(const std::filesystem::path& filePath);
+    SaveResult finishSave();
+
+    SaveResult writeToFile(const std::filesystem::path& filePath);
+    SaveResult saveCurrentFile();
+
+    // Bytes the lines take on the heap, counting edited lines and the table of lines but not the mapping they start in
+    size_t lineMemoryUsage() const;
+    size_t residentMappedBytes() const { return (m_mappedFile) ? m_mappedFile->residentBytes() : 0; }
+
+    // Gives the pages of the mapped file back while the buffer is not shown. Lines still in the mapping read them in again.
+    void releaseMappedPages() const;
+
+    // Pattern n and N look for, or null to forget it
+    void setSearchPattern(std::shared_ptr<const SearchPattern> pattern);
+
+    // Finds the next match of the search pattern from the cursor. wrapped tells whether it went past an end of the file.
+    bool findMatch(bool forward, SearchMatch& match, bool& wrapped);
+
+    // Brings the lexer states up to date as far as lastLine before the lines are drawn, damaging the lines whose colors
+    // changed without being edited
+    void updateSyntaxHighlighting(size_t lastLine);
+
+    bool isLineDamaged(size_t y) const { return y >= m_firstDamagedLine && y <= m_lastDamagedLine; }
+    void clearDamage();
+    const std::vector<LineEdit>& lineEdits() const { return m_lineEdits.edits(); }
+    bool lineEditsOverflowed() const { return m_lineEdits.overflowed(); }
 
     // SETTERS
     void setFileName(const std::filesystem::path& filePath) { m_filePath = filePath; }
     void setLastYankInitialCursor(const std::pair<int, int>& pos) { m_lastYankInitialPos = pos; }
     void setLastYankFinalCursor(const std::pair<int, int>& pos) { m_lastYankFinalPos = pos; }
+    void setUndoJournal(UndoJournal* undoJournal) { m_undoJournal = undoJournal; }
 
     // GETTERS
-    const FileGapBuffer& getFileGapBuffer() const { return m_file ; }
-    const std::shared_ptr<LineGapBuffer>& getLineGapBuffer(int y) const { return m_file[y]; }
+    const FileBackend& getFile() const { return *m_file ; }
+    const std::shared_ptr<LineGapBuffer>& getLineGapBuffer(int y) const { return (*m_file)[y]; }
     std::pair<int, int> getCursorPos() const { return std::pair<int, int>(m_cursorY, m_cursorX) ; }
     int cursorXBeforeYMove() const { return m_lastXSinceYMove ; }
     const std::filesystem::path& filePath() const { return m_filePath; }
+    const BackgroundSave* backgroundSave() const { return m_backgroundSave.get(); }
+    const SearchIndex& searchIndex() const { return m_searchIndex; }
+    const SyntaxHighlighter& syntaxHighlighter() const { return m_syntaxHighlighter; }
     const std::pair<int, int>& lastYankInitialCursor() const { return m_lastYankInitialPos; }
     const std::pair<int, int>& lastYankFinalCursor() const { return m_lastYankFinalPos; }
 
@@ -0,0 +1,89 @@
+#include "CellGrid.h"
+
+void CellGrid::resize(int rows, int cols)
+{
+    m_rows = std::max(0, rows);
+    m_cols = std::max(0, cols);
+
+    m_cells.assign(static_cast<size_t>(m_rows) * m_cols, Cell());
+    m_dirtyRows.assign(m_rows, true);
+}
+
+void CellGrid::invalidate()
+{
+    std::fill(m_cells.begin(), m_cells.end(), Cell{ '\0', false, -1 });
+}
+
+void CellGrid::set(int y, int x, char character, short colorPair, bool bold)
+{
+    if (!contains(y, x)) { return; }
+
+    m_cells[static_cast<size_t>(y) * m_cols + x] = Cell{ character, bold, colorPair };
+    m_dirtyRows[y] = true;
+}
+
+void CellGrid::fill(int y, int x, int count, char character, short colorPair)
+{
+    if (y < 0 || y >= m_rows) { return; }
+
+    int start = std::max(0, x);
+    int end = std::min(m_cols, x + count);
+
+    if (start >= end) { return; }
+
+    std::fill(m_cells.begin() + static_cast<size_t>(y) * m_cols + start, m_cells.begin() + static_cast<size_t>(y) * m_cols + end, Cell{ character, false, colorPair });
+    m_dirtyRows[y] = true;
+}
+
+int CellGrid::print(int y, int x, std::string_view text, short colorPair)
+{
+    for (char character : text) { set(y, x++, character, colorPair); }
+
+    return x;
+}
+
+void CellGrid::diff(CellGrid& screen, std::vector<CellRun>& runs)
+{
+    runs.clear();
+
+    for (int y = 0; y < m_rows; y++)
+    {
+        if (!m_dirtyRows[y]) { continue; }
+
+        m_dirtyRows[y] = false;
+
+        const Cell* row = &m_cells[static_cast<size_t>(y) * m_cols];
+        Cell* screenRow = &screen.m_cells[static_cast<size_t>(y) * m_cols];
+
+        int x = 0;
+
+        while (x < m_cols)
+        {
+            if (row[x] == screenRow[x])
+            {
+                x++;
+                continue;
+            }
+
+            // The run goes on over changed cells and gaps too short to be worth a cursor move
+            int start = x;
+            int end = x + 1;
+            int gap = 0;
+
+            for (x = end; x < m_cols && gap <= CELL_RUN_MERGE_GAP; x++)
+            {
+                if (row[x] != screenRow[x])
+                {
+                    end = x + 1;
+                    gap = 0;
+                }
+                else { gap++; }
+            }
+
+            std::copy(row + start, row + end, screenRow + start);
+            runs.push_back(CellRun{ y, start, end - start });
+
+            x = end;
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Includes.h"
+
+// Cells between changed runs closer than this are sent along with them, as moving the terminal cursor over them costs
+// more bytes than the cells do
+const int CELL_RUN_MERGE_GAP = 4;
+
+struct Cell
+{
+    char character = ' ';
+    bool bold = false;
+    short colorPair = BACKGROUND;
+
+    bool operator==(const Cell& other) const { return character == other.character && bold == other.bold && colorPair == other.colorPair; }
+    bool operator!=(const Cell& other) const { return !(*this == other); }
+};
+
+// Cells of one row that changed, to be sent to the terminal in one go
+struct CellRun
+{
+    int row;
+    int column;
+    int length;
+};
+
+// A frame of the screen as characters and their colors, built up away from the terminal so it can be compared with what
+// the terminal shows and only the cells that changed are sent. Rows are marked when they are written to, and only those
+// are compared.
+class CellGrid
+{
+
+private:
+
+    int m_rows = 0;
+    int m_cols = 0;
+
+    std::vector<Cell> m_cells;
+    std::vector<bool> m_dirtyRows;
+
+    bool contains(int y, int x) const { return y >= 0 && y < m_rows && x >= 0 && x < m_cols; }
+
+public:
+
+    // Blank cells of the given size, every row marked
+    void resize(int rows, int cols);
+
+    // Fills every cell with one no frame draws, so the next comparison against this grid finds every cell changed
+    void invalidate();
+
+    // Writes outside the grid are ignored
+    void set(int y, int x, char character, short colorPair, bool bold = false);
+    void fill(int y, int x, int count, char character, short colorPair);
+
+    // Writes text from x on and returns the column after it
+    int print(int y, int x, std::string_view text, short colorPair);
+
+    // Runs of cells that differ from screen on the rows written to since the last call, in screen order. The runs are
+    // copied into screen, which has to be of the same size, so it matches this grid afterwards.
+    void diff(CellGrid& screen, std::vector<CellRun>& runs);
+
+    // Getters
+    int rows() const { return m_rows; }
+    int cols() const { return m_cols; }
+    const Cell& at(int y, int x) const { return m_cells[static_cast<size_t>(y) * m_cols + x]; }
+
+};
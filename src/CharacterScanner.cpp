@@ -0,0 +1,250 @@
+#include "CharacterScanner.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define RAZZ_X86_SCANNER
+#endif
+
+CharacterScanner::ScanFunction CharacterScanner::findFirstFunction = CharacterScanner::findFirstScalar;
+CharacterScanner::ScanFunction CharacterScanner::findLastFunction = CharacterScanner::findLastScalar;
+SCANNER_IMPLEMENTATION CharacterScanner::currentImplementation = SCALAR_SCANNER;
+
+// Switches to the widest implementation before main runs
+static const bool scannerSelected = (CharacterScanner::use(CharacterScanner::supports(AVX2_SCANNER) ? AVX2_SCANNER : (CharacterScanner::supports(SSE2_SCANNER) ? SSE2_SCANNER : SCALAR_SCANNER)), true);
+
+int CharacterScanner::characterClass(char character)
+{
+    if ((character >= 'A' && character <= 'Z') || (character >= 'a' && character <= 'z') || (character == '_') || (character >= '0' && character <= '9')) { return WORD_CHARACTER; }
+    else if (character == ' ') { return SPACE_CHARACTER; }
+    else { return PUNCTUATION_CHARACTER; }
+}
+
+bool CharacterScanner::supports(SCANNER_IMPLEMENTATION implementation)
+{
+#ifdef RAZZ_X86_SCANNER
+    __builtin_cpu_init();
+
+    switch (implementation)
+    {
+        case SCALAR_SCANNER:
+            return true;
+        case SSE2_SCANNER:
+            return __builtin_cpu_supports("sse2");
+        case AVX2_SCANNER:
+            return __builtin_cpu_supports("avx2");
+    }
+
+    return false;
+#else
+    return implementation == SCALAR_SCANNER;
+#endif
+}
+
+void CharacterScanner::use(SCANNER_IMPLEMENTATION implementation)
+{
+    if (!supports(implementation)) { implementation = SCALAR_SCANNER; }
+
+    switch (implementation)
+    {
+        case SSE2_SCANNER:
+            findFirstFunction = findFirstSSE2;
+            findLastFunction = findLastSSE2;
+            break;
+        case AVX2_SCANNER:
+            findFirstFunction = findFirstAVX2;
+            findLastFunction = findLastAVX2;
+            break;
+        default:
+            findFirstFunction = findFirstScalar;
+            findLastFunction = findLastScalar;
+            break;
+    }
+
+    currentImplementation = implementation;
+}
+
+size_t CharacterScanner::findNext(std::string_view text, size_t from, int classes)
+{
+    if (from >= text.size()) { return std::string_view::npos; }
+
+    size_t index = findFirstFunction(text.data() + from, text.size() - from, classes);
+
+    return (index == std::string_view::npos) ? index : from + index;
+}
+
+size_t CharacterScanner::findNext(const LineGapBuffer& line, size_t from, int classes)
+{
+    std::string_view preGap = line.preGapSpan();
+
+    if (from < preGap.size())
+    {
+        size_t index = findNext(preGap, from, classes);
+
+        if (index != std::string_view::npos) { return index; }
+
+        from = preGap.size();
+    }
+
+    size_t index = findNext(line.postGapSpan(), from - preGap.size(), classes);
+
+    return (index == std::string_view::npos) ? index : preGap.size() + index;
+}
+
+size_t CharacterScanner::findPrevious(std::string_view text, size_t from, int classes)
+{
+    if (text.empty()) { return std::string_view::npos; }
+
+    return findLastFunction(text.data(), std::min(from, text.size() - 1) + 1, classes);
+}
+
+size_t CharacterScanner::findPrevious(const LineGapBuffer& line, size_t from, int classes)
+{
+    std::string_view preGap = line.preGapSpan();
+
+    if (from >= preGap.size())
+    {
+        size_t index = findPrevious(line.postGapSpan(), from - preGap.size(), classes);
+
+        if (index != std::string_view::npos) { return preGap.size() + index; }
+        if (preGap.empty()) { return std::string_view::npos; }
+
+        from = preGap.size() - 1;
+    }
+
+    return findPrevious(preGap, from, classes);
+}
+
+size_t CharacterScanner::findFirstScalar(const char* text, size_t size, int classes)
+{
+    for (size_t index = 0; index < size; index++)
+    {
+        if (characterClass(text[index]) & classes) { return index; }
+    }
+
+    return std::string_view::npos;
+}
+
+size_t CharacterScanner::findLastScalar(const char* text, size_t size, int classes)
+{
+    for (size_t index = size; index > 0; index--)
+    {
+        if (characterClass(text[index - 1]) & classes) { return index - 1; }
+    }
+
+    return std::string_view::npos;
+}
+
+#ifdef RAZZ_X86_SCANNER
+
+// One bit per character of the 16 at text, set for the characters in one of the classes. Letters are matched case
+// insensitively by setting bit 5, which only maps A-Z onto a-z. Bytes above 0x7f compare as negative and land in punctuation.
+__attribute__((target("sse2")))
+static inline uint32_t classMaskSSE2(const char* text, int classes)
+{
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text));
+    __m128i folded = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+
+    __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(folded, _mm_set1_epi8('a' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), folded));
+    __m128i digits = _mm_and_si128(_mm_cmpgt_epi8(chunk, _mm_set1_epi8('0' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), chunk));
+    __m128i underscores = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('_'));
+
+    uint32_t words = _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(letters, digits), underscores));
+    uint32_t spaces = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')));
+    uint32_t matches = 0;
+
+    if (classes & WORD_CHARACTER) { matches |= words; }
+    if (classes & SPACE_CHARACTER) { matches |= spaces; }
+    if (classes & PUNCTUATION_CHARACTER) { matches |= ~(words | spaces) & 0xFFFF; }
+
+    return matches;
+}
+
+__attribute__((target("avx2")))
+static inline uint32_t classMaskAVX2(const char* text, int classes)
+{
+    __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text));
+    __m256i folded = _mm256_or_si256(chunk, _mm256_set1_epi8(0x20));
+
+    __m256i letters = _mm256_and_si256(_mm256_cmpgt_epi8(folded, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), folded));
+    __m256i digits = _mm256_and_si256(_mm256_cmpgt_epi8(chunk, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), chunk));
+    __m256i underscores = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('_'));
+
+    uint32_t words = _mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(letters, digits), underscores));
+    uint32_t spaces = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')));
+    uint32_t matches = 0;
+
+    if (classes & WORD_CHARACTER) { matches |= words; }
+    if (classes & SPACE_CHARACTER) { matches |= spaces; }
+    if (classes & PUNCTUATION_CHARACTER) { matches |= ~(words | spaces); }
+
+    return matches;
+}
+
+__attribute__((target("sse2")))
+size_t CharacterScanner::findFirstSSE2(const char* text, size_t size, int classes)
+{
+    size_t index = 0;
+
+    for (; index + 16 <= size; index += 16)
+    {
+        uint32_t matches = classMaskSSE2(text + index, classes);
+
+        if (matches) { return index + __builtin_ctz(matches); }
+    }
+
+    size_t tailIndex = findFirstScalar(text + index, size - index, classes);
+
+    return (tailIndex == std::string_view::npos) ? tailIndex : index + tailIndex;
+}
+
+__attribute__((target("sse2")))
+size_t CharacterScanner::findLastSSE2(const char* text, size_t size, int classes)
+{
+    for (; size >= 16; size -= 16)
+    {
+        uint32_t matches = classMaskSSE2(text + size - 16, classes);
+
+        if (matches) { return size - 16 + (31 - __builtin_clz(matches)); }
+    }
+
+    return findLastScalar(text, size, classes);
+}
+
+__attribute__((target("avx2")))
+size_t CharacterScanner::findFirstAVX2(const char* text, size_t size, int classes)
+{
+    size_t index = 0;
+
+    for (; index + 32 <= size; index += 32)
+    {
+        uint32_t matches = classMaskAVX2(text + index, classes);
+
+        if (matches) { return index + __builtin_ctz(matches); }
+    }
+
+    size_t tailIndex = findFirstSSE2(text + index, size - index, classes);
+
+    return (tailIndex == std::string_view::npos) ? tailIndex : index + tailIndex;
+}
+
+__attribute__((target("avx2")))
+size_t CharacterScanner::findLastAVX2(const char* text, size_t size, int classes)
+{
+    for (; size >= 32; size -= 32)
+    {
+        uint32_t matches = classMaskAVX2(text + size - 32, classes);
+
+        if (matches) { return size - 32 + (31 - __builtin_clz(matches)); }
+    }
+
+    return findLastSSE2(text, size, classes);
+}
+
+#else
+
+size_t CharacterScanner::findFirstSSE2(const char* text, size_t size, int classes) { return findFirstScalar(text, size, classes); }
+size_t CharacterScanner::findLastSSE2(const char* text, size_t size, int classes) { return findLastScalar(text, size, classes); }
+size_t CharacterScanner::findFirstAVX2(const char* text, size_t size, int classes) { return findFirstScalar(text, size, classes); }
+size_t CharacterScanner::findLastAVX2(const char* text, size_t size, int classes) { return findLastScalar(text, size, classes); }
+
+#endif
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Includes.h"
+#include "LineGapBuffer.h"
+
+// Every character falls in exactly one of these, so they can be or'd together into the set of classes a scan stops at
+enum CHARACTER_CLASS
+{
+    WORD_CHARACTER = 1,
+    SPACE_CHARACTER = 2,
+    PUNCTUATION_CHARACTER = 4,
+};
+
+const int SYMBOLIC_CHARACTER = SPACE_CHARACTER | PUNCTUATION_CHARACTER;
+
+enum SCANNER_IMPLEMENTATION
+{
+    SCALAR_SCANNER,
+    SSE2_SCANNER,
+    AVX2_SCANNER,
+};
+
+// Finds the next or previous character belonging to a set of classes, a vector of characters at a time where the CPU allows it.
+// The widest implementation the CPU supports is picked at startup.
+class CharacterScanner
+{
+
+private:
+
+    // Index of the first or last character of text[0, size) in one of the classes, or std::string_view::npos
+    typedef size_t (*ScanFunction)(const char* text, size_t size, int classes);
+
+    static ScanFunction findFirstFunction;
+    static ScanFunction findLastFunction;
+    static SCANNER_IMPLEMENTATION currentImplementation;
+
+    static size_t findFirstScalar(const char* text, size_t size, int classes);
+    static size_t findLastScalar(const char* text, size_t size, int classes);
+    static size_t findFirstSSE2(const char* text, size_t size, int classes);
+    static size_t findLastSSE2(const char* text, size_t size, int classes);
+    static size_t findFirstAVX2(const char* text, size_t size, int classes);
+    static size_t findLastAVX2(const char* text, size_t size, int classes);
+
+public:
+
+    // Word characters are letters, digits and underscores, everything else other than a space is punctuation
+    static int characterClass(char character);
+
+    static bool supports(SCANNER_IMPLEMENTATION implementation);
+    static void use(SCANNER_IMPLEMENTATION implementation);
+
+    // Index of the first character at or after from in one of the classes, or std::string_view::npos
+    static size_t findNext(std::string_view text, size_t from, int classes);
+    static size_t findNext(const LineGapBuffer& line, size_t from, int classes);
+
+    // Index of the last character at or before from in one of the classes, or std::string_view::npos
+    static size_t findPrevious(std::string_view text, size_t from, int classes);
+    static size_t findPrevious(const LineGapBuffer& line, size_t from, int classes);
+
+    // Getters
+    static SCANNER_IMPLEMENTATION implementation() { return currentImplementation; }
+
+};
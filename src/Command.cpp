@@ -106,10 +106,7 @@ void Command::removeCharactersInRange(int start, int end, int cursorY) const
 
     m_buffer->moveCursor(cursorY, start);
 
-    for (int i = 0; i < end - start; i++)
-    {
-        m_buffer->removeCharacter(false);
-    }
+    m_buffer->removeCharacters(end - start);
 }
 
 void Command::removeCharactersInRangeAndInsertIntoVector(std::vector<char>& vec, int start, int end, int cursorY) const
@@ -121,10 +118,7 @@ void Command::removeCharactersInRangeAndInsertIntoVector(std::vector<char>& vec,
 
     m_buffer->moveCursor(cursorY, start);
 
-    for (int i = 0; i < end - start; i++)
-    {
-        vec.push_back(m_buffer->removeCharacter(false));
-    }
+    m_buffer->removeCharacters(end - start, &vec);
 }
 
 void Command::insertCharactersInRangeFromVector(const std::vector<char>& vec, int start, int end, int cursorY) const
@@ -134,10 +128,7 @@ void Command::insertCharactersInRangeFromVector(const std::vector<char>& vec, in
 
     m_buffer->moveCursor(cursorY, start);
 
-    for (int i = 0; i < end - start; i++)
-    {
-        m_buffer->insertCharacter(vec[i]);
-    }
+    m_buffer->insertCharacters(std::string_view(vec.data(), std::min(static_cast<size_t>(end - start), vec.size())));
 }
 
 int Command::getXCoordinateFromJumpCode(int jumpCode) const
@@ -175,8 +166,6 @@ int Command::getXCoordinateFromJumpCode(int jumpCode) const
     }
 }
 
-void SetModeCommand::redo() {}
-void SetModeCommand::undo() {}
 bool SetModeCommand::execute()
 {
     m_editor->setMode(m_mode);
@@ -202,8 +191,6 @@ bool SetModeCommand::execute()
     return false;
 }
 
-void MoveCursorXCommand::redo() {}
-void MoveCursorXCommand::undo() {}
 bool MoveCursorXCommand::execute()
 {
     int prevCursorX = m_buffer->getCursorPos().second;
@@ -215,39 +202,13 @@ bool MoveCursorXCommand::execute()
     return false;
 }
 
-void MoveCursorYCommand::redo()
-{
-    m_buffer->moveCursor(m_cursorPos.first, 0);
-
-    for (int i = 0; i < m_numberOfDeletedSpaces; i++)
-    {
-        m_buffer->removeCharacter(false);
-    }
-
-    m_buffer->moveCursor(m_cursorPos.first, m_cursorPos.second);
-
-    if (m_renderExecute) { m_editor->view().display(); }
-}
-void MoveCursorYCommand::undo()
-{
-    m_buffer->moveCursor(m_cursorPos.first, 0);
-
-    for (int i = 0; i < m_numberOfDeletedSpaces; i++)
-    {
-        m_buffer->insertCharacter(' ');
-    }
-
-    m_buffer->moveCursor(m_cursorPos.first, m_cursorPos.second);
-
-    if (m_renderUndo) { m_editor->view().display(); }
-}
 bool MoveCursorYCommand::execute()
 {
     m_cursorPos = m_buffer->getCursorPos();
     const std::shared_ptr<LineGapBuffer>& lineGapBuffer = m_buffer->getLineGapBuffer(m_cursorPos.first);
     int lineSize = static_cast<int>(lineGapBuffer->lineSize());
 
-    int numberOfLines = static_cast<int>(m_buffer->getFileGapBuffer().numberOfLines());
+    int numberOfLines = static_cast<int>(m_buffer->getFile().numberOfLines());
 
     if (numberOfLines == 0 || m_cursorPos.first + m_deltaY >= numberOfLines || m_cursorPos.first + m_deltaY < 0)
     {
@@ -293,24 +254,18 @@ bool MoveCursorYCommand::execute()
     }
 }
 
-void UndoCommand::redo() {}
-void UndoCommand::undo() { }
 bool UndoCommand::execute()
 {
     m_commandQueue->undo();
     return false;
 }
 
-void RedoCommand::redo() {}
-void RedoCommand::undo() { }
 bool RedoCommand::execute()
 {
     m_commandQueue->redo();
     return false;
 }
 
-void CursorFullRightCommand::redo() {}
-void CursorFullRightCommand::undo() { }
 bool CursorFullRightCommand::execute()
 {
     int prevCursorX = m_buffer->getCursorPos().second;
@@ -322,8 +277,6 @@ bool CursorFullRightCommand::execute()
     return false;
 }
 
-void CursorFullLeftCommand::redo() {}
-void CursorFullLeftCommand::undo() { }
 bool CursorFullLeftCommand::execute()
 {
     int prevCursorX = m_buffer->getCursorPos().second;
@@ -335,8 +288,6 @@ bool CursorFullLeftCommand::execute()
     return false;
 }
 
-void CursorFullTopCommand::redo() {}
-void CursorFullTopCommand::undo() { }
 bool CursorFullTopCommand::execute()
 {
     int prevCursorY = m_buffer->getCursorPos().first;
@@ -348,8 +299,6 @@ bool CursorFullTopCommand::execute()
     return false;
 }
 
-void CursorFullBottomCommand::redo() {}
-void CursorFullBottomCommand::undo() { }
 bool CursorFullBottomCommand::execute()
 {
     int prevCursorY = m_buffer->getCursorPos().first;
@@ -361,22 +310,6 @@ bool CursorFullBottomCommand::execute()
     return false;
 }
 
-void InsertCharacterCommand::redo()
-{
-    m_buffer->moveCursor(m_y, m_x - 1);
-    m_buffer->insertCharacter(m_character);
-    m_buffer->shiftCursorX(-1);
-
-    if (m_renderExecute) { m_view->display(); }
-}
-void InsertCharacterCommand::undo()
-{
-    m_buffer->moveCursor(m_y, m_x);
-    m_buffer->removeCharacter();
-    m_buffer->shiftCursorX(-1);
-
-    if (m_renderUndo) { m_view->display(); }
-}
 bool InsertCharacterCommand::execute()
 {
     m_buffer->insertCharacter(m_character);
@@ -389,38 +322,6 @@ bool InsertCharacterCommand::execute()
     return true;
 }
 
-void RemoveCharacterNormalCommand::redo()
-{
-    if (m_cursorLeft)
-    {
-        m_buffer->moveCursor(m_y, m_x);
-    }
-    else
-    {
-        m_buffer->moveCursor(m_y, m_x);
-    }
-
-    m_buffer->removeCharacter(m_cursorLeft);
-
-    if (m_renderExecute) { m_view->display(); }
-}
-void RemoveCharacterNormalCommand::undo()
-{
-    if (m_cursorLeft)
-    {
-        m_buffer->moveCursor(m_y, m_x - 1);
-        m_buffer->insertCharacter(m_character);
-    }
-    else
-    {
-        m_buffer->moveCursor(m_y, m_x);
-        m_buffer->insertCharacter(m_character);
-
-        m_buffer->shiftCursorX(-1);
-    }
-
-    if (m_renderUndo) { m_view->display(); }
-}
 bool RemoveCharacterNormalCommand::execute()
 {
     const std::pair<int, int>& cursorPos = m_buffer->getCursorPos();
@@ -438,94 +339,6 @@ bool RemoveCharacterNormalCommand::execute()
     return true;
 }
 
-void RemoveCharacterInsertCommand::redo()
-{
-    if (m_x == 0)
-    {
-        m_buffer->moveCursor(m_y, m_x);
-
-        m_buffer->removeLine();
-
-        m_buffer->moveCursor(m_y - 1, m_buffer->getLineGapBuffer(m_y - 1)->lineSize());
-
-        size_t lineSize = m_line->lineSize();
-        for (size_t column = 0; column < lineSize; column++)
-        { 
-            m_buffer->insertCharacter(m_line->at(column));
-        }
-
-        if (lineSize > 0)
-        {
-            m_buffer->shiftCursorX(- lineSize);
-        }
-
-        if (m_renderExecute) { m_view->display(); }
-    }
-    else
-    {
-        m_buffer->moveCursor(m_y, m_x);
-
-        m_buffer->removeCharacter(true);
-
-        if (m_character == ' ')
-        {
-            for (int i = 1; i < m_deletedWhitespaces; i++)
-            {
-                m_buffer->removeCharacter(true);
-            }
-        }
-        else if (m_autoDeletedPair)
-        {
-            m_buffer->removeCharacter(false);
-            m_buffer->moveCursor(m_y, m_x - 1);
-            m_buffer->shiftCursorX(0);
-        }
-
-        if (m_renderExecute) { m_view->display(); }
-    }
-}
-void RemoveCharacterInsertCommand::undo()
-{
-    if (m_x == 0)
-    {
-        m_buffer->moveCursor(m_y - 1, m_buffer->getLineGapBuffer(m_y - 1)->lineSize() - 1);
-
-        int lineLength = static_cast<int>(m_line->lineSize());
-
-        for (int x = 0; x < lineLength; x++)
-        {
-            m_buffer->removeCharacter(false);
-        }
-
-        m_buffer->insertLine(m_line, true);
-
-        m_buffer->moveCursor(m_y, 0);
-
-        if (m_renderUndo) { m_view->display(); }
-    }
-    else
-    {
-        for (int i = 0; i < m_deletedWhitespaces; i++)
-        {
-            m_buffer->moveCursor(m_y, m_x - m_deletedWhitespaces);
-            m_buffer->insertCharacter(' ');
-        }
-
-        if (m_deletedWhitespaces > 0)
-        {
-            m_buffer->moveCursor(m_y, m_x);
-        }
-        else
-        {
-            m_buffer->moveCursor(m_y, m_x - 1);
-        }
-
-        if (!m_deletedWhitespaces) { m_buffer->insertCharacter(m_character); m_buffer->shiftCursorX(0); }
-        if (m_autoDeletedPair) { m_buffer->insertCharacter(leftPairToRightPair(m_character)); m_buffer->moveCursor(m_y, m_x); }
-
-        if (m_renderUndo) { m_view->display(); }
-    }
-}
 bool RemoveCharacterInsertCommand::execute()
 {
     const std::pair<int, int>& cursorPos = m_buffer->getCursorPos();
@@ -541,10 +354,7 @@ bool RemoveCharacterInsertCommand::execute()
         m_buffer->moveCursor(m_y - 1, m_buffer->getLineGapBuffer(m_y - 1)->lineSize());
 
         size_t lineSize = m_line->lineSize();
-        for (size_t column = 0; column < lineSize; column++)
-        { 
-            m_buffer->insertCharacter(m_line->at(column));
-        }
+        m_buffer->insertCharacters(*m_line, 0, lineSize);
 
         if (lineSize > 0)
         {
@@ -563,8 +373,6 @@ bool RemoveCharacterInsertCommand::execute()
         // Auto delete spaces
         if (m_character == ' ')
         {
-            m_deletedWhitespaces++;
-
             for (int i = 1; i < WHITESPACE_PER_TAB; i++)
             {
                 int index = m_x - i - 1;
@@ -576,7 +384,6 @@ bool RemoveCharacterInsertCommand::execute()
 
                 if (lineGapBuffer->at(index) == ' ')
                 {
-                    m_deletedWhitespaces++;
                     m_character = m_buffer->removeCharacter(true);
                 }
                 else { break; }
@@ -593,8 +400,6 @@ bool RemoveCharacterInsertCommand::execute()
 
                 if (isMatchingPair(m_character, nextChar))
                 {
-                    m_autoDeletedPair = true;
-
                     m_buffer->removeCharacter(false);
 
                     m_buffer->moveCursor(m_y, m_x - 1);
@@ -608,18 +413,6 @@ bool RemoveCharacterInsertCommand::execute()
     return true;
 }
 
-void ReplaceCharacterCommand::redo()
-{
-    m_buffer->moveCursor(m_y, m_x);
-    m_buffer->replaceCharacter(m_character);
-    if (m_renderExecute) { m_view->display(); }
-}
-void ReplaceCharacterCommand::undo()
-{
-    m_buffer->moveCursor(m_y, m_x);
-    m_buffer->replaceCharacter(m_replacedCharacter);
-    if (m_renderUndo) { m_view->display(); }
-}
 bool ReplaceCharacterCommand::execute()
 {
     const std::pair<int, int>& cursorPos = m_buffer->getCursorPos();
@@ -642,51 +435,6 @@ bool ReplaceCharacterCommand::execute()
     return true;
 }
 
-void InsertLineNormalCommand::redo()
-{
-    m_buffer->moveCursor(m_y, 0);
-
-    for (int i = 0; i < m_deletedSpaces; i++)
-    {
-        m_buffer->removeCharacter(false);
-    }
-
-    m_buffer->moveCursor(m_y, m_x);
-
-    m_buffer->insertLine(m_down);
-
-    if (m_down)
-    {
-        for (int i = 0; i < m_buffer->getXPositionOfFirstCharacter(m_y); i++)
-        {
-            m_buffer->insertCharacter(' ');
-        }
-    }
-    else
-    {
-        for (int i = 0; i < m_buffer->getXPositionOfFirstCharacter(m_y + 1); i++)
-        {
-            m_buffer->insertCharacter(' ');
-        }
-    }
-
-    if (m_renderExecute) { m_view->display(); }
-}
-void InsertLineNormalCommand::undo()
-{
-    m_buffer->moveCursor(m_y + 1 * !m_down, 0);
-    for (int i = 0; i < m_deletedSpaces; i++)
-    {
-        m_buffer->insertCharacter(' ');
-    }
-
-    m_buffer->moveCursor(m_y + 1 * m_down, m_x);
-    m_buffer->removeLine();
-
-    m_buffer->moveCursor(m_y, m_x);
-
-    if (m_renderUndo) { m_view->display(); }
-}
 bool InsertLineNormalCommand::execute()
 {
     const std::pair<int, int>& cursorPos = m_buffer->getCursorPos();
@@ -713,7 +461,6 @@ bool InsertLineNormalCommand::execute()
             m_buffer->moveCursor(m_y, 0);
             for (int i = 0; i < lineSize; i++)
             {
-                m_deletedSpaces++;
                 m_buffer->removeCharacter(false);
             }
         }
@@ -744,79 +491,6 @@ bool InsertLineNormalCommand::execute()
     return true;
 }
 
-void InsertLineInsertCommand::redo()
-{
-    removeCharactersInRange(0, m_deletedSpaces, m_y);
-
-    removeCharactersInRange(m_x, m_x + m_distanceToEndLine, m_y);
-
-    if (m_insidePair)
-    {
-        m_buffer->insertLine(true);
-
-        for (int i = 0; i < m_xPositionOfFirstCharacter + WHITESPACE_PER_TAB; i++)
-        {
-            m_buffer->insertCharacter(' ');
-        }
-
-        m_buffer->insertLine(true);
-
-        for (int i = 0; i < m_xPositionOfFirstCharacter; i++)
-        {
-            m_buffer->insertCharacter(' ');
-        }
-
-        insertCharactersInRangeFromVector(m_characters, m_xPositionOfFirstCharacter, m_xPositionOfFirstCharacter + m_distanceToEndLine, m_y + 2);
-
-        m_buffer->moveCursor(m_y + 1, m_xPositionOfFirstCharacter + WHITESPACE_PER_TAB);
-    }
-    else
-    {
-        m_buffer->insertLine(true);
-
-        for (int i = 0; i < m_xPositionOfFirstCharacter; i++)
-        {
-            m_buffer->insertCharacter(' ');
-        }
-
-        insertCharactersInRangeFromVector(m_characters, m_xPositionOfFirstCharacter, m_xPositionOfFirstCharacter + m_distanceToEndLine, m_y + 1);
-
-        if (m_deletedSpaces)
-        {
-            m_buffer->moveCursor(m_y + 1, m_x - 1);
-        }
-        else
-        {
-            m_buffer->shiftCursorFullLeft();
-        }
-    }
-
-    if (m_renderExecute) { m_view->display(); }
-}
-void InsertLineInsertCommand::undo()
-{
-    m_buffer->moveCursor(m_y + 1, 0);
-
-    m_buffer->removeLine();
-    if (m_insidePair) { m_buffer->removeLine(); }
-
-    m_buffer->moveCursor(m_y, m_x);
-
-    for (int i = 0; i < m_deletedSpaces; i++)
-    {
-        m_buffer->insertCharacter(' ');
-    }
-
-    for (size_t i = 0; i < m_characters.size(); i++)
-    {
-        m_buffer->insertCharacter(m_characters[i]);
-    }
-
-    m_buffer->moveCursor(m_y, m_x);
-    m_buffer->shiftCursorX(0);
-
-    if (m_renderUndo) { m_view->display(); }
-}
 bool InsertLineInsertCommand::execute()
 {
     const std::pair<int, int>& cursorPos = m_buffer->getCursorPos();
@@ -826,8 +500,6 @@ bool InsertLineInsertCommand::execute()
 
     m_xPositionOfFirstCharacter = m_buffer->getXPositionOfFirstCharacter(m_y);
 
-    m_distanceToEndLine = m_buffer->getLineGapBuffer(m_y)->lineSize() - m_x;
-
     m_buffer->moveCursor(m_y, m_x);
 
     const std::shared_ptr<LineGapBuffer>& lineGapBuffer = m_buffer->getLineGapBuffer(m_y);
@@ -854,7 +526,6 @@ bool InsertLineInsertCommand::execute()
             m_buffer->moveCursor(m_y, 0);
             for (int i = 0; i < lineSize; i++)
             {
-                m_deletedSpaces++;
                 m_buffer->removeCharacter(false);
             }
         }
@@ -901,42 +572,13 @@ bool InsertLineInsertCommand::execute()
     return true;
 }
 
-void RemoveLineCommand::redo()
-{
-    m_buffer->moveCursor(m_y, m_x);
-
-    m_line = m_buffer->removeLine();
-
-    m_buffer->shiftCursorX(0);
-
-    if (m_renderExecute) { m_view->display(); }
-}
-void RemoveLineCommand::undo()
-{
-    int targetY;
-    if (m_y == 0) { targetY = 0; }
-    else { targetY = m_y; }
-    m_buffer->moveCursor(targetY, m_x);
-
-    m_buffer->insertLine(m_line, false);
-
-    m_buffer->moveCursor(m_y + 1, m_x);
-
-    if (m_deletedOnlyLine == true) { m_buffer->removeLine(); }
-
-    m_buffer->moveCursor(m_y, m_x);
-    m_buffer->shiftCursorX(0);
-
-    if (m_renderUndo) { m_view->display(); }
-}
 bool RemoveLineCommand::execute()
 {
     const std::pair<int, int>& cursorPos = m_buffer->getCursorPos();
     m_x = cursorPos.second;
     m_y = cursorPos.first;
 
-    if (m_buffer->getFileGapBuffer().numberOfLines() == 1 && m_buffer->getLineGapBuffer(m_y)->lineSize() == 0) { m_view->display(); return false; }
-    else if (m_buffer->getFileGapBuffer().numberOfLines() == 1) { m_deletedOnlyLine = true; }
+    if (m_buffer->getFile().numberOfLines() == 1 && m_buffer->getLineGapBuffer(m_y)->lineSize() == 0) { m_view->display(); return false; }
 
     m_line = m_buffer->removeLine();
 
@@ -951,33 +593,6 @@ bool RemoveLineCommand::execute()
     return true;
 }
 
-void RemoveLineToInsertCommand::redo()
-{
-    const std::shared_ptr<LineGapBuffer>& line = m_buffer->getLineGapBuffer(m_y);
-
-    removeCharactersInRange(m_indexOfFirstNonSpaceCharacter, static_cast<int>(line->lineSize()), m_y);
-
-    m_buffer->moveCursor(m_y, m_indexOfFirstNonSpaceCharacter);
-    m_buffer->shiftCursorX(0);
-
-    if (m_renderExecute) { m_view->display(); }
-}
-void RemoveLineToInsertCommand::undo()
-{
-    m_buffer->moveCursor(m_y, 0);
-
-    // Add back all spaces in beginning, if no spaces were removed, these get overwritten in the next function
-    for (int i = 0; i < m_indexOfFirstNonSpaceCharacter; i++)
-    {
-        m_buffer->insertCharacter(' ');
-    }
-
-    insertCharactersInRangeFromVector(m_characters, m_indexOfFirstNonSpaceCharacter, m_indexOfFirstNonSpaceCharacter + m_characters.size(), m_y);
-
-    m_buffer->moveCursor(m_y, m_indexOfFirstNonSpaceCharacter);
-
-    if (m_renderUndo) { m_view->display(); }
-}
 bool RemoveLineToInsertCommand::execute()
 {
     const std::pair<int, int>& cursorPos = m_buffer->getCursorPos();
@@ -1007,18 +622,6 @@ bool RemoveLineToInsertCommand::execute()
     return true;
 }
 
-void TabCommand::redo()
-{
-    m_buffer->moveCursor(m_y, m_x);
-    for (int i = 0; i < WHITESPACE_PER_TAB; i++) { m_buffer->insertCharacter(' '); }
-    if (m_renderExecute) { m_view->display(); }
-}
-void TabCommand::undo()
-{
-    m_buffer->moveCursor(m_y, m_x);
-    for (int i = 0; i < WHITESPACE_PER_TAB; i++) { m_buffer->removeCharacter(false); }
-    if (m_renderUndo) { m_view->display(); }
-}
 bool TabCommand::execute()
 {
     const std::pair<int, int>& cursorPos = m_buffer->getCursorPos();
@@ -1032,8 +635,6 @@ bool TabCommand::execute()
     return true;
 }
 
-void FindCharacterCommand::redo() {}
-void FindCharacterCommand::undo() {}
 bool FindCharacterCommand::execute()
 {
     const std::pair<int, int>& cursorPos = m_buffer->getCursorPos();
@@ -1049,8 +650,6 @@ bool FindCharacterCommand::execute()
     return false;
 }
 
-void JumpCursorCommand::redo() {}
-void JumpCursorCommand::undo() {}
 bool JumpCursorCommand::execute()
 {
     const std::pair<int, int>& cursorPos = m_buffer->getCursorPos();
@@ -1067,25 +666,7 @@ bool JumpCursorCommand::execute()
     return false;
 }
 
-void JumpCursorDeleteWordCommand::redo()
-{
-    removeCharactersInRange(m_startX, m_endX, m_y);
-
-    m_buffer->moveCursor(m_y, m_x);
-    m_editor->buffer().shiftCursorX(0);
-
-    if (m_renderExecute) { m_view->display(); }
-}
-void JumpCursorDeleteWordCommand::undo()
-{
-    insertCharactersInRangeFromVector(m_characters, m_startX, m_endX, m_y);
-
-    m_buffer->moveCursor(m_y, m_x);
-    m_buffer->shiftCursorX(0);
-
-    if (m_renderUndo) { m_view->display(); }
-}
-bool JumpCursorDeleteWordCommand::execute()
+bool JumpCursorDeleteWordCommand::execute()
 {
     const std::pair<int, int>& cursorPos = m_buffer->getCursorPos();
     m_x = cursorPos.second;
@@ -1126,23 +707,6 @@ bool JumpCursorDeleteWordCommand::execute()
     return true;
 }
 
-void JumpCursorDeletePreviousWordInsertModeCommand::redo()
-{
-    m_buffer->moveCursor(m_y, m_x);
-
-    removeCharactersInRange(m_targetX, m_x, m_y);
-
-    if (m_renderExecute) { m_view->display(); }
-}
-void JumpCursorDeletePreviousWordInsertModeCommand::undo()
-{
-    insertCharactersInRangeFromVector(m_characters, m_targetX, m_x, m_y);
-
-    m_buffer->moveCursor(m_y, m_x);
-    m_buffer->shiftCursorX(0);
-
-    if (m_renderUndo) { m_view->display(); }
-}
 bool JumpCursorDeletePreviousWordInsertModeCommand::execute()
 {
     const std::pair<int, int>& cursorPos = m_buffer->getCursorPos();
@@ -1168,46 +732,6 @@ bool JumpCursorDeletePreviousWordInsertModeCommand::execute()
     return true;
 }
 
-void RemoveLinesVisualLineModeCommand::redo()
-{
-    m_buffer->moveCursor(m_lowerBoundY, 0);
-
-    for (int i = 0; i <= m_upperBoundY - m_lowerBoundY; i++)
-    {
-        m_lines[i] = m_buffer->removeLine();
-    }
-
-    int finalX = std::min(m_initialX, static_cast<int>(m_buffer->getLineGapBuffer(std::min(m_lowerBoundY, static_cast<int>(m_buffer->getFileGapBuffer().numberOfLines()) - 1))->lineSize()) - 1);
-    m_buffer->moveCursor(m_lowerBoundY, finalX);
-
-    m_buffer->shiftCursorX(0);
-
-    if (m_renderExecute) { m_view->display(); }
-}
-void RemoveLinesVisualLineModeCommand::undo()
-{
-    int targetY = std::max(0, m_lowerBoundY - 1);
-    m_buffer->moveCursor(targetY, 0);
-
-    for (int i = 0; i <= m_upperBoundY - m_lowerBoundY; i++)
-    {
-        if (m_lowerBoundY == 0 && i == 0)
-        {
-            m_buffer->insertLine(m_lines[i], false);
-        }
-        else
-        {
-            m_buffer->insertLine(m_lines[i], true);
-        }
-    }
-
-    if (m_insertingOnEmptyFile) { m_buffer->moveCursor(m_upperBoundY + 1, m_initialX); m_buffer->removeLine(); }
-
-    m_buffer->moveCursor(m_initialY, m_initialX);
-    m_buffer->shiftCursorX(0);
-
-    if (m_renderUndo) { m_view->display(); }
-}
 bool RemoveLinesVisualLineModeCommand::execute()
 {
     const std::pair<int, int>& cursorPos = m_buffer->getCursorPos();
@@ -1215,27 +739,21 @@ bool RemoveLinesVisualLineModeCommand::execute()
     m_initialY = cursorPos.first;
     const std::pair<int, int>& previousVisualPos = m_editor->inputController().initialVisualModeCursor();
 
-    m_linesBeforeDeletion = m_editor->buffer().getFileGapBuffer().numberOfLines();
-
     m_lowerBoundY = std::min(cursorPos.first, previousVisualPos.first);
     m_upperBoundY = std::max(cursorPos.first, previousVisualPos.first);
 
     m_buffer->moveCursor(m_lowerBoundY, 0);
 
-    m_lines.reserve(m_upperBoundY - m_lowerBoundY);
-
     m_editor->clipBoard().lineUpdate();
 
-    for (int i = 0; i <= m_upperBoundY - m_lowerBoundY; i++)
-    {
-        m_lines.push_back(m_buffer->removeLine());
+    m_lines = m_buffer->removeLines(m_upperBoundY - m_lowerBoundY + 1);
 
-        m_editor->clipBoard().add(m_lines[i]);
+    for (const std::shared_ptr<LineGapBuffer>& line : m_lines)
+    {
+        m_editor->clipBoard().add(line);
     }
 
-    m_insertingOnEmptyFile = (static_cast<int>(m_linesBeforeDeletion) == m_upperBoundY - m_lowerBoundY + 1);
-
-    int finalX = std::min(m_initialX, static_cast<int>(m_buffer->getLineGapBuffer(std::min(m_lowerBoundY, static_cast<int>(m_buffer->getFileGapBuffer().numberOfLines()) - 1))->lineSize()) - 1);
+    int finalX = std::min(m_initialX, static_cast<int>(m_buffer->getLineGapBuffer(std::min(m_lowerBoundY, static_cast<int>(m_buffer->getFile().numberOfLines()) - 1))->lineSize()) - 1);
     m_buffer->moveCursor(m_lowerBoundY, finalX);
 
     m_editor->setMode(NORMAL_MODE);
@@ -1245,135 +763,6 @@ bool RemoveLinesVisualLineModeCommand::execute()
     return true;
 }
 
-void RemoveLinesVisualModeCommand::redo()
-{
-    m_buffer->moveCursor(m_lowerBoundY, 0);
-
-    for (int i = m_lowerBoundY; i <= m_upperBoundY; i++)
-    {
-        if (i == m_lowerBoundY)
-        {
-            if (m_removedFirstLine)
-            {
-                m_buffer->removeLine();
-            }
-            else
-            {
-                size_t lineSize = m_editor->buffer().getLineGapBuffer(m_lowerBoundY)->lineSize();
-
-                if (lineSize)
-                {
-                    if (m_lowerBoundY == m_upperBoundY)
-                    {
-                        removeCharactersInRange(m_lowerBoundX, m_upperBoundX + 1, m_lowerBoundY);
-                    }
-                    else if (m_lowerBoundY < m_cursorY)
-                    {
-                        removeCharactersInRange(m_previousVisualX, m_buffer->getLineGapBuffer(m_lowerBoundY)->lineSize(), m_lowerBoundY);
-                    }
-                    else
-                    {
-                        removeCharactersInRange(m_cursorX, m_buffer->getLineGapBuffer(m_lowerBoundY)->lineSize(), m_lowerBoundY);
-                    }
-                }
-            }
-        }
-        else
-        {
-            m_buffer->moveCursor(m_lowerBoundY + 1, 0);
-            m_intermediaryLines[i - m_lowerBoundY - 1] = m_buffer->removeLine();
-        }
-    }
-
-    // Append everything after the cursor on the last line to the first line
-    if (m_upperBoundY - m_lowerBoundY > 0)
-    {
-        const std::shared_ptr<LineGapBuffer>& lastLine = m_intermediaryLines[m_intermediaryLines.size() - 1];
-
-        if (m_lowerBoundY == m_cursorY)
-        {
-            m_buffer->moveCursor(m_lowerBoundY, m_cursorX);
-
-            for (size_t i = m_previousVisualX + 1; i < lastLine->lineSize(); i++)
-            {
-                m_buffer->insertCharacter(lastLine->at(i));
-            }
-        }
-        else
-        {
-            m_buffer->moveCursor(m_lowerBoundY, m_previousVisualX);
-
-            for (size_t i = m_cursorX + 1; i < lastLine->lineSize(); i++)
-            {
-                m_buffer->insertCharacter(lastLine->at(i));
-            }
-        }
-    }
-
-    m_buffer->moveCursor(m_lowerBoundY, m_upperBoundX);
-    m_buffer->shiftCursorX(0);
-
-    if (m_renderExecute) { m_view->display(); }
-}
-void RemoveLinesVisualModeCommand::undo()
-{
-    m_buffer->moveCursor(m_lowerBoundY, 0);
-
-    // Append everything after the cursor on the last line to the first line
-    if (!m_removedFirstLine && m_upperBoundY - m_lowerBoundY > 0)
-    {
-        const std::shared_ptr<LineGapBuffer>& firstLine = m_buffer->getLineGapBuffer(m_lowerBoundY);
-
-        if (firstLine->lineSize())
-        {
-            if (m_lowerBoundY == m_cursorY)
-            {
-                removeCharactersInRange(m_cursorX, static_cast<int>(firstLine->lineSize()), m_lowerBoundY);
-            }
-            else
-            {
-                removeCharactersInRange(m_previousVisualX, static_cast<int>(firstLine->lineSize()), m_lowerBoundY);
-            }
-        }
-    }
-
-    for (int i = m_upperBoundY; i >= m_lowerBoundY; i--)
-    {
-        if (i == m_lowerBoundY)
-        {
-            if (m_removedFirstLine)
-            {
-                m_buffer->insertLine(false);
-            }
-            else
-            {
-                if (m_lowerBoundY == m_upperBoundY)
-                {
-                    insertCharactersInRangeFromVector(m_lowerBoundCharacters, m_lowerBoundX, m_upperBoundX + 1, m_lowerBoundY);
-                }
-                else if (m_lowerBoundY < m_cursorY)
-                {
-                    insertCharactersInRangeFromVector(m_lowerBoundCharacters, m_previousVisualX, m_previousVisualX + static_cast<int>(m_lowerBoundCharacters.size()), m_lowerBoundY);
-                }
-                else
-                {
-                    insertCharactersInRangeFromVector(m_lowerBoundCharacters, m_cursorX, m_cursorX + static_cast<int>(m_lowerBoundCharacters.size()), m_lowerBoundY);
-                }
-            }
-        }
-        else
-        {
-            m_buffer->moveCursor(m_lowerBoundY, 0);
-            m_buffer->insertLine(m_intermediaryLines[i - m_lowerBoundY - 1], true);
-        }
-    }
-
-
-    m_buffer->moveCursor(m_lowerBoundY, m_upperBoundX);
-    m_buffer->shiftCursorX(0);
-
-    if (m_renderUndo) { m_view->display(); }
-}
 bool RemoveLinesVisualModeCommand::execute()
 {
     Clipboard& clipBoard = m_editor->clipBoard();
@@ -1416,12 +805,11 @@ bool RemoveLinesVisualModeCommand::execute()
             {
                 if (lineSize == 0)
                 {
-                    if (m_buffer->getFileGapBuffer().numberOfLines() == 1)
+                    if (m_buffer->getFile().numberOfLines() == 1)
                     {
                         return false;
                     }
 
-                    m_removedFirstLine = true;
                     m_buffer->removeLine();
                 }
                 else
@@ -1461,19 +849,13 @@ bool RemoveLinesVisualModeCommand::execute()
         {
             m_buffer->moveCursor(m_lowerBoundY, m_cursorX);
 
-            for (size_t i = m_previousVisualX + 1; i < lastLineSize; i++)
-            {
-                m_buffer->insertCharacter(lastLine->at(i));
-            }
+            if (m_previousVisualX + 1 < static_cast<int>(lastLineSize)) { m_buffer->insertCharacters(*lastLine, m_previousVisualX + 1, lastLineSize - m_previousVisualX - 1); }
         }
         else
         {
             m_buffer->moveCursor(m_lowerBoundY, m_previousVisualX);
 
-            for (size_t i = m_cursorX + 1; i < lastLineSize; i++)
-            {
-                m_buffer->insertCharacter(lastLine->at(i));
-            }
+            if (m_cursorX + 1 < static_cast<int>(lastLineSize)) { m_buffer->insertCharacters(*lastLine, m_cursorX + 1, lastLineSize - m_cursorX - 1); }
         }
     }
 
@@ -1498,47 +880,6 @@ bool RemoveLinesVisualModeCommand::execute()
     return true;
 }
 
-void RemoveLinesVisualBlockModeCommand::redo()
-{
-    m_buffer->moveCursor(m_lowerBoundY, 0);
-
-    for (int row = m_lowerBoundY; row <= m_upperBoundY; row++)
-    {
-        const std::shared_ptr<LineGapBuffer>& line = m_buffer->getLineGapBuffer(row);
-        int lineSize = static_cast<int>(line->lineSize());
-
-        if (lineSize == 0) { continue; }
-
-        int endIndex = std::min(m_upperBoundX + 1, lineSize);
-
-        if (m_lowerBoundX > endIndex) { continue; }
-
-        removeCharactersInRange(m_lowerBoundX, endIndex, row);
-    }
-
-    m_buffer->moveCursor(m_lowerBoundY, m_lowerBoundX);
-    m_buffer->shiftCursorX(0);
-
-    if (m_renderExecute) { m_view->display(); }
-}
-void RemoveLinesVisualBlockModeCommand::undo()
-{
-    m_buffer->moveCursor(m_lowerBoundY, 0);
-
-    for (int row = m_lowerBoundY; row <= m_upperBoundY; row++)
-    {
-        int numberOfCharactersToAdd = static_cast<int>(m_lines[row - m_lowerBoundY].size());
-
-        if (numberOfCharactersToAdd == 0) { continue; }
-
-        insertCharactersInRangeFromVector(m_lines[row - m_lowerBoundY], m_lowerBoundX, m_lowerBoundX + numberOfCharactersToAdd, row);
-    }
-
-    m_buffer->moveCursor(m_lowerBoundY, m_lowerBoundX);
-    m_buffer->shiftCursorX(0);
-
-    if (m_renderUndo) { m_view->display(); }
-}
 bool RemoveLinesVisualBlockModeCommand::execute()
 {
     const std::pair<int, int>& cursorPos = m_buffer->getCursorPos();
@@ -1589,27 +930,6 @@ bool RemoveLinesVisualBlockModeCommand::execute()
     return true;
 }
 
-void TabLineCommand::redo()
-{
-    m_buffer->moveCursor(m_initialY, m_initialX);
-
-    tabLine(m_buffer->getLineGapBuffer(m_initialY), m_headingRight, m_initialY);
-
-    m_buffer->moveCursor(m_initialY, m_initialX);
-    m_buffer->shiftCursorX(0);
-
-    if (m_renderExecute) { m_view->display(); }
-}
-void TabLineCommand::undo()
-{
-    m_buffer->moveCursor(m_initialY, m_initialX);
-
-    tabLine(m_buffer->getLineGapBuffer(m_initialY), !m_headingRight, m_initialY, m_differenceInCharacters);
-
-    m_buffer->moveCursor(m_initialY, m_initialX);
-
-    if (m_renderUndo) { m_view->display(); }
-}
 bool TabLineCommand::execute()
 {
     const std::pair<int, int>& cursorPos = m_buffer->getCursorPos();
@@ -1628,32 +948,6 @@ bool TabLineCommand::execute()
     return true;
 }
 
-void TabLineVisualCommand::redo()
-{
-    m_buffer->moveCursor(m_initialY, m_initialX);
-
-    for (int i = 0; i <= m_upperBoundY - m_lowerBoundY; i++)
-    {
-        tabLine(m_buffer->getLineGapBuffer(m_lowerBoundY + i), m_headingRight, m_lowerBoundY + i);
-    }
-
-    m_buffer->moveCursor(m_initialY, m_initialX);
-
-    if (m_renderExecute) { m_view->display(); }
-}
-void TabLineVisualCommand::undo()
-{
-    m_buffer->moveCursor(m_initialY, m_initialX);
-
-    for (int i = 0; i <= m_upperBoundY - m_lowerBoundY; i++)
-    {
-        tabLine(m_buffer->getLineGapBuffer(m_lowerBoundY + i), !m_headingRight, m_lowerBoundY + i, m_differenceInCharacters[i]);
-    }
-
-    m_buffer->moveCursor(m_initialY, m_initialX);
-
-    if (m_renderUndo) { m_view->display(); }
-}
 bool TabLineVisualCommand::execute()
 {
     const std::pair<int, int>& cursorPos = m_buffer->getCursorPos();
@@ -1664,451 +958,110 @@ bool TabLineVisualCommand::execute()
     m_lowerBoundY = std::min(cursorPos.first, previousVisualPos.first);
     m_upperBoundY = std::max(cursorPos.first, previousVisualPos.first);
 
-    m_differenceInCharacters.reserve(m_upperBoundY - m_lowerBoundY);
+    m_differenceInCharacters.reserve(m_upperBoundY - m_lowerBoundY + 1);
 
     bool madeChange = false;
 
-    for (int i = 0; i <= m_upperBoundY - m_lowerBoundY; i++)
+    // Same as tabLine on every line, but the lines are edited in one pass
+    m_buffer->editLines(m_lowerBoundY, m_upperBoundY, [this, &madeChange](int, const std::shared_ptr<LineGapBuffer>& line)
     {
-        m_differenceInCharacters.push_back(tabLine(m_buffer->getLineGapBuffer(m_lowerBoundY + i), m_headingRight, m_lowerBoundY + i));
-
-        if (m_differenceInCharacters[i] != 0) { madeChange = true; }
-    }
-
-    if (!madeChange) { return false; }
-
-    m_buffer->moveCursor(m_initialY, m_initialX);
-    m_buffer->shiftCursorX(0);
-
-    // Remove const qualifier to access method just once to ensure previous visual pos is in a reasonable spot
-    InputController& inputController = const_cast<InputController&>(m_editor->inputController());
-    inputController.setInitialVisualModeCursorX(std::min(static_cast<int>(m_editor->buffer().getLineGapBuffer(previousVisualPos.first)->lineSize()) - 1, previousVisualPos.second));
-
-    if (m_renderExecute) { m_view->display(); }
+        LineTextEdit edit;
 
-    return true;
-}
+        if (m_headingRight)
+        {
+            if (line->lineSize() != 0) { edit.insertedText.assign(WHITESPACE_PER_TAB, ' '); }
+        }
+        else
+        {
+            edit.erasedCharacters = std::min(WHITESPACE_PER_TAB, m_buffer->indexOfFirstNonSpaceCharacter(line));
+        }
 
-void AutocompletePair::redo()
-{
-    m_buffer->moveCursor(m_y, m_x);
+        int differenceInCharacters = edit.erasedCharacters + static_cast<int>(edit.insertedText.size());
 
-    m_buffer->insertCharacter(m_leftPair);
+        m_differenceInCharacters.push_back(differenceInCharacters);
 
-    if (m_autocomplete)
-    {
-        m_buffer->insertCharacter(m_rightPair);
-        m_buffer->shiftCursorX(-1);
-    }
+        if (differenceInCharacters != 0) { madeChange = true; }
 
-    m_buffer->moveCursor(m_y, m_x);
-    m_buffer->shiftCursorX(0);
-
-    if (m_renderExecute) { m_view->display(); }
-}
-void AutocompletePair::undo()
-{
-    m_buffer->moveCursor(m_y, m_x);
-
-    m_buffer->removeCharacter(false);
-
-    if (m_autocomplete)
-    {
-        m_buffer->removeCharacter(false);
-    }
-
-    m_buffer->moveCursor(m_y, m_x);
-    m_buffer->shiftCursorX(0);
-
-    if (m_renderUndo) { m_view->display(); }
-}
-bool AutocompletePair::execute()
-{
-    const std::pair<int, int>& cursorPos = m_buffer->getCursorPos();
-    m_x = cursorPos.second;
-    m_y = cursorPos.first;
-
-    switch (m_leftPair)
-    {
-        case '(':
-            m_rightPair = ')';
-            break;
-        case '{':
-            m_rightPair = '}';
-            break;
-        case '\'':
-            m_rightPair = '\'';
-            if (m_x != 0 && m_buffer->getLineGapBuffer(m_y)->at(m_x - 1) != ' ') { m_autocomplete = false; }
-            break;
-        case '[':
-            m_rightPair = ']';
-            break;
-        case '"':
-            m_rightPair = '"';
-            break;
-        default:
-            endwin();
-            std::cerr << "Unexpected input: " << m_leftPair << '\n';
-            exit(1);
-    }
-
-    m_buffer->insertCharacter(m_leftPair);
-
-    if (m_autocomplete)
-    {
-        m_buffer->insertCharacter(m_rightPair);
-        m_buffer->shiftCursorX(-1);
-    }
-
-    if (m_renderExecute) { m_view->display(); }
-
-    return true;
-}
-
-void PasteCommand::redo()
-{
-    Buffer& buffer = m_editor->buffer();
-
-    if (m_yankType == VISUAL_YANK)
-    {
-        buffer.moveCursor(m_pasteCursorY, m_pasteCursorX + 1);
-
-        const int boundDifferenceY = m_finalYankY - m_initialYankY;
-
-        const std::shared_ptr<LineGapBuffer>& firstBufferLine = m_buffer->getLineGapBuffer(m_pasteCursorY);
-
-        const LineGapBuffer& firstClipboardLine = m_yankedLines[0];
-        const LineGapBuffer& lastClipboardLine = m_yankedLines[m_yankedLines.size() - 1];
-
-        if (boundDifferenceY == 0)
-        {
-            if (firstClipboardLine.lineSize() > 0)
-            {
-                for (int charIndex = m_lowerBoundX; charIndex <= m_upperBoundX; charIndex++)
-                {
-                    buffer.insertCharacter(firstClipboardLine[charIndex]);
-                }
-            }
-            else
-            {
-                if (firstBufferLine->lineSize())
-                {
-                    removeCharactersInRange(m_pasteCursorX + 1, buffer.getLineGapBuffer(m_pasteCursorY)->lineSize(), m_pasteCursorY);
-                }
-
-                m_buffer->insertLine(true);
-
-                insertCharactersInRangeFromVector(m_visualRestOfLineAfterCursor, 0, m_visualRestOfLineAfterCursor.size(), m_pasteCursorY + 1);
-            }
-        }
-        else
-        {
-            int firstLineStartPaste = (boundDifferenceY > 0) ? m_initialYankX : m_finalYankX;
-
-            size_t initialBufferLineSize = firstBufferLine->lineSize();
-
-            // Insert characters in the first clipboard line after initialX onto the first buffer line
-            for (size_t charIndex = firstLineStartPaste; charIndex < firstClipboardLine.lineSize(); charIndex++)
-            {
-                buffer.insertCharacter(firstClipboardLine[charIndex]);
-            }
-
-            // Then remove all the characters that were pushed to the right; these will be appended to the last line later
-            int start = firstClipboardLine.lineSize() - firstLineStartPaste + m_pasteCursorX + 1;
-            int end = initialBufferLineSize + firstClipboardLine.lineSize() - firstLineStartPaste;
-            if (end - start >= 0)
-            {
-                removeCharactersInRange(start, end, m_pasteCursorY);
-            }
-
-            // Insert the intermediary lines
-            for (size_t i = 1; i < m_yankedLines.size(); i++)
-            {
-                buffer.insertLine(std::make_shared<LineGapBuffer>(m_yankedLines[i]), true);
-            }
-
-            // Insert characters from last clipboard line in-place onto the beginning of the first buffer line
-            if (lastClipboardLine.lineSize())
-            {
-                int absoluteLastY = (boundDifferenceY > 0) ? m_pasteCursorY + boundDifferenceY : m_pasteCursorY - boundDifferenceY;
-                int lastLineYankX = (boundDifferenceY > 0) ? m_finalYankX : m_initialYankX;
-
-                buffer.moveCursor(absoluteLastY, 0);
-                for (int charIndex = 0; charIndex <= lastLineYankX; charIndex++)
-                {
-                    buffer.insertCharacter(lastClipboardLine[charIndex]);
-                }
-
-                int insertEnd = lastLineYankX + m_visualRestOfLineAfterCursor.size() + 1;
-                insertCharactersInRangeFromVector(m_visualRestOfLineAfterCursor, lastLineYankX + 1, insertEnd, absoluteLastY);
-
-                removeCharactersInRange(insertEnd, buffer.getLineGapBuffer(absoluteLastY)->lineSize(), absoluteLastY);
-            }
-            else
-            {
-                int absoluteLastY = (boundDifferenceY > 0) ? m_pasteCursorY + boundDifferenceY : m_pasteCursorY - boundDifferenceY;
-
-                m_buffer->moveCursor(absoluteLastY, 0);
-
-                m_buffer->insertLine(true);
-
-                insertCharactersInRangeFromVector(m_visualRestOfLineAfterCursor, 0, m_visualRestOfLineAfterCursor.size(), absoluteLastY + 1);
-            }
-        }
-    }
-    else if (m_yankType == LINE_YANK)
-    {
-        buffer.moveCursor(m_pasteCursorY, m_pasteCursorX);
-
-        for (size_t i = 0; i < m_yankedLines.size(); i++)
-        {
-            // Insert characters from first clipboard line in-place onto the first buffer line
-            if (m_insertingOnOnlyEmptyLine && i == 0)
-            {
-                const LineGapBuffer& firstClipboardLine = m_yankedLines[0];
-
-                for (size_t charIndex = 0; charIndex < firstClipboardLine.lineSize(); charIndex++)
-                {
-                    m_buffer->insertCharacter(firstClipboardLine[charIndex]);
-                }
-            }
-            else
-            {
-                m_buffer->insertLine(std::make_shared<LineGapBuffer>(m_yankedLines[i]), true);
-            }
-        }
-    }
-    else // Block paste
-    {
-        // All characters are inserted in-place onto preexisting lines
-        buffer.moveCursor(m_pasteCursorY, m_pasteCursorX);
-
-        int lowerY = std::min(m_initialYankY, m_finalYankY);
-        int upperY = std::max(m_initialYankY, m_finalYankY);
-
-        const std::shared_ptr<LineGapBuffer>& lineOnPasteCursor = buffer.getLineGapBuffer(m_pasteCursorY);
-        size_t lineOnPasteCursorSize = (lineOnPasteCursor) ? lineOnPasteCursor->lineSize() : 0;
-
-        for (int i = lowerY; i <= upperY; i++)
-        {
-            buffer.moveCursor(m_pasteCursorY + i - lowerY, 0);
-
-            int bufferIndex = m_pasteCursorY + i - lowerY;
-            if (bufferIndex >= static_cast<int>(buffer.getFileGapBuffer().numberOfLines()))
-            {
-                buffer.insertLine(true);
-            }
-
-            const std::shared_ptr<LineGapBuffer>& bufferLine = buffer.getLineGapBuffer(m_pasteCursorY + i - lowerY);
-            const int bufferLineSize = static_cast<int>(bufferLine->lineSize());
-
-            if (lineOnPasteCursorSize == 0 && m_pasteCursorX == 0)
-            {
-                buffer.moveCursor(m_pasteCursorY + i - lowerY, m_pasteCursorX);
-            }
-            else
-            {
-                buffer.moveCursor(m_pasteCursorY + i - lowerY, m_pasteCursorX + 1);
-            }
-
-            // Insert spaces so the pasted block is contiguous
-            if (lineOnPasteCursorSize)
-            {
-                int numberOfSpaces = m_pasteCursorX + 1 - bufferLineSize;
-
-                for (int j = 0; j < numberOfSpaces; j++)
-                {
-                    buffer.insertCharacter(' ');
-                }
-            }
-
-            // Insert the characters from the block
-            bool addExtraSpacesInsideBlock = false;
-
-            const LineGapBuffer& yankedLine = m_yankedLines[i - lowerY];
-            int yankedLineSize = static_cast<int>(yankedLine.lineSize());
-
-            if (bufferLineSize > m_pasteCursorX) { addExtraSpacesInsideBlock = true; }
-
-            for (int j = m_lowerBoundX; j <= m_upperBoundX; j++)
-            {
-                if (addExtraSpacesInsideBlock)
-                {
-                    if (j >= yankedLineSize)
-                    {
-                        buffer.insertCharacter(' ');
-                    }
-                    else
-                    {
-                        buffer.insertCharacter(yankedLine[j]);
-                    }
-                }
-                else
-                {
-                    if (j >= yankedLineSize)
-                    {
-                        break;
-                    }
-                    else
-                    {
-                        buffer.insertCharacter(yankedLine[j]);
-                    }
-                }
-            }
-        }
-
-        if (m_pasteCursorX == 0)
-        {
-            buffer.moveCursor(m_pasteCursorY, m_pasteCursorX);
-        }
-        else
-        {
-            buffer.moveCursor(m_pasteCursorY, m_pasteCursorX + 1);
-        }
-    }
-
-    m_buffer->shiftCursorX(0);
-
-    if (m_renderExecute) { m_editor->view().display(); }
-}
-void PasteCommand::undo()
-{
-    Buffer& buffer = m_editor->buffer();
-
-    if (m_yankType == LINE_YANK)
-    {
-        buffer.moveCursor(m_pasteCursorY + 1, m_pasteCursorX);
-
-        for (size_t i = 0; i < m_yankedLines.size(); i++)
-        {
-            buffer.removeLine();
-        }
-
-        buffer.moveCursor(m_pasteCursorY, m_pasteCursorX);
-    }
-    else if (m_yankType == BLOCK_YANK)
-    {
-        int lowerY = std::min(m_initialYankY, m_finalYankY);
-        int upperY = std::max(m_initialYankY, m_finalYankY);
-
-        int minYankX = std::min(m_initialYankX, m_finalYankX);
-        int maxYankX = std::max(m_initialYankX, m_finalYankX);
-
-        int tempExtraLines = m_extraLinesInserted;
-
-        int extraInsertedSpacesSize = static_cast<int>(m_extraSpacesInserted.size());
-        int extraInsertedSpacesIndex = extraInsertedSpacesSize - 1;
-
-        for (int i = upperY; i >= lowerY; i--)
-        {
-            if (tempExtraLines != 0)
-            {
-                buffer.moveCursor(m_pasteCursorY + i - lowerY, 0);
-                buffer.removeLine();
-
-                tempExtraLines--;
-            }
-            else
-            {
-                int yPos = m_pasteCursorY + i - lowerY;
-
-                if (m_pastedOnEmptyLineAtZero)
-                {
-                    const std::shared_ptr<LineGapBuffer>& bufferLine = buffer.getLineGapBuffer(yPos);
-
-                    int endX = std::min(static_cast<int>(bufferLine->lineSize()), m_pasteCursorX + maxYankX - minYankX + 1);
-
-                    removeCharactersInRange(m_pasteCursorX, endX, yPos);
-                }
-                else
-                {
-                    const std::shared_ptr<LineGapBuffer>& bufferLine = buffer.getLineGapBuffer(yPos);
-
-                    int endX = std::min(static_cast<int>(bufferLine->lineSize()), m_pasteCursorX + maxYankX - minYankX + 2);
-
-                    removeCharactersInRange(m_pasteCursorX + 1, endX, yPos);
-                }
-
-                // Remove any extra spaces that were added in the execute phase
-                if (extraInsertedSpacesIndex >= 0)
-                {
-                    if (m_extraSpacesInserted[extraInsertedSpacesIndex].first == yPos)
-                    {
-                        int start = m_pasteCursorX - m_extraSpacesInserted[extraInsertedSpacesIndex--].second + 1;
-                        int end = m_pasteCursorX + 1;
-
-                        removeCharactersInRange(start, end, yPos);
-                    }
-                }
-            }
-        }
-
-        buffer.moveCursor(m_pasteCursorY, m_pasteCursorX);
-    }
-    else // Visual yank
-    {
-        const int boundDifferenceY = m_finalYankY - m_initialYankY;
-
-        if (boundDifferenceY == 0)
-        {
-            size_t firstClipboardLineSize = m_yankedLines[0].lineSize();
-
-            if (firstClipboardLineSize > 0)
-            {
-                removeCharactersInRange(m_pasteCursorX + 1, m_pasteCursorX + m_upperBoundX - m_lowerBoundX + 2, m_pasteCursorY);
-            }
-            else
-            {
-                m_buffer->moveCursor(m_pasteCursorY + 1, m_pasteCursorX);
+        return edit;
+    });
 
-                m_buffer->removeLine();
+    if (!madeChange) { return false; }
 
-                insertCharactersInRangeFromVector(m_visualRestOfLineAfterCursor, m_pasteCursorX + 1, m_pasteCursorX + 1 + m_visualRestOfLineAfterCursor.size(), m_pasteCursorY);
-            }
-        }
-        else
-        {
-            size_t clipBoardNumberOfLines = m_yankedLines.size();
+    m_buffer->moveCursor(m_initialY, m_initialX);
+    m_buffer->shiftCursorX(0);
 
-            buffer.moveCursor(m_pasteCursorY + 1, m_pasteCursorX);
+    // Remove const qualifier to access method just once to ensure previous visual pos is in a reasonable spot
+    InputController& inputController = const_cast<InputController&>(m_editor->inputController());
+    inputController.setInitialVisualModeCursorX(std::min(static_cast<int>(m_editor->buffer().getLineGapBuffer(previousVisualPos.first)->lineSize()) - 1, previousVisualPos.second));
 
-            // Delete intermediary lines
-            for (size_t i = 1; i < clipBoardNumberOfLines; i++)
-            {
-                buffer.removeLine();
-            }
+    if (m_renderExecute) { m_view->display(); }
 
-            // Remove added characters on first line
-            int firstLineStartPaste = (boundDifferenceY > 0) ? m_initialYankX : m_finalYankX;
-            removeCharactersInRange(m_pasteCursorX + 1, m_pasteCursorX + 1 + static_cast<int>(m_yankedLines[0].lineSize()) - firstLineStartPaste, m_pasteCursorY);
+    return true;
+}
 
-            // Insert characters that were initially removed on the first line ONTO the first line
-            int start = m_pasteCursorX + 1;
-            int end = m_pasteCursorX + 1 + m_visualRestOfLineAfterCursor.size();
+bool AutocompletePair::execute()
+{
+    const std::pair<int, int>& cursorPos = m_buffer->getCursorPos();
+    m_x = cursorPos.second;
+    m_y = cursorPos.first;
 
-            insertCharactersInRangeFromVector(m_visualRestOfLineAfterCursor, start, end, m_pasteCursorY);
+    switch (m_leftPair)
+    {
+        case '(':
+            m_rightPair = ')';
+            break;
+        case '{':
+            m_rightPair = '}';
+            break;
+        case '\'':
+            m_rightPair = '\'';
+            if (m_x != 0 && m_buffer->getLineGapBuffer(m_y)->at(m_x - 1) != ' ') { m_autocomplete = false; }
+            break;
+        case '[':
+            m_rightPair = ']';
+            break;
+        case '"':
+            m_rightPair = '"';
+            break;
+        default:
+            endwin();
+            std::cerr << "Unexpected input: " << m_leftPair << '\n';
+            exit(1);
+    }
 
-            if (m_yankedLines[m_yankedLines.size() - 1].lineSize() == 0)
-            {
-                buffer.moveCursor(m_pasteCursorY + 1, 0);
-                buffer.removeLine();
-            }
-        }
+    m_buffer->insertCharacter(m_leftPair);
 
-        buffer.moveCursor(m_pasteCursorY, m_pasteCursorX);
+    if (m_autocomplete)
+    {
+        m_buffer->insertCharacter(m_rightPair);
+        m_buffer->shiftCursorX(-1);
     }
 
-    m_buffer->shiftCursorX(0);
+    if (m_renderExecute) { m_view->display(); }
+
+    return true;
+}
+
+std::vector<std::shared_ptr<LineGapBuffer>> PasteCommand::copyOfYankedLines(size_t first) const
+{
+    std::vector<std::shared_ptr<LineGapBuffer>> copies;
+    copies.reserve(m_yankedLines.size() - std::min(first, m_yankedLines.size()));
+
+    for (size_t i = first; i < m_yankedLines.size(); i++)
+    {
+        copies.push_back(std::make_shared<LineGapBuffer>(m_yankedLines[i]));
+    }
 
-    if (m_renderUndo) { m_view->display(); }
+    return copies;
 }
+
 bool PasteCommand::execute()
 {
     const std::pair<int, int>& cursorPos = m_buffer->getCursorPos();
     m_pasteCursorX = cursorPos.second;
     m_pasteCursorY = cursorPos.first;
 
-    const size_t numberOfLines = m_buffer->getFileGapBuffer().numberOfLines();
+    const size_t numberOfLines = m_buffer->getFile().numberOfLines();
 
     const Clipboard& clipboard = m_editor->clipBoard();
 
@@ -2144,10 +1097,7 @@ bool PasteCommand::execute()
         {
             if (firstClipboardLine.lineSize() > 0)
             {
-                for (int charIndex = m_lowerBoundX; charIndex <= m_upperBoundX; charIndex++)
-                {
-                    m_buffer->insertCharacter(firstClipboardLine[charIndex]);
-                }
+                if (m_upperBoundX >= m_lowerBoundX) { m_buffer->insertCharacters(firstClipboardLine, m_lowerBoundX, m_upperBoundX - m_lowerBoundX + 1); }
             }
             else
             {
@@ -2168,10 +1118,7 @@ bool PasteCommand::execute()
             size_t initialBufferLineSize = firstBufferLine->lineSize();
 
             // Insert characters in the first clipboard line after initialX onto the first buffer line
-            for (size_t charIndex = firstLineStartPaste; charIndex < firstClipboardLine.lineSize(); charIndex++)
-            {
-                m_buffer->insertCharacter(firstClipboardLine[charIndex]);
-            }
+            m_buffer->insertCharacters(firstClipboardLine, firstLineStartPaste, firstClipboardLine.lineSize() - std::min(static_cast<size_t>(firstLineStartPaste), firstClipboardLine.lineSize()));
 
             // Then remove all the characters that were pushed to the right; these will be appended to the last line later
             int start = firstClipboardLine.lineSize() - firstLineStartPaste + m_pasteCursorX + 1;
@@ -2184,10 +1131,7 @@ bool PasteCommand::execute()
 
 
             // Insert the intermediary lines
-            for (size_t i = 1; i < clipBoardNumberOfLines; i++)
-            {
-                m_buffer->insertLine(std::make_shared<LineGapBuffer>(m_yankedLines[i]), true);
-            }
+            m_buffer->insertLines(copyOfYankedLines(1));
 
             // Insert characters from last clipboard line in-place onto the beginning of the first buffer line
             if (lastClipboardLine.lineSize())
@@ -2196,10 +1140,7 @@ bool PasteCommand::execute()
                 int lastLineYankX = (boundDifferenceY > 0) ? m_finalYankX : m_initialYankX;
 
                 m_buffer->moveCursor(absoluteLastY, 0);
-                for (int charIndex = 0; charIndex <= lastLineYankX; charIndex++)
-                {
-                    m_buffer->insertCharacter(lastClipboardLine[charIndex]);
-                }
+                if (lastLineYankX >= 0) { m_buffer->insertCharacters(lastClipboardLine, 0, lastLineYankX + 1); }
 
                 int insertEnd = lastLineYankX + m_visualRestOfLineAfterCursor.size() + 1;
                 insertCharactersInRangeFromVector(m_visualRestOfLineAfterCursor, lastLineYankX + 1, insertEnd, absoluteLastY);
@@ -2225,28 +1166,17 @@ bool PasteCommand::execute()
         // If there's only one line and it's empty, we don't want to append anything, just insert characters onto the first line.
         if (numberOfLines == 1 && firstBufferLine->lineSize() == 0)
         {
-            m_insertingOnOnlyEmptyLine = true; 
-
             const LineGapBuffer& firstClipboardLine = m_yankedLines[0];
 
             // Insert characters from first clipboard line in-place onto the first buffer line
-            for (size_t charIndex = 0; charIndex < firstClipboardLine.lineSize(); charIndex++)
-            {
-                m_buffer->insertCharacter(firstClipboardLine[charIndex]);
-            }
+            m_buffer->insertCharacters(firstClipboardLine, 0, firstClipboardLine.lineSize());
 
             // Append the additional lines
-            for (size_t i = 1; i < clipBoardNumberOfLines; i++)
-            {
-                m_buffer->insertLine(std::make_shared<LineGapBuffer>(m_yankedLines[i]), true);
-            }
+            m_buffer->insertLines(copyOfYankedLines(1));
         }
         else
         {
-            for (size_t i = 0; i < clipBoardNumberOfLines; i++)
-            {
-                m_buffer->insertLine(std::make_shared<LineGapBuffer>(m_yankedLines[i]), true);
-            }
+            m_buffer->insertLines(copyOfYankedLines(0));
         }
     }
     else // Block paste
@@ -2273,10 +1203,9 @@ bool PasteCommand::execute()
             currentBuffer.moveCursor(m_pasteCursorY + i - lowerY, 0);
 
             int bufferIndex = m_pasteCursorY + i - lowerY;
-            if (bufferIndex >= static_cast<int>(currentBuffer.getFileGapBuffer().numberOfLines()))
+            if (bufferIndex >= static_cast<int>(currentBuffer.getFile().numberOfLines()))
             {
                 currentBuffer.insertLine(true);
-                m_extraLinesInserted++;
             }
 
             const std::shared_ptr<LineGapBuffer>& bufferLine = currentBuffer.getLineGapBuffer(m_pasteCursorY + i - lowerY);
@@ -2284,7 +1213,6 @@ bool PasteCommand::execute()
 
             if (lineOnPasteCursorSize == 0 && m_pasteCursorX == 0)
             {
-                m_pastedOnEmptyLineAtZero = true;
                 currentBuffer.moveCursor(m_pasteCursorY + i - lowerY, m_pasteCursorX);
             }
             else
@@ -2301,12 +1229,6 @@ bool PasteCommand::execute()
                 {
                     currentBuffer.insertCharacter(' ');
                 }
-
-                // Store the extra spaces in memory for undo
-                if (numberOfSpaces > 0)
-                {
-                    m_extraSpacesInserted.push_back(std::pair<int, int>(m_pasteCursorY + i - lowerY, numberOfSpaces));
-                }
             }
 
             // Insert the characters from the block
@@ -2361,8 +1283,6 @@ bool PasteCommand::execute()
     return true;
 }
 
-void VisualYankCommand::redo() {}
-void VisualYankCommand::undo() {}
 bool VisualYankCommand::execute()
 {
     Clipboard& clipboard = m_editor->clipBoard();
@@ -2396,13 +1316,11 @@ bool VisualYankCommand::execute()
     m_editor->buffer().setLastYankInitialCursor(initialYankPos);
     m_editor->buffer().setLastYankFinalCursor(finalYankPos);
 
-    if (m_renderExecute) { m_editor->view().yankHighlightTimer(YANK_HIGHLIGHT_MILLISECONDS, m_yankType); }
+    if (m_renderExecute) { m_editor->view().startYankHighlight(YANK_HIGHLIGHT_MILLISECONDS, m_yankType); }
 
     return false;
 }
 
-void NormalYankLineCommand::redo() {}
-void NormalYankLineCommand::undo() {}
 bool NormalYankLineCommand::execute()
 {
     Clipboard& clipboard = m_editor->clipBoard();
@@ -2424,7 +1342,7 @@ bool NormalYankLineCommand::execute()
     int upperBoundY = std::max(initialYankPos.first, initialYankPos.first + m_direction + additionalLines);
 
     lowerBoundY = std::max(0, lowerBoundY);
-    upperBoundY = std::min(static_cast<int>(buffer.getFileGapBuffer().numberOfLines()) - 1, upperBoundY);
+    upperBoundY = std::min(static_cast<int>(buffer.getFile().numberOfLines()) - 1, upperBoundY);
 
     clipboard.lineUpdate();
 
@@ -2436,13 +1354,11 @@ bool NormalYankLineCommand::execute()
     buffer.setLastYankInitialCursor(std::pair<int, int>(lowerBoundY, initialYankPos.second));
     buffer.setLastYankFinalCursor(std::pair<int, int>(upperBoundY, initialYankPos.second));
 
-    if (m_renderExecute) { m_editor->view().yankHighlightTimer(YANK_HIGHLIGHT_MILLISECONDS, LINE_YANK); }
+    if (m_renderExecute) { m_editor->view().startYankHighlight(YANK_HIGHLIGHT_MILLISECONDS, LINE_YANK); }
 
     return false;
 }
 
-void JumpCursorYankWordCommand::redo() {}
-void JumpCursorYankWordCommand::undo() {}
 bool JumpCursorYankWordCommand::execute()
 {
     Clipboard& clipboard = m_editor->clipBoard();
@@ -2476,13 +1392,11 @@ bool JumpCursorYankWordCommand::execute()
 
     buffer.moveCursor(initialYankPos.first, initialYankPos.second);
 
-    if (m_renderExecute) { m_editor->view().yankHighlightTimer(YANK_HIGHLIGHT_MILLISECONDS, BLOCK_YANK); }
+    if (m_renderExecute) { m_editor->view().startYankHighlight(YANK_HIGHLIGHT_MILLISECONDS, BLOCK_YANK); }
 
     return false;
 }
 
-void JumpCursorYankEndlineCommand::redo() {}
-void JumpCursorYankEndlineCommand::undo() {}
 bool JumpCursorYankEndlineCommand::execute()
 {
     Clipboard& clipboard = m_editor->clipBoard();
@@ -2512,13 +1426,11 @@ bool JumpCursorYankEndlineCommand::execute()
 
     buffer.moveCursor(initialYankPos.first, initialYankPos.second);
 
-    if (m_renderExecute) { m_editor->view().yankHighlightTimer(YANK_HIGHLIGHT_MILLISECONDS, BLOCK_YANK); }
+    if (m_renderExecute) { m_editor->view().startYankHighlight(YANK_HIGHLIGHT_MILLISECONDS, BLOCK_YANK); }
 
     return false;
 }
 
-void QuickVerticalMovementCommand::redo() {}
-void QuickVerticalMovementCommand::undo() {}
 bool QuickVerticalMovementCommand::execute()
 {
     int direction = (m_down) ? 1 : -1;
@@ -2535,58 +1447,91 @@ bool QuickVerticalMovementCommand::execute()
     return false;
 }
 
-void ToggleCommentLineCommand::redo()
+bool SearchCommand::execute()
 {
-    Buffer& buffer = m_editor->buffer();
+    const std::shared_ptr<const SearchPattern>& pattern = m_buffer->searchIndex().pattern();
 
-    if (m_commentedLine)
-    {
-        buffer.moveCursor(m_cursorY, m_indexOfFirstNonSpaceCharacter);
+    if (!pattern) { m_view->setMessage("No previous search pattern"); return false; }
 
-        buffer.insertCharacter('/');
-        buffer.insertCharacter('/');
-        buffer.insertCharacter(' ');
-    }
-    else
+    std::string prompt = (m_forward ? "/" : "?") + pattern->pattern();
+
+    SearchMatch match;
+    bool wrapped;
+
+    if (!m_buffer->findMatch(m_forward, match, wrapped))
     {
-        buffer.moveCursor(m_cursorY, m_indexOfFirstNonSpaceCharacter);
+        m_view->setMessage("Pattern not found: " + pattern->pattern());
+        if (m_renderExecute) { m_view->display(); }
 
-        for (int i = 0; i < 3; i++)
-            buffer.removeCharacter(false);
+        return false;
     }
 
-    buffer.moveCursor(m_cursorY, m_cursorX);
-    buffer.shiftCursorX(0);
+    m_buffer->moveCursor(match.line, match.column);
 
-    if (m_renderExecute) { m_editor->view().display(); }
+    if (wrapped) { m_view->setMessage(m_forward ? "search hit BOTTOM, continuing at TOP" : "search hit TOP, continuing at BOTTOM"); }
+    else { m_view->setMessage(prompt); }
+
+    if (m_renderExecute) { m_view->display(); }
+
+    return false;
 }
-void ToggleCommentLineCommand::undo()
+
+bool SubstituteCommand::execute()
 {
-    Buffer& buffer = m_editor->buffer();
+    // How often a long substitution shows how far it got
+    static const int progressLines = 1 << 16;
 
-    if (m_commentedLine)
-    {
-        buffer.moveCursor(m_cursorY, m_indexOfFirstNonSpaceCharacter);
+    int substitutions = 0;
+    int substitutedLines = 0;
+    int lastSubstitutedLine = -1;
+    std::string scratch;
 
-        for (int i = 0; i < 3; i++)
-            buffer.removeCharacter(false);
-    }
-    else
+    // Every line of the range is rewritten in one pass over the file, with a single erase and insert for all of its matches
+    m_buffer->editLines(m_firstLine, m_lastLine, [this, &substitutions, &substitutedLines, &lastSubstitutedLine, &scratch](int y, const std::shared_ptr<LineGapBuffer>& line)
     {
-        buffer.moveCursor(m_cursorY, m_indexOfFirstNonSpaceCharacter);
+        LineTextEdit textEdit;
+        int end = 0;
 
-        buffer.insertCharacter('/');
-        buffer.insertCharacter('/');
-        buffer.insertCharacter(' ');
+        int lineSubstitutions = m_pattern->substitute(*line, m_replacement, m_global, textEdit.x, end, textEdit.insertedText, scratch);
+
+        if (lineSubstitutions)
+        {
+            textEdit.erasedCharacters = end - textEdit.x;
+
+            substitutions += lineSubstitutions;
+            substitutedLines++;
+            lastSubstitutedLine = y;
+        }
+
+        if ((y - m_firstLine + 1) % progressLines == 0)
+        {
+            m_view->setStatus("Substituting " + std::to_string(static_cast<int64_t>(y - m_firstLine) * 100 / (m_lastLine - m_firstLine + 1)) + "%");
+            m_view->displayBufferInformationLine();
+        }
+
+        return textEdit;
+    });
+
+    m_view->setStatus("");
 
+    if (!substitutions)
+    {
+        m_view->setMessage("Pattern not found: " + m_pattern->pattern());
+        if (m_renderExecute) { m_view->display(); }
+
+        return false;
     }
 
-    buffer.moveCursor(m_cursorY, m_cursorX);
-    buffer.shiftCursorX(0);
+    m_buffer->moveCursor(lastSubstitutedLine, m_buffer->indexOfFirstNonSpaceCharacter(m_buffer->getLineGapBuffer(lastSubstitutedLine)));
 
-    if (m_renderUndo) { m_editor->view().display(); }
+    m_view->setMessage(std::to_string(substitutions) + (substitutions == 1 ? " substitution on " : " substitutions on ") + std::to_string(substitutedLines) +
+        (substitutedLines == 1 ? " line" : " lines"));
+
+    if (m_renderExecute) { m_view->display(); }
 
+    return false;
 }
+
 bool ToggleCommentLineCommand::execute()
 {
     const std::pair<int, int>& cursorPos = m_buffer->getCursorPos();
@@ -2644,138 +1589,6 @@ bool ToggleCommentLineCommand::execute()
     return true;
 }
 
-void ToggleCommentLinesVisualCommand::redo()
-{
-    Buffer& buffer = m_editor->buffer();
-
-    int indexOfSpeciallyRemovedComment = 0;
-    int indexOfCommentedLinesWithNoSpaceAfterSlashes = 0;
-
-    for (int row = m_lowerY; row <= m_upperY; row++)
-    {
-        const std::shared_ptr<LineGapBuffer>& currentLine = buffer.getLineGapBuffer(row);
-
-        bool commentingEmptyLine = false;
-
-        if (static_cast<int>(currentLine->lineSize()) < m_smallestIndexOfFirstNonSpaceCharacter)
-        {
-            buffer.moveCursor(row, static_cast<int>(currentLine->lineSize()) - 1);
-
-            for (int i = static_cast<int>(currentLine->lineSize()); i < m_smallestIndexOfFirstNonSpaceCharacter; i++)
-            {
-                buffer.insertCharacter(' ');
-            }
-
-            commentingEmptyLine = true;
-        }
-
-        buffer.moveCursor(row, m_smallestIndexOfFirstNonSpaceCharacter);
-
-        if (m_commentLines)
-        {
-
-            buffer.insertCharacter('/');
-            buffer.insertCharacter('/');
-            if (!commentingEmptyLine)
-            {
-                buffer.insertCharacter(' ');
-            }
-        }
-        else
-        {
-            if (indexOfSpeciallyRemovedComment < static_cast<int>(m_indicesOfFirstCharacters.size()) && m_indicesOfFirstCharacters[indexOfSpeciallyRemovedComment].first == row)
-            {
-                buffer.moveCursor(row, m_indicesOfFirstCharacters[indexOfSpeciallyRemovedComment++].second);
-            }
-            else
-            {
-                buffer.moveCursor(row, m_smallestIndexOfFirstNonSpaceCharacter);
-            }
-
-            buffer.removeCharacter(false);
-            buffer.removeCharacter(false);
-
-            if (indexOfCommentedLinesWithNoSpaceAfterSlashes >= static_cast<int>(m_indicesOfCommentsWithNoSpaceAfterSlashes.size()) || m_indicesOfCommentsWithNoSpaceAfterSlashes[indexOfCommentedLinesWithNoSpaceAfterSlashes] != row)
-            {
-                buffer.removeCharacter(false);
-            }
-            else
-            {
-                indexOfCommentedLinesWithNoSpaceAfterSlashes++;
-            }
-        }
-    }
-
-    buffer.moveCursor(m_finalY, m_finalX);
-    buffer.shiftCursorX(0);
-
-    if (m_renderExecute) { m_editor->view().display(); }
-}
-void ToggleCommentLinesVisualCommand::undo()
-{
-    Buffer& buffer = m_editor->buffer();
-
-    int indexOfSpeciallyRemovedComment = 0;
-    int indexOfCommentedLinesWithNoSpaceAfterSlashes = 0;
-
-    for (int row = m_lowerY; row <= m_upperY; row++)
-    {
-        int lineSize = static_cast<int>(buffer.getLineGapBuffer(row)->lineSize());
-
-        bool commentedEmptyLine = false;
-
-        if (lineSize == m_smallestIndexOfFirstNonSpaceCharacter + 2) { commentedEmptyLine = true; }
-
-        if (m_commentLines)
-        {
-            buffer.moveCursor(row, m_smallestIndexOfFirstNonSpaceCharacter);
-
-            if (commentedEmptyLine)
-            {
-                buffer.moveCursor(row, 0);
-                for (int i = 0; i < lineSize; i++)
-                {
-                    buffer.removeCharacter(false);
-                }
-            }
-            else
-            {
-                buffer.removeCharacter(false);
-                buffer.removeCharacter(false);
-                buffer.removeCharacter(false);
-            }
-        }
-        else
-        {
-            if (indexOfSpeciallyRemovedComment < static_cast<int>(m_indicesOfFirstCharacters.size()) && m_indicesOfFirstCharacters[indexOfSpeciallyRemovedComment].first == row)
-            {
-                buffer.moveCursor(row, m_indicesOfFirstCharacters[indexOfSpeciallyRemovedComment++].second);
-            }
-            else
-            {
-                buffer.moveCursor(row, m_smallestIndexOfFirstNonSpaceCharacter);
-            }
-
-
-            buffer.insertCharacter('/');
-            buffer.insertCharacter('/');
-
-            if (indexOfCommentedLinesWithNoSpaceAfterSlashes >= static_cast<int>(m_indicesOfCommentsWithNoSpaceAfterSlashes.size()) || m_indicesOfCommentsWithNoSpaceAfterSlashes[indexOfCommentedLinesWithNoSpaceAfterSlashes] != row)
-            {
-                buffer.insertCharacter(' ');
-            }
-            else
-            {
-                indexOfCommentedLinesWithNoSpaceAfterSlashes++;
-            }
-        }
-    }
-
-    buffer.moveCursor(m_finalY, m_finalX);
-    buffer.shiftCursorX(0);
-
-    if (m_renderUndo) { m_editor->view().display(); }
-}
 bool ToggleCommentLinesVisualCommand::execute()
 {
     const std::pair<int, int>& cursorPos = m_buffer->getCursorPos();
@@ -2817,69 +1630,52 @@ bool ToggleCommentLinesVisualCommand::execute()
         }
     }
 
-    for (int row = m_lowerY; row <= m_upperY; row++)
+    buffer.editLines(m_lowerY, m_upperY, [this](int row, const std::shared_ptr<LineGapBuffer>& line)
     {
-        const std::shared_ptr<LineGapBuffer>& currentLine = buffer.getLineGapBuffer(row);
-        int lineSize = static_cast<int>(currentLine->lineSize());
+        int lineSize = static_cast<int>(line->lineSize());
 
-        bool commentingEmptyLine = false;
+        LineTextEdit edit;
 
-        if (lineSize <= m_smallestIndexOfFirstNonSpaceCharacter)
+        if (m_commentLines)
         {
-            buffer.moveCursor(row, lineSize - 1);
-
-            for (int i = lineSize; i < m_smallestIndexOfFirstNonSpaceCharacter; i++)
+            // Lines too short to reach the comment are padded with spaces and get no space after the slashes
+            if (lineSize <= m_smallestIndexOfFirstNonSpaceCharacter)
             {
-                buffer.insertCharacter(' ');
+                edit.x = lineSize;
+                edit.insertedText.assign(m_smallestIndexOfFirstNonSpaceCharacter - lineSize, ' ');
+                edit.insertedText += "//";
             }
-
-            commentingEmptyLine = true;
-        }
-
-
-        if (m_commentLines)
-        {
-            buffer.moveCursor(row, m_smallestIndexOfFirstNonSpaceCharacter);
-
-            buffer.insertCharacter('/');
-            buffer.insertCharacter('/');
-            if (!commentingEmptyLine)
+            else
             {
-                buffer.insertCharacter(' ');
+                edit.x = m_smallestIndexOfFirstNonSpaceCharacter;
+                edit.insertedText = "// ";
             }
         }
         else
         {
-            const std::shared_ptr<LineGapBuffer>& line = buffer.getLineGapBuffer(row);
-
-            int actualFirstNonSpaceCharacter = buffer.getXPositionOfFirstCharacter(row);
+            // Every line has a character that is not a space when uncommenting, so the slashes start at the first one
+            int firstNonSpaceCharacter = static_cast<int>(line->firstNonSpaceIndex());
 
-            if (actualFirstNonSpaceCharacter != m_smallestIndexOfFirstNonSpaceCharacter)
+            if (firstNonSpaceCharacter + 1 < lineSize)
             {
-                m_indicesOfFirstCharacters.push_back(std::pair<int, int>(row, actualFirstNonSpaceCharacter));
+                edit.x = firstNonSpaceCharacter;
+                edit.erasedCharacters = 2;
 
-                buffer.moveCursor(row, buffer.getXPositionOfFirstCharacter(row));
+                if (firstNonSpaceCharacter + 2 < lineSize && line->at(firstNonSpaceCharacter + 2) == ' ') { edit.erasedCharacters++; }
+                else { m_indicesOfCommentsWithNoSpaceAfterSlashes.push_back(row); }
             }
             else
             {
-                buffer.moveCursor(row, m_smallestIndexOfFirstNonSpaceCharacter);
-            }
-
-            buffer.removeCharacter(false);
-            buffer.removeCharacter(false);
+                // A lone slash at the end of the line takes the character before it along
+                edit.x = std::max(0, firstNonSpaceCharacter - 1);
+                edit.erasedCharacters = std::min(2, lineSize);
 
-            int lineSize = (line) ? static_cast<int>(line->lineSize()) : 0;
-
-            if (lineSize > 0 && actualFirstNonSpaceCharacter < lineSize && line->at(actualFirstNonSpaceCharacter) == ' ')
-            {
-                buffer.removeCharacter(false);
-            }
-            else
-            {
                 m_indicesOfCommentsWithNoSpaceAfterSlashes.push_back(row);
             }
         }
-    }
+
+        return edit;
+    });
 
     buffer.moveCursor(m_finalY, m_finalX);
     buffer.shiftCursorX(0);
@@ -2889,16 +1685,6 @@ bool ToggleCommentLinesVisualCommand::execute()
     return true;
 }
 
-void SwapLinesVisualModeCommand::redo()
-{
-
-    if (m_renderExecute) { m_editor->view().display(); }
-}
-void SwapLinesVisualModeCommand::undo()
-{
-
-    if (m_renderUndo) { m_editor->view().display(); }
-}
 bool SwapLinesVisualModeCommand::execute()
 {
     m_initialPos = m_buffer->getCursorPos();
@@ -2909,16 +1695,14 @@ bool SwapLinesVisualModeCommand::execute()
 
     int differenceY = upperBoundY - lowerBoundY;
 
-    int numberOfLines = static_cast<int>(m_buffer->getFileGapBuffer().numberOfLines());
+    int numberOfLines = static_cast<int>(m_buffer->getFile().numberOfLines());
 
     if (differenceY == numberOfLines) { return false; }
     if (m_down && upperBoundY >= numberOfLines - 1) { return false; }
     if (!m_down && lowerBoundY <= 0) { return false; }
 
 
-    FileGapBuffer& fileGapBuffer = const_cast<FileGapBuffer&>(m_buffer->getFileGapBuffer());
-
-    fileGapBuffer.swapLinesInRange(m_down, lowerBoundY, upperBoundY);
+    m_buffer->swapLinesInRange(m_down, lowerBoundY, upperBoundY);
 
     if (m_down)
     {
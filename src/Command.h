@@ -2,6 +2,7 @@
 
 #include "Includes.h"
 #include "LineGapBuffer.h"
+#include "SearchPattern.h"
 #include <climits>
 
 class Editor;
@@ -41,13 +42,12 @@ protected:
 public:
 
     bool m_renderExecute;
-    bool m_renderUndo;
 
-    Command(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo)
-        : m_editor(editor), m_buffer(buffer), m_view(view), m_commandQueue(commandQueue), m_renderExecute(renderExecute), m_renderUndo(renderUndo) {}
+    Command(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute)
+        : m_editor(editor), m_buffer(buffer), m_view(view), m_commandQueue(commandQueue), m_renderExecute(renderExecute) {}
+
+    virtual ~Command() = default;
 
-    virtual void redo() = 0;
-    virtual void undo() = 0;
     virtual bool execute() = 0;
 
 };
@@ -58,12 +58,10 @@ private:
     MODE m_mode;
     int m_cursorOffset;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 public:
-    SetModeCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo, MODE mode, int offset)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo), m_mode(mode), m_cursorOffset(offset) {}
+    SetModeCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, MODE mode, int offset)
+        : Command(editor, buffer, view, commandQueue, renderExecute), m_mode(mode), m_cursorOffset(offset) {}
 };
 
 class MoveCursorXCommand : public Command
@@ -71,12 +69,10 @@ class MoveCursorXCommand : public Command
 private:
     int deltaX = 0;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 public:
-    MoveCursorXCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo, int x)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo), deltaX(x) {}
+    MoveCursorXCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, int x)
+        : Command(editor, buffer, view, commandQueue, renderExecute), deltaX(x) {}
 };
 
 class MoveCursorYCommand : public Command
@@ -86,78 +82,64 @@ private:
     int m_numberOfDeletedSpaces = 0;
     int m_deltaY = 0;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 public:
-    MoveCursorYCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo, int y)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo), m_deltaY(y) {}
+    MoveCursorYCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, int y)
+        : Command(editor, buffer, view, commandQueue, renderExecute), m_deltaY(y) {}
 };
 
 class UndoCommand : public Command
 {
 private:
-    void redo() override;
-    void undo() override;
     bool execute() override;
 public:
-    UndoCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo) {}
+    UndoCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute)
+        : Command(editor, buffer, view, commandQueue, renderExecute) {}
 };
 
 class RedoCommand : public Command
 {
 private:
-    void redo() override;
-    void undo() override;
     bool execute() override;
 public:
-    RedoCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo) {}
+    RedoCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute)
+        : Command(editor, buffer, view, commandQueue, renderExecute) {}
 };
 
 class CursorFullRightCommand : public Command
 {
 private:
-    void redo() override;
-    void undo() override;
     bool execute() override;
 public:
-    CursorFullRightCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo) {}
+    CursorFullRightCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute)
+        : Command(editor, buffer, view, commandQueue, renderExecute) {}
 };
 
 class CursorFullLeftCommand : public Command
 {
 private:
-    void redo() override;
-    void undo() override;
     bool execute() override;
 public:
-    CursorFullLeftCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo) {}
+    CursorFullLeftCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute)
+        : Command(editor, buffer, view, commandQueue, renderExecute) {}
 };
 
 class CursorFullTopCommand : public Command
 {
 private:
-    void redo() override;
-    void undo() override;
     bool execute() override;
 public:
-    CursorFullTopCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo) {}
+    CursorFullTopCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute)
+        : Command(editor, buffer, view, commandQueue, renderExecute) {}
 };
 
 class CursorFullBottomCommand : public Command
 {
 private:
-    void redo() override;
-    void undo() override;
     bool execute() override;
 public:
-    CursorFullBottomCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo) {}
+    CursorFullBottomCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute)
+        : Command(editor, buffer, view, commandQueue, renderExecute) {}
 };
 
 class InsertCharacterCommand : public Command
@@ -167,12 +149,10 @@ private:
     int m_x = 0;
     int m_y = 0;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 public:
-    InsertCharacterCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo, char character)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo), m_character(character) {}
+    InsertCharacterCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, char character)
+        : Command(editor, buffer, view, commandQueue, renderExecute), m_character(character) {}
 };
 
 class RemoveCharacterNormalCommand : public Command
@@ -184,12 +164,10 @@ private:
 
     bool m_cursorLeft;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 public:
-    RemoveCharacterNormalCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo, bool cursorLeft)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo), m_cursorLeft(cursorLeft) {}
+    RemoveCharacterNormalCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool cursorLeft)
+        : Command(editor, buffer, view, commandQueue, renderExecute), m_cursorLeft(cursorLeft) {}
 };
 
 class RemoveCharacterInsertCommand : public Command
@@ -200,16 +178,12 @@ private:
     int m_y = 0;
 
     std::shared_ptr<LineGapBuffer> m_line = nullptr;
-    int m_deletedWhitespaces = 0;
 
-    bool m_autoDeletedPair = false;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 public:
-    RemoveCharacterInsertCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo) {}
+    RemoveCharacterInsertCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute)
+        : Command(editor, buffer, view, commandQueue, renderExecute) {}
 };
 
 class ReplaceCharacterCommand : public Command
@@ -222,12 +196,10 @@ private:
 
     bool m_headingRight = false;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 public:
-    ReplaceCharacterCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo, char character, bool headingRight)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo), m_character(character), m_headingRight(headingRight) {}
+    ReplaceCharacterCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, char character, bool headingRight)
+        : Command(editor, buffer, view, commandQueue, renderExecute), m_character(character), m_headingRight(headingRight) {}
 };
 
 class InsertLineNormalCommand : public Command
@@ -238,14 +210,11 @@ private:
 
     bool m_down;
 
-    int m_deletedSpaces = 0;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 public:
-    InsertLineNormalCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo, bool down)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo), m_down(down) {}
+    InsertLineNormalCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool down)
+        : Command(editor, buffer, view, commandQueue, renderExecute), m_down(down) {}
 };
 
 class InsertLineInsertCommand : public Command
@@ -254,20 +223,16 @@ private:
     int m_x = 0;
     int m_y = 0;
 
-    int m_deletedSpaces = 0;
 
     std::vector<char> m_characters;
-    size_t m_distanceToEndLine;
     int m_xPositionOfFirstCharacter;
 
     bool m_insidePair = false;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 public:
-    InsertLineInsertCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo) {}
+    InsertLineInsertCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute)
+        : Command(editor, buffer, view, commandQueue, renderExecute) {}
 };
 
 class RemoveLineCommand : public Command
@@ -278,14 +243,11 @@ private:
     int m_x = 0;
     int m_y = 0;
 
-    bool m_deletedOnlyLine = false;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 public:
-    RemoveLineCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo) {}
+    RemoveLineCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute)
+        : Command(editor, buffer, view, commandQueue, renderExecute) {}
 };
 
 class RemoveLineToInsertCommand : public Command
@@ -298,12 +260,10 @@ private:
 
     int m_indexOfFirstNonSpaceCharacter = 0;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 public:
-    RemoveLineToInsertCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo) {}
+    RemoveLineToInsertCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute)
+        : Command(editor, buffer, view, commandQueue, renderExecute) {}
 };
 
 class TabCommand : public Command
@@ -312,12 +272,10 @@ private:
     int m_x = 0;
     int m_y = 0;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 public:
-    TabCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo) {}
+    TabCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute)
+        : Command(editor, buffer, view, commandQueue, renderExecute) {}
 };
 
 class FindCharacterCommand : public Command
@@ -326,12 +284,10 @@ private:
     char m_character;
     bool m_searchForward;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 public:
-    FindCharacterCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo, char character, bool forward)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo), m_character(character), m_searchForward(forward) {}
+    FindCharacterCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, char character, bool forward)
+        : Command(editor, buffer, view, commandQueue, renderExecute), m_character(character), m_searchForward(forward) {}
 };
 
 class JumpCursorCommand : public Command
@@ -339,12 +295,10 @@ class JumpCursorCommand : public Command
 private:
     int m_jumpCode;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 public:
-    JumpCursorCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo, int code)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo), m_jumpCode(code) {}
+    JumpCursorCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, int code)
+        : Command(editor, buffer, view, commandQueue, renderExecute), m_jumpCode(code) {}
 };
 
 class JumpCursorDeleteWordCommand : public Command
@@ -361,12 +315,10 @@ private:
 
     bool m_toInsert = false;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 public:
-    JumpCursorDeleteWordCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo, int code, bool toInsert)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo), m_jumpCode(code), m_toInsert(toInsert) {}
+    JumpCursorDeleteWordCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, int code, bool toInsert)
+        : Command(editor, buffer, view, commandQueue, renderExecute), m_jumpCode(code), m_toInsert(toInsert) {}
 };
 
 class JumpCursorDeletePreviousWordInsertModeCommand : public Command
@@ -379,12 +331,10 @@ private:
 
     int m_targetX;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 public:
-    JumpCursorDeletePreviousWordInsertModeCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo) {}
+    JumpCursorDeletePreviousWordInsertModeCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute)
+        : Command(editor, buffer, view, commandQueue, renderExecute) {}
 };
 
 class RemoveLinesVisualLineModeCommand : public Command
@@ -397,16 +347,12 @@ private:
 
     std::vector<std::shared_ptr<LineGapBuffer>> m_lines;
 
-    size_t m_linesBeforeDeletion = 0;
-    bool m_insertingOnEmptyFile = false;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 
 public:
-    RemoveLinesVisualLineModeCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo) {}
+    RemoveLinesVisualLineModeCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute)
+        : Command(editor, buffer, view, commandQueue, renderExecute) {}
 };
 
 class RemoveLinesVisualModeCommand : public Command
@@ -421,18 +367,15 @@ private:
     int m_lowerBoundX = 0;
     int m_upperBoundX = 0;
 
-    bool m_removedFirstLine = false;
 
     std::vector<char> m_lowerBoundCharacters;
     std::vector<std::shared_ptr<LineGapBuffer>> m_intermediaryLines;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 
 public:
-    RemoveLinesVisualModeCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo) {}
+    RemoveLinesVisualModeCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute)
+        : Command(editor, buffer, view, commandQueue, renderExecute) {}
 };
 
 class RemoveLinesVisualBlockModeCommand : public Command
@@ -452,13 +395,11 @@ private:
 
     std::vector<std::vector<char>> m_lines;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 
 public:
-    RemoveLinesVisualBlockModeCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo) {}
+    RemoveLinesVisualBlockModeCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute)
+        : Command(editor, buffer, view, commandQueue, renderExecute) {}
 };
 
 class TabLineCommand : public Command
@@ -471,13 +412,11 @@ private:
 
     int m_differenceInCharacters = 0;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 
 public:
-    TabLineCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo, bool headingRight)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo), m_headingRight(headingRight) {}
+    TabLineCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool headingRight)
+        : Command(editor, buffer, view, commandQueue, renderExecute), m_headingRight(headingRight) {}
 };
 
 class TabLineVisualCommand : public Command
@@ -493,13 +432,11 @@ private:
 
     std::vector<int> m_differenceInCharacters;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 
 public:
-    TabLineVisualCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo, bool headingRight)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo), m_headingRight(headingRight) {}
+    TabLineVisualCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool headingRight)
+        : Command(editor, buffer, view, commandQueue, renderExecute), m_headingRight(headingRight) {}
 };
 
 class AutocompletePair : public Command
@@ -513,13 +450,11 @@ private:
 
     bool m_autocomplete = true;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 
 public:
-    AutocompletePair(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo, char leftPair)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo), m_leftPair(leftPair) {}
+    AutocompletePair(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, char leftPair)
+        : Command(editor, buffer, view, commandQueue, renderExecute), m_leftPair(leftPair) {}
 };
 
 class PasteCommand : public Command
@@ -537,25 +472,21 @@ private:
     int m_lowerBoundX = 0;
     int m_upperBoundX = 0;
 
-    bool m_insertingOnOnlyEmptyLine = false;
 
     std::vector<char> m_visualRestOfLineAfterCursor;
 
-    int m_extraLinesInserted = 0;
-    std::vector<std::pair<int, int>> m_extraSpacesInserted;
-    bool m_pastedOnEmptyLineAtZero = false;
 
     std::vector<LineGapBuffer> m_yankedLines;
     YANK_TYPE m_yankType = YANK_TYPE::LINE_YANK;
 
+    // Copies of the yanked lines from first on, ready to be inserted into the buffer
+    std::vector<std::shared_ptr<LineGapBuffer>> copyOfYankedLines(size_t first) const;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 
 public:
-    PasteCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo) {}
+    PasteCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute)
+        : Command(editor, buffer, view, commandQueue, renderExecute) {}
 };
 
 class VisualYankCommand : public Command
@@ -563,13 +494,11 @@ class VisualYankCommand : public Command
 private:
     YANK_TYPE m_yankType = YANK_TYPE::LINE_YANK;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 
 public:
-    VisualYankCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo, YANK_TYPE yankType)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo), m_yankType(yankType) {}
+    VisualYankCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, YANK_TYPE yankType)
+        : Command(editor, buffer, view, commandQueue, renderExecute), m_yankType(yankType) {}
 };
 
 class NormalYankLineCommand : public Command
@@ -578,13 +507,11 @@ private:
     int m_direction = 0;
     int m_repetitions = 1;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 
 public:
-    NormalYankLineCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo, int direction, int repetitions)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo), m_direction(direction), m_repetitions(repetitions) {}
+    NormalYankLineCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, int direction, int repetitions)
+        : Command(editor, buffer, view, commandQueue, renderExecute), m_direction(direction), m_repetitions(repetitions) {}
 };
 
 class JumpCursorYankWordCommand : public Command
@@ -593,13 +520,11 @@ private:
     int m_jumpCode = 0;
     int m_repetitions = 1;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 
 public:
-    JumpCursorYankWordCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo, int jumpCode, int repetitions)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo), m_jumpCode(jumpCode), m_repetitions(repetitions) {}
+    JumpCursorYankWordCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, int jumpCode, int repetitions)
+        : Command(editor, buffer, view, commandQueue, renderExecute), m_jumpCode(jumpCode), m_repetitions(repetitions) {}
 };
 
 class JumpCursorYankEndlineCommand : public Command
@@ -607,13 +532,11 @@ class JumpCursorYankEndlineCommand : public Command
 private:
     bool m_right = true;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 
 public:
-    JumpCursorYankEndlineCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo, bool right)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo), m_right(right) {}
+    JumpCursorYankEndlineCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool right)
+        : Command(editor, buffer, view, commandQueue, renderExecute), m_right(right) {}
 };
 
 class QuickVerticalMovementCommand : public Command
@@ -621,13 +544,41 @@ class QuickVerticalMovementCommand : public Command
 private:
     bool m_down = true;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 
 public:
-    QuickVerticalMovementCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo, bool down)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo), m_down(down) {}
+    QuickVerticalMovementCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool down)
+        : Command(editor, buffer, view, commandQueue, renderExecute), m_down(down) {}
+};
+
+class SearchCommand : public Command
+{
+private:
+    bool m_forward;
+
+    bool execute() override;
+
+public:
+    SearchCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool forward)
+        : Command(editor, buffer, view, commandQueue, renderExecute), m_forward(forward) {}
+};
+
+class SubstituteCommand : public Command
+{
+private:
+    std::shared_ptr<const SearchPattern> m_pattern;
+    std::string m_replacement;
+    bool m_global;
+    int m_firstLine;
+    int m_lastLine;
+
+    bool execute() override;
+
+public:
+    SubstituteCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, const std::shared_ptr<const SearchPattern>& pattern,
+        const std::string& replacement, bool global, int firstLine, int lastLine)
+        : Command(editor, buffer, view, commandQueue, renderExecute), m_pattern(pattern), m_replacement(replacement), m_global(global),
+        m_firstLine(firstLine), m_lastLine(lastLine) {}
 };
 
 class ToggleCommentLineCommand : public Command
@@ -640,13 +591,11 @@ private:
 
     bool m_commentedLine = true;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 
 public:
-    ToggleCommentLineCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo) {}
+    ToggleCommentLineCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute)
+        : Command(editor, buffer, view, commandQueue, renderExecute) {}
 };
 
 class ToggleCommentLinesVisualCommand : public Command
@@ -660,18 +609,15 @@ private:
 
     int m_smallestIndexOfFirstNonSpaceCharacter = INT_MAX;
 
-    std::vector<std::pair<int, int>> m_indicesOfFirstCharacters;
     std::vector<int> m_indicesOfCommentsWithNoSpaceAfterSlashes;
 
     bool m_commentLines = false;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 
 public:
-    ToggleCommentLinesVisualCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo) {}
+    ToggleCommentLinesVisualCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute)
+        : Command(editor, buffer, view, commandQueue, renderExecute) {}
 };
 
 class SwapLinesVisualModeCommand : public Command
@@ -682,11 +628,9 @@ private:
 
     bool m_down = true;
 
-    void redo() override;
-    void undo() override;
     bool execute() override;
 
 public:
-    SwapLinesVisualModeCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool renderUndo, bool down)
-        : Command(editor, buffer, view, commandQueue, renderExecute, renderUndo), m_down(down) {}
+    SwapLinesVisualModeCommand(Editor* editor, Buffer* buffer, View* view, CommandQueue* commandQueue, bool renderExecute, bool down)
+        : Command(editor, buffer, view, commandQueue, renderExecute), m_down(down) {}
 };
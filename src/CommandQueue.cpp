@@ -1,82 +1,140 @@
 #include "CommandQueue.h"
+#include "Editor.h"
 
-// TODO: In future, construct with save file to fill command queue
+CommandQueue::CommandQueue(Editor* editor, Buffer* buffer, View* view)
+    : m_undoJournal(maxCommandHistory), m_editor(editor), m_buffer(buffer), m_view(view), m_commandQueue(this)
+{
+    m_buffer->setUndoJournal(&m_undoJournal);
+}
 
-void CommandQueue::undo()
+std::pair<int, int> CommandQueue::cursorPos() const
 {
-    try
+    return m_buffer->getCursorPos();
+}
+
+bool CommandQueue::inInsertMode() const
+{
+    return m_editor->mode() == INSERT_MODE;
+}
+
+void CommandQueue::applyOperation(const UndoOperation& operation, bool inverse)
+{
+    bool inserting = (operation.type == TEXT_INSERTED || operation.type == LINE_INSERTED) != inverse;
+
+    switch (operation.type)
     {
-        if (m_currentCommandCount <= 0)
-        {
-            // std::cout << "Already at oldest change!\n";
-            // TODO: Send signal to command buffer. Maybe have this function return a bool to say if it worked or not? Then we can contextualize the return statement, giving a proper warning
-            return;
-        }
-
-        size_t repetitionNumber = m_commandRepetitions[m_currentCommandCount - 1];
-
-        while (m_currentCommandCount > 0 && m_commandRepetitions[m_currentCommandCount - 1] == repetitionNumber)
-        {
-            if (m_currentCommandCount <= m_commands.size())
-            {
-                if (m_commands[m_currentCommandCount - 1])
-                {
-                    m_commands[m_currentCommandCount - 1]->undo();
-                }
-                else
-                {
-                    std::cerr << "Error: Command at index " << m_currentCommandCount - 1 << " is a nullptr.\n";
-                }
-            }
-            else
-            {
-                std::cerr << "Error: m_currentCommandCount (" << m_currentCommandCount << ") exceeds m_commands size (" << m_commands.size() << ").\n";
-            }
-
-            m_undoesSinceChange++;
-
-            m_currentCommandCount--;
-        }
+        case TEXT_INSERTED:
+        case TEXT_ERASED:
+            if (inserting) { m_buffer->insertText(operation.y, operation.x, operation.text); }
+            else { m_buffer->eraseText(operation.y, operation.x, static_cast<int>(operation.text.size())); }
+            break;
+        case LINE_INSERTED:
+        case LINE_REMOVED:
+            if (inserting) { m_buffer->insertLineAt(operation.y, std::make_shared<LineGapBuffer>(LineGapBuffer::initialBufferSize, std::string(operation.text))); }
+            else { m_buffer->removeLineAt(operation.y); }
+            break;
+        case LINE_MOVED:
+            if (inverse) { m_buffer->moveLine(operation.x, operation.y); }
+            else { m_buffer->moveLine(operation.y, operation.x); }
+            break;
     }
-    catch (const std::out_of_range& e)
+}
+
+void CommandQueue::beginUndoGroup()
+{
+    if (m_undoGroupDepth++ == 0) { m_undoGroupRepetition = m_repetitionCounter++; }
+}
+
+void CommandQueue::endUndoGroup()
+{
+    // Stepped past again so the next batch command, which takes the number before the counter, does not join the group
+    if (--m_undoGroupDepth == 0) { m_repetitionCounter++; }
+}
+
+void CommandQueue::travelTo(int64_t state)
+{
+    std::pair<std::vector<int64_t>, std::vector<int64_t>> path = m_undoJournal.pathTo(state);
+
+    if (path.first.empty() && path.second.empty()) { return; }
+
+    // Replaying must not record itself. However far the state is, only the entries between it and the current one on the
+    // tree are applied, straight to the text, and the screen is drawn once at the end.
+    RenderTransaction renderTransaction(*m_view);
+
+    m_buffer->setUndoJournal(nullptr);
+
+    for (int64_t undone : path.first)
     {
-        endwin();
-        std::cerr << "Out of range error: " << e.what() << '\n';
-        abort();
+        m_undoJournal.forEachOperation(m_undoJournal.indexOf(undone), true, [this](const UndoOperation& operation) { applyOperation(operation, true); });
     }
-    catch (const std::exception& e)
+
+    for (int64_t redone : path.second)
     {
-        endwin();
-        std::cerr << "Exception: " << e.what() << '\n';
-        abort();
+        m_undoJournal.forEachOperation(m_undoJournal.indexOf(redone), false, [this](const UndoOperation& operation) { applyOperation(operation, false); });
     }
-}
 
-void CommandQueue::redo()
-{
-    if (m_undoesSinceChange > 0)
+    m_buffer->setUndoJournal(&m_undoJournal);
+    m_undoJournal.moveTo(state);
+
+    // Where the cursor was after the last change redone, or before the last one undone. Left of it if the change was typed.
+    if (!path.second.empty())
     {
-        size_t repetitionNumber = m_commandRepetitions[m_currentCommandCount];
+        const UndoJournal::Entry& entry = m_undoJournal.entry(m_undoJournal.indexOf(path.second.back()));
 
-        while (m_undoesSinceChange > 0 && m_commandRepetitions[m_currentCommandCount] == repetitionNumber)
-        {
-            m_undoesSinceChange--;
-            m_commands[m_currentCommandCount++]->redo();
-        }
+        m_buffer->moveCursor(entry.cursorAfter.first, entry.cursorAfter.second);
+        m_buffer->shiftCursorX((entry.insertModeAfter) ? -1 : 0);
     }
     else
     {
-        // std::cout << "Already at newest change!\n";
-        // TODO: Same thing here
+        const UndoJournal::Entry& entry = m_undoJournal.entry(m_undoJournal.indexOf(path.first.back()));
+
+        m_buffer->moveCursor(entry.cursorBefore.first, entry.cursorBefore.second);
+        m_buffer->shiftCursorX((entry.insertModeBefore) ? -1 : 0);
     }
+
+    m_view->display();
 }
 
-void CommandQueue::printRepetitionQueue() const
+void CommandQueue::undo()
 {
-    for (auto it : m_commandRepetitions)
+    // History from earlier sessions is only read from disk once undoing reaches it
+    if (m_undoJournal.currentState() == m_undoJournal.rootState() && !m_buffer->loadUndoHistory())
     {
-        std::cout << it << ", ";
+        // TODO: Send signal to command buffer. Maybe have this function return a bool to say if it worked or not? Then we can contextualize the return statement, giving a proper warning
+        return;
     }
 
-    std::cout << std::endl;
+    travelTo(m_undoJournal.parentState(m_undoJournal.currentState()));
+}
+
+void CommandQueue::redo()
+{
+    int64_t redoState = m_undoJournal.redoState(m_undoJournal.currentState());
+
+    if (redoState == UndoJournal::noState || !m_undoJournal.reachable(redoState))
+    {
+        // TODO: Same thing here
+        return;
+    }
+
+    travelTo(redoState);
+}
+
+void CommandQueue::travelChronologically(int64_t steps)
+{
+    int64_t state = m_undoJournal.chronologicalState(steps);
+
+    if (steps < 0 && state == m_undoJournal.rootState() && m_buffer->loadUndoHistory()) { state = m_undoJournal.chronologicalState(steps); }
+
+    travelTo(state);
+}
+
+void CommandQueue::travelInTime(int64_t milliseconds)
+{
+    int64_t time = m_undoJournal.stateTime(m_undoJournal.currentState()) + milliseconds;
+    int64_t state = m_undoJournal.stateAt(time);
+
+    if (milliseconds < 0 && state == m_undoJournal.rootState() && m_buffer->loadUndoHistory()) { state = m_undoJournal.stateAt(time); }
+
+    travelTo(state);
 }
@@ -1,24 +1,26 @@
 #pragma once
 
 #include "Command.h"
+#include "UndoJournal.h"
+#include "View.h"
 
 class Buffer;
-class View;
 
 class CommandQueue
 {
 
 private:
 
-    const size_t m_maxCommandHistory = 50000;
-    size_t m_currentCommandCount = 0;
-    size_t m_undoesSinceChange = 0;
-    std::deque<std::unique_ptr<Command>> m_commands;
+    static inline size_t maxCommandHistory = 50000;
 
+    // Commands sharing a repetition number are undone together. Consecutive batch commands share one.
     size_t m_repetitionCounter = 0;
-    std::deque<size_t> m_commandRepetitions;
 
-    size_t m_consecutiveBatchCommands = 0;
+    // Commands run inside an undo group all take its repetition number, so they are undone as one change
+    int m_undoGroupDepth = 0;
+    size_t m_undoGroupRepetition = 0;
+
+    UndoJournal m_undoJournal;
 
     // POINTERS TO OBJECTS
     Editor* m_editor;
@@ -26,19 +28,36 @@ private:
     View* m_view;
     CommandQueue* m_commandQueue;
 
-public:
+private:
 
-    CommandQueue(Editor* editor, Buffer* buffer, View* view)
-        : m_editor(editor), m_buffer(buffer), m_view(view), m_commandQueue(this)
-    {
-    }
+    std::pair<int, int> cursorPos() const;
+    bool inInsertMode() const;
 
-    void printRepetitionQueue() const;
+    // Applies one recorded operation to the buffer, or its inverse
+    void applyOperation(const UndoOperation& operation, bool inverse);
+
+    // Brings the text to any reachable state of the undo tree
+    void travelTo(int64_t state);
+
+public:
+
+    CommandQueue(Editor* editor, Buffer* buffer, View* view);
 
     void undo();
     void redo();
 
-    size_t currentCommandCount() const { return m_currentCommandCount; }
+    void beginUndoGroup();
+    void endUndoGroup();
+
+    // Through the states in the order they were made, whichever branch they are on, like g- and g+
+    void travelChronologically(int64_t steps);
+
+    // To the state the text was in that long before or after the current state was made
+    void travelInTime(int64_t milliseconds);
+
+    // Changes to the buffer since it was opened, less the ones undone. Equal counts mean equal text.
+    size_t currentCommandCount() const { return m_undoJournal.changeNumber(); }
+    const UndoJournal& undoJournal() const { return m_undoJournal; }
 
     template <typename CommandType, typename ... CommandArgs>
     void execute(bool batch, int repetition, CommandArgs&&... commandArgs)
@@ -47,87 +66,34 @@ public:
 
         if (repetition == 0) { return; }
 
-        bool modifiesBuffer;
+        // Repeated commands draw the screen once, after the last of them
+        RenderTransaction renderTransaction(*m_view, repetition > 1);
 
         for (int repeat = 0; repeat < repetition; repeat++)
         {
-            std::unique_ptr<Command> command;
+            size_t repetitionNumber;
+            bool renderExecute;
 
             if (batch)
             {
                 repetition = 1;
-
-                if (m_consecutiveBatchCommands == 0)
-                {
-                    command = std::make_unique<CommandType>(
-                            m_editor, m_buffer, m_view, m_commandQueue, true, true,
-                            std::forward<CommandArgs>(commandArgs)...);
-                }
-                else
-                {
-                    command = std::make_unique<CommandType>(
-                            m_editor, m_buffer, m_view, m_commandQueue, true, false,
-                            std::forward<CommandArgs>(commandArgs)...);
-
-                    if (m_currentCommandCount >= 1)
-                    {
-                        m_commands[m_currentCommandCount - 1]->m_renderExecute = false;
-                    }
-                }
-
-                m_commandRepetitions[m_currentCommandCount] = --m_repetitionCounter;
-
-                m_consecutiveBatchCommands++;
+                repetitionNumber = --m_repetitionCounter;
+                renderExecute = true;
             }
             else
             {
-                m_consecutiveBatchCommands = 0;
-
-                command = std::make_unique<CommandType>(
-                        m_editor, m_buffer, m_view, m_commandQueue, (repeat == repetition - 1), (repeat == 0),
-                        std::forward<CommandArgs>(commandArgs)...);
+                repetitionNumber = m_repetitionCounter;
+                renderExecute = (repeat == repetition - 1);
             }
 
-            modifiesBuffer = command->execute();
+            if (m_undoGroupDepth > 0) { repetitionNumber = m_undoGroupRepetition; }
 
-            if (modifiesBuffer)
-            {
-                if (m_currentCommandCount < m_maxCommandHistory)
-                {
-                    if (m_currentCommandCount < m_commands.size())
-                    {
-                        m_commands[m_currentCommandCount] = std::move(command);
-                        m_commandRepetitions[m_currentCommandCount] = m_repetitionCounter;
-                    }
-                    else
-                    {
-                        m_commands.push_back(std::move(command));
-                        m_commandRepetitions.push_back(m_repetitionCounter);
-                    }
-
-                    m_currentCommandCount++;
-                }
-                else
-                {
-                    m_commands.push_back(std::move(command));
-                    m_commands.pop_front();
-
-                    m_commandRepetitions.push_back(m_repetitionCounter);
-                    m_commandRepetitions.pop_front();
-                }
-
-                m_undoesSinceChange = 0;
-            }
-            else
-            {
-                if (m_consecutiveBatchCommands > 0 && m_currentCommandCount >= 1)
-                {
-                    m_commands[m_currentCommandCount - 1]->m_renderExecute = true;
-                }
-            }
+            // Commands only live as long as they run. What they change is kept in the undo journal.
+            CommandType command(m_editor, m_buffer, m_view, m_commandQueue, renderExecute, std::forward<CommandArgs>(commandArgs)...);
 
-            // std::cout << "Current command count: " << m_currentCommandCount << '\n';
-            // std::cout << "SIZE OF DEQUE: " << m_commands.size() << '\n';
+            m_undoJournal.beginEntry(cursorPos(), repetitionNumber, inInsertMode());
+            static_cast<Command&>(command).execute();
+            m_undoJournal.commitEntry(cursorPos(), inInsertMode());
         }
 
         m_repetitionCounter++;
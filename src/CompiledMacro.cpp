@@ -0,0 +1,94 @@
+#include "CompiledMacro.h"
+#include "Editor.h"
+
+CompiledMacro::CompiledMacro(Editor* editor, const std::vector<int>& keys, char& findCharacter, bool& searchedForward)
+    : m_editor(editor), m_compiled(true), m_findCharacter(findCharacter), m_searchedForward(searchedForward)
+{
+    // Macros are recorded and replayed from normal mode, so the mode each key is read in follows from the keys alone
+    MODE mode = NORMAL_MODE;
+    std::string repetitionBuffer;
+    int operatorKey = 0;
+    int previousKey = 0;
+
+    for (int key : keys)
+    {
+        const KeyBinding* binding = nullptr;
+        int repetition = 1;
+
+        if (mode == INSERT_MODE)
+        {
+            binding = KeyBindings::insertMode(key);
+
+            // Other keys do nothing in insert mode
+            if (!binding) { previousKey = key; continue; }
+        }
+        else if (operatorKey == d)
+        {
+            binding = KeyBindings::afterDelete(key);
+            repetition = KeyBindings::takeRepetition(repetitionBuffer);
+            operatorKey = 0;
+        }
+        else if (operatorKey)
+        {
+            // The character looked for goes into the find state when the step runs, for ; and , after it
+            KeyContext context = keyContext(key, KeyBindings::takeRepetition(repetitionBuffer), false);
+            bool forward = (operatorKey == f);
+
+            m_steps.push_back([context, forward]() { KeyBindings::findCharacter(context, forward); });
+
+            operatorKey = 0;
+            previousKey = key;
+            continue;
+        }
+        else if (key == d || key == f || key == F)
+        {
+            operatorKey = key;
+            previousKey = key;
+            continue;
+        }
+        else if (KeyBindings::addRepetitionDigit(repetitionBuffer, key))
+        {
+            previousKey = key;
+            continue;
+        }
+        else
+        {
+            binding = KeyBindings::normalMode(key);
+
+            if (binding && binding->takesRepetition) { repetition = KeyBindings::takeRepetition(repetitionBuffer); }
+        }
+
+        // Keys handled by the input controller itself, and modes other than normal and insert, are only replayed
+        if (!binding || (binding->nextMode != NORMAL_MODE && binding->nextMode != INSERT_MODE))
+        {
+            m_compiled = false;
+            m_steps.clear();
+            return;
+        }
+
+        addBinding(*binding, keyContext(key, repetition, key == previousKey));
+
+        mode = binding->nextMode;
+        previousKey = key;
+    }
+
+    // A count or operator left waiting would be taken by the keys after the macro
+    if (!repetitionBuffer.empty() || operatorKey) { m_compiled = false; m_steps.clear(); }
+}
+
+KeyContext CompiledMacro::keyContext(int key, int repetition, bool repeated) const
+{
+    return KeyContext{ &m_editor->commandQueue(), &m_editor->buffer(), key, repetition, repeated, &m_findCharacter, &m_searchedForward };
+}
+
+void CompiledMacro::addBinding(const KeyBinding& binding, const KeyContext& context)
+{
+    KeyBinding::RunFunction run = binding.run;
+
+    m_steps.push_back([run, context]() { run(context); });
+}
+
+void CompiledMacro::run() const
+{
+    for (const std::function<void()>& step : m_steps) { step(); }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "KeyBindings.h"
+
+class Editor;
+
+// A macro resolved once into the commands its keys run, so it can be run many times without going through key dispatch,
+// the input ring or drawing. The commands come from the same key bindings typed keys run. Only macros made of bound keys,
+// counts, d and f or F are compiled. Anything else, like visual or command mode, makes the macro be replayed key by key instead.
+class CompiledMacro
+{
+
+private:
+
+    Editor* m_editor;
+
+    std::vector<std::function<void()>> m_steps;
+    bool m_compiled;
+
+    // Where the last f or F the macro ran leaves the find state of the input controller
+    char& m_findCharacter;
+    bool& m_searchedForward;
+
+    KeyContext keyContext(int key, int repetition, bool repeated) const;
+    void addBinding(const KeyBinding& binding, const KeyContext& context);
+
+public:
+
+    CompiledMacro(Editor* editor, const std::vector<int>& keys, char& findCharacter, bool& searchedForward);
+
+    CompiledMacro(const CompiledMacro&) = delete;
+    CompiledMacro& operator=(const CompiledMacro&) = delete;
+
+    void run() const;
+
+    // Getters
+    bool compiled() const { return m_compiled; }
+    size_t numberOfSteps() const { return m_steps.size(); }
+
+};
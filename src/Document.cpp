@@ -0,0 +1,34 @@
+#include "Document.h"
+
+static std::filesystem::path normalizedPath(const std::string& fileName)
+{
+    std::error_code error;
+    std::filesystem::path path = std::filesystem::weakly_canonical(fileName, error);
+
+    return (error) ? std::filesystem::path(fileName).lexically_normal() : path;
+}
+
+Document::Document(const std::string& fileName, FILE_BACKEND fileBackend)
+    : m_fileName(fileName), m_fileBackend(fileBackend)
+{
+}
+
+void Document::load(Editor* editor, View* view)
+{
+    if (m_buffer) { return; }
+
+    m_buffer = std::make_unique<Buffer>(m_fileName, m_fileBackend);
+    m_commandQueue = std::make_unique<CommandQueue>(editor, m_buffer.get(), view);
+}
+
+size_t Document::heapMemoryUsage() const
+{
+    if (!m_buffer) { return 0; }
+
+    return m_buffer->lineMemoryUsage() + m_commandQueue->undoJournal().memoryUsage();
+}
+
+bool Document::isFile(const std::string& fileName) const
+{
+    return normalizedPath(fileName) == normalizedPath(this->fileName());
+}
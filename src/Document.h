@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Buffer.h"
+#include "CommandQueue.h"
+
+class Editor;
+class View;
+
+// An open file with its undo history and what else belongs to its text. The file is only read in when the document is
+// first shown, and stays loaded afterwards so switching back to it costs nothing.
+class Document
+{
+
+private:
+
+    std::string m_fileName;
+    FILE_BACKEND m_fileBackend;
+
+    std::unique_ptr<Buffer> m_buffer;
+    std::unique_ptr<CommandQueue> m_commandQueue;
+
+    // Change number of the undo journal when the file was last written
+    size_t m_lastSavedCommand = 0;
+
+    // Where the view was scrolled to when the document was last shown
+    int m_linesDown = 0;
+
+public:
+
+    Document(const std::string& fileName, FILE_BACKEND fileBackend);
+
+    Document(const Document&) = delete;
+    Document& operator=(const Document&) = delete;
+
+    void load(Editor* editor, View* view);
+
+    // Whether it has changes that were not written
+    bool modified() const { return m_buffer && m_lastSavedCommand != m_commandQueue->currentCommandCount(); }
+
+    // Bytes of lines and undo history on the heap, and of the mapped file in memory
+    size_t heapMemoryUsage() const;
+    size_t residentMappedBytes() const { return (m_buffer) ? m_buffer->residentMappedBytes() : 0; }
+
+    // Whether fileName names the same file as this document
+    bool isFile(const std::string& fileName) const;
+
+    // SETTERS
+    void setLastSavedCommand(size_t lastSavedCommand) { m_lastSavedCommand = lastSavedCommand; }
+    void setLinesDown(int linesDown) { m_linesDown = linesDown; }
+
+    // GETTERS
+    bool loaded() const { return m_buffer != nullptr; }
+    Buffer& buffer() { return *m_buffer; }
+    const Buffer& buffer() const { return *m_buffer; }
+    CommandQueue& commandQueue() { return *m_commandQueue; }
+    std::string fileName() const { return (m_buffer) ? m_buffer->filePath().string() : m_fileName; }
+    size_t lastSavedCommand() const { return m_lastSavedCommand; }
+    int linesDown() const { return m_linesDown; }
+
+};
@@ -1,9 +1,14 @@
 #include "Editor.h"
 #include "Includes.h"
 
-Editor::Editor(const std::string& fileName)
-    : m_currentMode(MODE::NORMAL_MODE), m_buffer(fileName), m_view((initNcurses(), this), &m_buffer), m_commandQueue(this, &m_buffer, &m_view), m_inputController(this)
+Editor::Editor(const std::vector<std::string>& fileNames, FILE_BACKEND fileBackend)
+    : m_currentMode(MODE::NORMAL_MODE), m_fileBackend(fileBackend), m_view((initNcurses(), this), nullptr), m_inputController(this)
 {
+    for (const std::string& fileName : fileNames) { openDocument(fileName); }
+
+    if (m_documents.empty()) { openDocument("NO_NAME"); }
+
+    showDocument(0);
 }
 
 Editor::~Editor()
@@ -65,6 +70,21 @@ void Editor::initNcurses()
     init_pair(ERROR_MESSAGE_PAIR, INDIAN_RED1_1, GREY11);
 
     init_pair(YANK_HIGHLIGHT_PAIR, COLOR_WHITE, SANDY_BROWN);
+    init_pair(SEARCH_HIGHLIGHT_PAIR, GREY11, LIGHT_GOLDENROD3);
+
+    init_pair(SYNTAX_KEYWORD_PAIR, MEDIUM_PURPLE2_1, GREY11);
+    init_pair(SYNTAX_TYPE_NAME_PAIR, SKY_BLUE3, GREY11);
+    init_pair(SYNTAX_STRING_PAIR, DARK_OLIVE_GREEN3_3, GREY11);
+    init_pair(SYNTAX_NUMBER_PAIR, SANDY_BROWN, GREY11);
+    init_pair(SYNTAX_COMMENT_PAIR, GREY50, GREY11);
+    init_pair(SYNTAX_PREPROCESSOR_PAIR, LIGHT_CORAL, GREY11);
+
+    init_pair(SYNTAX_KEYWORD_CURSOR_LINE_PAIR, MEDIUM_PURPLE2_1, GREY19);
+    init_pair(SYNTAX_TYPE_NAME_CURSOR_LINE_PAIR, SKY_BLUE3, GREY19);
+    init_pair(SYNTAX_STRING_CURSOR_LINE_PAIR, DARK_OLIVE_GREEN3_3, GREY19);
+    init_pair(SYNTAX_NUMBER_CURSOR_LINE_PAIR, SANDY_BROWN, GREY19);
+    init_pair(SYNTAX_COMMENT_CURSOR_LINE_PAIR, GREY50, GREY19);
+    init_pair(SYNTAX_PREPROCESSOR_CURSOR_LINE_PAIR, LIGHT_CORAL, GREY19);
 
     bkgd(COLOR_PAIR(BACKGROUND));
 
@@ -79,7 +99,13 @@ void Editor::run()
 
     while (m_running)
     {
-        m_inputController.handleInput();
+        // Keys typed faster than they are handled, like a paste, are handled together and drawn once
+        RenderTransaction renderTransaction(m_view);
+
+        auto batchStart = std::chrono::steady_clock::now();
+
+        do { m_inputController.handleInput(); }
+        while (m_running && m_inputController.inputPending() && std::chrono::steady_clock::now() - batchStart < std::chrono::milliseconds(INPUT_BATCH_MILLISECONDS));
     }
 }
 
@@ -87,3 +113,94 @@ void Editor::quit()
 {
     m_running = false;
 }
+
+void Editor::runDueTimers()
+{
+    if (m_timerQueue.empty()) { return; }
+
+    m_timerQueue.takeDue(TimerQueue::Clock::now(), m_dueTimers);
+
+    for (TIMER_EVENT event : m_dueTimers)
+    {
+        switch (event)
+        {
+            case YANK_HIGHLIGHT_EXPIRY:
+                m_view.endYankHighlight();
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+size_t Editor::openDocument(const std::string& fileName)
+{
+    for (size_t i = 0; i < m_documents.size(); i++)
+    {
+        if (fileName != "NO_NAME" && m_documents[i]->isFile(fileName)) { return i; }
+    }
+
+    m_documents.push_back(std::make_unique<Document>(fileName, m_fileBackend));
+
+    return m_documents.size() - 1;
+}
+
+void Editor::showDocument(size_t index)
+{
+    Document& previousDocument = *m_documents[m_currentDocument];
+    std::shared_ptr<const SearchPattern> searchPattern;
+
+    if (previousDocument.loaded())
+    {
+        searchPattern = previousDocument.buffer().searchIndex().pattern();
+
+        if (index != m_currentDocument) { previousDocument.setLinesDown(m_view.linesDown()); }
+    }
+
+    size_t previousIndex = m_currentDocument;
+    m_currentDocument = index;
+
+    Document& document = *m_documents[index];
+
+    document.load(this, &m_view);
+
+    // n and N look for the last pattern searched for, whichever file it was searched in
+    if (searchPattern) { document.buffer().setSearchPattern(searchPattern); }
+
+    m_view.setBuffer(&document.buffer(), document.linesDown());
+
+    if (previousIndex != index && previousDocument.loaded() && !m_view.showsBuffer(&previousDocument.buffer()))
+    {
+        previousDocument.buffer().releaseMappedPages();
+    }
+}
+
+void Editor::followActiveViewport(const std::shared_ptr<const SearchPattern>& searchPattern)
+{
+    for (size_t i = 0; i < m_documents.size(); i++)
+    {
+        if (m_documents[i]->loaded() && &m_documents[i]->buffer() == m_view.buffer()) { m_currentDocument = i; }
+    }
+
+    if (searchPattern) { buffer().setSearchPattern(searchPattern); }
+}
+
+void Editor::focusViewport(int id)
+{
+    std::shared_ptr<const SearchPattern> searchPattern = buffer().searchIndex().pattern();
+
+    m_view.focusViewport(id);
+
+    followActiveViewport(searchPattern);
+}
+
+bool Editor::closeViewport()
+{
+    std::shared_ptr<const SearchPattern> searchPattern = buffer().searchIndex().pattern();
+
+    if (!m_view.closeViewport()) { return false; }
+
+    followActiveViewport(searchPattern);
+
+    return true;
+}
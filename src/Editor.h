@@ -1,10 +1,10 @@
 #pragma once
 
-#include "CommandQueue.h"
-#include "Buffer.h"
+#include "Document.h"
 #include "InputController.h"
 #include "View.h"
 #include "Clipboard.h"
+#include "TimerQueue.h"
 #include <string>
 
 class Editor
@@ -15,35 +15,65 @@ private:
     bool m_running = true;
 
     MODE m_currentMode;
-    Buffer m_buffer;
+    FILE_BACKEND m_fileBackend;
+
+    // Open files in the order they were opened, each read in the first time it is shown
+    std::vector<std::unique_ptr<Document>> m_documents;
+    size_t m_currentDocument = 0;
+
     View m_view;
-    CommandQueue m_commandQueue;
     InputController m_inputController;
     Clipboard m_clipBoard;
 
+    TimerQueue m_timerQueue;
+    std::vector<TIMER_EVENT> m_dueTimers;
+
     std::vector<std::string> m_benchmarkMessages;
 
 private:
 
     void initNcurses();
 
+    // Makes the document of the buffer the active viewport shows the current one
+    void followActiveViewport(const std::shared_ptr<const SearchPattern>& searchPattern);
+
 public:
 
-    Editor(const std::string& fileName);
+    Editor(const std::vector<std::string>& fileNames, FILE_BACKEND fileBackend = GAP_BUFFER_BACKEND);
     ~Editor();
 
     void run();
     void quit();
 
+    // Handles the deferred events whose time has come. The input loop calls this while it waits on keys, so they are
+    // handled on the same thread as everything else that draws.
+    void runDueTimers();
+
+    // Index of the document of fileName, which is added to the list without being read in if it is not open yet
+    size_t openDocument(const std::string& fileName);
+
+    // Shows the document at index, reading its file in if it was not yet. The pages of the mapped file of the document
+    // shown before are given back until it is shown again.
+    void showDocument(size_t index);
+
+    // Moves to another viewport, or closes the active one, making the document it shows the current one. Closing the
+    // last viewport fails.
+    void focusViewport(int id);
+    bool closeViewport();
+
     // SETTERS
     void setMode(const MODE mode) { m_currentMode = mode ; }
 
     // GETTERS
-    CommandQueue& commandQueue() { return m_commandQueue ; }
-    Buffer& buffer() { return m_buffer ; }
+    CommandQueue& commandQueue() { return m_documents[m_currentDocument]->commandQueue() ; }
+    Buffer& buffer() { return m_documents[m_currentDocument]->buffer() ; }
+    Document& document() { return *m_documents[m_currentDocument]; }
+    const std::vector<std::unique_ptr<Document>>& documents() const { return m_documents; }
+    size_t currentDocument() const { return m_currentDocument; }
     const InputController& inputController() { return m_inputController; }
     View& view() { return m_view; }
     MODE mode() const { return m_currentMode ; }
     Clipboard& clipBoard() { return m_clipBoard; }
+    TimerQueue& timerQueue() { return m_timerQueue; }
 
 };
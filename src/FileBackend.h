@@ -0,0 +1,37 @@
+#pragma once
+
+#include "LineGapBuffer.h"
+
+enum FILE_BACKEND
+{
+    GAP_BUFFER_BACKEND,
+    ROPE_BACKEND,
+};
+
+// Line storage behind a Buffer. Lines are addressed by their index in the file.
+class FileBackend
+{
+
+public:
+
+    virtual ~FileBackend() = default;
+
+    virtual void insertLine(size_t index, const std::shared_ptr<LineGapBuffer>& line) = 0;
+    virtual std::shared_ptr<LineGapBuffer> deleteLine(size_t index) = 0;
+    virtual void replaceLine(size_t index, const std::shared_ptr<LineGapBuffer>& line) = 0;
+
+    // Range versions of the above, which shift the lines after the range once for the whole range instead of once per line
+    virtual void insertLines(size_t index, const std::vector<std::shared_ptr<LineGapBuffer>>& insertedLines) = 0;
+    virtual std::vector<std::shared_ptr<LineGapBuffer>> deleteLines(size_t index, size_t count) = 0;
+
+    // Visits the lines from first to last in order, each through a reference it may replace the line with
+    virtual void transformLines(size_t first, size_t last, const std::function<void(std::shared_ptr<LineGapBuffer>&)>& transform) = 0;
+
+    // Visits every line in order, which is cheaper than indexing each one
+    virtual void forEachLine(const std::function<void(const std::shared_ptr<LineGapBuffer>&)>& visit) const = 0;
+
+    virtual size_t numberOfLines() const = 0;
+
+    virtual const std::shared_ptr<LineGapBuffer>& operator [](size_t index) const = 0;
+
+};
@@ -9,6 +9,11 @@ FileGapBuffer::FileGapBuffer(int initialSize)
 {
 }
 
+FileGapBuffer::FileGapBuffer(std::vector<std::shared_ptr<LineGapBuffer>>&& loadedLines)
+    : m_buffer(std::move(loadedLines)), m_preGapIndex(0), m_postGapIndex(0), m_bufferSize(m_buffer.size())
+{
+}
+
 void FileGapBuffer::up()
 {
     if (m_preGapIndex != 0)
@@ -29,8 +34,34 @@ void FileGapBuffer::down()
     }
 }
 
-void FileGapBuffer::insertLine(const std::shared_ptr<LineGapBuffer>& line)
+void FileGapBuffer::moveGap(size_t index)
 {
+    index = std::min(index, numberOfLines());
+
+    if (index < m_preGapIndex)
+    {
+        size_t distance = m_preGapIndex - index;
+
+        std::move_backward(m_buffer.begin() + index, m_buffer.begin() + m_preGapIndex, m_buffer.begin() + m_postGapIndex);
+
+        m_preGapIndex -= distance;
+        m_postGapIndex -= distance;
+    }
+    else if (index > m_preGapIndex)
+    {
+        size_t distance = index - m_preGapIndex;
+
+        std::move(m_buffer.begin() + m_postGapIndex, m_buffer.begin() + m_postGapIndex + distance, m_buffer.begin() + m_preGapIndex);
+
+        m_preGapIndex += distance;
+        m_postGapIndex += distance;
+    }
+}
+
+void FileGapBuffer::insertLine(size_t index, const std::shared_ptr<LineGapBuffer>& line)
+{
+    moveGap(index);
+
     if (m_preGapIndex == m_postGapIndex)
     {
         grow();
@@ -46,11 +77,13 @@ void FileGapBuffer::insertLine(const std::shared_ptr<LineGapBuffer>& line)
     m_preGapIndex++;
 }
 
-std::shared_ptr<LineGapBuffer> FileGapBuffer::deleteLine()
+std::shared_ptr<LineGapBuffer> FileGapBuffer::deleteLine(size_t index)
 {
+    moveGap(index + 1);
+
     if (m_preGapIndex > 0)
     {
-        return m_buffer[--m_preGapIndex];
+        return std::move(m_buffer[--m_preGapIndex]);
     }
     else
     {
@@ -58,77 +91,80 @@ std::shared_ptr<LineGapBuffer> FileGapBuffer::deleteLine()
     }
 }
 
-void FileGapBuffer::grow()
+void FileGapBuffer::replaceLine(size_t index, const std::shared_ptr<LineGapBuffer>& line)
 {
-    int newSize = m_bufferSize * 2;
+    if (index >= numberOfLines()) { return; }
 
-    std::vector<std::shared_ptr<LineGapBuffer>> newBuffer(newSize);
+    m_buffer[(index < m_preGapIndex) ? index : index + m_postGapIndex - m_preGapIndex] = line;
+}
 
-    std::move(m_buffer.begin(), m_buffer.begin() + m_preGapIndex, newBuffer.begin());
-    std::move(m_buffer.begin() + m_preGapIndex, m_buffer.end(), newBuffer.begin() + newSize / 2 + m_preGapIndex);
+void FileGapBuffer::insertLines(size_t index, const std::vector<std::shared_ptr<LineGapBuffer>>& insertedLines)
+{
+    moveGap(index);
 
-    m_postGapIndex = newSize / 2 + m_preGapIndex;
+    if (m_postGapIndex - m_preGapIndex < insertedLines.size()) { grow(insertedLines.size()); }
 
-    m_buffer = std::move(newBuffer);
-    m_bufferSize = newSize;
+    std::copy(insertedLines.begin(), insertedLines.end(), m_buffer.begin() + m_preGapIndex);
+    m_preGapIndex += insertedLines.size();
 }
 
-void FileGapBuffer::swapLinesInRange(bool right, int start, int end)
+std::vector<std::shared_ptr<LineGapBuffer>> FileGapBuffer::deleteLines(size_t index, size_t count)
 {
-    if (static_cast<size_t>(right) && static_cast<size_t>(end) == m_bufferSize - m_postGapIndex + m_preGapIndex - 1) { return; }
-    if (!right && start == 0) { return; }
-    if (end - start < 0) { return; }
+    moveGap(index);
 
-    size_t absoluteStart = (static_cast<size_t>(start) < m_preGapIndex) ? static_cast<size_t>(start) : static_cast<size_t>(start) + m_postGapIndex - m_preGapIndex;
-    size_t absoluteEnd = (static_cast<size_t>(end) < m_preGapIndex) ? static_cast<size_t>(start) : static_cast<size_t>(start) + m_postGapIndex - m_preGapIndex;
+    count = std::min(count, m_bufferSize - m_postGapIndex);
 
-    // MOve up first
-    if (!right)
-    {
-        if (absoluteStart < m_preGapIndex && absoluteEnd < m_preGapIndex)
-        {
-            const std::shared_ptr<LineGapBuffer>& lineLeftOfStart = m_buffer[absoluteStart - 1];
+    std::vector<std::shared_ptr<LineGapBuffer>> deletedLines(std::make_move_iterator(m_buffer.begin() + m_postGapIndex),
+        std::make_move_iterator(m_buffer.begin() + m_postGapIndex + count));
+    m_postGapIndex += count;
 
-            std::move(m_buffer.begin() + absoluteStart, m_buffer.begin() + absoluteEnd, m_buffer.begin() + absoluteStart - 1);
-            m_buffer[absoluteEnd] = std::move(lineLeftOfStart);
-        }
-        else if (absoluteStart < m_preGapIndex && absoluteEnd >= m_postGapIndex)
-        {
-            if (absoluteEnd < m_postGapIndex) { endwin(); exit(1); }
+    return deletedLines;
+}
 
-            const std::shared_ptr<LineGapBuffer>& lineLeftOfStart = m_buffer[absoluteStart - 1];
+void FileGapBuffer::transformLines(size_t first, size_t last, const std::function<void(std::shared_ptr<LineGapBuffer>&)>& transform)
+{
+    if (first >= numberOfLines()) { return; }
 
-            size_t numberOfLinesBeforePreGapIndex = m_preGapIndex - absoluteStart;
+    last = std::min(last, numberOfLines() - 1);
 
-            std::move(m_buffer.begin() + absoluteStart, m_buffer.begin() + numberOfLinesBeforePreGapIndex, m_buffer.begin() + absoluteStart - 1);
+    // The gap stays where it is, the lines are visited on either side of it
+    for (size_t index = first; index <= last && index < m_preGapIndex; index++)
+    {
+        transform(m_buffer[index]);
+    }
 
-            m_buffer[m_preGapIndex - 1] = std::move(m_buffer[m_postGapIndex]);
+    for (size_t index = std::max(first, m_preGapIndex); index <= last; index++)
+    {
+        transform(m_buffer[index + m_postGapIndex - m_preGapIndex]);
+    }
+}
 
-            std::move(m_buffer.begin() + m_postGapIndex + 1, m_buffer.begin() + absoluteEnd, m_buffer.begin() + m_postGapIndex);
+void FileGapBuffer::grow(size_t minimumGapSize)
+{
+    size_t newSize = std::max(m_bufferSize * 2, numberOfLines() + minimumGapSize);
+    size_t linesAfterGap = m_bufferSize - m_postGapIndex;
 
-            m_buffer[absoluteEnd] = std::move(lineLeftOfStart);
-        }
-        else
-        {
-            if (absoluteStart == m_postGapIndex)
-            {
-                // const std::shared_ptr<LineGapBuffer>& lineLeftOfStart = m_buffer[m_preGapIndex - 1];
-                const std::shared_ptr<LineGapBuffer>& lineLeftOfStart = m_buffer[m_postGapIndex];
+    std::vector<std::shared_ptr<LineGapBuffer>> newBuffer(newSize);
+
+    std::move(m_buffer.begin(), m_buffer.begin() + m_preGapIndex, newBuffer.begin());
+    std::move(m_buffer.begin() + m_postGapIndex, m_buffer.end(), newBuffer.end() - linesAfterGap);
 
-                m_buffer[m_preGapIndex - 1] = std::move(m_buffer[m_postGapIndex]);
+    m_postGapIndex = newSize - linesAfterGap;
 
-                std::move(m_buffer.begin() + absoluteStart + 1, m_buffer.begin() + absoluteEnd, m_buffer.begin() + absoluteStart);
+    m_buffer = std::move(newBuffer);
+    m_bufferSize = newSize;
+}
 
-                m_buffer[absoluteEnd] = std::move(lineLeftOfStart);
-            }
-            else
-            {
-                const std::shared_ptr<LineGapBuffer>& lineLeftOfStart = m_buffer[absoluteStart - 1];
+void FileGapBuffer::forEachLine(const std::function<void(const std::shared_ptr<LineGapBuffer>&)>& visit) const
+{
+    for (size_t index = 0; index < m_preGapIndex; index++)
+    {
+        visit(m_buffer[index]);
+    }
 
-                std::move(m_buffer.begin() + absoluteStart, m_buffer.begin() + absoluteEnd, m_buffer.begin() + absoluteStart - 1);
-                m_buffer[absoluteEnd] = std::move(lineLeftOfStart);
-            }
-        }
+    for (size_t index = m_postGapIndex; index < m_bufferSize; index++)
+    {
+        visit(m_buffer[index]);
     }
 }
 
@@ -1,6 +1,8 @@
-#include "LineGapBuffer.h"
+#pragma once
 
-class FileGapBuffer
+#include "FileBackend.h"
+
+class FileGapBuffer : public FileBackend
 {
 
 private:
@@ -10,27 +12,39 @@ private:
     size_t m_postGapIndex;
     size_t m_bufferSize;
 
+private:
+
+    // Relocates the gap in front of index with a single bulk move
+    void moveGap(size_t index);
+
 public:
 
     FileGapBuffer(int initialSize);
+    FileGapBuffer(std::vector<std::shared_ptr<LineGapBuffer>>&& loadedLines);
 
     void up();
     void down();
 
-    void insertLine(const std::shared_ptr<LineGapBuffer>& line);
-    std::shared_ptr<LineGapBuffer> deleteLine();
+    void insertLine(size_t index, const std::shared_ptr<LineGapBuffer>& line) override;
+    std::shared_ptr<LineGapBuffer> deleteLine(size_t index) override;
+    void replaceLine(size_t index, const std::shared_ptr<LineGapBuffer>& line) override;
+
+    void insertLines(size_t index, const std::vector<std::shared_ptr<LineGapBuffer>>& insertedLines) override;
+    std::vector<std::shared_ptr<LineGapBuffer>> deleteLines(size_t index, size_t count) override;
+    void transformLines(size_t first, size_t last, const std::function<void(std::shared_ptr<LineGapBuffer>&)>& transform) override;
 
-    void grow();
+    // Doubles the buffer, or grows it further if that still leaves the gap smaller than minimumGapSize
+    void grow(size_t minimumGapSize = 1);
 
-    void swapLinesInRange(bool down, int start, int end);
+    void forEachLine(const std::function<void(const std::shared_ptr<LineGapBuffer>&)>& visit) const override;
 
     // Getters
     const std::vector<std::shared_ptr<LineGapBuffer>>& getVectorOfSharedPtrsToLineGapBuffers() const { return m_buffer; }
     size_t preGapIndex() const { return m_preGapIndex; }
     size_t postGapIndex() const { return m_postGapIndex; }
     size_t bufferSize() const { return m_bufferSize; }
-    size_t numberOfLines() const { return m_bufferSize - (m_postGapIndex - m_preGapIndex); }
+    size_t numberOfLines() const override { return m_bufferSize - (m_postGapIndex - m_preGapIndex); }
 
-    const std::shared_ptr<LineGapBuffer>& operator [](size_t index) const;
+    const std::shared_ptr<LineGapBuffer>& operator [](size_t index) const override;
 
 };
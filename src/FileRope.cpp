@@ -0,0 +1,252 @@
+#include "FileRope.h"
+
+FileRope::FileRope(std::vector<std::shared_ptr<LineGapBuffer>>&& loadedLines)
+{
+    m_root = build(loadedLines);
+}
+
+std::unique_ptr<FileRope::Node> FileRope::build(const std::vector<std::shared_ptr<LineGapBuffer>>& treeLines)
+{
+    // Builds the treap in linear time by keeping its right spine on a stack. Every new line becomes the rightmost node
+    // and adopts the part of the spine with a lower priority as its left subtree.
+    std::unique_ptr<Node> root;
+    std::vector<Node*> rightSpine;
+
+    for (const std::shared_ptr<LineGapBuffer>& line : treeLines)
+    {
+        std::unique_ptr<Node> node = createNode(line);
+
+        bool adoptsSubtree = false;
+        while (!rightSpine.empty() && rightSpine.back()->priority < node->priority)
+        {
+            rightSpine.pop_back();
+            adoptsSubtree = true;
+        }
+
+        std::unique_ptr<Node>& parentLink = (rightSpine.empty()) ? root : rightSpine.back()->right;
+
+        if (adoptsSubtree) { node->left = std::move(parentLink); }
+
+        rightSpine.push_back(node.get());
+        parentLink = std::move(node);
+    }
+
+    updateSizes(root.get());
+
+    return root;
+}
+
+void FileRope::updateSize(Node* node)
+{
+    node->size = subtreeSize(node->left) + subtreeSize(node->right) + 1;
+}
+
+void FileRope::updateSizes(Node* node)
+{
+    if (!node) { return; }
+
+    updateSizes(node->left.get());
+    updateSizes(node->right.get());
+    updateSize(node);
+}
+
+void FileRope::split(std::unique_ptr<Node> node, size_t index, std::unique_ptr<Node>& left, std::unique_ptr<Node>& right)
+{
+    if (!node)
+    {
+        left.reset();
+        right.reset();
+        return;
+    }
+
+    if (subtreeSize(node->left) < index)
+    {
+        split(std::move(node->right), index - subtreeSize(node->left) - 1, node->right, right);
+        updateSize(node.get());
+        left = std::move(node);
+    }
+    else
+    {
+        split(std::move(node->left), index, left, node->left);
+        updateSize(node.get());
+        right = std::move(node);
+    }
+}
+
+std::unique_ptr<FileRope::Node> FileRope::merge(std::unique_ptr<Node> left, std::unique_ptr<Node> right)
+{
+    if (!left) { return right; }
+    if (!right) { return left; }
+
+    if (left->priority > right->priority)
+    {
+        left->right = merge(std::move(left->right), std::move(right));
+        updateSize(left.get());
+        return left;
+    }
+    else
+    {
+        right->left = merge(std::move(left), std::move(right->left));
+        updateSize(right.get());
+        return right;
+    }
+}
+
+std::unique_ptr<FileRope::Node> FileRope::createNode(const std::shared_ptr<LineGapBuffer>& line)
+{
+    return std::make_unique<Node>(Node{ line, nullptr, nullptr, static_cast<uint32_t>(m_randomGenerator()), 1 });
+}
+
+void FileRope::insertLine(size_t index, const std::shared_ptr<LineGapBuffer>& line)
+{
+    std::unique_ptr<Node> left;
+    std::unique_ptr<Node> right;
+
+    split(std::move(m_root), index, left, right);
+
+    m_root = merge(merge(std::move(left), createNode(line)), std::move(right));
+}
+
+std::shared_ptr<LineGapBuffer> FileRope::deleteLine(size_t index)
+{
+    if (index >= numberOfLines()) { return std::shared_ptr<LineGapBuffer>(); }
+
+    std::unique_ptr<Node> left;
+    std::unique_ptr<Node> deleted;
+    std::unique_ptr<Node> right;
+
+    split(std::move(m_root), index, left, right);
+    split(std::move(right), 1, deleted, right);
+
+    m_root = merge(std::move(left), std::move(right));
+
+    return std::move(deleted->line);
+}
+
+void FileRope::replaceLine(size_t index, const std::shared_ptr<LineGapBuffer>& line)
+{
+    if (index >= numberOfLines()) { return; }
+
+    Node* node = m_root.get();
+
+    while (true)
+    {
+        size_t leftSize = subtreeSize(node->left);
+
+        if (index < leftSize)
+        {
+            node = node->left.get();
+        }
+        else if (index == leftSize)
+        {
+            node->line = line;
+            return;
+        }
+        else
+        {
+            index -= leftSize + 1;
+            node = node->right.get();
+        }
+    }
+}
+
+void FileRope::insertLines(size_t index, const std::vector<std::shared_ptr<LineGapBuffer>>& insertedLines)
+{
+    std::unique_ptr<Node> left;
+    std::unique_ptr<Node> right;
+
+    split(std::move(m_root), index, left, right);
+
+    m_root = merge(merge(std::move(left), build(insertedLines)), std::move(right));
+}
+
+std::vector<std::shared_ptr<LineGapBuffer>> FileRope::deleteLines(size_t index, size_t count)
+{
+    std::unique_ptr<Node> left;
+    std::unique_ptr<Node> deleted;
+    std::unique_ptr<Node> right;
+
+    split(std::move(m_root), index, left, right);
+    split(std::move(right), count, deleted, right);
+
+    m_root = merge(std::move(left), std::move(right));
+
+    std::vector<std::shared_ptr<LineGapBuffer>> deletedLines;
+    deletedLines.reserve(subtreeSize(deleted));
+
+    transformLines(deleted.get(), [&deletedLines](std::shared_ptr<LineGapBuffer>& line) { deletedLines.push_back(std::move(line)); });
+
+    return deletedLines;
+}
+
+void FileRope::transformLines(Node* node, const std::function<void(std::shared_ptr<LineGapBuffer>&)>& transform)
+{
+    if (!node) { return; }
+
+    transformLines(node->left.get(), transform);
+    transform(node->line);
+    transformLines(node->right.get(), transform);
+}
+
+void FileRope::transformLines(size_t first, size_t last, const std::function<void(std::shared_ptr<LineGapBuffer>&)>& transform)
+{
+    if (first > last) { return; }
+
+    std::unique_ptr<Node> left;
+    std::unique_ptr<Node> range;
+    std::unique_ptr<Node> right;
+
+    split(std::move(m_root), first, left, right);
+    split(std::move(right), last - first + 1, range, right);
+
+    transformLines(range.get(), transform);
+
+    m_root = merge(merge(std::move(left), std::move(range)), std::move(right));
+}
+
+void FileRope::forEachLine(const Node* node, const std::function<void(const std::shared_ptr<LineGapBuffer>&)>& visit)
+{
+    if (!node) { return; }
+
+    forEachLine(node->left.get(), visit);
+    visit(node->line);
+    forEachLine(node->right.get(), visit);
+}
+
+void FileRope::forEachLine(const std::function<void(const std::shared_ptr<LineGapBuffer>&)>& visit) const
+{
+    forEachLine(m_root.get(), visit);
+}
+
+const std::shared_ptr<LineGapBuffer>& FileRope::operator [](size_t index) const
+{
+    if (index >= numberOfLines())
+    {
+        endwin();
+        std::cerr << "Index out of bounds: " << index << '\n';
+        std::cout << "File Rope Info:\n\t" << "Num lines: " << numberOfLines() << "\n";
+
+        abort();
+    }
+
+    const Node* node = m_root.get();
+
+    while (true)
+    {
+        size_t leftSize = subtreeSize(node->left);
+
+        if (index < leftSize)
+        {
+            node = node->left.get();
+        }
+        else if (index == leftSize)
+        {
+            return node->line;
+        }
+        else
+        {
+            index -= leftSize + 1;
+            node = node->right.get();
+        }
+    }
+}
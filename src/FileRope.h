@@ -0,0 +1,60 @@
+#pragma once
+
+#include "FileBackend.h"
+
+// Lines kept in an implicit treap: every node stores the size of its subtree, so indexing, inserting and deleting
+// anywhere in the file are O(log n) instead of moving a gap across the lines in between.
+class FileRope : public FileBackend
+{
+
+private:
+
+    struct Node
+    {
+        std::shared_ptr<LineGapBuffer> line;
+        std::unique_ptr<Node> left;
+        std::unique_ptr<Node> right;
+        uint32_t priority;
+        size_t size;
+    };
+
+    std::unique_ptr<Node> m_root;
+    std::mt19937 m_randomGenerator;
+
+private:
+
+    static size_t subtreeSize(const std::unique_ptr<Node>& node) { return node ? node->size : 0; }
+    static void updateSize(Node* node);
+    static void updateSizes(Node* node);
+
+    // Splits node into the first index lines and the rest
+    static void split(std::unique_ptr<Node> node, size_t index, std::unique_ptr<Node>& left, std::unique_ptr<Node>& right);
+    static std::unique_ptr<Node> merge(std::unique_ptr<Node> left, std::unique_ptr<Node> right);
+
+    std::unique_ptr<Node> createNode(const std::shared_ptr<LineGapBuffer>& line);
+    std::unique_ptr<Node> build(const std::vector<std::shared_ptr<LineGapBuffer>>& treeLines);
+
+    static void transformLines(Node* node, const std::function<void(std::shared_ptr<LineGapBuffer>&)>& transform);
+
+    static void forEachLine(const Node* node, const std::function<void(const std::shared_ptr<LineGapBuffer>&)>& visit);
+
+public:
+
+    FileRope(std::vector<std::shared_ptr<LineGapBuffer>>&& loadedLines);
+
+    void insertLine(size_t index, const std::shared_ptr<LineGapBuffer>& line) override;
+    std::shared_ptr<LineGapBuffer> deleteLine(size_t index) override;
+    void replaceLine(size_t index, const std::shared_ptr<LineGapBuffer>& line) override;
+
+    void insertLines(size_t index, const std::vector<std::shared_ptr<LineGapBuffer>>& insertedLines) override;
+    std::vector<std::shared_ptr<LineGapBuffer>> deleteLines(size_t index, size_t count) override;
+    void transformLines(size_t first, size_t last, const std::function<void(std::shared_ptr<LineGapBuffer>&)>& transform) override;
+
+    void forEachLine(const std::function<void(const std::shared_ptr<LineGapBuffer>&)>& visit) const override;
+
+    // Getters
+    size_t numberOfLines() const override { return subtreeSize(m_root); }
+
+    const std::shared_ptr<LineGapBuffer>& operator [](size_t index) const override;
+
+};
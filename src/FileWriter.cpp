@@ -0,0 +1,236 @@
+#include "FileWriter.h"
+
+#include <fcntl.h>
+#include <grp.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Read while the process is still single threaded, as reading it means setting it for a moment
+static const mode_t processUmask = []()
+{
+    mode_t mask = umask(0);
+    umask(mask);
+    return mask;
+}();
+
+// Saving through a symlink replaces the file it points to, not the link itself
+static std::filesystem::path resolveSymlink(const std::filesystem::path& path)
+{
+    std::error_code errorCode;
+
+    if (std::filesystem::is_symlink(path, errorCode))
+    {
+        std::filesystem::path resolvedPath = std::filesystem::canonical(path, errorCode);
+        if (!errorCode) { return resolvedPath; }
+    }
+
+    return path;
+}
+
+static std::filesystem::path directoryOf(const std::filesystem::path& path)
+{
+    std::filesystem::path directory = path.parent_path();
+    return (directory.empty()) ? "." : directory;
+}
+
+static bool inGroup(gid_t group)
+{
+    if (group == getegid()) { return true; }
+
+    std::vector<gid_t> groups(std::max(0, getgroups(0, nullptr)));
+    groups.resize(std::max(0, getgroups(static_cast<int>(groups.size()), groups.data())));
+
+    return std::find(groups.begin(), groups.end(), group) != groups.end();
+}
+
+// Whether a new file in place of one with targetStatus could be given its owner and group
+static bool canKeepOwnership(const struct stat& targetStatus)
+{
+    if (geteuid() == 0) { return true; }
+
+    return targetStatus.st_uid == geteuid() && inGroup(targetStatus.st_gid);
+}
+
+bool FileWriter::writesInPlace(const std::filesystem::path& targetPath)
+{
+    std::filesystem::path resolvedPath = resolveSymlink(targetPath);
+
+    struct stat targetStatus;
+
+    if (stat(resolvedPath.c_str(), &targetStatus) == 0 && (targetStatus.st_nlink > 1 || !canKeepOwnership(targetStatus))) { return true; }
+
+    return faccessat(AT_FDCWD, directoryOf(resolvedPath).c_str(), W_OK, AT_EACCESS) != 0 && (errno == EACCES || errno == EROFS);
+}
+
+FileWriter::FileWriter(const std::filesystem::path& targetPath, bool mayWriteInPlace)
+    : m_targetPath(resolveSymlink(targetPath)), m_fileDescriptor(-1), m_mayWriteInPlace(mayWriteInPlace), m_inPlace(false), m_buffer(writeBufferSize), m_bufferedBytes(0), m_bytesWritten(0)
+{
+    if (writesInPlace(m_targetPath))
+    {
+        openInPlace("Cannot replace " + m_targetPath.string() + " without losing its other links or its owner");
+        return;
+    }
+
+    std::string temporaryPath = (directoryOf(m_targetPath) / ("." + m_targetPath.filename().string() + ".razz-save-XXXXXX")).string();
+
+    m_fileDescriptor = mkstemp(temporaryPath.data());
+
+    if (m_fileDescriptor == -1)
+    {
+        if (errno == EACCES || errno == EROFS) { openInPlace("Cannot create a temporary file next to " + m_targetPath.string() + ": " + strerror(errno)); }
+        else { fail("Cannot create a temporary file next to " + m_targetPath.string()); }
+
+        return;
+    }
+
+    m_temporaryPath = temporaryPath;
+
+    // mkstemp creates the file as 0600, so carry over the permissions of the file being replaced or the ones a new file would get
+    struct stat targetStatus;
+    mode_t mode = 0666 & ~processUmask;
+
+    if (stat(m_targetPath.c_str(), &targetStatus) == 0)
+    {
+        mode = targetStatus.st_mode & 07777;
+
+        // A replacement that cannot be given the owner of the file is dropped, and the file is overwritten instead
+        if (fchown(m_fileDescriptor, targetStatus.st_uid, targetStatus.st_gid) != 0)
+        {
+            std::string whyNotReplaced = "Cannot give the owner of " + m_targetPath.string() + " to its replacement: " + strerror(errno);
+
+            close(m_fileDescriptor);
+            unlink(m_temporaryPath.c_str());
+            m_temporaryPath.clear();
+
+            openInPlace(whyNotReplaced);
+            return;
+        }
+    }
+
+    if (fchmod(m_fileDescriptor, mode) != 0) { fail("Cannot set the permissions of " + m_temporaryPath.string()); }
+}
+
+FileWriter::~FileWriter()
+{
+    if (m_fileDescriptor != -1) { close(m_fileDescriptor); }
+
+    // Anything left at the temporary path belongs to an aborted save
+    if (!m_temporaryPath.empty()) { unlink(m_temporaryPath.c_str()); }
+}
+
+void FileWriter::openInPlace(const std::string& whyNotReplaced)
+{
+    if (!m_mayWriteInPlace)
+    {
+        m_error = whyNotReplaced + ", and it cannot be overwritten while its text is still mapped";
+        return;
+    }
+
+    m_inPlace = true;
+    m_fileDescriptor = open(m_targetPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+
+    if (m_fileDescriptor == -1) { fail("Cannot open " + m_targetPath.string()); }
+}
+
+void FileWriter::fail(const std::string& operation)
+{
+    if (m_error.empty()) { m_error = operation + ": " + strerror(errno); }
+}
+
+void FileWriter::writeFully(const char* data, size_t size)
+{
+    size_t written = 0;
+
+    while (written < size && !failed())
+    {
+        ssize_t result = ::write(m_fileDescriptor, data + written, size - written);
+
+        if (result == -1)
+        {
+            if (errno != EINTR) { fail("Cannot write " + writtenPath().string()); }
+        }
+        else
+        {
+            written += result;
+        }
+    }
+
+    m_bytesWritten += written;
+}
+
+void FileWriter::flush()
+{
+    writeFully(m_buffer.data(), m_bufferedBytes);
+    m_bufferedBytes = 0;
+}
+
+void FileWriter::write(std::string_view text)
+{
+    if (failed()) { return; }
+
+    if (m_bufferedBytes + text.size() > m_buffer.size())
+    {
+        flush();
+
+        // Spans that would not fit in an empty buffer skip it
+        if (text.size() > m_buffer.size())
+        {
+            writeFully(text.data(), text.size());
+            return;
+        }
+    }
+
+    memcpy(m_buffer.data() + m_bufferedBytes, text.data(), text.size());
+    m_bufferedBytes += text.size();
+}
+
+void FileWriter::write(char character)
+{
+    if (m_bufferedBytes == m_buffer.size()) { flush(); }
+
+    if (failed()) { return; }
+
+    m_buffer[m_bufferedBytes++] = character;
+}
+
+bool FileWriter::commit()
+{
+    flush();
+
+    if (failed()) { return false; }
+
+    if (fsync(m_fileDescriptor) != 0)
+    {
+        fail("Cannot sync " + writtenPath().string());
+        return false;
+    }
+
+    int result = close(m_fileDescriptor);
+    m_fileDescriptor = -1;
+
+    if (result != 0)
+    {
+        fail("Cannot close " + writtenPath().string());
+        return false;
+    }
+
+    if (m_inPlace) { return true; }
+
+    if (rename(m_temporaryPath.c_str(), m_targetPath.c_str()) != 0)
+    {
+        fail("Cannot replace " + m_targetPath.string());
+        return false;
+    }
+
+    m_temporaryPath.clear();
+
+    // Makes the rename itself durable
+    int directoryDescriptor = open(directoryOf(m_targetPath).c_str(), O_RDONLY | O_DIRECTORY);
+    if (directoryDescriptor != -1)
+    {
+        fsync(directoryDescriptor);
+        close(directoryDescriptor);
+    }
+
+    return true;
+}
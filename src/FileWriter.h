@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Includes.h"
+
+// Writes a file through a temporary file in the same directory that is renamed over the target on commit, so the
+// target is either left untouched or fully replaced, never truncated halfway through a save. Where replacing the file
+// would lose something, like its other hard links or its owner, or no file can be created next to it, the target is
+// overwritten in place instead.
+class FileWriter
+{
+
+private:
+
+    std::filesystem::path m_targetPath;
+    std::filesystem::path m_temporaryPath;
+    int m_fileDescriptor;
+    bool m_mayWriteInPlace;
+    bool m_inPlace;
+
+    std::vector<char> m_buffer;
+    size_t m_bufferedBytes;
+    size_t m_bytesWritten;
+
+    std::string m_error;
+
+    void writeFully(const char* data, size_t size);
+    void flush();
+    void fail(const std::string& operation);
+
+    // Truncates the target and writes straight into it, or fails with whyNotReplaced if it may not be overwritten
+    void openInPlace(const std::string& whyNotReplaced);
+
+    // Where the data goes until commit
+    const std::filesystem::path& writtenPath() const { return (m_inPlace) ? m_targetPath : m_temporaryPath; }
+
+public:
+
+    // Unless mayWriteInPlace is set, the target is only ever replaced, and the save fails where that cannot be done
+    FileWriter(const std::filesystem::path& targetPath, bool mayWriteInPlace = true);
+    ~FileWriter();
+
+    FileWriter(const FileWriter&) = delete;
+    FileWriter& operator=(const FileWriter&) = delete;
+
+    static inline size_t writeBufferSize = 1 << 20;
+
+    // Whether a save to targetPath will overwrite it in place, as far as can be told before trying. Anything still reading
+    // the target, like a mapping of it, has to let go of it first.
+    static bool writesInPlace(const std::filesystem::path& targetPath);
+
+    void write(std::string_view text);
+    void write(char character);
+
+    // Flushes, syncs and renames the temporary file over the target. Returns false and keeps the target if any step failed,
+    // unless it was being overwritten in place.
+    bool commit();
+
+    // Getters
+    bool failed() const { return !m_error.empty(); }
+    const std::string& error() const { return m_error; }
+    size_t bytesWritten() const { return m_bytesWritten; }
+    bool inPlace() const { return m_inPlace; }
+
+};
@@ -5,12 +5,16 @@
 #include <memory>
 #include <deque>
 #include <vector>
+#include <unordered_set>
+#include <unordered_map>
 #include <stdio.h>
 #include <string>
+#include <string_view>
 #include <term.h>
 #include <deque>
 #include <iostream>
 #include <memory>
+#include <functional>
 #include <cassert>
 #include <cstring>
 #include <fstream>
@@ -50,6 +54,15 @@ enum YANK_TYPE
 
 const int YANK_HIGHLIGHT_MILLISECONDS = 100;
 
+const int SAVE_PROGRESS_MILLISECONDS = 100;
+
+// Keys typed ahead, like a paste, are handled for at most this long before the screen is drawn
+const int INPUT_BATCH_MILLISECONDS = 100;
+
+// Viewports are not split into halves smaller than this
+const int MIN_VIEWPORT_ROWS = 2;
+const int MIN_VIEWPORT_COLUMNS = 12;
+
 enum CUSTOM_COLORS
 {
     GREY = 8,
@@ -322,6 +335,21 @@ enum COLOR_PAIRS
     ERROR_MESSAGE_PAIR,
 
     YANK_HIGHLIGHT_PAIR,
+    SEARCH_HIGHLIGHT_PAIR,
+
+    SYNTAX_KEYWORD_PAIR,
+    SYNTAX_TYPE_NAME_PAIR,
+    SYNTAX_STRING_PAIR,
+    SYNTAX_NUMBER_PAIR,
+    SYNTAX_COMMENT_PAIR,
+    SYNTAX_PREPROCESSOR_PAIR,
+
+    SYNTAX_KEYWORD_CURSOR_LINE_PAIR,
+    SYNTAX_TYPE_NAME_CURSOR_LINE_PAIR,
+    SYNTAX_STRING_CURSOR_LINE_PAIR,
+    SYNTAX_NUMBER_CURSOR_LINE_PAIR,
+    SYNTAX_COMMENT_CURSOR_LINE_PAIR,
+    SYNTAX_PREPROCESSOR_CURSOR_LINE_PAIR,
 };
 
 enum KEYS
@@ -340,10 +368,12 @@ enum KEYS
     APOSTROPHE = 39,
     LEFT_PARENTHESIS = 40,
     COMMA = 44,
+    SLASH = 47,
     COLON = 58,
     SEMICOLON = 59,
     LESS_THAN_SIGN = 60,
     GREATER_THAN_SIGN = 62,
+    QUESTION_MARK = 63,
     AT = 64,
     A = 65, B, C, D, E, F, G, H, I, J, K, L, M, N, O, P, Q, R, S, T, U, V, W, X, Y, Z,
     LEFT_BRACKET = 91,
@@ -3,8 +3,69 @@
 #include "Editor.h"
 #include "Command.h"
 #include "Includes.h"
+#include "CompiledMacro.h"
 #include <cstdlib>
+#include <iomanip>
 #include <ncurses.h>
+#include <poll.h>
+#include <unistd.h>
+
+// Length of the line range in front of a command name, like "%" or "3,$"
+static size_t rangeLength(const std::string& command)
+{
+    return std::min(command.find_first_not_of("0123456789%.$,"), command.size());
+}
+
+// Length of s or substitute at the start of command if it is followed by a delimiter, or 0 if command is not a substitution
+static size_t substituteLength(const std::string& command)
+{
+    for (size_t length : { 10, 1 })
+    {
+        if (command.compare(0, length, std::string("substitute"), 0, length) == 0 && command.size() > length &&
+            !isalnum(static_cast<unsigned char>(command[length])) && !isspace(static_cast<unsigned char>(command[length])))
+        {
+            return length;
+        }
+    }
+
+    return 0;
+}
+
+// Bytes as B, KB or MB, the way :ls shows how much memory a buffer takes
+static std::string formatBytes(size_t bytes)
+{
+    std::ostringstream text;
+
+    if (bytes < 1024) { text << bytes << "B"; }
+    else if (bytes < 1024 * 1024) { text << std::fixed << std::setprecision(1) << bytes / 1024.0 << "KB"; }
+    else { text << std::fixed << std::setprecision(1) << bytes / (1024.0 * 1024.0) << "MB"; }
+
+    return text.str();
+}
+
+// Splits /pattern/replacement/flags at the delimiter it starts with. An escaped delimiter stands for itself, and other
+// escapes are left for the pattern and the replacement.
+static std::vector<std::string> splitSubstitute(const std::string& arguments)
+{
+    std::vector<std::string> parts(1);
+    char delimiter = arguments[0];
+
+    for (size_t i = 1; i < arguments.size(); i++)
+    {
+        if (arguments[i] == '\\' && i + 1 < arguments.size())
+        {
+            if (arguments[i + 1] != delimiter) { parts.back().push_back('\\'); }
+
+            parts.back().push_back(arguments[++i]);
+        }
+        else if (arguments[i] == delimiter && parts.size() < 3) { parts.emplace_back(); }
+        else { parts.back().push_back(arguments[i]); }
+    }
+
+    parts.resize(3);
+
+    return parts;
+}
 
 InputController::InputController(Editor* editor)
     : m_editor(editor), m_commandBuffer(""), m_repetitionBuffer(""), m_circularInputBuffer(INPUT_CONTROLLER_MAX_CIRCULAR_BUFFER_SIZE)
@@ -57,9 +118,31 @@ int InputController::getRandomKey() const
 
 int InputController::getInput()
 {
+    m_editor->runDueTimers();
+
     if (!m_testInput || m_numberOfRandomInputs-- <= 0)
     {
-        return getch();
+        int input;
+
+        // Keys typed ahead are read without drawing what the batch they are in held back. Only waiting on a key that was not
+        // typed yet shows it, and lets what is drawn during the wait through.
+        int renderSuppression = inputPending() ? -1 : m_editor->view().suspendRenderTransactions();
+
+        // getch times out while a save or the first highlighting pass is running, so what they show keeps being redrawn,
+        // and when the next timer is due
+        updateInputTimeout();
+
+        while ((input = getch()) == ERR)
+        {
+            pollBackgroundSave();
+            pollSyntaxHighlighting();
+            m_editor->runDueTimers();
+            updateInputTimeout();
+        }
+
+        if (renderSuppression != -1) { m_editor->view().resumeRenderTransactions(renderSuppression); }
+
+        return input;
     }
     else if (m_inputRepetitionCount <= 1)
     {
@@ -102,13 +185,26 @@ int InputController::getInput()
     }
 }
 
+bool InputController::inputPending() const
+{
+    pollfd terminal{ STDIN_FILENO, POLLIN, 0 };
+
+    return poll(&terminal, 1, 0) > 0 && (terminal.revents & POLLIN);
+}
+
 int InputController::repetitionCount()
 {
-    int repetitionCount = atoi(m_repetitionBuffer.c_str());
+    return KeyBindings::takeRepetition(m_repetitionBuffer);
+}
 
-    clearRepetitionBuffer();
+KeyContext InputController::keyContext(int key, int repetition)
+{
+    return KeyContext{ &m_editor->commandQueue(), &m_editor->buffer(), key, repetition, repeatedInput(key), &m_findCharacter, &m_searchedForward };
+}
 
-    return std::clamp(repetitionCount, 1, MAX_REPETITION_COUNT);
+void InputController::runKeyBinding(const KeyBinding& binding, int key)
+{
+    binding.run(keyContext(key, (binding.takesRepetition) ? repetitionCount() : 1));
 }
 
 void InputController::handleMacroRecord()
@@ -153,6 +249,11 @@ void InputController::handleMacroReplay(const int repetition, const int recursiv
 
     if (!MacroRegisters::isValidRegisterKey(inputRegister)) { return; }
 
+    // However many keys the macro replays, the screen is drawn once it is done
+    RenderTransaction renderTransaction(m_editor->view());
+
+    if (runCompiledMacro(m_macroRegisters[inputRegister], repetition)) { return; }
+
     for (int iter = 0; iter < repetition; iter++)
     {
         for (size_t i = 0; i < m_macroRegisters[inputRegister].size(); i++)
@@ -192,6 +293,10 @@ void InputController::recursiveMacroReplay(const int macroRegister)
 
 void InputController::replayLastMacro(const int repetition)
 {
+    RenderTransaction renderTransaction(m_editor->view());
+
+    if (runCompiledMacro(m_macroRegisters[m_currentMacroRegister], repetition)) { return; }
+
     for (int iter = 0; iter < repetition; iter++)
     {
         for (size_t i = 0; i < m_macroRegisters[m_currentMacroRegister].size(); i++)
@@ -201,11 +306,131 @@ void InputController::replayLastMacro(const int repetition)
     }
 }
 
+bool InputController::runCompiledMacro(const std::vector<int>& keys, int repetition)
+{
+    CompiledMacro compiledMacro(m_editor, keys, m_findCharacter, m_searchedForward);
+
+    if (!compiledMacro.compiled()) { return false; }
+
+    for (int iter = 0; iter < repetition; iter++) { compiledMacro.run(); }
+
+    if (!keys.empty()) { m_previousInput = keys.back(); }
+
+    return true;
+}
+
+void InputController::runOnLines(const std::vector<int>& keys, int firstLine, int lastLine, bool fromLineStart)
+{
+    RenderTransaction renderTransaction(m_editor->view());
+
+    Buffer& buffer = m_editor->buffer();
+    CommandQueue& commandQueue = m_editor->commandQueue();
+
+    CompiledMacro compiledMacro(m_editor, keys, m_findCharacter, m_searchedForward);
+
+    // Keys replayed one by one must not be read as the rest of the command line
+    m_commandBuffer.clear();
+    commandQueue.execute<SetModeCommand>(false, 1, NORMAL_MODE, 0);
+
+    commandQueue.beginUndoGroup();
+
+    int line = firstLine;
+
+    for (int remaining = lastLine - firstLine + 1; remaining > 0 && line < static_cast<int>(buffer.getFile().numberOfLines()); remaining--)
+    {
+        int linesBefore = static_cast<int>(buffer.getFile().numberOfLines());
+
+        if (fromLineStart) { buffer.moveCursor(line, 0); }
+
+        if (compiledMacro.compiled())
+        {
+            compiledMacro.run();
+        }
+        else
+        {
+            for (int key : keys) { handleInput(key); }
+        }
+
+        // Whatever the keys leave unfinished is ended, like an escape would
+        if (m_editor->mode() == INSERT_MODE) { commandQueue.execute<SetModeCommand>(false, 1, NORMAL_MODE, -1); }
+        else if (m_editor->mode() != NORMAL_MODE) { commandQueue.execute<SetModeCommand>(false, 1, NORMAL_MODE, 0); }
+
+        m_commandBuffer.clear();
+        m_commandLinePrompt = ':';
+        clearRepetitionBuffer();
+
+        // The next line of the range is wherever the lines the keys added or removed pushed it
+        line = std::max(0, line + 1 + static_cast<int>(buffer.getFile().numberOfLines()) - linesBefore);
+    }
+
+    commandQueue.endUndoGroup();
+}
+
+bool InputController::parseLineRange(const std::string& range, int& firstLine, int& lastLine) const
+{
+    int numberOfLines = static_cast<int>(m_editor->buffer().getFile().numberOfLines());
+    int currentLine = m_editor->buffer().getCursorPos().first;
+
+    if (range.empty()) { firstLine = lastLine = currentLine; return true; }
+    if (range == "%") { firstLine = 0; lastLine = numberOfLines - 1; return true; }
+
+    // Line numbers count from 1, and . and $ stand for the current and the last line
+    auto parseLine = [numberOfLines, currentLine](const std::string& address, int& line)
+    {
+        if (address == ".") { line = currentLine; return true; }
+        if (address == "$") { line = numberOfLines - 1; return true; }
+        if (address.empty() || address.size() > 9 || !std::all_of(address.begin(), address.end(), isdigit)) { return false; }
+
+        line = std::stoi(address) - 1;
+
+        return line >= 0 && line < numberOfLines;
+    };
+
+    size_t comma = range.find(',');
+
+    if (comma == std::string::npos)
+    {
+        if (!parseLine(range, firstLine)) { return false; }
+
+        lastLine = firstLine;
+
+        return true;
+    }
+
+    if (!parseLine(range.substr(0, comma), firstLine) || !parseLine(range.substr(comma + 1), lastLine)) { return false; }
+
+    if (firstLine > lastLine) { std::swap(firstLine, lastLine); }
+
+    return true;
+}
+
+void InputController::countFramesOfLastInput()
+{
+    // Keys typed into the command line do not count, so the command line can ask about the input before it
+    if (m_modeAtInputStart == COMMAND_MODE || m_editor->mode() == COMMAND_MODE) { return; }
+
+    m_framesOfLastInput = m_editor->view().framesDrawn() - m_framesAtInputStart;
+    m_mostFramesOfAnInput = std::max(m_mostFramesOfAnInput, m_framesOfLastInput);
+    m_cellsOfLastInput = m_editor->view().cellsSent() - m_cellsAtInputStart;
+    m_estimatedBytesOfLastInput = m_editor->view().estimatedBytesSent() - m_estimatedBytesAtInputStart;
+}
+
 void InputController::handleInput(int input)
 {
     if (input == -1)
     {
+        // Frames drawn while waiting on the key, like save progress, are not counted against either input
+        countFramesOfLastInput();
+
         input = getInput();
+
+        m_framesAtInputStart = m_editor->view().framesDrawn();
+        m_cellsAtInputStart = m_editor->view().cellsSent();
+        m_estimatedBytesAtInputStart = m_editor->view().estimatedBytesSent();
+        m_modeAtInputStart = m_editor->mode();
+
+        m_editor->view().setMessage("");
+        m_editor->view().setStatus("");
     }
 
     // Global input
@@ -290,71 +515,20 @@ void InputController::handleNormalModeInput(int input)
         handleYankCommands(input);
         return;
     }
+    else if (m_commandBuffer.size() == 1 && m_commandBuffer[0] == CTRL_W)
+    {
+        handleWindowCommands(input);
+        return;
+    }
+
+    if (const KeyBinding* binding = KeyBindings::normalMode(input))
+    {
+        runKeyBinding(*binding, input);
+        return;
+    }
 
     switch (input)
     {
-        case CTRL_C:
-            clearRepetitionBuffer();
-            break;
-        case j:
-            m_editor->commandQueue().execute<SetModeCommand>(false, 1, INSERT_MODE, 0);
-            break;
-        case a:
-            m_editor->commandQueue().execute<SetModeCommand>(false, 1, INSERT_MODE, 1);
-            break;
-        case h:
-            m_editor->commandQueue().execute<MoveCursorXCommand>(false, 1, -1 * repetitionCount());
-            break;
-        case i:
-            m_editor->commandQueue().execute<MoveCursorYCommand>(false, 1, 1 * repetitionCount());
-            break;
-        case p:
-            m_editor->commandQueue().execute<MoveCursorYCommand>(false, 1, -1 * repetitionCount());
-            break;
-        case APOSTROPHE:
-            m_editor->commandQueue().execute<MoveCursorXCommand>(false, 1, 1 * repetitionCount());
-            break;
-        case H:
-            m_editor->commandQueue().execute<CursorFullLeftCommand>(false, 1);
-            break;
-        case QUOTE:
-            m_editor->commandQueue().execute<CursorFullRightCommand>(false, 1);
-            break;
-        case I:
-            m_editor->commandQueue().execute<QuickVerticalMovementCommand>(false, 1, true);
-            break;
-        case P:
-            m_editor->commandQueue().execute<QuickVerticalMovementCommand>(false, 1, false);
-            break;
-        case u:
-            m_editor->commandQueue().execute<UndoCommand>(false, 1);
-            break;
-        case CTRL_R:
-            m_editor->commandQueue().execute<RedoCommand>(false, 1);
-            break;
-        case x:
-            m_editor->commandQueue().execute<RemoveCharacterNormalCommand>(true, repetitionCount(), false);
-            break;
-        case X:
-            m_editor->commandQueue().execute<RemoveCharacterNormalCommand>(true, repetitionCount(), true);
-            break;
-        case A:
-            m_editor->commandQueue().execute<CursorFullRightCommand>(false, 1);
-            m_editor->commandQueue().execute<SetModeCommand>(false, 1, INSERT_MODE, 1);
-            break;
-        case J:
-            m_editor->commandQueue().execute<CursorFullLeftCommand>(false, 1);
-            m_editor->commandQueue().execute<SetModeCommand>(false, 1, INSERT_MODE, 0);
-            break;
-        case r:
-            m_editor->commandQueue().execute<SetModeCommand>(false, 1, REPLACE_CHAR_MODE, 0);
-            break;
-        case o:
-            m_editor->commandQueue().execute<InsertLineNormalCommand>(true, 1, true);
-            break;
-        case O:
-            m_editor->commandQueue().execute<InsertLineNormalCommand>(true, 1, false);
-            break;
         case d:
             m_commandBuffer.push_back('d');
             break;
@@ -370,71 +544,12 @@ void InputController::handleNormalModeInput(int input)
         case y:
             m_commandBuffer.push_back('y');
             break;
-        case SEMICOLON:
-            m_editor->commandQueue().execute<FindCharacterCommand>(false, repetitionCount(), m_findCharacter, m_searchedForward);
-            break;
-        case COMMA:
-            m_editor->commandQueue().execute<FindCharacterCommand>(false, repetitionCount(), m_findCharacter, !m_searchedForward);
-            break;
-        case w:
-            m_editor->commandQueue().execute<JumpCursorCommand>(false, repetitionCount(), JUMP_FORWARD | JUMP_BY_WORD);
-            break;
-        case W:
-            m_editor->commandQueue().execute<JumpCursorCommand>(false, repetitionCount(), JUMP_FORWARD);
-            break;
-        case s:
-            m_editor->commandQueue().execute<JumpCursorCommand>(false, repetitionCount(), JUMP_BY_WORD);
-            break;
-        case S:
-            m_editor->commandQueue().execute<JumpCursorCommand>(false, repetitionCount(), 0);
-            break;
-        case e:
-            m_editor->commandQueue().execute<JumpCursorCommand>(false, repetitionCount(), JUMP_FORWARD | JUMP_BY_WORD | JUMP_TO_END);
-            break;
-        case E:
-            m_editor->commandQueue().execute<JumpCursorCommand>(false, repetitionCount(), JUMP_FORWARD | JUMP_TO_END);
-            break;
-        case q:
-            m_editor->commandQueue().execute<JumpCursorCommand>(false, repetitionCount(), JUMP_BY_WORD | JUMP_TO_END);
-            break;
-        case Q:
-            m_editor->commandQueue().execute<JumpCursorCommand>(false, repetitionCount(), JUMP_TO_END);
+        case CTRL_W:
+            m_commandBuffer.push_back(CTRL_W);
             break;
         case c:
             m_commandBuffer.push_back('c');
             break;
-        case k:
-            m_editor->commandQueue().execute<PasteCommand>(false, repetitionCount());
-            break;
-        case LESS_THAN_SIGN:
-        {
-            int repetition = repetitionCount();
-
-            if (repetition > 1)
-            {
-                m_editor->commandQueue().execute<TabLineCommand>(false, repetition, false);
-            }
-            else
-            {
-                m_editor->commandQueue().execute<TabLineCommand>(true, 1, false);
-            }
-
-            break;
-        }
-        case GREATER_THAN_SIGN:
-        {
-            int repetition = repetitionCount();
-
-            if (repetition > 1)
-            {
-                m_editor->commandQueue().execute<TabLineCommand>(false, repetition, true);
-            }
-            else
-            {
-                m_editor->commandQueue().execute<TabLineCommand>(true, 1, true);
-            }
-        }
-            break;
         case v:
         {
             clearRepetitionBuffer();
@@ -465,9 +580,6 @@ void InputController::handleNormalModeInput(int input)
             m_editor->commandQueue().execute<SetModeCommand>(false, 1, VISUAL_BLOCK_MODE, 0);
             break;
         }
-        case t:
-            m_editor->commandQueue().execute<ToggleCommentLineCommand>(false, 1);
-            break;
         case m:
             clearRepetitionBuffer();
             handleMacroRecord();
@@ -478,32 +590,33 @@ void InputController::handleNormalModeInput(int input)
         case M:
             replayLastMacro(repetitionCount());
             break;
+        case SLASH:
+            clearRepetitionBuffer();
+            startSearch(true);
+            break;
+        case QUESTION_MARK:
+            clearRepetitionBuffer();
+            startSearch(false);
+            break;
+        case n:
+        case N:
+            m_editor->view().setSearchHighlight(m_editor->buffer().searchIndex().pattern());
+            m_editor->commandQueue().execute<SearchCommand>(false, repetitionCount(), m_searchedPatternForward == (input == n));
+            break;
         default:
-        {
-            if (input >= '0' && input <= '9')
-            {
-                m_repetitionBuffer.push_back(static_cast<char>(input));
-
-                if (m_repetitionBuffer == "0")
-                {
-                    clearRepetitionBuffer();
-                    break;
-                }
-            }
-            else
-            {
-                // clear();
-                // move(0, 0);
-                // printw("You printed: %c with integer code: %d", input, input);
-            }
-
+            KeyBindings::addRepetitionDigit(m_repetitionBuffer, input);
             break;
-        }
     }
 }
 
 void InputController::handleCommandModeInput(int input)
 {
+    if (m_commandLinePrompt != ':')
+    {
+        handleSearchInput(input);
+        return;
+    }
+
     switch (input)
     {
         case CTRL_C:
@@ -563,52 +676,121 @@ void InputController::handleCommandModeInput(int input)
     m_editor->view().displayCommandBuffer();
 }
 
-void InputController::handleInsertModeInput(int input)
+void InputController::startSearch(bool forward)
+{
+    m_commandLinePrompt = forward ? '/' : '?';
+    m_cursorPosBeforeSearch = m_editor->buffer().getCursorPos();
+    m_highlightBeforeSearch = m_editor->view().searchHighlight();
+
+    m_editor->commandQueue().execute<SetModeCommand>(false, 1, COMMAND_MODE, 0);
+    m_editor->view().displayCommandBuffer();
+}
+
+void InputController::handleSearchInput(int input)
 {
     switch (input)
     {
         case CTRL_C:
-            m_editor->commandQueue().execute<SetModeCommand>(false, 1, NORMAL_MODE, -1);
-            break;
         case ESCAPE:
-            m_editor->commandQueue().execute<SetModeCommand>(false, 1, NORMAL_MODE, -1);
-            break;
-        case BACKSPACE:
-            m_editor->commandQueue().execute<RemoveCharacterInsertCommand>(repeatedInput(input), 1);
-            break;
+            endSearch(false);
+            return;
         case ENTER:
-            m_editor->commandQueue().execute<InsertLineInsertCommand>(true, 1);
-            break;
-        case TAB:
-            m_editor->commandQueue().execute<TabCommand>(true, 1);
-            break;
-        case LEFT_PARENTHESIS:
-            m_editor->commandQueue().execute<AutocompletePair>(true, 1, '(');
-            break;
-        case LEFT_BRACKET:
-            m_editor->commandQueue().execute<AutocompletePair>(true, 1, '[');
-            break;
-        case LEFT_BRACE:
-            m_editor->commandQueue().execute<AutocompletePair>(true, 1, '{');
-            break;
-        case APOSTROPHE:
-            m_editor->commandQueue().execute<AutocompletePair>(true, 1, '\'');
-            break;
-        case QUOTE:
-            m_editor->commandQueue().execute<AutocompletePair>(true, 1, '"');
-            break;
+            endSearch(true);
+            return;
         case CTRL_W:
         {
-            m_editor->commandQueue().execute<JumpCursorDeletePreviousWordInsertModeCommand>(true, 1);
+            size_t wordEnd = m_commandBuffer.find_last_not_of(' ');
+            size_t wordStart = (wordEnd == std::string::npos) ? std::string::npos : m_commandBuffer.find_last_of(' ', wordEnd);
+
+            m_commandBuffer.erase((wordStart == std::string::npos) ? 0 : wordStart + 1);
             break;
         }
+        case BACKSPACE:
+            if (m_commandBuffer.empty())
+            {
+                endSearch(false);
+                return;
+            }
+
+            m_commandBuffer.pop_back();
+            break;
         default:
-        if (input >= 32 && input <= 126)
-        {
-            m_editor->commandQueue().execute<InsertCharacterCommand>(true, 1, input);
+            if (input >= 32 && input <= 126) { m_commandBuffer.push_back(static_cast<char>(input)); }
             break;
-        }
     }
+
+    previewSearch();
+}
+
+void InputController::previewSearch()
+{
+    Buffer& buffer = m_editor->buffer();
+    std::shared_ptr<const SearchPattern> pattern = std::make_shared<const SearchPattern>(m_commandBuffer);
+
+    SearchMatch match;
+    bool wrapped;
+
+    // A pattern that is not valid yet, like one with an unclosed bracket, shows what was highlighted before the search
+    if (pattern->valid() && SearchIndex::scanFrom(buffer.getFile(), *pattern, m_cursorPosBeforeSearch, m_commandLinePrompt == '/', match, wrapped))
+    {
+        buffer.moveCursor(match.line, match.column);
+    }
+    else
+    {
+        buffer.moveCursor(m_cursorPosBeforeSearch.first, m_cursorPosBeforeSearch.second);
+    }
+
+    m_editor->view().setSearchHighlight(pattern->valid() ? pattern : m_highlightBeforeSearch);
+    m_editor->view().display();
+    m_editor->view().displayCommandBuffer();
+}
+
+void InputController::endSearch(bool accepted)
+{
+    Buffer& buffer = m_editor->buffer();
+    bool forward = (m_commandLinePrompt == '/');
+    std::string text = m_commandBuffer;
+
+    m_commandLinePrompt = ':';
+    m_commandBuffer.clear();
+
+    // The search runs from where it started through the same command as n and N
+    buffer.moveCursor(m_cursorPosBeforeSearch.first, m_cursorPosBeforeSearch.second);
+    m_editor->commandQueue().execute<SetModeCommand>(false, 1, NORMAL_MODE, 0);
+
+    if (!accepted)
+    {
+        m_editor->view().setSearchHighlight(m_highlightBeforeSearch);
+        m_editor->view().display();
+        return;
+    }
+
+    // An empty pattern searches for the last one again
+    if (!text.empty())
+    {
+        std::shared_ptr<const SearchPattern> pattern = std::make_shared<const SearchPattern>(text);
+
+        if (!pattern->valid())
+        {
+            m_editor->view().setSearchHighlight(m_highlightBeforeSearch);
+            m_editor->view().display();
+            displayErrorMessage("Invalid pattern: " + text);
+            m_commandBuffer.clear();
+            return;
+        }
+
+        buffer.setSearchPattern(pattern);
+    }
+
+    m_searchedPatternForward = forward;
+    m_editor->view().setSearchHighlight(buffer.searchIndex().pattern());
+    m_editor->commandQueue().execute<SearchCommand>(false, 1, forward);
+    m_editor->view().display();
+}
+
+void InputController::handleInsertModeInput(int input)
+{
+    if (const KeyBinding* binding = KeyBindings::insertMode(input)) { runKeyBinding(*binding, input); }
 }
 
 void InputController::handleReplaceCharMode(int input)
@@ -651,28 +833,27 @@ void InputController::handleCommandBufferInput()
 
     while (istream >> currentSubstring)
     {
-        if (currentSubstring == "q!")
+        // With several viewports open the buffers stay loaded, so quitting only closes the active viewport
+        if ((currentSubstring == "q!" || currentSubstring == "q") && m_editor->closeViewport())
+        {
+            break;
+        }
+        else if (currentSubstring == "q!")
         {
             m_editor->quit();
             break;
         }
         else if (currentSubstring == "q")
         {
-            if (m_lastSavedCommand == m_editor->commandQueue().currentCommandCount())
-            {
-                m_editor->quit();
-            }
-            else
-            {
-                displayErrorMessage("No write since last change");
-            }
+            if (m_editor->buffer().backgroundSave()) { finishBackgroundSave(); }
+
+            if (!unsavedChanges()) { m_editor->quit(); }
         }
         else if (currentSubstring == "w")
         {
             if (m_editor->buffer().filePath() != "NO_NAME")
             {
-                m_editor->buffer().saveCurrentFile();
-                m_lastSavedCommand = m_editor->commandQueue().currentCommandCount();
+                startBackgroundSave(m_editor->buffer().filePath());
             }
             else
             {
@@ -685,15 +866,22 @@ void InputController::handleCommandBufferInput()
         {
             if (m_editor->buffer().filePath() != "NO_NAME")
             {
-                m_editor->buffer().saveCurrentFile();
+                if (m_editor->buffer().backgroundSave()) { finishBackgroundSave(); }
+
+                // A failed save keeps the editor open so the changes are not lost
+                if (reportSave(m_editor->buffer().filePath(), m_editor->buffer().saveCurrentFile()))
+                {
+                    m_editor->document().setLastSavedCommand(m_editor->commandQueue().currentCommandCount());
+
+                    if (!m_editor->closeViewport() && !unsavedChanges()) { m_editor->quit(); }
+                }
             }
             else
             {
                 displayErrorMessage("No file name. Run :write 'filename'");
+                m_editor->quit();
             }
 
-            m_editor->quit();
-
             break;
         }
         else if (currentSubstring == "write")
@@ -707,13 +895,228 @@ void InputController::handleCommandBufferInput()
 
             if (m_editor->buffer().filePath() == "NO_NAME") { m_editor->buffer().setFileName(fileName); }
 
-            m_editor->buffer().writeToFile(fileName);
+            startBackgroundSave(fileName);
+
+            break;
+        }
+        else if (currentSubstring == "e" || currentSubstring == "edit")
+        {
+            std::string fileName;
+
+            if (!(istream >> fileName)) { displayErrorMessage("No file name"); break; }
+
+            switchToDocument(m_editor->openDocument(fileName));
+
+            break;
+        }
+        else if (currentSubstring == "sp" || currentSubstring == "split" || currentSubstring == "vs" || currentSubstring == "vsplit")
+        {
+            // The new viewport shows the same buffer, or the file named after the command
+            if (!m_editor->view().splitViewport(currentSubstring[0] == 'v'))
+            {
+                displayErrorMessage("Not enough room");
+                break;
+            }
+
+            std::string fileName;
+
+            if (istream >> fileName) { switchToDocument(m_editor->openDocument(fileName)); }
+
+            break;
+        }
+        else if (currentSubstring == "clo" || currentSubstring == "close")
+        {
+            if (!m_editor->closeViewport()) { displayErrorMessage("Cannot close last window"); }
+
+            break;
+        }
+        else if (currentSubstring == "on" || currentSubstring == "only")
+        {
+            m_editor->view().onlyViewport();
+
+            break;
+        }
+        else if (currentSubstring == "bn" || currentSubstring == "bnext" || currentSubstring == "bp" || currentSubstring == "bprevious")
+        {
+            size_t numberOfDocuments = m_editor->documents().size();
+            size_t step = (currentSubstring[1] == 'n') ? 1 : numberOfDocuments - 1;
+
+            switchToDocument((m_editor->currentDocument() + step) % numberOfDocuments);
+
+            break;
+        }
+        else if (currentSubstring == "b" || currentSubstring == "buffer")
+        {
+            // Buffers are numbered from 1, as :ls lists them
+            size_t number = 0;
+
+            if (!(istream >> number) || number == 0 || number > m_editor->documents().size())
+            {
+                displayErrorMessage("No such buffer");
+                break;
+            }
+
+            switchToDocument(number - 1);
+
+            break;
+        }
+        else if (currentSubstring == "ls" || currentSubstring == "buffers" || currentSubstring == "files")
+        {
+            // % marks the buffer shown and + one with changes that were not written. Buffers not shown yet are not read in.
+            std::ostringstream message;
+
+            for (size_t i = 0; i < m_editor->documents().size(); i++)
+            {
+                const Document& document = *m_editor->documents()[i];
+
+                if (i > 0) { message << " | "; }
+
+                message << i + 1 << ((i == m_editor->currentDocument()) ? "%" : "") << (document.modified() ? "+" : "") << " \"" << document.fileName() << "\" ";
+
+                if (document.loaded())
+                {
+                    message << document.buffer().getFile().numberOfLines() << " lines, " << formatBytes(document.heapMemoryUsage()) << " heap, "
+                        << formatBytes(document.residentMappedBytes()) << " mapped";
+                }
+                else
+                {
+                    message << "not loaded";
+                }
+            }
+
+            m_editor->view().setMessage(message.str());
+
+            break;
+        }
+        else if (currentSubstring == "earlier" || currentSubstring == "later")
+        {
+            // A count of changes, or a time with s, m, h or d after it
+            std::string amount = "1";
+            istream >> amount;
+
+            size_t digits = 0;
+            while (digits < amount.size() && isdigit(static_cast<unsigned char>(amount[digits]))) { digits++; }
+
+            std::string unit = amount.substr(digits);
+            int64_t count = (digits > 0 && digits <= 12) ? std::stoll(amount.substr(0, digits)) : -1;
+            int64_t direction = (currentSubstring == "earlier") ? -1 : 1;
+
+            if (count < 0 || unit.size() > 1)
+            {
+                displayErrorMessage("Invalid argument: " + amount);
+            }
+            else if (unit.empty())
+            {
+                m_editor->commandQueue().travelChronologically(direction * count);
+            }
+            else
+            {
+                static const std::string units = "smhd";
+                static const int64_t unitMilliseconds[] = { 1000, 60 * 1000, 60 * 60 * 1000, 24 * 60 * 60 * 1000 };
+
+                size_t unitIndex = units.find(unit[0]);
+
+                if (unitIndex == std::string::npos) { displayErrorMessage("Invalid argument: " + amount); }
+                else { m_editor->commandQueue().travelInTime(direction * count * unitMilliseconds[unitIndex]); }
+            }
+
+            break;
+        }
+        else if (currentSubstring.compare(rangeLength(currentSubstring), std::string::npos, "norm") == 0
+            || currentSubstring.compare(rangeLength(currentSubstring), std::string::npos, "normal") == 0)
+        {
+            // [range]normal {keys} runs the keys on every line of the range as if typed there. @x runs register x.
+            std::string range = currentSubstring.substr(0, rangeLength(currentSubstring));
+            std::string text;
+            std::getline(istream, text);
+
+            if (!text.empty() && text[0] == ' ') { text.erase(0, 1); }
+
+            std::vector<int> keys(text.begin(), text.end());
+
+            if (text.size() == 2 && text[0] == '@')
+            {
+                if (!MacroRegisters::isValidRegisterKey(text[1])) { displayErrorMessage("Invalid register: " + text.substr(1)); break; }
+
+                keys = m_macroRegisters[text[1]];
+            }
+
+            int firstLine, lastLine;
+
+            if (!parseLineRange(range, firstLine, lastLine)) { displayErrorMessage("Invalid range: " + range); break; }
+
+            runOnLines(keys, firstLine, lastLine, !range.empty());
+
+            break;
+        }
+        else if (substituteLength(currentSubstring.substr(rangeLength(currentSubstring))))
+        {
+            // [range]s/pattern/replacement/[g], with the pattern and replacement taken up to the end of the line
+            std::string range = currentSubstring.substr(0, rangeLength(currentSubstring));
+            std::string command = currentSubstring.substr(range.size());
+            std::string text;
+            std::getline(istream, text);
+
+            std::vector<std::string> parts = splitSubstitute(command.substr(substituteLength(command)) + text);
+
+            Buffer& buffer = m_editor->buffer();
+            int firstLine, lastLine;
+
+            if (!parseLineRange(range, firstLine, lastLine)) { displayErrorMessage("Invalid range: " + range); break; }
+
+            if (parts[2] != "" && parts[2] != "g") { displayErrorMessage("Invalid flags: " + parts[2]); break; }
+
+            // An empty pattern substitutes the last one searched for
+            std::shared_ptr<const SearchPattern> pattern = buffer.searchIndex().pattern();
+
+            if (!parts[0].empty()) { pattern = std::make_shared<const SearchPattern>(parts[0]); }
+
+            if (!pattern) { displayErrorMessage("No previous search pattern"); break; }
+            if (!pattern->valid()) { displayErrorMessage("Invalid pattern: " + parts[0]); break; }
+
+            m_editor->commandQueue().execute<SubstituteCommand>(false, 1, pattern, parts[1], parts[2] == "g", firstLine, lastLine);
+
+            // Set once the lines are rewritten, so the search scan is not copying lines out from under the substitution
+            buffer.setSearchPattern(pattern);
+            m_editor->view().setSearchHighlight(pattern);
+
+            break;
+        }
+        else if (currentSubstring == "noh" || currentSubstring == "nohlsearch")
+        {
+            // Until the next search, or n or N
+            m_editor->view().setSearchHighlight(nullptr);
+
+            break;
+        }
+        else if (currentSubstring == "renderstats")
+        {
+            const View& view = m_editor->view();
+
+            std::ostringstream message;
+            message << m_framesOfLastInput << " frames drawn by the last input, " << m_mostFramesOfAnInput << " at most, " << view.framesDrawn() << " in total. "
+                << m_cellsOfLastInput << " cells in about " << m_estimatedBytesOfLastInput << "B sent for the last input, " << view.cellsOfLastFrame()
+                << " cells in " << view.runsOfLastFrame() << " runs and about " << view.estimatedBytesOfLastFrame() << "B by the last frame, about "
+                << view.estimatedBytesSent() << "B in total";
+
+            m_editor->view().setMessage(message.str());
+
+            break;
+        }
+        else if (currentSubstring == "undostats")
+        {
+            const UndoJournal& undoJournal = m_editor->commandQueue().undoJournal();
 
-            if (fileName ==  m_editor->buffer().filePath())
+            std::ostringstream message;
+            message << undoJournal.numberOfEntries() << " changes, " << undoJournal.editsInHistory() << " edits in " << undoJournal.memoryUsage() << "B of undo history";
+
+            if (undoJournal.editsInHistory() > 0)
             {
-                m_lastSavedCommand = m_editor->commandQueue().currentCommandCount();
+                message << " (" << std::fixed << std::setprecision(1) << static_cast<double>(undoJournal.memoryUsage()) / undoJournal.editsInHistory() << " B/edit)";
             }
 
+            m_editor->view().setMessage(message.str());
+
             break;
         }
         else
@@ -757,91 +1160,16 @@ void InputController::handleCommandBufferInput()
 
 void InputController::handleDeleteCommands(int input)
 {
-    int numberOfLines = static_cast<int>(m_editor->buffer().getFileGapBuffer().numberOfLines());
-    int rep = std::min(repetitionCount(), numberOfLines);
-
-    switch (input)
-    {
-        case d:
-            m_editor->commandQueue().execute<RemoveLineCommand>(false, rep);
-            break;
-        case w:
-            m_editor->commandQueue().execute<JumpCursorDeleteWordCommand>(false, rep, JUMP_FORWARD | JUMP_BY_WORD, false);
-            break;
-        case W:
-            m_editor->commandQueue().execute<JumpCursorDeleteWordCommand>(false, rep, JUMP_FORWARD, false);
-            break;
-        case s:
-            m_editor->commandQueue().execute<JumpCursorDeleteWordCommand>(false, rep, JUMP_BY_WORD, false);
-            break;
-        case S:
-            m_editor->commandQueue().execute<JumpCursorDeleteWordCommand>(false, rep, 0, false);
-            break;
-        case e:
-            m_editor->commandQueue().execute<JumpCursorDeleteWordCommand>(false, rep, JUMP_FORWARD | JUMP_BY_WORD | JUMP_TO_END, false);
-            break;
-        case E:
-            m_editor->commandQueue().execute<JumpCursorDeleteWordCommand>(false, rep, JUMP_FORWARD | JUMP_TO_END, false);
-            break;
-        case q:
-            m_editor->commandQueue().execute<JumpCursorDeleteWordCommand>(false, rep, JUMP_BY_WORD | JUMP_TO_END, false);
-            break;
-        case Q:
-            m_editor->commandQueue().execute<JumpCursorDeleteWordCommand>(false, rep, JUMP_TO_END, false);
-            break;
-        case i:
-        {
-            int modifiedRep = std::min(rep + 1, numberOfLines);
-
-            if (m_editor->buffer().getCursorPos().first == numberOfLines - 1) { break; }
-
-            m_editor->commandQueue().execute<RemoveLineCommand>(false, modifiedRep);
-            break;
-        }
-        case p:
-        {
-            int modifiedrep = std::min(rep + 1, numberOfLines);
-
-            const std::pair<int, int>& cursorPos = m_editor->buffer().getCursorPos();
-
-            if (cursorPos.first == 0) { break; }
-
-            bool onLastLine = (cursorPos.first == numberOfLines - 1);
-
-            for (int i = 0; i < modifiedrep; i++)
-            {
-                if (!onLastLine && i > 0) { m_editor->buffer().shiftCursorY(-1); }
-                m_editor->commandQueue().execute<RemoveLineCommand>(true, 1);
-            }
+    int repetition = repetitionCount();
 
-            break;
-        }
-        default:
-            // TODO: Send signal that command isn't valid
-            break;
-    }
+    if (const KeyBinding* binding = KeyBindings::afterDelete(input)) { binding->run(keyContext(input, repetition)); }
 
     m_commandBuffer.clear();
 }
 
 void InputController::handleFindCommand(int input)
 {
-    size_t rep = std::min(repetitionCount(), static_cast<int>(m_editor->buffer().getFileGapBuffer().numberOfLines()));
-
-    if (m_commandBuffer == "f")
-    {
-        m_editor->commandQueue().execute<FindCharacterCommand>(false, rep, static_cast<char>(input), true);
-
-        m_searchedForward = true;
-    }
-    else
-    {
-        m_editor->commandQueue().execute<FindCharacterCommand>(false, rep, static_cast<char>(input), false);
-
-        m_searchedForward = false;
-    }
-
-    m_findCharacter = static_cast<char>(input);
+    KeyBindings::findCharacter(keyContext(input, repetitionCount()), m_commandBuffer == "f");
 
     m_commandBuffer.clear();
 }
@@ -887,13 +1215,146 @@ void InputController::handleDeleteToInsertCommands(int input)
     m_commandBuffer.clear();
 }
 
+void InputController::startBackgroundSave(const std::filesystem::path& filePath)
+{
+    // Only one save runs at a time, so a previous one is finished and reported first
+    if (m_editor->buffer().backgroundSave()) { finishBackgroundSave(); }
+
+    m_commandCountOfRunningSave = m_editor->commandQueue().currentCommandCount();
+
+    m_editor->buffer().startSave(filePath);
+
+    updateInputTimeout();
+}
+
+void InputController::finishBackgroundSave()
+{
+    std::filesystem::path filePath = m_editor->buffer().backgroundSave()->filePath();
+
+    if (reportSave(filePath, m_editor->buffer().finishSave()) && filePath == m_editor->buffer().filePath())
+    {
+        m_editor->document().setLastSavedCommand(m_commandCountOfRunningSave);
+    }
+
+    updateInputTimeout();
+}
+
+void InputController::pollBackgroundSave()
+{
+    const BackgroundSave* backgroundSave = m_editor->buffer().backgroundSave();
+
+    if (!backgroundSave) { return; }
+
+    if (!backgroundSave->finished())
+    {
+        m_editor->view().displayBufferInformationLine();
+        return;
+    }
+
+    finishBackgroundSave();
+
+    m_editor->view().display();
+
+    if (m_editor->mode() == COMMAND_MODE) { m_editor->view().displayCommandBuffer(); }
+}
+
+void InputController::switchToDocument(size_t index)
+{
+    // The save reports into the document it was started from
+    if (m_editor->buffer().backgroundSave()) { finishBackgroundSave(); }
+
+    m_editor->showDocument(index);
+
+    std::ostringstream message;
+    message << '"' << m_editor->buffer().filePath().string() << "\" " << m_editor->buffer().getFile().numberOfLines() << " lines";
+
+    m_editor->view().setMessage(message.str());
+}
+
+bool InputController::unsavedChanges()
+{
+    const std::vector<std::unique_ptr<Document>>& documents = m_editor->documents();
+
+    if (m_editor->document().modified())
+    {
+        displayErrorMessage("No write since last change");
+        return true;
+    }
+
+    for (const std::unique_ptr<Document>& document : documents)
+    {
+        if (document->modified())
+        {
+            displayErrorMessage("No write since last change for buffer \"" + document->fileName() + "\"");
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void InputController::pollSyntaxHighlighting()
+{
+    if (!m_editor->buffer().syntaxHighlighter().scan().finished()) { return; }
+
+    // Drawing takes the finished pass over and colors the lines
+    m_editor->view().display();
+
+    if (m_editor->mode() == COMMAND_MODE) { m_editor->view().displayCommandBuffer(); }
+}
+
+void InputController::updateInputTimeout()
+{
+    const SyntaxHighlighter& syntaxHighlighter = m_editor->buffer().syntaxHighlighter();
+
+    bool polling = m_editor->buffer().backgroundSave() || syntaxHighlighter.scan().started();
+
+    int milliseconds = polling ? SAVE_PROGRESS_MILLISECONDS : -1;
+    int timerMilliseconds = m_editor->timerQueue().millisecondsUntilNext(TimerQueue::Clock::now());
+
+    if (timerMilliseconds != -1 && (milliseconds == -1 || timerMilliseconds < milliseconds)) { milliseconds = timerMilliseconds; }
+
+    timeout(milliseconds);
+}
+
+bool InputController::reportSave(const std::filesystem::path& filePath, const SaveResult& result)
+{
+    if (!result.succeeded)
+    {
+        displayErrorMessage(result.error);
+        return false;
+    }
+
+    double megabytes = result.bytesWritten / (1024.0 * 1024.0);
+
+    std::ostringstream message;
+    message << '"' << filePath.string() << "\" " << result.bytesWritten << "B written in " << std::fixed << std::setprecision(3) << result.seconds << "s";
+
+    if (result.seconds > 0) { message << " (" << std::setprecision(1) << megabytes / result.seconds << " MB/s)"; }
+
+    m_editor->view().setMessage(message.str());
+    m_editor->view().setStatus("Saved");
+
+    return true;
+}
+
 void InputController::displayErrorMessage(const std::string& message)
 {
     m_commandBuffer = message;
 
     m_editor->view().displayCommandBuffer(COLOR_PAIR(ERROR_MESSAGE_PAIR));
 
-    getch();
+    // Seen before waiting on the key even in the middle of a macro
+    int renderSuppression = m_editor->view().suspendRenderTransactions();
+
+    // getch may be polling a running save or waiting on a timer, but the message stays until a key is pressed
+    while (getch() == ERR)
+    {
+        m_editor->runDueTimers();
+        updateInputTimeout();
+    }
+
+    m_editor->view().resumeRenderTransactions(renderSuppression);
 }
 
 void InputController::handleVisualModes(int input)
@@ -1084,7 +1545,7 @@ void InputController::handleVisualModes(int input)
 
 void InputController::handleGoCommands(int input)
 {
-    clearRepetitionBuffer();
+    int repetition = repetitionCount();
 
     switch (input)
     {
@@ -1094,9 +1555,66 @@ void InputController::handleGoCommands(int input)
         case i:
             m_editor->commandQueue().execute<CursorFullBottomCommand>(false, 1);
             break;
+        case '-':
+            m_editor->commandQueue().travelChronologically(-repetition);
+            break;
+        case '+':
+            m_editor->commandQueue().travelChronologically(repetition);
+            break;
+    }
+
+    m_commandBuffer.clear();
+}
+
+void InputController::handleWindowCommands(int input)
+{
+    View& view = m_editor->view();
+
+    switch (input)
+    {
+        case s:
+        case S:
+            if (!view.splitViewport(false)) { displayErrorMessage("Not enough room"); }
+            break;
+        case v:
+        case V:
+            if (!view.splitViewport(true)) { displayErrorMessage("Not enough room"); }
+            break;
+        case c:
+        case q:
+            if (!m_editor->closeViewport()) { displayErrorMessage("Cannot close last window"); }
+            break;
+        case o:
+            view.onlyViewport();
+            break;
+        case w:
+        case CTRL_W:
+            m_editor->focusViewport(view.nextViewport());
+            break;
+        case h:
+            focusNeighborViewport(NEIGHBOR_LEFT);
+            break;
+        case i:
+            focusNeighborViewport(NEIGHBOR_DOWN);
+            break;
+        case p:
+            focusNeighborViewport(NEIGHBOR_UP);
+            break;
+        case APOSTROPHE:
+            focusNeighborViewport(NEIGHBOR_RIGHT);
+            break;
     }
 
     m_commandBuffer.clear();
+
+    view.display();
+}
+
+void InputController::focusNeighborViewport(NEIGHBOR_DIRECTION direction)
+{
+    int neighbor = m_editor->view().neighborViewport(direction);
+
+    if (neighbor != -1) { m_editor->focusViewport(neighbor); }
 }
 
 void InputController::handleYankCommands(int input)
@@ -1,10 +1,14 @@
 #pragma once
 
 #include "Command.h"
+#include "KeyBindings.h"
 #include "CircularBuffer.h"
 #include "MacroRegisters.h"
+#include "SearchPattern.h"
+#include "SplitLayout.h"
 
 class Editor;
+struct SaveResult;
 
 class InputController
 {
@@ -19,15 +23,33 @@ private:
     char m_findCharacter = '\0';
     bool m_searchedForward = true;
 
+    // Command mode doubles as the search prompt of / and ?, which shows its key in place of the colon
+    char m_commandLinePrompt = ':';
+    bool m_searchedPatternForward = true;
+    std::pair<int, int> m_cursorPosBeforeSearch;
+    std::shared_ptr<const SearchPattern> m_highlightBeforeSearch;
+
     int m_previousInput = 0;
     MODE m_previousMode = NORMAL_MODE;
 
-    size_t m_lastSavedCommand = 0;
+    size_t m_commandCountOfRunningSave = 0;
 
     CircularBuffer m_circularInputBuffer;
 
     std::pair<int, int> m_cursorPosOnVisualMode;
 
+    // How many frames the screen was drawn in for each key pressed, to catch inputs that draw more than once
+    size_t m_framesAtInputStart = 0;
+    MODE m_modeAtInputStart = NORMAL_MODE;
+    size_t m_framesOfLastInput = 0;
+    size_t m_mostFramesOfAnInput = 0;
+
+    // Cells sent to the terminal for the last input, and about how many bytes they took
+    size_t m_cellsAtInputStart = 0;
+    size_t m_estimatedBytesAtInputStart = 0;
+    size_t m_cellsOfLastInput = 0;
+    size_t m_estimatedBytesOfLastInput = 0;
+
 // ============== RANDOM INPUT TESTING =================
 
     const bool m_testInput = false;
@@ -65,9 +87,18 @@ private:
     void replayLastMacro(const int repetition);
     void recursiveMacroReplay(const int macroRegister);
 
+    // Runs the keys compiled into commands if they can be, returning false if they have to be replayed key by key instead
+    bool runCompiledMacro(const std::vector<int>& keys, int repetition);
+
+    // Runs the keys on every line in the range as one change, from the start of each line or where the cursor is
+    void runOnLines(const std::vector<int>& keys, int firstLine, int lastLine, bool fromLineStart);
+    bool parseLineRange(const std::string& range, int& firstLine, int& lastLine) const;
+
 
 // =============== PRIVATE FUNCTIONS ===================
 
+    void countFramesOfLastInput();
+
     void handleNormalModeInput(int input);
     void handleCommandModeInput(int input);
     void handleInsertModeInput(int input);
@@ -75,26 +106,60 @@ private:
     void handleVisualModes(int input);
 
     void handleCommandBufferInput();
+
+    void startSearch(bool forward);
+    void handleSearchInput(int input);
+    // Highlights the pattern typed so far and moves to its first match from where the search started
+    void previewSearch();
+    void endSearch(bool accepted);
     void handleDeleteCommands(int input);
     void handleFindCommand(int input);
     void handleDeleteToInsertCommands(int input);
     void handleGoCommands(int input);
     void handleYankCommands(int input);
+    // Second key of CTRL-W, splitting, closing or moving between viewports
+    void handleWindowCommands(int input);
+    void focusNeighborViewport(NEIGHBOR_DIRECTION direction);
 
     void clearRepetitionBuffer() { m_repetitionBuffer.clear(); }
     int repetitionCount();
 
+    // Runs the commands a key is bound to, with the count typed before it if it takes one
+    KeyContext keyContext(int key, int repetition);
+    void runKeyBinding(const KeyBinding& binding, int key);
+
     bool repeatedInput(int input) { return (input == m_previousInput) ;}
     void displayErrorMessage(const std::string& message);
 
+    void startBackgroundSave(const std::filesystem::path& filePath);
+    void finishBackgroundSave();
+    void pollBackgroundSave();
+    void pollSyntaxHighlighting();
+
+    // Makes getch time out while anything running in the background has to be polled
+    void updateInputTimeout();
+
+    // Finishes a running save and shows the document at index
+    void switchToDocument(size_t index);
+
+    // Shows an error and returns true if any open file has changes that were not written
+    bool unsavedChanges();
+
+    // Shows how fast a save went, or why it failed. Returns whether the file was written.
+    bool reportSave(const std::filesystem::path& filePath, const SaveResult& result);
+
 public:
 
     InputController(Editor* editor);
 
     void handleInput(int input = -1);
 
+    // Whether keys have been typed that were not read yet
+    bool inputPending() const;
+
     // Getters
     const std::string& commandBuffer() const { return m_commandBuffer; }
+    char commandLinePrompt() const { return m_commandLinePrompt; }
     const CircularBuffer& circularBuffer() const { return m_circularInputBuffer; }
     const std::pair<int, int>& initialVisualModeCursor() const { return m_cursorPosOnVisualMode; }
 
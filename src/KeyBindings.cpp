@@ -0,0 +1,188 @@
+#include "KeyBindings.h"
+#include "Buffer.h"
+#include "CommandQueue.h"
+
+// Counts of line operators are cut down to the number of lines the file has when they run
+static int lineRepetition(const KeyContext& context)
+{
+    return std::min(context.repetition, static_cast<int>(context.buffer->getFile().numberOfLines()));
+}
+
+static void deleteWord(const KeyContext& context, int jumpCode)
+{
+    context.commandQueue->execute<JumpCursorDeleteWordCommand>(false, lineRepetition(context), jumpCode, false);
+}
+
+static void jumpCursor(const KeyContext& context, int jumpCode)
+{
+    context.commandQueue->execute<JumpCursorCommand>(false, context.repetition, jumpCode);
+}
+
+static void tabLine(const KeyContext& context, bool headingRight)
+{
+    if (context.repetition > 1) { context.commandQueue->execute<TabLineCommand>(false, context.repetition, headingRight); }
+    else { context.commandQueue->execute<TabLineCommand>(true, 1, headingRight); }
+}
+
+const std::unordered_map<int, KeyBinding> KeyBindings::normalModeBindings = {
+    { CTRL_C, { true, NORMAL_MODE, [](const KeyContext&) {} } },
+    { j, { false, INSERT_MODE, [](const KeyContext& context) { context.commandQueue->execute<SetModeCommand>(false, 1, INSERT_MODE, 0); } } },
+    { a, { false, INSERT_MODE, [](const KeyContext& context) { context.commandQueue->execute<SetModeCommand>(false, 1, INSERT_MODE, 1); } } },
+    { h, { true, NORMAL_MODE, [](const KeyContext& context) { context.commandQueue->execute<MoveCursorXCommand>(false, 1, -1 * context.repetition); } } },
+    { i, { true, NORMAL_MODE, [](const KeyContext& context) { context.commandQueue->execute<MoveCursorYCommand>(false, 1, 1 * context.repetition); } } },
+    { p, { true, NORMAL_MODE, [](const KeyContext& context) { context.commandQueue->execute<MoveCursorYCommand>(false, 1, -1 * context.repetition); } } },
+    { APOSTROPHE, { true, NORMAL_MODE, [](const KeyContext& context) { context.commandQueue->execute<MoveCursorXCommand>(false, 1, 1 * context.repetition); } } },
+    { H, { false, NORMAL_MODE, [](const KeyContext& context) { context.commandQueue->execute<CursorFullLeftCommand>(false, 1); } } },
+    { QUOTE, { false, NORMAL_MODE, [](const KeyContext& context) { context.commandQueue->execute<CursorFullRightCommand>(false, 1); } } },
+    { I, { false, NORMAL_MODE, [](const KeyContext& context) { context.commandQueue->execute<QuickVerticalMovementCommand>(false, 1, true); } } },
+    { P, { false, NORMAL_MODE, [](const KeyContext& context) { context.commandQueue->execute<QuickVerticalMovementCommand>(false, 1, false); } } },
+    { u, { false, NORMAL_MODE, [](const KeyContext& context) { context.commandQueue->execute<UndoCommand>(false, 1); } } },
+    { CTRL_R, { false, NORMAL_MODE, [](const KeyContext& context) { context.commandQueue->execute<RedoCommand>(false, 1); } } },
+    { x, { true, NORMAL_MODE, [](const KeyContext& context) { context.commandQueue->execute<RemoveCharacterNormalCommand>(true, context.repetition, false); } } },
+    { X, { true, NORMAL_MODE, [](const KeyContext& context) { context.commandQueue->execute<RemoveCharacterNormalCommand>(true, context.repetition, true); } } },
+    { A, { false, INSERT_MODE, [](const KeyContext& context)
+    {
+        context.commandQueue->execute<CursorFullRightCommand>(false, 1);
+        context.commandQueue->execute<SetModeCommand>(false, 1, INSERT_MODE, 1);
+    } } },
+    { J, { false, INSERT_MODE, [](const KeyContext& context)
+    {
+        context.commandQueue->execute<CursorFullLeftCommand>(false, 1);
+        context.commandQueue->execute<SetModeCommand>(false, 1, INSERT_MODE, 0);
+    } } },
+    { r, { false, REPLACE_CHAR_MODE, [](const KeyContext& context) { context.commandQueue->execute<SetModeCommand>(false, 1, REPLACE_CHAR_MODE, 0); } } },
+    { o, { false, INSERT_MODE, [](const KeyContext& context) { context.commandQueue->execute<InsertLineNormalCommand>(true, 1, true); } } },
+    { O, { false, INSERT_MODE, [](const KeyContext& context) { context.commandQueue->execute<InsertLineNormalCommand>(true, 1, false); } } },
+    { SEMICOLON, { true, NORMAL_MODE, [](const KeyContext& context)
+    {
+        context.commandQueue->execute<FindCharacterCommand>(false, context.repetition, *context.findCharacter, *context.searchedForward);
+    } } },
+    { COMMA, { true, NORMAL_MODE, [](const KeyContext& context)
+    {
+        context.commandQueue->execute<FindCharacterCommand>(false, context.repetition, *context.findCharacter, !*context.searchedForward);
+    } } },
+    { w, { true, NORMAL_MODE, [](const KeyContext& context) { jumpCursor(context, JUMP_FORWARD | JUMP_BY_WORD); } } },
+    { W, { true, NORMAL_MODE, [](const KeyContext& context) { jumpCursor(context, JUMP_FORWARD); } } },
+    { s, { true, NORMAL_MODE, [](const KeyContext& context) { jumpCursor(context, JUMP_BY_WORD); } } },
+    { S, { true, NORMAL_MODE, [](const KeyContext& context) { jumpCursor(context, 0); } } },
+    { e, { true, NORMAL_MODE, [](const KeyContext& context) { jumpCursor(context, JUMP_FORWARD | JUMP_BY_WORD | JUMP_TO_END); } } },
+    { E, { true, NORMAL_MODE, [](const KeyContext& context) { jumpCursor(context, JUMP_FORWARD | JUMP_TO_END); } } },
+    { q, { true, NORMAL_MODE, [](const KeyContext& context) { jumpCursor(context, JUMP_BY_WORD | JUMP_TO_END); } } },
+    { Q, { true, NORMAL_MODE, [](const KeyContext& context) { jumpCursor(context, JUMP_TO_END); } } },
+    { k, { true, NORMAL_MODE, [](const KeyContext& context) { context.commandQueue->execute<PasteCommand>(false, context.repetition); } } },
+    { LESS_THAN_SIGN, { true, NORMAL_MODE, [](const KeyContext& context) { tabLine(context, false); } } },
+    { GREATER_THAN_SIGN, { true, NORMAL_MODE, [](const KeyContext& context) { tabLine(context, true); } } },
+    { t, { false, NORMAL_MODE, [](const KeyContext& context) { context.commandQueue->execute<ToggleCommentLineCommand>(false, 1); } } },
+};
+
+const std::unordered_map<int, KeyBinding> KeyBindings::insertModeBindings = {
+    { CTRL_C, { false, NORMAL_MODE, [](const KeyContext& context) { context.commandQueue->execute<SetModeCommand>(false, 1, NORMAL_MODE, -1); } } },
+    { ESCAPE, { false, NORMAL_MODE, [](const KeyContext& context) { context.commandQueue->execute<SetModeCommand>(false, 1, NORMAL_MODE, -1); } } },
+    { BACKSPACE, { false, INSERT_MODE, [](const KeyContext& context) { context.commandQueue->execute<RemoveCharacterInsertCommand>(context.repeated, 1); } } },
+    { ENTER, { false, INSERT_MODE, [](const KeyContext& context) { context.commandQueue->execute<InsertLineInsertCommand>(true, 1); } } },
+    { TAB, { false, INSERT_MODE, [](const KeyContext& context) { context.commandQueue->execute<TabCommand>(true, 1); } } },
+    { LEFT_PARENTHESIS, { false, INSERT_MODE, [](const KeyContext& context) { context.commandQueue->execute<AutocompletePair>(true, 1, '('); } } },
+    { LEFT_BRACKET, { false, INSERT_MODE, [](const KeyContext& context) { context.commandQueue->execute<AutocompletePair>(true, 1, '['); } } },
+    { LEFT_BRACE, { false, INSERT_MODE, [](const KeyContext& context) { context.commandQueue->execute<AutocompletePair>(true, 1, '{'); } } },
+    { APOSTROPHE, { false, INSERT_MODE, [](const KeyContext& context) { context.commandQueue->execute<AutocompletePair>(true, 1, '\''); } } },
+    { QUOTE, { false, INSERT_MODE, [](const KeyContext& context) { context.commandQueue->execute<AutocompletePair>(true, 1, '"'); } } },
+    { CTRL_W, { false, INSERT_MODE, [](const KeyContext& context) { context.commandQueue->execute<JumpCursorDeletePreviousWordInsertModeCommand>(true, 1); } } },
+};
+
+const KeyBinding KeyBindings::insertCharacterBinding = { false, INSERT_MODE, [](const KeyContext& context)
+{
+    context.commandQueue->execute<InsertCharacterCommand>(true, 1, static_cast<char>(context.key));
+} };
+
+const std::unordered_map<int, KeyBinding> KeyBindings::deleteBindings = {
+    { d, { true, NORMAL_MODE, [](const KeyContext& context) { context.commandQueue->execute<RemoveLineCommand>(false, lineRepetition(context)); } } },
+    { w, { true, NORMAL_MODE, [](const KeyContext& context) { deleteWord(context, JUMP_FORWARD | JUMP_BY_WORD); } } },
+    { W, { true, NORMAL_MODE, [](const KeyContext& context) { deleteWord(context, JUMP_FORWARD); } } },
+    { s, { true, NORMAL_MODE, [](const KeyContext& context) { deleteWord(context, JUMP_BY_WORD); } } },
+    { S, { true, NORMAL_MODE, [](const KeyContext& context) { deleteWord(context, 0); } } },
+    { e, { true, NORMAL_MODE, [](const KeyContext& context) { deleteWord(context, JUMP_FORWARD | JUMP_BY_WORD | JUMP_TO_END); } } },
+    { E, { true, NORMAL_MODE, [](const KeyContext& context) { deleteWord(context, JUMP_FORWARD | JUMP_TO_END); } } },
+    { q, { true, NORMAL_MODE, [](const KeyContext& context) { deleteWord(context, JUMP_BY_WORD | JUMP_TO_END); } } },
+    { Q, { true, NORMAL_MODE, [](const KeyContext& context) { deleteWord(context, JUMP_TO_END); } } },
+    { i, { true, NORMAL_MODE, [](const KeyContext& context)
+    {
+        // The line the cursor is on and the ones below it
+        int numberOfLines = static_cast<int>(context.buffer->getFile().numberOfLines());
+
+        if (context.buffer->getCursorPos().first == numberOfLines - 1) { return; }
+
+        context.commandQueue->execute<RemoveLineCommand>(false, std::min(lineRepetition(context) + 1, numberOfLines));
+    } } },
+    { p, { true, NORMAL_MODE, [](const KeyContext& context)
+    {
+        // The line the cursor is on and the ones above it
+        int numberOfLines = static_cast<int>(context.buffer->getFile().numberOfLines());
+        int removedLines = std::min(lineRepetition(context) + 1, numberOfLines);
+
+        const std::pair<int, int>& cursorPos = context.buffer->getCursorPos();
+
+        if (cursorPos.first == 0) { return; }
+
+        bool onLastLine = (cursorPos.first == numberOfLines - 1);
+
+        for (int line = 0; line < removedLines; line++)
+        {
+            if (!onLastLine && line > 0) { context.buffer->shiftCursorY(-1); }
+            context.commandQueue->execute<RemoveLineCommand>(true, 1);
+        }
+    } } },
+};
+
+const KeyBinding* KeyBindings::normalMode(int key)
+{
+    std::unordered_map<int, KeyBinding>::const_iterator binding = normalModeBindings.find(key);
+
+    return (binding != normalModeBindings.end()) ? &binding->second : nullptr;
+}
+
+const KeyBinding* KeyBindings::insertMode(int key)
+{
+    std::unordered_map<int, KeyBinding>::const_iterator binding = insertModeBindings.find(key);
+
+    if (binding != insertModeBindings.end()) { return &binding->second; }
+
+    // Other keys do nothing in insert mode
+    return (key >= 32 && key <= 126) ? &insertCharacterBinding : nullptr;
+}
+
+const KeyBinding* KeyBindings::afterDelete(int key)
+{
+    std::unordered_map<int, KeyBinding>::const_iterator binding = deleteBindings.find(key);
+
+    return (binding != deleteBindings.end()) ? &binding->second : nullptr;
+}
+
+void KeyBindings::findCharacter(const KeyContext& context, bool forward)
+{
+    char character = static_cast<char>(context.key);
+
+    context.commandQueue->execute<FindCharacterCommand>(false, lineRepetition(context), character, forward);
+
+    *context.searchedForward = forward;
+    *context.findCharacter = character;
+}
+
+bool KeyBindings::addRepetitionDigit(std::string& repetitionBuffer, int key)
+{
+    if (key < '0' || key > '9') { return false; }
+
+    repetitionBuffer.push_back(static_cast<char>(key));
+
+    if (repetitionBuffer == "0") { repetitionBuffer.clear(); }
+
+    return true;
+}
+
+int KeyBindings::takeRepetition(std::string& repetitionBuffer)
+{
+    int repetitionCount = atoi(repetitionBuffer.c_str());
+
+    repetitionBuffer.clear();
+
+    return std::clamp(repetitionCount, 1, MAX_REPETITION_COUNT);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Includes.h"
+
+class CommandQueue;
+class Buffer;
+
+// What a bound key reads and changes when it runs
+struct KeyContext
+{
+    CommandQueue* commandQueue;
+    Buffer* buffer;
+
+    int key;
+
+    // Count typed before the key, from 1 up, if the key takes one
+    int repetition;
+
+    // Whether the key before was the same one, so holding a key down is undone as one change
+    bool repeated;
+
+    // What the last f or F looked for and which way, for ; and , to look for it again
+    char* findCharacter;
+    bool* searchedForward;
+};
+
+struct KeyBinding
+{
+    // Whether the key takes the count typed before it. Keys that do not leave it for the key after them.
+    bool takesRepetition;
+
+    // Mode the key leaves the editor in
+    MODE nextMode;
+
+    typedef void (*RunFunction)(const KeyContext& context);
+    RunFunction run;
+};
+
+// The commands keys run in normal mode, in insert mode and after d. Typed keys and compiled macros both look them up here,
+// so a macro runs the same commands as its keys typed by hand. Keys that need more of the input controller than the
+// commands, like visual mode, search or macros themselves, are handled by it directly.
+class KeyBindings
+{
+
+private:
+
+    static const std::unordered_map<int, KeyBinding> normalModeBindings;
+    static const std::unordered_map<int, KeyBinding> insertModeBindings;
+    static const std::unordered_map<int, KeyBinding> deleteBindings;
+
+    // Printable characters without a binding of their own are typed into the line
+    static const KeyBinding insertCharacterBinding;
+
+public:
+
+    // Binding of key in normal mode, in insert mode or typed after d, or null if it has none there
+    static const KeyBinding* normalMode(int key);
+    static const KeyBinding* insertMode(int key);
+    static const KeyBinding* afterDelete(int key);
+
+    // f or F followed by the character in context.key
+    static void findCharacter(const KeyContext& context, bool forward);
+
+    // Adds key to the count being typed if it is a digit. A count does not start with 0.
+    static bool addRepetitionDigit(std::string& repetitionBuffer, int key);
+
+    // The count typed so far, from 1 up, which is then cleared
+    static int takeRepetition(std::string& repetitionBuffer);
+
+};
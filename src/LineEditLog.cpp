@@ -0,0 +1,94 @@
+#include "LineEditLog.h"
+
+void LineEditLog::record(LINE_EDIT_TYPE type, size_t index, size_t count)
+{
+    if (m_overflowed) { return; }
+
+    if (!m_edits.empty())
+    {
+        LineEdit& lastEdit = m_edits.back();
+
+        // Typing keeps changing the same line, pasting inserts line after line and deleting removes line at the same index
+        if (lastEdit.type == type && type == LINE_CHANGED && index >= lastEdit.index && index <= lastEdit.index + lastEdit.count)
+        {
+            lastEdit.count = std::max(lastEdit.count, index + count - lastEdit.index);
+            return;
+        }
+
+        if (lastEdit.type == type && ((type == LINES_INSERTED && (lastEdit.index == index || lastEdit.index + lastEdit.count == index)) ||
+            (type == LINES_REMOVED && lastEdit.index == index)))
+        {
+            lastEdit.count += count;
+            return;
+        }
+    }
+
+    if (m_edits.size() == MAX_RECORDED_LINE_EDITS)
+    {
+        m_edits.clear();
+        m_overflowed = true;
+        return;
+    }
+
+    m_edits.push_back(LineEdit{ type, index, count });
+}
+
+void LineEditLog::clear()
+{
+    m_edits.clear();
+    m_overflowed = false;
+}
+
+std::vector<std::pair<size_t, size_t>> LineEditLog::changedRanges(bool linesAfterRemovals) const
+{
+    // Ranges are kept in the line numbers of the file as it is after each edit
+    std::vector<std::pair<size_t, size_t>> ranges;
+
+    for (const LineEdit& lineEdit : m_edits)
+    {
+        size_t index = lineEdit.index;
+        size_t count = lineEdit.count;
+
+        if (lineEdit.type == LINE_CHANGED)
+        {
+            ranges.push_back(std::pair<size_t, size_t>(index, index + count));
+            continue;
+        }
+
+        std::vector<std::pair<size_t, size_t>> shiftedRanges;
+
+        if (lineEdit.type == LINES_INSERTED)
+        {
+            for (const std::pair<size_t, size_t>& range : ranges)
+            {
+                if (range.second <= index) { shiftedRanges.push_back(range); }
+                else if (range.first >= index) { shiftedRanges.push_back(std::pair<size_t, size_t>(range.first + count, range.second + count)); }
+                else
+                {
+                    shiftedRanges.push_back(std::pair<size_t, size_t>(range.first, index));
+                    shiftedRanges.push_back(std::pair<size_t, size_t>(index + count, range.second + count));
+                }
+            }
+
+            shiftedRanges.push_back(std::pair<size_t, size_t>(index, index + count));
+        }
+        else
+        {
+            for (const std::pair<size_t, size_t>& range : ranges)
+            {
+                size_t first = range.first < index ? range.first : range.first < index + count ? index : range.first - count;
+                size_t end = range.second < index ? range.second : range.second < index + count ? index : range.second - count;
+
+                if (first < end) { shiftedRanges.push_back(std::pair<size_t, size_t>(first, end)); }
+            }
+
+            if (linesAfterRemovals) { shiftedRanges.push_back(std::pair<size_t, size_t>(index, index + 1)); }
+        }
+
+        ranges = std::move(shiftedRanges);
+    }
+
+    std::sort(ranges.begin(), ranges.end());
+
+    return ranges;
+}
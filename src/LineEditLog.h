@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Includes.h"
+
+enum LINE_EDIT_TYPE
+{
+    LINE_CHANGED,
+    LINES_INSERTED,
+    LINES_REMOVED,
+};
+
+struct LineEdit
+{
+    LINE_EDIT_TYPE type;
+    size_t index;
+    size_t count;
+};
+
+const size_t MAX_RECORDED_LINE_EDITS = 4096;
+
+// Line edits in order, so data indexed by line can be shifted instead of rebuilt. Runs of edits to neighbouring lines are
+// merged into one, and once there are too many only the fact that the log overflowed is kept.
+class LineEditLog
+{
+
+private:
+
+    std::vector<LineEdit> m_edits;
+    bool m_overflowed;
+
+public:
+
+    LineEditLog(bool overflowed = false)
+        : m_overflowed(overflowed) {}
+
+    void record(LINE_EDIT_TYPE type, size_t index, size_t count = 1);
+    void clear();
+
+    // Lines the edits changed or inserted, as sorted and possibly overlapping [first, end) ranges of line numbers after all
+    // the edits. With linesAfterRemovals, the line that took the place of removed lines counts as changed too.
+    std::vector<std::pair<size_t, size_t>> changedRanges(bool linesAfterRemovals = false) const;
+
+    // Getters
+    const std::vector<LineEdit>& edits() const { return m_edits; }
+    bool overflowed() const { return m_overflowed; }
+    bool empty() const { return m_edits.empty() && !m_overflowed; }
+
+};
@@ -1,17 +1,32 @@
 #include "LineGapBuffer.h"
 
 LineGapBuffer::LineGapBuffer(int initialSize)
-    : m_buffer(std::vector<char>(initialSize)), m_preGapIndex(0), m_postGapIndex(initialSize), m_bufferSize(initialSize)
+    : m_buffer(std::vector<char>(initialSize)), m_preGapIndex(0), m_postGapIndex(initialSize), m_bufferSize(initialSize), m_mappedLine(nullptr), m_generation(currentGeneration),
+    m_version(0), m_firstNonSpaceIndex(0), m_firstNonSpaceIndexKnown(false), m_hash(0), m_hashVersion(0), m_hashKnown(false)
 {
 }
 
 LineGapBuffer::LineGapBuffer(int initialSize, const std::string& line)
-    : m_buffer(std::vector<char>(initialSize)), m_preGapIndex(0), m_postGapIndex(initialSize), m_bufferSize(initialSize)
+    : m_buffer(std::vector<char>(std::max(static_cast<size_t>(initialSize), line.size() * 2))), m_preGapIndex(0),
+    m_postGapIndex(m_buffer.size() - line.size()), m_bufferSize(m_buffer.size()), m_mappedLine(nullptr),
+    m_generation(currentGeneration), m_version(0), m_firstNonSpaceIndex(0), m_firstNonSpaceIndexKnown(false), m_hash(0), m_hashVersion(0),
+    m_hashKnown(false)
+{
+    memcpy(m_buffer.data() + m_postGapIndex, line.data(), line.size());
+}
+
+LineGapBuffer::LineGapBuffer(const char* mappedLine, size_t lineSize)
+    : m_preGapIndex(0), m_postGapIndex(0), m_bufferSize(lineSize), m_mappedLine(mappedLine), m_generation(currentGeneration),
+    m_version(0), m_firstNonSpaceIndex(0), m_firstNonSpaceIndexKnown(false), m_hash(0), m_hashVersion(0), m_hashKnown(false)
 {
-    for (char character : line)
-    {
-        insertChar(character);
-    }
+}
+
+std::shared_ptr<LineGapBuffer> LineGapBuffer::clone() const
+{
+    std::shared_ptr<LineGapBuffer> copy = std::make_shared<LineGapBuffer>(*this);
+    copy->m_generation = currentGeneration;
+
+    return copy;
 }
 
 void LineGapBuffer::left()
@@ -26,6 +41,8 @@ void LineGapBuffer::left()
 
 void LineGapBuffer::right()
 {
+    if (m_mappedLine) { materialize(); }
+
     if (m_postGapIndex < m_bufferSize)
     {
         m_buffer[m_preGapIndex] = m_buffer[m_postGapIndex];
@@ -34,21 +51,68 @@ void LineGapBuffer::right()
     }
 }
 
+void LineGapBuffer::moveGap(size_t index)
+{
+    index = std::min(index, lineSize());
+
+    if (index == m_preGapIndex) { return; }
+
+    if (m_mappedLine) { materialize(); }
+
+    if (index < m_preGapIndex)
+    {
+        size_t distance = m_preGapIndex - index;
+
+        memmove(m_buffer.data() + m_postGapIndex - distance, m_buffer.data() + index, distance);
+
+        m_preGapIndex -= distance;
+        m_postGapIndex -= distance;
+    }
+    else
+    {
+        size_t distance = index - m_preGapIndex;
+
+        memmove(m_buffer.data() + m_preGapIndex, m_buffer.data() + m_postGapIndex, distance);
+
+        m_preGapIndex += distance;
+        m_postGapIndex += distance;
+    }
+}
+
 void LineGapBuffer::insertChar(char character)
 {
+    if (m_mappedLine) { materialize(); }
+
     if (m_preGapIndex >= m_postGapIndex)
     {
         grow();
     }
 
+    // Text inserted in front of the first non-space character shifts it, or becomes it
+    if (m_firstNonSpaceIndexKnown && m_preGapIndex <= m_firstNonSpaceIndex)
+    {
+        m_firstNonSpaceIndex = (character == ' ') ? m_firstNonSpaceIndex + 1 : m_preGapIndex;
+    }
+
     m_buffer[m_preGapIndex] = character;
     m_preGapIndex++;
+    m_version++;
 }
 
 char LineGapBuffer::deleteChar()
 {
     if (m_preGapIndex > 0)
     {
+        size_t deletedIndex = m_preGapIndex - 1;
+
+        if (m_firstNonSpaceIndexKnown)
+        {
+            if (deletedIndex < m_firstNonSpaceIndex) { m_firstNonSpaceIndex--; }
+            else if (deletedIndex == m_firstNonSpaceIndex) { m_firstNonSpaceIndexKnown = false; }
+        }
+
+        m_version++;
+
         return m_buffer[m_preGapIndex--];
     }
     else
@@ -57,8 +121,52 @@ char LineGapBuffer::deleteChar()
     }
 }
 
+void LineGapBuffer::insertText(std::string_view text)
+{
+    if (text.empty()) { return; }
+
+    if (m_mappedLine) { materialize(); }
+
+    if (m_postGapIndex - m_preGapIndex < text.size())
+    {
+        growGap(text.size());
+    }
+
+    if (m_firstNonSpaceIndexKnown && m_preGapIndex <= m_firstNonSpaceIndex)
+    {
+        size_t index = text.find_first_not_of(' ');
+
+        m_firstNonSpaceIndex = (index == std::string_view::npos) ? m_firstNonSpaceIndex + text.size() : m_preGapIndex + index;
+    }
+
+    memcpy(m_buffer.data() + m_preGapIndex, text.data(), text.size());
+    m_preGapIndex += text.size();
+    m_version++;
+}
+
+void LineGapBuffer::eraseText(size_t index, size_t count)
+{
+    index = std::min(index, lineSize());
+    count = std::min(count, lineSize() - index);
+
+    if (count == 0) { return; }
+
+    moveGap(index + count);
+
+    if (m_firstNonSpaceIndexKnown)
+    {
+        if (index + count <= m_firstNonSpaceIndex) { m_firstNonSpaceIndex -= count; }
+        else if (index <= m_firstNonSpaceIndex) { m_firstNonSpaceIndexKnown = false; }
+    }
+
+    m_preGapIndex -= count;
+    m_version++;
+}
+
 void LineGapBuffer::grow()
 {
+    if (m_mappedLine) { materialize(); }
+
     m_buffer.resize(m_bufferSize * 2);
     m_bufferSize *= 2;
 
@@ -72,6 +180,35 @@ void LineGapBuffer::grow()
     m_postGapIndex = m_bufferSize / 2 + m_preGapIndex;
 }
 
+void LineGapBuffer::growGap(size_t minimumGapSize)
+{
+    size_t newBufferSize = std::max(m_bufferSize * 2, lineSize() + minimumGapSize);
+    size_t postGapSize = m_bufferSize - m_postGapIndex;
+
+    m_buffer.resize(newBufferSize);
+    memmove(m_buffer.data() + newBufferSize - postGapSize, m_buffer.data() + m_postGapIndex, postGapSize);
+
+    m_postGapIndex = newBufferSize - postGapSize;
+    m_bufferSize = newBufferSize;
+}
+
+void LineGapBuffer::materialize()
+{
+    if (!m_mappedLine) { return; }
+
+    size_t lineSize = m_bufferSize;
+
+    m_bufferSize = std::max(static_cast<size_t>(initialBufferSize), lineSize * 2);
+    m_buffer.resize(m_bufferSize);
+
+    // Keep the gap in front of the text, where an unmaterialized line reports it
+    m_preGapIndex = 0;
+    m_postGapIndex = m_bufferSize - lineSize;
+    memcpy(m_buffer.data() + m_postGapIndex, m_mappedLine, lineSize);
+
+    m_mappedLine = nullptr;
+}
+
 void LineGapBuffer::printFullLineGapBuffer() const
 {
     for (size_t index = 0; index < m_buffer.size(); index++)
@@ -89,28 +226,27 @@ void LineGapBuffer::printFullLineGapBuffer() const
     std::cout << std::endl;
 }
 
+void LineGapBuffer::indexOutOfBounds(size_t index) const
+{
+    endwin();
+    std::cerr << "Index out of bounds: " << index << '\n';
+    std::cout << "Line Gap Buffer Info:\n\t" << "Buffer Size: " << m_bufferSize << "\n\t";
+    std::cout << "Num characters: " << lineSize() << "\n\t";
+    std::cout << "Pre index: " << preGapIndex() << "\n\t";
+    std::cout << "Post index: " << postGapIndex() << "\n";
+
+    abort();
+}
+
 char LineGapBuffer::operator[](size_t index) const
 {
-    try
-    {
-        if (!(index < m_bufferSize - m_postGapIndex + m_preGapIndex))
-        {
-            throw (index);
-        }
-    }
-    catch (size_t)
-    {
-        endwin();
-        std::cerr << "Index out of bounds: " << index << '\n';
-        std::cout << "File Gap Buffer Info:\n\t" << "Buffer Size: " << m_bufferSize << "\n\t";
-        std::cout << "Num characters: " << lineSize() << "\n\t";
-        std::cout << "Pre index: " << preGapIndex() << "\n\t";
-        std::cout << "Post index: " << postGapIndex() << "\n";
+    if (index >= lineSize()) { indexOutOfBounds(index); }
 
-        abort();
+    if (m_mappedLine)
+    {
+        return m_mappedLine[index];
     }
-
-    if (index < m_preGapIndex)
+    else if (index < m_preGapIndex)
     {
         return m_buffer[index];
     }
@@ -120,33 +256,74 @@ char LineGapBuffer::operator[](size_t index) const
     }
 }
 
-char LineGapBuffer::at(size_t index) const
+std::string_view LineGapBuffer::postGapSpan() const
 {
-    try
+    if (m_mappedLine) { return std::string_view(m_mappedLine, m_bufferSize); }
+
+    return std::string_view(m_buffer.data() + m_postGapIndex, m_bufferSize - m_postGapIndex);
+}
+
+std::pair<std::string_view, std::string_view> LineGapBuffer::spans(size_t index, size_t count) const
+{
+    std::string_view preGap = preGapSpan();
+    std::string_view postGap = postGapSpan();
+
+    index = std::min(index, lineSize());
+    count = std::min(count, lineSize() - index);
+
+    if (index >= preGap.size()) { return { postGap.substr(index - preGap.size(), count), std::string_view() }; }
+
+    std::string_view first = preGap.substr(index, count);
+
+    return { first, postGap.substr(0, count - first.size()) };
+}
+
+size_t LineGapBuffer::firstNonSpaceIndex() const
+{
+    if (!m_firstNonSpaceIndexKnown)
     {
-        if (!(index < m_bufferSize - m_postGapIndex + m_preGapIndex))
+        std::string_view preGap = preGapSpan();
+        std::string_view postGap = postGapSpan();
+
+        size_t index = preGap.find_first_not_of(' ');
+
+        if (index == std::string_view::npos)
         {
-            throw (index);
+            index = postGap.find_first_not_of(' ');
+            index = (index == std::string_view::npos) ? lineSize() : preGap.size() + index;
         }
-    }
-    catch (size_t)
-    {
-        endwin();
-        std::cerr << "Index out of bounds: " << index << '\n';
-        std::cout << "Line Gap Buffer Info:\n\t" << "Buffer Size: " << m_bufferSize << "\n\t";
-        std::cout << "Num characters: " << lineSize() << "\n\t";
-        std::cout << "Pre index: " << preGapIndex() << "\n\t";
-        std::cout << "Post index: " << postGapIndex() << "\n";
 
-        abort();
+        m_firstNonSpaceIndex = index;
+        m_firstNonSpaceIndexKnown = true;
     }
 
-    if (index < m_preGapIndex)
-    {
-        return m_buffer[index];
-    }
-    else
+    return m_firstNonSpaceIndex;
+}
+
+uint64_t LineGapBuffer::hash() const
+{
+    if (!m_hashKnown || m_hashVersion != m_version)
     {
-        return m_buffer[index + m_postGapIndex - m_preGapIndex];
+        uint64_t hash = 14695981039346656037ULL;
+
+        for (std::string_view span : { preGapSpan(), postGapSpan() })
+        {
+            for (char character : span)
+            {
+                hash ^= static_cast<unsigned char>(character);
+                hash *= 1099511628211ULL;
+            }
+        }
+
+        m_hash = hash;
+        m_hashVersion = m_version;
+        m_hashKnown = true;
     }
+
+    return m_hash;
+}
+
+char LineGapBuffer::at(size_t index) const
+{
+    return (*this)[index];
 }
@@ -12,20 +12,59 @@ private:
     size_t m_postGapIndex;
     size_t m_bufferSize;
 
+    // Untouched lines of a mapped file point into the mapping and are only copied into m_buffer on their first edit
+    const char* m_mappedLine;
+
+    // Value of currentGeneration when this line was created, used to tell whether a save snapshot may hold it
+    uint64_t m_generation;
+
+    // Bumped by every insertChar and deleteChar, so derived data can be cached against it
+    uint64_t m_version;
+
+    // Kept up to date by insertChar and deleteChar where that is cheap, otherwise recomputed on the next read
+    mutable size_t m_firstNonSpaceIndex;
+    mutable bool m_firstNonSpaceIndexKnown;
+
+    mutable uint64_t m_hash;
+    mutable uint64_t m_hashVersion;
+    mutable bool m_hashKnown;
+
+private:
+
+    // Grows the buffer once so the gap holds at least minimumGapSize characters
+    void growGap(size_t minimumGapSize);
+
+    [[noreturn]] void indexOutOfBounds(size_t index) const;
+
 public:
 
     LineGapBuffer(int initialSize);
     LineGapBuffer(int initialSize, const std::string& line);
+    LineGapBuffer(const char* mappedLine, size_t lineSize);
 
     static inline int initialBufferSize = 1;
 
+    // Bumped whenever a save snapshot is taken. Only touched from the main thread.
+    static inline uint64_t currentGeneration = 0;
+
+    // Copy of this line stamped with the current generation
+    std::shared_ptr<LineGapBuffer> clone() const;
+
     void left();
     void right();
 
+    // Relocates the gap in front of index with a single memmove
+    void moveGap(size_t index);
+
     void insertChar(char character);
     char deleteChar();
 
+    // Bulk versions of insertChar and deleteChar, which touch the buffer and the cached metadata once per call
+    void insertText(std::string_view text);
+    void eraseText(size_t index, size_t count);
+
     void grow();
+    void materialize();
 
     void printFullLineGapBuffer() const;
 
@@ -35,6 +74,22 @@ public:
     size_t postGapIndex() const { return m_postGapIndex; }
     size_t bufferSize() const { return m_bufferSize; }
     size_t lineSize() const { return m_bufferSize - (m_postGapIndex - m_preGapIndex); }
+    bool isMapped() const { return m_mappedLine != nullptr; }
+    uint64_t generation() const { return m_generation; }
+    uint64_t version() const { return m_version; }
+
+    // Index of the first character that is not a space, or lineSize() for a line of only spaces
+    size_t firstNonSpaceIndex() const;
+
+    // FNV-1a hash of the text, cached until the next edit
+    uint64_t hash() const;
+
+    // The text before and after the gap, which together make up the whole line
+    std::string_view preGapSpan() const { return (m_mappedLine) ? std::string_view() : std::string_view(m_buffer.data(), m_preGapIndex); }
+    std::string_view postGapSpan() const;
+
+    // Up to count characters starting at index, split in two where the gap falls
+    std::pair<std::string_view, std::string_view> spans(size_t index, size_t count) const;
 
     char operator [](size_t index) const;
     char at(size_t index) const;
@@ -0,0 +1,96 @@
+#include "MappedFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cinttypes>
+
+MappedFile::MappedFile(const std::filesystem::path& filePath)
+    : m_data(nullptr), m_size(0), m_detached(false)
+{
+    int fileDescriptor = open(filePath.c_str(), O_RDONLY);
+
+    if (fileDescriptor == -1) { return; }
+
+    struct stat fileStatus;
+
+    // Empty and special files (pipes, /proc entries reporting a size of 0) are left unmapped so the caller can fall back to streaming them
+    if (fstat(fileDescriptor, &fileStatus) == 0 && S_ISREG(fileStatus.st_mode) && fileStatus.st_size > 0)
+    {
+        void* mapping = mmap(nullptr, fileStatus.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+        if (mapping != MAP_FAILED)
+        {
+            m_data = static_cast<const char*>(mapping);
+            m_size = static_cast<size_t>(fileStatus.st_size);
+        }
+    }
+
+    close(fileDescriptor);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data)
+    {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+}
+
+void MappedFile::releasePages() const
+{
+    // Dropped copies would be read again from a file that no longer holds them
+    if (m_data && !m_detached) { madvise(const_cast<char*>(m_data), m_size, MADV_DONTNEED); }
+}
+
+bool MappedFile::detachFromFile()
+{
+    if (!m_data || m_detached) { return true; }
+
+    // Copied pages of a private mapping are still dropped when the file is truncated, so the text is copied into memory
+    // of its own that is then moved over the mapping in one step, while anyone reading it sees the same bytes throughout
+    void* copy = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (copy == MAP_FAILED) { return false; }
+
+    memcpy(copy, m_data, m_size);
+    mprotect(copy, m_size, PROT_READ);
+
+    if (mremap(copy, m_size, m_size, MREMAP_MAYMOVE | MREMAP_FIXED, const_cast<char*>(m_data)) == MAP_FAILED)
+    {
+        munmap(copy, m_size);
+        return false;
+    }
+
+    m_detached = true;
+
+    return true;
+}
+
+size_t MappedFile::residentBytes() const
+{
+    if (!m_data) { return 0; }
+
+    // Pages of the file cached by the system only count once this process maps them in, which smaps tells
+    std::ifstream smaps("/proc/self/smaps");
+    std::string line;
+    bool inMapping = false;
+
+    while (std::getline(smaps, line))
+    {
+        uintptr_t start, end;
+        int fieldEnd = 0;
+
+        if (sscanf(line.c_str(), "%" SCNxPTR "-%" SCNxPTR " %n", &start, &end, &fieldEnd) == 2 && fieldEnd > 0)
+        {
+            inMapping = (start == reinterpret_cast<uintptr_t>(m_data));
+        }
+        else if (inMapping && line.compare(0, 4, "Rss:") == 0)
+        {
+            return std::strtoull(line.c_str() + 4, nullptr, 10) * 1024;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Includes.h"
+
+// Read-only private mapping of a file. Lines loaded from it point straight into the mapping until they are edited,
+// so the mapping has to outlive every LineGapBuffer created from it.
+class MappedFile
+{
+
+private:
+
+    const char* m_data;
+    size_t m_size;
+
+    // Set once every page was copied, after which the mapping no longer follows the file
+    bool m_detached;
+
+public:
+
+    MappedFile(const std::filesystem::path& filePath);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Drops the pages read in so far. The mapping stays valid and reads them from the file again on the next access.
+    void releasePages() const;
+
+    // Copies every page into memory of this process, so the file can be overwritten without the text read from it
+    // changing under the lines pointing into it. Returns false, leaving the mapping as it was, if it could not be copied.
+    bool detachFromFile();
+
+    // Bytes of the mapping this process has in memory
+    size_t residentBytes() const;
+
+    // Getters
+    bool isMapped() const { return m_data != nullptr; }
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool detached() const { return m_detached; }
+
+};
@@ -0,0 +1,298 @@
+#include "SearchIndex.h"
+
+SearchIndex::~SearchIndex()
+{
+    stopScan();
+}
+
+void SearchIndex::setPattern(std::shared_ptr<const SearchPattern> pattern, const FileBackend& file)
+{
+    stopScan();
+
+    m_pattern = std::move(pattern);
+    m_matches.clear();
+    m_pendingEdits.clear();
+    m_ready = false;
+
+    if (!m_pattern || !m_pattern->valid()) { return; }
+
+    if (file.numberOfLines() > backgroundScanLines)
+    {
+        startScan(file);
+        return;
+    }
+
+    std::vector<std::pair<int, int>> lineMatches;
+    std::string scratch;
+    int y = 0;
+
+    file.forEachLine([this, &lineMatches, &scratch, &y](const std::shared_ptr<LineGapBuffer>& line)
+    {
+        scanLine(*m_pattern, *line, y++, m_matches, lineMatches, scratch);
+    });
+
+    m_ready = true;
+}
+
+void SearchIndex::startScan(const FileBackend& file)
+{
+    stopScan();
+
+    // Edits from here on are relative to the snapshot, and are caught up with once the scan is taken over
+    m_pendingEdits.clear();
+
+    m_scan.start(file, [this](const std::vector<std::shared_ptr<const LineGapBuffer>>& snapshot, const std::atomic<bool>& cancelled)
+    {
+        size_t threads = std::max(1u, std::thread::hardware_concurrency());
+
+        m_scanMatches = scanLines(snapshot, *m_pattern, threads, cancelled);
+    });
+}
+
+void SearchIndex::stopScan()
+{
+    m_scan.stop();
+    m_scanMatches.clear();
+}
+
+std::vector<SearchMatch> SearchIndex::scanLines(const std::vector<std::shared_ptr<const LineGapBuffer>>& scannedLines, const SearchPattern& pattern,
+    size_t threads, const std::atomic<bool>& cancelled)
+{
+    size_t numberOfChunks = (scannedLines.size() + scanChunkLines - 1) / scanChunkLines;
+
+    // Chunks are handed out one at a time, so a thread that got lines with few matches goes on to take more of them
+    std::vector<std::vector<SearchMatch>> chunkMatches(numberOfChunks);
+    std::atomic<size_t> nextChunk = 0;
+
+    std::function<void()> scanChunks = [&scannedLines, &pattern, &cancelled, &chunkMatches, &nextChunk, numberOfChunks]()
+    {
+        std::vector<std::pair<int, int>> lineMatches;
+        std::string scratch;
+
+        for (size_t chunk = nextChunk++; chunk < numberOfChunks; chunk = nextChunk++)
+        {
+            size_t end = std::min((chunk + 1) * scanChunkLines, scannedLines.size());
+
+            for (size_t y = chunk * scanChunkLines; y < end; y++)
+            {
+                if (cancelled.load(std::memory_order_relaxed)) { return; }
+
+                scanLine(pattern, *scannedLines[y], y, chunkMatches[chunk], lineMatches, scratch);
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+
+    for (size_t thread = 1; thread < std::min(threads, numberOfChunks); thread++) { workers.emplace_back(scanChunks); }
+
+    scanChunks();
+
+    for (std::thread& worker : workers) { worker.join(); }
+
+    size_t numberOfMatches = 0;
+
+    for (const std::vector<SearchMatch>& matches : chunkMatches) { numberOfMatches += matches.size(); }
+
+    std::vector<SearchMatch> matches;
+    matches.reserve(numberOfMatches);
+
+    for (const std::vector<SearchMatch>& chunk : chunkMatches) { matches.insert(matches.end(), chunk.begin(), chunk.end()); }
+
+    return matches;
+}
+
+void SearchIndex::scanLine(const SearchPattern& pattern, const LineGapBuffer& line, int y, std::vector<SearchMatch>& matches,
+    std::vector<std::pair<int, int>>& lineMatches, std::string& scratch)
+{
+    lineMatches.clear();
+    pattern.findAll(line, lineMatches, scratch);
+
+    for (const std::pair<int, int>& lineMatch : lineMatches) { matches.push_back(SearchMatch{ y, lineMatch.first, lineMatch.second }); }
+}
+
+void SearchIndex::recordLineEdit(LINE_EDIT_TYPE type, size_t index, size_t count)
+{
+    if (m_pattern && m_pattern->valid()) { m_pendingEdits.record(type, index, count); }
+}
+
+bool SearchIndex::update(const FileBackend& file)
+{
+    if (!m_pattern || !m_pattern->valid()) { return false; }
+
+    if (m_scan.started())
+    {
+        if (!m_scan.finished()) { return false; }
+
+        m_scan.join();
+
+        m_matches = std::move(m_scanMatches);
+        m_scanMatches.clear();
+        m_ready = true;
+    }
+
+    if (!m_ready) { return false; }
+
+    if (m_pendingEdits.overflowed())
+    {
+        // Too many edits to follow, so everything is looked for again
+        setPattern(std::shared_ptr<const SearchPattern>(m_pattern), file);
+
+        return m_ready;
+    }
+
+    if (!m_pendingEdits.empty()) { applyPendingEdits(file); }
+
+    return true;
+}
+
+void SearchIndex::applyPendingEdits(const FileBackend& file)
+{
+    std::vector<std::pair<size_t, size_t>> dirtyRanges = m_pendingEdits.changedRanges();
+
+    // Matches of removed lines go and matches after inserted or removed lines move with their lines
+    for (const LineEdit& lineEdit : m_pendingEdits.edits())
+    {
+        if (lineEdit.type == LINE_CHANGED) { continue; }
+
+        size_t index = lineEdit.index;
+        size_t count = lineEdit.count;
+
+        std::vector<SearchMatch>::iterator firstAfter = std::lower_bound(m_matches.begin(), m_matches.end(), index,
+            [](const SearchMatch& match, size_t y) { return static_cast<size_t>(match.line) < y; });
+
+        if (lineEdit.type == LINES_INSERTED)
+        {
+            for (std::vector<SearchMatch>::iterator match = firstAfter; match != m_matches.end(); ++match) { match->line += count; }
+        }
+        else
+        {
+            std::vector<SearchMatch>::iterator firstKept = std::lower_bound(firstAfter, m_matches.end(), index + count,
+                [](const SearchMatch& match, size_t y) { return static_cast<size_t>(match.line) < y; });
+
+            for (std::vector<SearchMatch>::iterator match = firstKept; match != m_matches.end(); ++match) { match->line -= count; }
+
+            m_matches.erase(firstAfter, firstKept);
+        }
+    }
+
+    m_pendingEdits.clear();
+
+    if (dirtyRanges.empty()) { return; }
+
+    // The matches outside the ranges are kept and the lines inside them are scanned again, in one pass over the matches
+    std::vector<SearchMatch> matches;
+    matches.reserve(m_matches.size());
+
+    std::vector<std::pair<int, int>> lineMatches;
+    std::string scratch;
+
+    std::vector<SearchMatch>::const_iterator kept = m_matches.begin();
+    size_t scannedUntil = 0;
+
+    for (const std::pair<size_t, size_t>& range : dirtyRanges)
+    {
+        size_t first = std::max(range.first, scannedUntil);
+        size_t end = std::min(range.second, file.numberOfLines());
+
+        if (first >= end) { continue; }
+
+        for (; kept != m_matches.end() && static_cast<size_t>(kept->line) < first; ++kept) { matches.push_back(*kept); }
+        for (; kept != m_matches.end() && static_cast<size_t>(kept->line) < end; ++kept) {}
+
+        for (size_t y = first; y < end; y++) { scanLine(*m_pattern, *file[y], y, matches, lineMatches, scratch); }
+
+        scannedUntil = end;
+    }
+
+    matches.insert(matches.end(), kept, m_matches.cend());
+    m_matches = std::move(matches);
+}
+
+bool SearchIndex::findNext(const FileBackend& file, const std::pair<int, int>& position, bool forward, SearchMatch& match, bool& wrapped)
+{
+    if (!m_pattern || !m_pattern->valid()) { return false; }
+
+    // Until the matches are known the lines are looked through, as if there were no index
+    if (!update(file)) { return scanFrom(file, *m_pattern, position, forward, match, wrapped); }
+
+    wrapped = false;
+
+    if (m_matches.empty()) { return false; }
+
+    // Matches are ordered by line, then column, the same as the cursor positions
+    if (forward)
+    {
+        std::vector<SearchMatch>::const_iterator next = std::upper_bound(m_matches.cbegin(), m_matches.cend(), position,
+            [](const std::pair<int, int>& cursor, const SearchMatch& candidate) { return cursor < std::pair<int, int>(candidate.line, candidate.column); });
+
+        wrapped = (next == m_matches.cend());
+        match = wrapped ? m_matches.front() : *next;
+    }
+    else
+    {
+        std::vector<SearchMatch>::const_iterator next = std::lower_bound(m_matches.cbegin(), m_matches.cend(), position,
+            [](const SearchMatch& candidate, const std::pair<int, int>& cursor) { return std::pair<int, int>(candidate.line, candidate.column) < cursor; });
+
+        wrapped = (next == m_matches.cbegin());
+        match = wrapped ? m_matches.back() : *(next - 1);
+    }
+
+    return true;
+}
+
+bool SearchIndex::scanFrom(const FileBackend& file, const SearchPattern& pattern, const std::pair<int, int>& position, bool forward,
+    SearchMatch& match, bool& wrapped)
+{
+    wrapped = false;
+
+    if (!pattern.valid() || file.numberOfLines() == 0) { return false; }
+
+    int numberOfLines = static_cast<int>(file.numberOfLines());
+    int y = std::clamp(position.first, 0, numberOfLines - 1);
+    int x = position.second;
+
+    std::vector<std::pair<int, int>> lineMatches;
+    std::string scratch;
+
+    // The cursor line is looked at twice, past the cursor first and before it again once the search has gone around
+    for (int step = 0; step <= numberOfLines; step++)
+    {
+        int line = forward ? y + step : y - step;
+
+        if (line >= numberOfLines) { line -= numberOfLines; wrapped = true; }
+        if (line < 0) { line += numberOfLines; wrapped = true; }
+
+        lineMatches.clear();
+        pattern.findAll(*file[line], lineMatches, scratch);
+
+        if (lineMatches.empty()) { continue; }
+
+        std::vector<std::pair<int, int>>::const_iterator found = lineMatches.cend();
+
+        if (forward)
+        {
+            for (std::vector<std::pair<int, int>>::const_iterator lineMatch = lineMatches.cbegin(); lineMatch != lineMatches.cend(); ++lineMatch)
+            {
+                if (step != 0 || lineMatch->first > x) { found = lineMatch; break; }
+            }
+        }
+        else
+        {
+            for (std::vector<std::pair<int, int>>::const_iterator lineMatch = lineMatches.cbegin(); lineMatch != lineMatches.cend(); ++lineMatch)
+            {
+                if (step == 0 && lineMatch->first >= x) { break; }
+
+                found = lineMatch;
+            }
+        }
+
+        if (found == lineMatches.cend()) { continue; }
+
+        match = SearchMatch{ line, found->first, found->second };
+
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "FileBackend.h"
+#include "LineEditLog.h"
+#include "SearchPattern.h"
+#include "SnapshotScan.h"
+
+struct SearchMatch
+{
+    int line;
+    int column;
+    int length;
+};
+
+// Where the last search pattern matches in a file, sorted so the match after or before any position is a binary search away.
+// Files with many lines are scanned in the background, split in chunks across as many threads as there are cores.
+// Searches made before the scan is done look through the file from the cursor instead. Edits are logged as they happen
+// and only the lines they touched are scanned again, the next time the matches are needed.
+class SearchIndex
+{
+
+private:
+
+    std::shared_ptr<const SearchPattern> m_pattern;
+
+    std::vector<SearchMatch> m_matches;
+    bool m_ready = false;
+
+    // Edits since the matches were last brought up to date, or since the running scan took its snapshot
+    LineEditLog m_pendingEdits;
+
+    // Matches found by the running scan, taken over once it is done
+    std::vector<SearchMatch> m_scanMatches;
+    SnapshotScan m_scan;
+
+    void startScan(const FileBackend& file);
+    void stopScan();
+
+    // Scans the lines the pending edits touched again and moves the matches of the lines after them
+    void applyPendingEdits(const FileBackend& file);
+
+    static void scanLine(const SearchPattern& pattern, const LineGapBuffer& line, int y, std::vector<SearchMatch>& matches,
+        std::vector<std::pair<int, int>>& lineMatches, std::string& scratch);
+
+public:
+
+    // Files with fewer lines are scanned right away
+    static inline const size_t backgroundScanLines = 10000;
+
+    // Lines a scan thread takes at a time
+    static inline const size_t scanChunkLines = 4096;
+
+    SearchIndex() = default;
+    ~SearchIndex();
+
+    SearchIndex(const SearchIndex&) = delete;
+    SearchIndex& operator=(const SearchIndex&) = delete;
+
+    // Starts finding every match of pattern in the file, or forgets the matches if pattern is null
+    void setPattern(std::shared_ptr<const SearchPattern> pattern, const FileBackend& file);
+
+    void recordLineEdit(LINE_EDIT_TYPE type, size_t index, size_t count);
+
+    // Takes over the matches of a finished scan and catches up with the edits made since. Returns whether the matches
+    // cover the whole file.
+    bool update(const FileBackend& file);
+
+    // The first match after position, or the last one before it going backwards, wrapping around the ends of the file
+    bool findNext(const FileBackend& file, const std::pair<int, int>& position, bool forward, SearchMatch& match, bool& wrapped);
+
+    // Every match in lines, found by threads taking chunks of them in turn, in order. Stops early once cancelled is set.
+    static std::vector<SearchMatch> scanLines(const std::vector<std::shared_ptr<const LineGapBuffer>>& scannedLines, const SearchPattern& pattern,
+        size_t threads, const std::atomic<bool>& cancelled);
+
+    // Same as findNext, looking through the lines from position on instead of the matches
+    static bool scanFrom(const FileBackend& file, const SearchPattern& pattern, const std::pair<int, int>& position, bool forward,
+        SearchMatch& match, bool& wrapped);
+
+    // Getters
+    const std::shared_ptr<const SearchPattern>& pattern() const { return m_pattern; }
+    const std::vector<SearchMatch>& matches() const { return m_matches; }
+    bool ready() const { return m_ready; }
+    const SnapshotScan& scan() const { return m_scan; }
+
+};
@@ -0,0 +1,176 @@
+#include "SearchPattern.h"
+
+static void expandReplacement(std::string_view replacement, std::string_view matched, const std::vector<re2::StringPiece>* groups, std::string& expanded)
+{
+    for (size_t i = 0; i < replacement.size(); i++)
+    {
+        char character = replacement[i];
+
+        if (character == '&') { expanded.append(matched); continue; }
+
+        if (character != '\\' || i + 1 == replacement.size()) { expanded.push_back(character); continue; }
+
+        character = replacement[++i];
+
+        if (character >= '0' && character <= '9')
+        {
+            size_t group = character - '0';
+
+            if (group == 0) { expanded.append(matched); }
+            else if (groups && group < groups->size() && (*groups)[group].data()) { expanded.append((*groups)[group].data(), (*groups)[group].size()); }
+        }
+        else if (character == 't') { expanded.push_back('\t'); }
+        else
+        {
+            // \& and \\ and any other escaped character stand for themselves
+            expanded.push_back(character);
+        }
+    }
+}
+
+// Next match of regex in text from position on, with its groups if there is room for them, moving position past it. Text
+// before position is still seen by ^ and \b.
+static bool nextMatch(const re2::RE2& regex, std::string_view text, size_t& position, std::vector<re2::StringPiece>& groups)
+{
+    re2::StringPiece wholeText(text.data(), text.size());
+
+    if (!regex.Match(wholeText, position, text.size(), re2::RE2::UNANCHORED, groups.data(), static_cast<int>(groups.size()))) { return false; }
+
+    size_t matchEnd = groups[0].data() - text.data() + groups[0].size();
+
+    // A match of no characters would be found again, so the next search starts a character further on
+    position = groups[0].empty() ? matchEnd + 1 : matchEnd;
+
+    return true;
+}
+
+SearchPattern::SearchPattern(const std::string& pattern)
+    : m_pattern(pattern), m_literal(pattern.find_first_of(specialCharacters) == std::string::npos), m_valid(!pattern.empty())
+{
+    if (m_literal || !m_valid) { return; }
+
+    // Columns are bytes, so the pattern is matched against bytes too
+    re2::RE2::Options options;
+    options.set_encoding(re2::RE2::Options::EncodingLatin1);
+    options.set_log_errors(false);
+
+    m_regex = std::make_unique<re2::RE2>(pattern, options);
+
+    // Half typed patterns are searched for as they are typed, so an invalid one is not an error yet
+    m_valid = m_regex->ok();
+}
+
+void SearchPattern::findAll(std::string_view text, std::vector<std::pair<int, int>>& matches) const
+{
+    if (!m_valid) { return; }
+
+    if (m_literal)
+    {
+        const char* start = text.data();
+        const char* end = text.data() + text.size();
+
+        while (static_cast<size_t>(end - start) >= m_pattern.size())
+        {
+            const char* found = static_cast<const char*>(memmem(start, end - start, m_pattern.data(), m_pattern.size()));
+
+            if (!found) { break; }
+
+            matches.push_back(std::pair<int, int>(static_cast<int>(found - text.data()), static_cast<int>(m_pattern.size())));
+            start = found + m_pattern.size();
+        }
+
+        return;
+    }
+
+    std::vector<re2::StringPiece> groups(1);
+    size_t position = 0;
+
+    while (position <= text.size() && nextMatch(*m_regex, text, position, groups))
+    {
+        if (!groups[0].empty()) { matches.push_back(std::pair<int, int>(static_cast<int>(groups[0].data() - text.data()), static_cast<int>(groups[0].size()))); }
+    }
+}
+
+void SearchPattern::findAll(const LineGapBuffer& line, std::vector<std::pair<int, int>>& matches, std::string& scratch) const
+{
+    std::string_view preGapSpan = line.preGapSpan();
+    std::string_view postGapSpan = line.postGapSpan();
+
+    if (preGapSpan.empty()) { findAll(postGapSpan, matches); }
+    else if (postGapSpan.empty()) { findAll(preGapSpan, matches); }
+    else
+    {
+        scratch.assign(preGapSpan);
+        scratch.append(postGapSpan);
+
+        findAll(std::string_view(scratch), matches);
+    }
+}
+
+int SearchPattern::substitute(std::string_view text, std::string_view replacement, bool global, int& start, int& end, std::string& replaced) const
+{
+    replaced.clear();
+
+    if (!m_valid) { return 0; }
+
+    int substitutions = 0;
+    size_t position = 0;
+
+    // Text between the matches is copied over as it is
+    auto replace = [&text, &replacement, &start, &replaced, &substitutions, &position](size_t matchStart, size_t matchLength,
+        const std::vector<re2::StringPiece>* groups)
+    {
+        if (substitutions == 0) { start = static_cast<int>(matchStart); }
+        else { replaced.append(text.substr(position, matchStart - position)); }
+
+        expandReplacement(replacement, text.substr(matchStart, matchLength), groups, replaced);
+
+        position = matchStart + matchLength;
+        substitutions++;
+    };
+
+    if (m_literal)
+    {
+        while (text.size() - position >= m_pattern.size())
+        {
+            const char* found = static_cast<const char*>(memmem(text.data() + position, text.size() - position, m_pattern.data(), m_pattern.size()));
+
+            if (!found) { break; }
+
+            replace(found - text.data(), m_pattern.size(), nullptr);
+
+            if (!global) { break; }
+        }
+    }
+    else
+    {
+        std::vector<re2::StringPiece> groups(m_regex->NumberOfCapturingGroups() + 1);
+        size_t searchPosition = 0;
+
+        while (searchPosition <= text.size() && nextMatch(*m_regex, text, searchPosition, groups))
+        {
+            replace(groups[0].data() - text.data(), groups[0].size(), &groups);
+
+            if (!global) { break; }
+        }
+    }
+
+    end = static_cast<int>(position);
+
+    return substitutions;
+}
+
+int SearchPattern::substitute(const LineGapBuffer& line, std::string_view replacement, bool global, int& start, int& end, std::string& replaced,
+    std::string& scratch) const
+{
+    std::string_view preGapSpan = line.preGapSpan();
+    std::string_view postGapSpan = line.postGapSpan();
+
+    if (preGapSpan.empty()) { return substitute(postGapSpan, replacement, global, start, end, replaced); }
+    if (postGapSpan.empty()) { return substitute(preGapSpan, replacement, global, start, end, replaced); }
+
+    scratch.assign(preGapSpan);
+    scratch.append(postGapSpan);
+
+    return substitute(std::string_view(scratch), replacement, global, start, end, replaced);
+}
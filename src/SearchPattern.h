@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Includes.h"
+#include "LineGapBuffer.h"
+
+#include <re2/re2.h>
+
+// A pattern looked for with / and ?. Patterns without any of the special characters of regular expressions are looked for
+// as they are with memmem, which runs the two-way algorithm. Anything else is a regular expression run by RE2, which takes
+// time linear in the line and no stack however long the line is, so it has no back references or lookarounds.
+class SearchPattern
+{
+
+private:
+
+    static inline const char* specialCharacters = "\\^$.|?*+()[]{}";
+
+    std::string m_pattern;
+    bool m_literal;
+    bool m_valid;
+    std::unique_ptr<re2::RE2> m_regex;
+
+public:
+
+    SearchPattern(const std::string& pattern);
+
+    // Adds the column and length of every match in text to matches, leftmost first and without overlaps. Matches of no
+    // characters are skipped, there would be nothing to show of them.
+    void findAll(std::string_view text, std::vector<std::pair<int, int>>& matches) const;
+
+    // Same for a whole line, which is copied into scratch when its gap splits the text
+    void findAll(const LineGapBuffer& line, std::vector<std::pair<int, int>>& matches, std::string& scratch) const;
+
+    // Replaces the first match in text, or every match if global, with replacement. & and \0 in replacement stand for the
+    // match and \1 to \9 for its groups. Returns how many matches were replaced, with the span of text they cover in
+    // [start, end) and what that span becomes in replaced.
+    int substitute(std::string_view text, std::string_view replacement, bool global, int& start, int& end, std::string& replaced) const;
+    int substitute(const LineGapBuffer& line, std::string_view replacement, bool global, int& start, int& end, std::string& replaced,
+        std::string& scratch) const;
+
+    // Getters
+    const std::string& pattern() const { return m_pattern; }
+    bool literal() const { return m_literal; }
+    bool valid() const { return m_valid; }
+
+};
@@ -0,0 +1,51 @@
+#include "SnapshotScan.h"
+
+SnapshotScan::~SnapshotScan()
+{
+    stop();
+}
+
+void SnapshotScan::start(const FileBackend& file, std::function<void(const std::vector<std::shared_ptr<const LineGapBuffer>>&, const std::atomic<bool>&)> scan)
+{
+    stop();
+
+    m_generation = takeSnapshot(file, m_snapshot);
+    m_finished.store(false, std::memory_order_relaxed);
+    m_cancelled.store(false, std::memory_order_relaxed);
+
+    m_thread = std::thread([this, scan = std::move(scan)]()
+    {
+        scan(m_snapshot, m_cancelled);
+
+        m_finished.store(true, std::memory_order_release);
+    });
+}
+
+void SnapshotScan::stop()
+{
+    if (m_thread.joinable())
+    {
+        m_cancelled.store(true, std::memory_order_relaxed);
+        m_thread.join();
+    }
+
+    m_snapshot.clear();
+}
+
+void SnapshotScan::join()
+{
+    if (m_thread.joinable()) { m_thread.join(); }
+
+    m_snapshot.clear();
+}
+
+uint64_t SnapshotScan::takeSnapshot(const FileBackend& file, std::vector<std::shared_ptr<const LineGapBuffer>>& snapshot)
+{
+    snapshot.clear();
+    snapshot.reserve(file.numberOfLines());
+
+    file.forEachLine([&snapshot](const std::shared_ptr<LineGapBuffer>& line) { snapshot.push_back(line); });
+
+    // Lines stamped with this generation or an older one may be in the snapshot and are copied before being edited
+    return LineGapBuffer::currentGeneration++;
+}
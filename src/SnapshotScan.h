@@ -0,0 +1,50 @@
+#pragma once
+
+#include "FileBackend.h"
+
+// Runs a pass over a snapshot of a file's lines on a worker thread, the way a background save writes one. The snapshot
+// shares the lines with the buffer, which asks every registered scan whether it may hold a line and copies the line
+// before editing it if so. Whatever the worker reads or fills, like the lines and the results of the pass, has to be
+// declared before the object running it, so the worker is joined before any of that goes away.
+class SnapshotScan
+{
+
+private:
+
+    std::vector<std::shared_ptr<const LineGapBuffer>> m_snapshot;
+    uint64_t m_generation = 0;
+    std::atomic<bool> m_finished = false;
+    std::atomic<bool> m_cancelled = false;
+    std::thread m_thread;
+
+public:
+
+    SnapshotScan() = default;
+    ~SnapshotScan();
+
+    SnapshotScan(const SnapshotScan&) = delete;
+    SnapshotScan& operator=(const SnapshotScan&) = delete;
+
+    // Takes a snapshot of the lines of file and calls scan on it from a worker thread, stopping any running scan first.
+    // The scan should return early once the cancelled flag is set.
+    void start(const FileBackend& file, std::function<void(const std::vector<std::shared_ptr<const LineGapBuffer>>&, const std::atomic<bool>&)> scan);
+
+    // Cancels the scan if it is running, waits for it and lets go of the snapshot
+    void stop();
+
+    // Waits for the scan and lets go of the snapshot, once its results are to be taken over
+    void join();
+
+    // Whether line may be in the snapshot of a scan that is still running
+    bool mayHold(const LineGapBuffer& line) const { return running() && line.generation() <= m_generation; }
+
+    // Fills snapshot with the lines of file and returns the generation they are stamped with at most
+    static uint64_t takeSnapshot(const FileBackend& file, std::vector<std::shared_ptr<const LineGapBuffer>>& snapshot);
+
+    // Getters
+    bool started() const { return m_thread.joinable(); }
+    bool running() const { return m_thread.joinable() && !m_finished.load(std::memory_order_acquire); }
+    bool finished() const { return m_thread.joinable() && m_finished.load(std::memory_order_acquire); }
+    uint64_t generation() const { return m_generation; }
+
+};
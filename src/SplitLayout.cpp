@@ -0,0 +1,200 @@
+#include "SplitLayout.h"
+
+SplitLayout::SplitLayout()
+    : m_root(std::make_unique<Node>())
+{
+    m_root->viewport = 0;
+}
+
+SplitLayout::Node* SplitLayout::findLeaf(Node* node, int viewport) const
+{
+    if (!node) { return nullptr; }
+
+    if (node->viewport != -1) { return (node->viewport == viewport) ? node : nullptr; }
+
+    Node* leaf = findLeaf(node->first.get(), viewport);
+
+    return (leaf) ? leaf : findLeaf(node->second.get(), viewport);
+}
+
+int SplitLayout::firstViewport(const Node& node)
+{
+    return (node.viewport != -1) ? node.viewport : firstViewport(*node.first);
+}
+
+void SplitLayout::collectViewports(const Node& node, std::vector<int>& viewports)
+{
+    if (node.viewport != -1)
+    {
+        viewports.push_back(node.viewport);
+        return;
+    }
+
+    collectViewports(*node.first, viewports);
+    collectViewports(*node.second, viewports);
+}
+
+int SplitLayout::split(int viewport, bool sideBySide)
+{
+    Node* leaf = findLeaf(m_root.get(), viewport);
+
+    if (!leaf) { return -1; }
+
+    int newViewport = m_nextViewport++;
+
+    leaf->first = std::make_unique<Node>();
+    leaf->first->viewport = newViewport;
+    leaf->first->parent = leaf;
+
+    leaf->second = std::make_unique<Node>();
+    leaf->second->viewport = viewport;
+    leaf->second->parent = leaf;
+
+    leaf->viewport = -1;
+    leaf->sideBySide = sideBySide;
+
+    m_numberOfViewports++;
+
+    return newViewport;
+}
+
+int SplitLayout::close(int viewport)
+{
+    Node* leaf = findLeaf(m_root.get(), viewport);
+
+    if (!leaf || leaf == m_root.get()) { return -1; }
+
+    Node* parent = leaf->parent;
+    Node* grandParent = parent->parent;
+
+    // The other half takes the place of the split, and with it the whole of its area
+    std::unique_ptr<Node> sibling = std::move((parent->first.get() == leaf) ? parent->second : parent->first);
+    sibling->parent = grandParent;
+
+    int remainingViewport = firstViewport(*sibling);
+
+    if (!grandParent) { m_root = std::move(sibling); }
+    else if (grandParent->first.get() == parent) { grandParent->first = std::move(sibling); }
+    else { grandParent->second = std::move(sibling); }
+
+    m_numberOfViewports--;
+
+    return remainingViewport;
+}
+
+std::vector<int> SplitLayout::only(int viewport)
+{
+    std::vector<int> viewports;
+    collectViewports(*m_root, viewports);
+
+    std::vector<int> closedViewports;
+
+    for (int closedViewport : viewports)
+    {
+        if (closedViewport != viewport && close(closedViewport) != -1) { closedViewports.push_back(closedViewport); }
+    }
+
+    return closedViewports;
+}
+
+void SplitLayout::collectAreas(const Node& node, const ViewportArea& area, std::vector<std::pair<int, ViewportArea>>& areas, std::vector<ViewportArea>& separators)
+{
+    if (node.viewport != -1)
+    {
+        areas.push_back(std::pair<int, ViewportArea>(node.viewport, area));
+        return;
+    }
+
+    ViewportArea firstArea = area;
+    ViewportArea separator = area;
+    ViewportArea secondArea = area;
+
+    if (node.sideBySide)
+    {
+        int available = std::max(0, area.cols - 1);
+
+        firstArea.cols = (available + 1) / 2;
+        separator.left = area.left + firstArea.cols;
+        separator.cols = std::min(1, area.cols);
+        secondArea.left = separator.left + separator.cols;
+        secondArea.cols = available - firstArea.cols;
+    }
+    else
+    {
+        int available = std::max(0, area.rows - 1);
+
+        firstArea.rows = (available + 1) / 2;
+        separator.top = area.top + firstArea.rows;
+        separator.rows = std::min(1, area.rows);
+        secondArea.top = separator.top + separator.rows;
+        secondArea.rows = available - firstArea.rows;
+    }
+
+    collectAreas(*node.first, firstArea, areas, separators);
+    separators.push_back(separator);
+    collectAreas(*node.second, secondArea, areas, separators);
+}
+
+void SplitLayout::areas(int rows, int cols, std::vector<std::pair<int, ViewportArea>>& areas, std::vector<ViewportArea>& separators) const
+{
+    areas.clear();
+    separators.clear();
+
+    collectAreas(*m_root, ViewportArea{ 0, 0, std::max(0, rows), std::max(0, cols) }, areas, separators);
+}
+
+int SplitLayout::neighbor(const std::vector<std::pair<int, ViewportArea>>& areas, int viewport, NEIGHBOR_DIRECTION direction, int position)
+{
+    std::vector<std::pair<int, ViewportArea>>::const_iterator own = std::find_if(areas.begin(), areas.end(),
+        [viewport](const std::pair<int, ViewportArea>& area) { return area.first == viewport; });
+
+    if (own == areas.end()) { return -1; }
+
+    const ViewportArea& area = own->second;
+    int found = -1;
+
+    for (const std::pair<int, ViewportArea>& other : areas)
+    {
+        const ViewportArea& otherArea = other.second;
+        bool adjacent = false;
+        int start = 0;
+        int end = 0;
+
+        switch (direction)
+        {
+            case NEIGHBOR_LEFT:
+                adjacent = (otherArea.left + otherArea.cols + 1 == area.left);
+                break;
+            case NEIGHBOR_RIGHT:
+                adjacent = (area.left + area.cols + 1 == otherArea.left);
+                break;
+            case NEIGHBOR_UP:
+                adjacent = (otherArea.top + otherArea.rows + 1 == area.top);
+                break;
+            case NEIGHBOR_DOWN:
+                adjacent = (area.top + area.rows + 1 == otherArea.top);
+                break;
+        }
+
+        if (direction == NEIGHBOR_LEFT || direction == NEIGHBOR_RIGHT)
+        {
+            adjacent = adjacent && otherArea.top < area.top + area.rows && area.top < otherArea.top + otherArea.rows;
+            start = otherArea.top;
+            end = otherArea.top + otherArea.rows;
+        }
+        else
+        {
+            adjacent = adjacent && otherArea.left < area.left + area.cols && area.left < otherArea.left + otherArea.cols;
+            start = otherArea.left;
+            end = otherArea.left + otherArea.cols;
+        }
+
+        if (!adjacent) { continue; }
+
+        if (position >= start && position < end) { return other.first; }
+
+        if (found == -1) { found = other.first; }
+    }
+
+    return found;
+}
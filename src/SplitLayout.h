@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Includes.h"
+
+struct ViewportArea
+{
+    int top;
+    int left;
+    int rows;
+    int cols;
+
+    bool operator==(const ViewportArea& other) const { return top == other.top && left == other.left && rows == other.rows && cols == other.cols; }
+    bool operator!=(const ViewportArea& other) const { return !(*this == other); }
+};
+
+enum NEIGHBOR_DIRECTION
+{
+    NEIGHBOR_LEFT,
+    NEIGHBOR_DOWN,
+    NEIGHBOR_UP,
+    NEIGHBOR_RIGHT,
+};
+
+// How the text area is divided between viewports, as a tree of splits. Every split cuts an area in two halves of equal
+// size with a separator one cell wide between them, so the areas are worked out again for any terminal size, and closing
+// a viewport gives its area back to the other half of the split it came from.
+class SplitLayout
+{
+
+private:
+
+    struct Node
+    {
+        // Viewport of a leaf, or -1 for a split
+        int viewport = -1;
+        bool sideBySide = false;
+
+        std::unique_ptr<Node> first;
+        std::unique_ptr<Node> second;
+        Node* parent = nullptr;
+    };
+
+    std::unique_ptr<Node> m_root;
+    int m_nextViewport = 1;
+    size_t m_numberOfViewports = 1;
+
+    Node* findLeaf(Node* node, int viewport) const;
+    static int firstViewport(const Node& node);
+    static void collectViewports(const Node& node, std::vector<int>& viewports);
+    static void collectAreas(const Node& node, const ViewportArea& area, std::vector<std::pair<int, ViewportArea>>& areas, std::vector<ViewportArea>& separators);
+
+public:
+
+    // Starts out as viewport 0 taking the whole area
+    SplitLayout();
+
+    // Splits the area of viewport in two, above and below or side by side. The new viewport takes the top or left half
+    // and its id is returned.
+    int split(int viewport, bool sideBySide);
+
+    // Gives the area of viewport to the other half of its split, returning a viewport of that half, or -1 for the last one
+    int close(int viewport);
+
+    // Closes every viewport but this one, returning the ids of those closed
+    std::vector<int> only(int viewport);
+
+    // Areas of the viewports in order from the top left, and of the separators between them, in an area of the given size
+    void areas(int rows, int cols, std::vector<std::pair<int, ViewportArea>>& areas, std::vector<ViewportArea>& separators) const;
+
+    // Viewport across the separator on one side of viewport, preferring the one next to position, the screen row or
+    // column along that side. -1 if there is none.
+    static int neighbor(const std::vector<std::pair<int, ViewportArea>>& areas, int viewport, NEIGHBOR_DIRECTION direction, int position);
+
+    // Getters
+    size_t numberOfViewports() const { return m_numberOfViewports; }
+
+};
@@ -0,0 +1,329 @@
+#include "SyntaxHighlighter.h"
+
+static bool isWordCharacter(char character)
+{
+    return isalnum(static_cast<unsigned char>(character)) || character == '_';
+}
+
+SyntaxHighlighter::~SyntaxHighlighter()
+{
+    stopScan();
+}
+
+void SyntaxHighlighter::start(const FileBackend& file, const std::filesystem::path& filePath)
+{
+    stopScan();
+
+    m_enabled = std::find(extensions.begin(), extensions.end(), filePath.extension().string()) != extensions.end();
+    m_lineStates.clear();
+    m_ready = false;
+    m_firstStaleLine = std::numeric_limits<size_t>::max();
+    m_pendingEdits.clear();
+
+    if (!m_enabled) { return; }
+
+    if (file.numberOfLines() > backgroundLexLines)
+    {
+        startScan(file);
+        return;
+    }
+
+    LEXER_STATE state = LEXER_NORMAL;
+    std::string scratch;
+
+    m_lineStates.reserve(file.numberOfLines() + 1);
+    m_lineStates.push_back(state);
+
+    file.forEachLine([this, &state, &scratch](const std::shared_ptr<LineGapBuffer>& line)
+    {
+        state = lexLine(*line, state, nullptr, scratch);
+        m_lineStates.push_back(state);
+    });
+
+    m_ready = true;
+}
+
+void SyntaxHighlighter::startScan(const FileBackend& file)
+{
+    m_pendingEdits.clear();
+
+    m_scan.start(file, [this](const std::vector<std::shared_ptr<const LineGapBuffer>>& snapshot, const std::atomic<bool>& cancelled)
+    {
+        LEXER_STATE state = LEXER_NORMAL;
+        std::string scratch;
+
+        m_scanStates.reserve(snapshot.size() + 1);
+        m_scanStates.push_back(state);
+
+        for (const std::shared_ptr<const LineGapBuffer>& line : snapshot)
+        {
+            if (cancelled.load(std::memory_order_relaxed)) { break; }
+
+            state = lexLine(*line, state, nullptr, scratch);
+            m_scanStates.push_back(state);
+        }
+    });
+}
+
+void SyntaxHighlighter::stopScan()
+{
+    m_scan.stop();
+    m_scanStates.clear();
+}
+
+void SyntaxHighlighter::recordLineEdit(LINE_EDIT_TYPE type, size_t index, size_t count)
+{
+    if (m_enabled) { m_pendingEdits.record(type, index, count); }
+}
+
+bool SyntaxHighlighter::update(const FileBackend& file, size_t lastLine, size_t& firstRestyledLine, size_t& lastRestyledLine)
+{
+    firstRestyledLine = std::numeric_limits<size_t>::max();
+    lastRestyledLine = 0;
+
+    if (!m_enabled) { return false; }
+
+    if (m_scan.started())
+    {
+        if (!m_scan.finished()) { return false; }
+
+        m_scan.join();
+
+        m_lineStates = std::move(m_scanStates);
+        m_scanStates.clear();
+        m_ready = true;
+
+        // Every line was drawn plain until now
+        firstRestyledLine = 0;
+        lastRestyledLine = std::numeric_limits<size_t>::max();
+    }
+
+    if (!m_ready) { return false; }
+
+    if (m_pendingEdits.overflowed())
+    {
+        // Too many edits to follow, so every line is lexed again as it comes into view
+        m_pendingEdits.clear();
+        m_lineStates.resize(file.numberOfLines() + 1);
+        m_firstStaleLine = 0;
+
+        firstRestyledLine = 0;
+        lastRestyledLine = std::numeric_limits<size_t>::max();
+    }
+
+    applyPendingEdits(file, lastLine, firstRestyledLine, lastRestyledLine);
+
+    return true;
+}
+
+void SyntaxHighlighter::applyPendingEdits(const FileBackend& file, size_t lastLine, size_t& firstRestyledLine, size_t& lastRestyledLine)
+{
+    std::vector<std::pair<size_t, size_t>> dirtyRanges = m_pendingEdits.changedRanges(true);
+
+    // Inserted lines start out in the state of the line they were inserted at, and the line after removed lines in the
+    // state of the first removed one, which is where the lexer comes out of the line before them
+    for (const LineEdit& lineEdit : m_pendingEdits.edits())
+    {
+        size_t index = lineEdit.index;
+        size_t count = lineEdit.count;
+
+        if (lineEdit.type == LINES_INSERTED)
+        {
+            m_lineStates.insert(m_lineStates.begin() + index, count, m_lineStates[index]);
+
+            if (m_firstStaleLine > index && m_firstStaleLine != std::numeric_limits<size_t>::max()) { m_firstStaleLine += count; }
+        }
+        else if (lineEdit.type == LINES_REMOVED)
+        {
+            m_lineStates.erase(m_lineStates.begin() + index + 1, m_lineStates.begin() + index + count + 1);
+
+            if (m_firstStaleLine > index && m_firstStaleLine != std::numeric_limits<size_t>::max())
+            {
+                m_firstStaleLine = (m_firstStaleLine < index + count) ? index : m_firstStaleLine - count;
+            }
+        }
+    }
+
+    m_pendingEdits.clear();
+
+    size_t numberOfLines = file.numberOfLines();
+
+    if (m_lineStates.size() != numberOfLines + 1)
+    {
+        m_lineStates.resize(numberOfLines + 1);
+        m_firstStaleLine = 0;
+    }
+
+    if (m_firstStaleLine < numberOfLines)
+    {
+        dirtyRanges.push_back(std::pair<size_t, size_t>(m_firstStaleLine, numberOfLines));
+        std::sort(dirtyRanges.begin(), dirtyRanges.end());
+    }
+
+    m_firstStaleLine = std::numeric_limits<size_t>::max();
+
+    std::string scratch;
+    size_t range = 0;
+    size_t y = dirtyRanges.empty() ? numberOfLines : dirtyRanges[0].first;
+
+    while (y < numberOfLines)
+    {
+        // Lines below the screen are lexed once they come into view
+        if (y > lastLine)
+        {
+            m_firstStaleLine = y;
+            break;
+        }
+
+        LEXER_STATE state = lexLine(*file[y], m_lineStates[y], nullptr, scratch);
+        bool restyled = (state != m_lineStates[y + 1]);
+
+        m_lineStates[y + 1] = state;
+        y++;
+
+        if (restyled)
+        {
+            firstRestyledLine = std::min(firstRestyledLine, y);
+            lastRestyledLine = std::max(lastRestyledLine, y);
+        }
+
+        while (range < dirtyRanges.size() && dirtyRanges[range].second <= y) { range++; }
+
+        if (restyled || (range < dirtyRanges.size() && dirtyRanges[range].first <= y)) { continue; }
+
+        // The lexer came out of the edited lines the same as before, so the lines up to the next edit keep their colors
+        y = (range < dirtyRanges.size()) ? dirtyRanges[range].first : numberOfLines;
+    }
+}
+
+void SyntaxHighlighter::lineSpans(const LineGapBuffer& line, size_t y, std::vector<ColorSpan>& spans, std::string& scratch) const
+{
+    spans.clear();
+
+    if (!m_ready || y >= m_lineStates.size()) { return; }
+
+    lexLine(line, m_lineStates[y], &spans, scratch);
+}
+
+LEXER_STATE SyntaxHighlighter::lexLine(std::string_view text, LEXER_STATE state, std::vector<ColorSpan>* spans)
+{
+    size_t size = text.size();
+    size_t i = 0;
+
+    auto addSpan = [spans](size_t start, size_t end, TOKEN_TYPE token)
+    {
+        if (spans && end > start) { spans->push_back(ColorSpan{ static_cast<int>(start), static_cast<int>(end - start), token }); }
+    };
+
+    if (state == LEXER_BLOCK_COMMENT)
+    {
+        size_t end = text.find("*/");
+
+        if (end == std::string_view::npos)
+        {
+            addSpan(0, size, TOKEN_COMMENT);
+            return LEXER_BLOCK_COMMENT;
+        }
+
+        addSpan(0, end + 2, TOKEN_COMMENT);
+        i = end + 2;
+    }
+
+    size_t firstNonSpace = text.find_first_not_of(" \t");
+
+    while (i < size)
+    {
+        char character = text[i];
+        char nextCharacter = (i + 1 < size) ? text[i + 1] : '\0';
+
+        if (character == '/' && nextCharacter == '/')
+        {
+            addSpan(i, size, TOKEN_COMMENT);
+            return LEXER_NORMAL;
+        }
+
+        if (character == '/' && nextCharacter == '*')
+        {
+            size_t end = text.find("*/", i + 2);
+
+            if (end == std::string_view::npos)
+            {
+                addSpan(i, size, TOKEN_COMMENT);
+                return LEXER_BLOCK_COMMENT;
+            }
+
+            addSpan(i, end + 2, TOKEN_COMMENT);
+            i = end + 2;
+        }
+        else if (character == '"' || character == '\'')
+        {
+            // Strings left open end with the line
+            size_t end = i + 1;
+
+            while (end < size && text[end] != character) { end += (text[end] == '\\') ? 2 : 1; }
+
+            end = std::min(end + 1, size);
+
+            addSpan(i, end, TOKEN_STRING);
+            i = end;
+        }
+        else if (character == '#' && i == firstNonSpace)
+        {
+            size_t end = text.find_first_not_of(" \t", i + 1);
+
+            while (end < size && isWordCharacter(text[end])) { end++; }
+
+            end = std::min(end, size);
+
+            addSpan(i, end, TOKEN_PREPROCESSOR);
+            i = end;
+        }
+        else if (isdigit(static_cast<unsigned char>(character)) || (character == '.' && isdigit(static_cast<unsigned char>(nextCharacter))))
+        {
+            // Digit separators, suffixes and the sign of an exponent are part of the number
+            size_t end = i + 1;
+
+            while (end < size && (isWordCharacter(text[end]) || text[end] == '.' || text[end] == '\'' ||
+                ((text[end] == '+' || text[end] == '-') && std::string_view("eEpP").find(text[end - 1]) != std::string_view::npos)))
+            {
+                end++;
+            }
+
+            addSpan(i, end, TOKEN_NUMBER);
+            i = end;
+        }
+        else if (isWordCharacter(character))
+        {
+            size_t end = i + 1;
+
+            while (end < size && isWordCharacter(text[end])) { end++; }
+
+            std::string_view word = text.substr(i, end - i);
+
+            if (keywords.count(word)) { addSpan(i, end, TOKEN_KEYWORD); }
+            else if (typeNames.count(word)) { addSpan(i, end, TOKEN_TYPE_NAME); }
+
+            i = end;
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    return LEXER_NORMAL;
+}
+
+LEXER_STATE SyntaxHighlighter::lexLine(const LineGapBuffer& line, LEXER_STATE state, std::vector<ColorSpan>* spans, std::string& scratch)
+{
+    std::string_view preGapSpan = line.preGapSpan();
+    std::string_view postGapSpan = line.postGapSpan();
+
+    if (preGapSpan.empty()) { return lexLine(postGapSpan, state, spans); }
+    if (postGapSpan.empty()) { return lexLine(preGapSpan, state, spans); }
+
+    scratch.assign(preGapSpan);
+    scratch.append(postGapSpan);
+
+    return lexLine(std::string_view(scratch), state, spans);
+}
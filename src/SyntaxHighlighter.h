@@ -0,0 +1,113 @@
+#pragma once
+
+#include "FileBackend.h"
+#include "LineEditLog.h"
+#include "SnapshotScan.h"
+
+enum TOKEN_TYPE : uint8_t
+{
+    TOKEN_PLAIN,
+    TOKEN_KEYWORD,
+    TOKEN_TYPE_NAME,
+    TOKEN_STRING,
+    TOKEN_NUMBER,
+    TOKEN_COMMENT,
+    TOKEN_PREPROCESSOR,
+};
+
+// What the lexer carries over from the end of one line to the start of the next
+enum LEXER_STATE : uint8_t
+{
+    LEXER_NORMAL,
+    LEXER_BLOCK_COMMENT,
+};
+
+struct ColorSpan
+{
+    int start;
+    int length;
+    TOKEN_TYPE token;
+};
+
+// Colors C-like source by lexing it a line at a time. The state the lexer is in at the start of every line is kept, so a
+// line can be lexed again on its own when it is drawn, and an edit only lexes lines again from the edited one until the
+// states of the lines after it come out the same as before. The first pass over a large file runs in the background,
+// and lines are drawn plain until it is done.
+class SyntaxHighlighter
+{
+
+private:
+
+    bool m_enabled = false;
+
+    // State at the start of each line, and after the last one
+    std::vector<LEXER_STATE> m_lineStates;
+    bool m_ready = false;
+
+    // States from this line on were not lexed again after an edit yet, which happens as they come into view
+    size_t m_firstStaleLine = std::numeric_limits<size_t>::max();
+
+    // Edits since the states were last brought up to date, or since the running pass took its snapshot
+    LineEditLog m_pendingEdits;
+
+    // States found by the running first pass, taken over once it is done
+    std::vector<LEXER_STATE> m_scanStates;
+    SnapshotScan m_scan;
+
+    static inline const std::unordered_set<std::string_view> keywords = {
+        "alignas", "alignof", "asm", "auto", "break", "case", "catch", "class", "const", "constexpr", "consteval", "constinit",
+        "const_cast", "continue", "co_await", "co_return", "co_yield", "decltype", "default", "delete", "do", "dynamic_cast",
+        "else", "enum", "explicit", "export", "extern", "false", "final", "for", "friend", "goto", "if", "inline", "mutable",
+        "namespace", "new", "noexcept", "nullptr", "operator", "override", "private", "protected", "public", "register",
+        "reinterpret_cast", "return", "sizeof", "static", "static_assert", "static_cast", "struct", "switch", "template",
+        "this", "thread_local", "throw", "true", "try", "typedef", "typeid", "typename", "union", "using", "virtual",
+        "volatile", "while" };
+
+    static inline const std::unordered_set<std::string_view> typeNames = {
+        "bool", "char", "char8_t", "char16_t", "char32_t", "double", "float", "int", "long", "short", "signed", "unsigned",
+        "void", "wchar_t", "size_t", "int8_t", "int16_t", "int32_t", "int64_t", "uint8_t", "uint16_t", "uint32_t", "uint64_t" };
+
+    static inline const std::vector<std::string> extensions = {
+        ".c", ".cc", ".cpp", ".cxx", ".h", ".hh", ".hpp", ".hxx", ".inl", ".java", ".js", ".ts", ".cs", ".go", ".rs" };
+
+    void startScan(const FileBackend& file);
+    void stopScan();
+
+    // Moves the states with their lines and lexes the edited lines again, up to lastLine
+    void applyPendingEdits(const FileBackend& file, size_t lastLine, size_t& firstRestyledLine, size_t& lastRestyledLine);
+
+public:
+
+    // Files with fewer lines are lexed right away
+    static inline const size_t backgroundLexLines = 10000;
+
+    SyntaxHighlighter() = default;
+    ~SyntaxHighlighter();
+
+    SyntaxHighlighter(const SyntaxHighlighter&) = delete;
+    SyntaxHighlighter& operator=(const SyntaxHighlighter&) = delete;
+
+    // Starts the first pass over the file if its extension is one of a C-like language
+    void start(const FileBackend& file, const std::filesystem::path& filePath);
+
+    void recordLineEdit(LINE_EDIT_TYPE type, size_t index, size_t count);
+
+    // Takes over a finished first pass and lexes the lines edited since, as far as lastLine. Returns whether the states
+    // of the lines up to lastLine are known, with the lines whose colors may have changed other than the edited ones.
+    bool update(const FileBackend& file, size_t lastLine, size_t& firstRestyledLine, size_t& lastRestyledLine);
+
+    // Colors of line y, which update must have brought up to date
+    void lineSpans(const LineGapBuffer& line, size_t y, std::vector<ColorSpan>& spans, std::string& scratch) const;
+
+    // Lexes a line starting in state, adding the spans of anything not plain if spans is given. Returns the state the
+    // next line starts in.
+    static LEXER_STATE lexLine(std::string_view text, LEXER_STATE state, std::vector<ColorSpan>* spans);
+    static LEXER_STATE lexLine(const LineGapBuffer& line, LEXER_STATE state, std::vector<ColorSpan>* spans, std::string& scratch);
+
+    // Getters
+    bool enabled() const { return m_enabled; }
+    bool ready() const { return m_ready; }
+    const SnapshotScan& scan() const { return m_scan; }
+    const std::vector<LEXER_STATE>& lineStates() const { return m_lineStates; }
+
+};
@@ -0,0 +1,45 @@
+#include "TimerQueue.h"
+
+void TimerQueue::schedule(TIMER_EVENT event, Clock::time_point deadline)
+{
+    m_deadlines[event] = deadline;
+    m_pending[event] = true;
+}
+
+int TimerQueue::millisecondsUntilNext(Clock::time_point now) const
+{
+    int milliseconds = -1;
+
+    for (int event = 0; event < NUMBER_OF_TIMER_EVENTS; event++)
+    {
+        if (!m_pending[event]) { continue; }
+
+        auto remaining = std::chrono::ceil<std::chrono::milliseconds>(m_deadlines[event] - now).count();
+        int eventMilliseconds = static_cast<int>(std::clamp<decltype(remaining)>(remaining, 0, std::numeric_limits<int>::max()));
+
+        if (milliseconds == -1 || eventMilliseconds < milliseconds) { milliseconds = eventMilliseconds; }
+    }
+
+    return milliseconds;
+}
+
+void TimerQueue::takeDue(Clock::time_point now, std::vector<TIMER_EVENT>& due)
+{
+    due.clear();
+
+    for (int event = 0; event < NUMBER_OF_TIMER_EVENTS; event++)
+    {
+        if (m_pending[event] && m_deadlines[event] <= now)
+        {
+            due.push_back(static_cast<TIMER_EVENT>(event));
+            m_pending[event] = false;
+        }
+    }
+
+    std::sort(due.begin(), due.end(), [this](TIMER_EVENT first, TIMER_EVENT second) { return m_deadlines[first] < m_deadlines[second]; });
+}
+
+bool TimerQueue::empty() const
+{
+    return std::none_of(m_pending.begin(), m_pending.end(), [](bool pending) { return pending; });
+}
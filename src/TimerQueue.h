@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Includes.h"
+
+#include <array>
+
+// Things done a while after something happened, serviced by the input loop while it waits on keys
+enum TIMER_EVENT
+{
+    YANK_HIGHLIGHT_EXPIRY,
+    NUMBER_OF_TIMER_EVENTS,
+};
+
+// Deadlines of deferred events, at most one pending per kind of event so scheduling one again moves its deadline. There
+// is nothing to allocate and no thread to start, so events can be scheduled as often as keys come in.
+class TimerQueue
+{
+
+public:
+
+    using Clock = std::chrono::steady_clock;
+
+private:
+
+    std::array<Clock::time_point, NUMBER_OF_TIMER_EVENTS> m_deadlines;
+    std::array<bool, NUMBER_OF_TIMER_EVENTS> m_pending = {};
+
+public:
+
+    void schedule(TIMER_EVENT event, Clock::time_point deadline);
+    void schedule(TIMER_EVENT event, int milliseconds) { schedule(event, Clock::now() + std::chrono::milliseconds(milliseconds)); }
+    void cancel(TIMER_EVENT event) { m_pending[event] = false; }
+
+    // Milliseconds from now until the earliest deadline, rounded up, 0 if one has passed and -1 if nothing is pending
+    int millisecondsUntilNext(Clock::time_point now) const;
+
+    // Takes the events due by now off the queue, earliest first
+    void takeDue(Clock::time_point now, std::vector<TIMER_EVENT>& due);
+
+    // Getters
+    bool pending(TIMER_EVENT event) const { return m_pending[event]; }
+    bool empty() const;
+
+};
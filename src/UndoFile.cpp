@@ -0,0 +1,207 @@
+#include "UndoFile.h"
+#include "FileWriter.h"
+
+// Numbers are stored in the byte order of the machine, undo files are not meant to travel between machines
+template <typename T>
+static void store(std::vector<char>& data, size_t offset, T value)
+{
+    memcpy(data.data() + offset, &value, sizeof(value));
+}
+
+template <typename T>
+static T retrieve(const char* data, size_t offset)
+{
+    T value;
+    memcpy(&value, data + offset, sizeof(value));
+
+    return value;
+}
+
+ContentHash::ContentHash()
+    : m_state(0x9E3779B97F4A7C15), m_pendingBytes(0), m_size(0)
+{
+}
+
+void ContentHash::mix(const char* word)
+{
+    uint64_t value;
+    memcpy(&value, word, sizeof(value));
+
+    m_state = (m_state ^ value) * 0xFF51AFD7ED558CCD;
+    m_state ^= m_state >> 29;
+}
+
+void ContentHash::update(const char* data, size_t size)
+{
+    m_size += size;
+
+    // A word started by the last piece is finished first
+    if (m_pendingBytes)
+    {
+        size_t taken = std::min(size, sizeof(m_pending) - m_pendingBytes);
+
+        memcpy(m_pending + m_pendingBytes, data, taken);
+        m_pendingBytes += taken;
+        data += taken;
+        size -= taken;
+
+        if (m_pendingBytes < sizeof(m_pending)) { return; }
+
+        mix(m_pending);
+        m_pendingBytes = 0;
+    }
+
+    for (; size >= sizeof(m_pending); data += sizeof(m_pending), size -= sizeof(m_pending)) { mix(data); }
+
+    memcpy(m_pending, data, size);
+    m_pendingBytes = size;
+}
+
+uint64_t ContentHash::value() const
+{
+    ContentHash hash = *this;
+
+    char tail[sizeof(m_pending)] = {};
+    memcpy(tail, m_pending, m_pendingBytes);
+    hash.mix(tail);
+
+    char size[sizeof(m_pending)];
+    memcpy(size, &m_size, sizeof(size));
+    hash.mix(size);
+
+    uint64_t state = hash.m_state;
+    state ^= state >> 33;
+    state *= 0xC4CEB9FE1A85EC53;
+    state ^= state >> 33;
+
+    return state;
+}
+
+UndoFile::UndoFile(const std::filesystem::path& undoFilePath)
+    : m_mappedFile(undoFilePath), m_numberOfEntries(0), m_operationsSize(0)
+{
+    if (!m_mappedFile.isMapped() || m_mappedFile.size() < headerSize) { return; }
+
+    const char* data = m_mappedFile.data();
+
+    if (memcmp(data, magic, sizeof(magic)) != 0 || retrieve<uint32_t>(data, 8) != version) { return; }
+
+    uint32_t numberOfEntries = retrieve<uint32_t>(data, 12);
+    uint64_t operationsSize = retrieve<uint64_t>(data, 32);
+
+    // A file cut short or grown since it was written is not trusted with anything
+    if (operationsSize > m_mappedFile.size() || headerSize + numberOfEntries * entryRecordSize + operationsSize != m_mappedFile.size()) { return; }
+
+    m_numberOfEntries = numberOfEntries;
+    m_operationsSize = operationsSize;
+}
+
+std::filesystem::path UndoFile::undoFilePath(const std::filesystem::path& filePath)
+{
+    return filePath.parent_path() / ("." + filePath.filename().string() + ".razzundo");
+}
+
+std::vector<char> UndoFile::serialize(const UndoJournal& journal)
+{
+    // Only the way from the root to the current state is kept, other branches do not lead to the saved text
+    std::vector<int64_t> states = journal.pathTo(journal.rootState()).first;
+    std::reverse(states.begin(), states.end());
+
+    size_t numberOfEntries = states.size();
+    size_t operationsSize = 0;
+
+    for (int64_t state : states) { operationsSize += journal.entry(journal.indexOf(state)).size; }
+
+    std::vector<char> serialized(headerSize + numberOfEntries * entryRecordSize + operationsSize);
+
+    memcpy(serialized.data(), magic, sizeof(magic));
+    store<uint32_t>(serialized, 8, version);
+    store<uint32_t>(serialized, 12, static_cast<uint32_t>(numberOfEntries));
+    store<uint64_t>(serialized, 32, operationsSize);
+
+    size_t operationsOffset = headerSize + numberOfEntries * entryRecordSize;
+
+    for (size_t index = 0; index < numberOfEntries; index++)
+    {
+        size_t entryIndex = journal.indexOf(states[index]);
+        const UndoJournal::Entry& entry = journal.entry(entryIndex);
+        size_t record = headerSize + index * entryRecordSize;
+
+        store<uint64_t>(serialized, record, entry.size);
+        store<uint64_t>(serialized, record + 8, entry.edits);
+        store<int32_t>(serialized, record + 16, entry.cursorBefore.first);
+        store<int32_t>(serialized, record + 20, entry.cursorBefore.second);
+        store<int32_t>(serialized, record + 24, entry.cursorAfter.first);
+        store<int32_t>(serialized, record + 28, entry.cursorAfter.second);
+        store<uint32_t>(serialized, record + 32, (entry.insertModeBefore ? 1 : 0) | (entry.insertModeAfter ? 2 : 0));
+        store<int64_t>(serialized, record + 40, entry.time);
+
+        std::string_view operations = journal.entryOperations(entryIndex);
+        memcpy(serialized.data() + operationsOffset, operations.data(), operations.size());
+        operationsOffset += operations.size();
+    }
+
+    return serialized;
+}
+
+bool UndoFile::write(const std::filesystem::path& undoFilePath, std::vector<char>& serialized, const ContentHash& contentHash)
+{
+    store<uint64_t>(serialized, 16, contentHash.value());
+    store<uint64_t>(serialized, 24, contentHash.size());
+
+    ContentHash checksum;
+    checksum.update(serialized.data() + headerSize, serialized.size() - headerSize);
+    store<uint64_t>(serialized, 40, checksum.value());
+
+    FileWriter writer(undoFilePath);
+    writer.write(std::string_view(serialized.data(), serialized.size()));
+
+    return writer.commit();
+}
+
+bool UndoFile::load(UndoJournal& journal, const ContentHash& contentHash) const
+{
+    if (!valid()) { return false; }
+
+    const char* data = m_mappedFile.data();
+
+    if (retrieve<uint64_t>(data, 16) != contentHash.value() || retrieve<uint64_t>(data, 24) != contentHash.size()) { return false; }
+
+    ContentHash checksum;
+    checksum.update(data + headerSize, m_mappedFile.size() - headerSize);
+
+    if (checksum.value() != retrieve<uint64_t>(data, 40)) { return false; }
+
+    std::vector<UndoJournal::Entry> entries;
+    entries.reserve(m_numberOfEntries);
+
+    size_t offset = 0;
+
+    for (size_t index = 0; index < m_numberOfEntries; index++)
+    {
+        const char* record = data + headerSize + index * entryRecordSize;
+        uint32_t flags = retrieve<uint32_t>(record, 32);
+
+        UndoJournal::Entry entry;
+        entry.offset = offset;
+        entry.size = retrieve<uint64_t>(record, 0);
+        entry.repetition = 0;
+        entry.edits = retrieve<uint64_t>(record, 8);
+        entry.cursorBefore = { retrieve<int32_t>(record, 16), retrieve<int32_t>(record, 20) };
+        entry.cursorAfter = { retrieve<int32_t>(record, 24), retrieve<int32_t>(record, 28) };
+        entry.insertModeBefore = flags & 1;
+        entry.insertModeAfter = flags & 2;
+        entry.parent = UndoJournal::noState;
+        entry.redoState = UndoJournal::noState;
+        entry.time = retrieve<int64_t>(record, 40);
+
+        offset += entry.size;
+        entries.push_back(entry);
+    }
+
+    if (offset != m_operationsSize) { return false; }
+
+    journal.prependEntries(entries, std::string_view(data + headerSize + m_numberOfEntries * entryRecordSize, m_operationsSize));
+
+    return true;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Includes.h"
+#include "MappedFile.h"
+#include "UndoJournal.h"
+
+// Streaming 64-bit hash of a file's text, fed a word at a time whatever the pieces it is handed
+class ContentHash
+{
+
+private:
+
+    uint64_t m_state;
+    char m_pending[8];
+    size_t m_pendingBytes;
+    size_t m_size;
+
+    void mix(const char* word);
+
+public:
+
+    ContentHash();
+
+    void update(const char* data, size_t size);
+    void update(std::string_view text) { update(text.data(), text.size()); }
+
+    uint64_t value() const;
+
+    // Getters
+    size_t size() const { return m_size; }
+
+};
+
+// Undo history saved beside a file as ".<name>.razzundo", so it survives restarts. It only applies to the text it was
+// saved with, which is recognized by the hash and size of the lines joined by newlines.
+//
+// The file is a header of the magic, the format version, the number of entries, the content hash and size, the size of the
+// operations and a checksum of everything after the header. Then a fixed size record per entry and the operations of all
+// entries back to back, as the journal packs them.
+//
+// Opening only maps the file and checks its header. The entries are checked and read when they are first needed.
+class UndoFile
+{
+
+private:
+
+    static inline const char magic[8] = { 'R', 'A', 'Z', 'Z', 'U', 'N', 'D', 'O' };
+    static inline const uint32_t version = 2;
+
+    static inline const size_t headerSize = 48;
+    static inline const size_t entryRecordSize = 48;
+
+    MappedFile m_mappedFile;
+    uint32_t m_numberOfEntries;
+    size_t m_operationsSize;
+
+public:
+
+    UndoFile(const std::filesystem::path& undoFilePath);
+
+    static std::filesystem::path undoFilePath(const std::filesystem::path& filePath);
+
+    // The entries leading from the root of the journal to its current state laid out as an undo file, with the content hash and checksum still to be filled in
+    static std::vector<char> serialize(const UndoJournal& journal);
+
+    // Fills in the content hash and checksum of serialized history and replaces the undo file with it
+    static bool write(const std::filesystem::path& undoFilePath, std::vector<char>& serialized, const ContentHash& contentHash);
+
+    // Puts the saved entries in front of the journal if the file is intact and was saved with text hashing to contentHash
+    bool load(UndoJournal& journal, const ContentHash& contentHash) const;
+
+    // Getters
+    bool valid() const { return m_mappedFile.isMapped() && m_numberOfEntries > 0; }
+    uint32_t numberOfEntries() const { return m_numberOfEntries; }
+
+};
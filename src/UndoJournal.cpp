@@ -0,0 +1,370 @@
+#include "UndoJournal.h"
+
+UndoJournal::UndoJournal(size_t maxEntries)
+    : m_maxEntries(maxEntries), m_firstState(0), m_rootState(0), m_rootRedoState(noState), m_rootTime(currentTime()), m_currentState(0),
+    m_recording(false), m_entryStarted(false), m_extendingLastEntry(false), m_recordingEntry(), m_canExtendLastEntry(false), m_lastOperation(),
+    m_editsInHistory(0)
+{
+}
+
+int64_t UndoJournal::currentTime()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void UndoJournal::appendVarint(uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        m_arena.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+
+    m_arena.push_back(static_cast<char>(value));
+}
+
+uint64_t UndoJournal::readVarint(const char* data, size_t& offset)
+{
+    uint64_t value = 0;
+    int shift = 0;
+
+    while (true)
+    {
+        unsigned char byte = static_cast<unsigned char>(data[offset++]);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+        if (!(byte & 0x80)) { return value; }
+
+        shift += 7;
+    }
+}
+
+void UndoJournal::appendOperation(UNDO_OPERATION type, int y, int x, std::string_view first, std::string_view second)
+{
+    if (!m_entryStarted) { startEntry(); }
+
+    int64_t deltaY = static_cast<int64_t>(y) - m_lastOperation.y;
+
+    m_arena.push_back(static_cast<char>(type));
+    appendVarint((static_cast<uint64_t>(deltaY) << 1) ^ static_cast<uint64_t>(deltaY >> 63));
+    appendVarint(static_cast<uint64_t>(x));
+
+    uint32_t length = static_cast<uint32_t>(first.size() + second.size());
+    size_t lengthOffset = m_arena.size();
+
+    m_arena.resize(m_arena.size() + sizeof(length));
+    memcpy(m_arena.data() + lengthOffset, &length, sizeof(length));
+
+    m_arena.insert(m_arena.end(), first.begin(), first.end());
+    m_arena.insert(m_arena.end(), second.begin(), second.end());
+
+    m_lastOperation = LastOperation{ lengthOffset, length, y, x + static_cast<int>(length), type == TEXT_INSERTED };
+
+    m_recordingEntry.edits++;
+}
+
+void UndoJournal::beginEntry(const std::pair<int, int>& cursorBefore, size_t repetition, bool insertMode)
+{
+    m_recording = true;
+    m_entryStarted = false;
+
+    m_recordingEntry = Entry{ 0, 0, repetition, 0, cursorBefore, cursorBefore, insertMode, insertMode, m_currentState, noState, 0 };
+}
+
+void UndoJournal::startEntry()
+{
+    m_entryStarted = true;
+
+    // Commands repeated as one change keep adding to the same entry, as long as nothing was undone in between
+    m_extendingLastEntry = (m_canExtendLastEntry && m_currentState == lastState() && m_entries.back().repetition == m_recordingEntry.repetition);
+
+    if (m_extendingLastEntry)
+    {
+        m_recordingEntry = m_entries.back();
+        return;
+    }
+
+    m_recordingEntry.offset = m_arena.size();
+
+    m_lastOperation.y = m_recordingEntry.cursorBefore.first;
+    m_lastOperation.extendable = false;
+}
+
+void UndoJournal::commitEntry(const std::pair<int, int>& cursorAfter, bool insertMode, int64_t time)
+{
+    m_recording = false;
+
+    if (!m_entryStarted) { return; }
+
+    m_recordingEntry.size = m_arena.size() - m_recordingEntry.offset;
+    m_recordingEntry.cursorAfter = cursorAfter;
+    m_recordingEntry.insertModeAfter = insertMode;
+    m_recordingEntry.time = time;
+    m_canExtendLastEntry = true;
+
+    if (m_extendingLastEntry)
+    {
+        m_editsInHistory += m_recordingEntry.edits - m_entries.back().edits;
+        m_entries.back() = m_recordingEntry;
+
+        return;
+    }
+
+    // A change made after undoing leaves the undone entries where they are, on a branch of their own
+    m_entries.push_back(m_recordingEntry);
+    m_currentState = lastState();
+    redoStateOf(m_recordingEntry.parent) = m_currentState;
+    m_editsInHistory += m_recordingEntry.edits;
+
+    if (m_entries.size() > m_maxEntries) { discardOldestEntry(); }
+}
+
+void UndoJournal::discardOldestEntry()
+{
+    const Entry& oldest = m_entries.front();
+    m_firstState++;
+
+    // Redo from the root leads through the current state, so that is where to look for whether the oldest entry is on the
+    // way to it. If it is, its state becomes the root. If not, it is dropped with whatever hangs off it.
+    if (oldest.parent == m_rootState && m_rootRedoState == m_firstState && m_currentState != m_rootState)
+    {
+        m_rootState = m_firstState;
+        m_rootRedoState = oldest.redoState;
+        m_rootTime = oldest.time;
+    }
+
+    m_editsInHistory -= oldest.edits;
+    m_entries.pop_front();
+
+    // The arena is only compacted once the discarded bytes at its front outweigh the live ones
+    size_t deadBytes = m_entries.empty() ? m_arena.size() : m_entries.front().offset;
+
+    if (deadBytes > m_arena.size() / 2)
+    {
+        m_arena.erase(m_arena.begin(), m_arena.begin() + deadBytes);
+
+        for (Entry& entry : m_entries) { entry.offset -= deadBytes; }
+
+        m_lastOperation.lengthOffset -= deadBytes;
+    }
+}
+
+void UndoJournal::prependEntries(const std::vector<Entry>& entries, std::string_view operations)
+{
+    assert(m_firstState == 0 && m_rootState == 0);
+
+    if (entries.empty()) { return; }
+
+    m_arena.insert(m_arena.begin(), operations.begin(), operations.end());
+
+    for (Entry& entry : m_entries) { entry.offset += operations.size(); }
+
+    m_lastOperation.lengthOffset += operations.size();
+
+    // The loaded entries lead from a new root up to the state that was the root, so the states of this session keep their
+    // numbers. Repetitions are numbered apart from each other and from the first entry of this session, so no two of them
+    // are taken for one change.
+    int64_t state = 0;
+    int64_t redoState = m_rootRedoState;
+    size_t repetition = (m_entries.empty()) ? 0 : m_entries.front().repetition;
+
+    for (auto entry = entries.rbegin(); entry != entries.rend(); entry++)
+    {
+        m_entries.push_front(*entry);
+        m_entries.front().repetition = ++repetition;
+        m_entries.front().parent = state - 1;
+        m_entries.front().redoState = redoState;
+
+        m_editsInHistory += entry->edits;
+
+        redoState = state;
+        state--;
+    }
+
+    m_firstState = state;
+    m_rootState = state;
+    m_rootRedoState = redoState;
+    m_rootTime = entries.front().time;
+
+    while (m_entries.size() > m_maxEntries) { discardOldestEntry(); }
+}
+
+bool UndoJournal::reachable(int64_t state) const
+{
+    while (state > m_rootState && state > m_firstState) { state = parentState(state); }
+
+    return state == m_rootState;
+}
+
+void UndoJournal::reachableStates(std::vector<bool>& reachable) const
+{
+    reachable.assign(m_entries.size(), false);
+
+    for (int64_t state = m_rootState + 1; state <= lastState(); state++)
+    {
+        int64_t parent = parentState(state);
+
+        reachable[indexOf(state)] = parent == m_rootState || (parent > m_rootState && reachable[indexOf(parent)]);
+    }
+}
+
+std::pair<std::vector<int64_t>, std::vector<int64_t>> UndoJournal::pathTo(int64_t state) const
+{
+    std::vector<int64_t> undone;
+    std::vector<int64_t> redone;
+
+    // Parents are always older than their children, so stepping up from the newer side meets at the common ancestor
+    int64_t from = m_currentState;
+
+    while (from != state)
+    {
+        if (from > state)
+        {
+            undone.push_back(from);
+            from = parentState(from);
+        }
+        else
+        {
+            redone.push_back(state);
+            state = parentState(state);
+        }
+    }
+
+    std::reverse(redone.begin(), redone.end());
+
+    return { undone, redone };
+}
+
+void UndoJournal::moveTo(int64_t state)
+{
+    for (int64_t redone : pathTo(state).second) { redoStateOf(parentState(redone)) = redone; }
+
+    m_currentState = state;
+    m_canExtendLastEntry = false;
+    m_lastOperation.extendable = false;
+}
+
+int64_t UndoJournal::stateAt(int64_t time) const
+{
+    std::vector<bool> reachable;
+    reachableStates(reachable);
+
+    for (int64_t state = lastState(); state > m_rootState; state--)
+    {
+        if (stateTime(state) <= time && reachable[indexOf(state)]) { return state; }
+    }
+
+    return m_rootState;
+}
+
+int64_t UndoJournal::chronologicalState(int64_t steps) const
+{
+    std::vector<bool> reachable;
+    reachableStates(reachable);
+
+    int64_t state = m_currentState;
+    int64_t direction = (steps < 0) ? -1 : 1;
+
+    for (int64_t step = 0; step != steps; step += direction)
+    {
+        int64_t next = state + direction;
+
+        while (next > m_rootState && next <= lastState() && !reachable[indexOf(next)]) { next += direction; }
+
+        if (next < m_rootState || next > lastState()) { break; }
+
+        state = next;
+    }
+
+    return state;
+}
+
+void UndoJournal::recordInsertText(int y, int x, std::string_view text)
+{
+    if (!m_recording || text.empty()) { return; }
+
+    if (!m_entryStarted) { startEntry(); }
+
+    if (m_lastOperation.extendable && y == m_lastOperation.y && x == m_lastOperation.textEnd)
+    {
+        m_arena.insert(m_arena.end(), text.begin(), text.end());
+
+        m_lastOperation.length += static_cast<uint32_t>(text.size());
+        m_lastOperation.textEnd += static_cast<int>(text.size());
+        memcpy(m_arena.data() + m_lastOperation.lengthOffset, &m_lastOperation.length, sizeof(m_lastOperation.length));
+
+        m_recordingEntry.edits++;
+
+        return;
+    }
+
+    appendOperation(TEXT_INSERTED, y, x, text);
+}
+
+void UndoJournal::recordEraseText(int y, int x, const std::pair<std::string_view, std::string_view>& text)
+{
+    if (!m_recording) { return; }
+
+    appendOperation(TEXT_ERASED, y, x, text.first, text.second);
+}
+
+void UndoJournal::recordInsertLine(int y, const LineGapBuffer& line)
+{
+    if (!m_recording) { return; }
+
+    std::pair<std::string_view, std::string_view> text = line.spans(0, line.lineSize());
+
+    appendOperation(LINE_INSERTED, y, 0, text.first, text.second);
+}
+
+void UndoJournal::recordRemoveLine(int y, const LineGapBuffer& line)
+{
+    if (!m_recording) { return; }
+
+    std::pair<std::string_view, std::string_view> text = line.spans(0, line.lineSize());
+
+    appendOperation(LINE_REMOVED, y, 0, text.first, text.second);
+}
+
+void UndoJournal::recordMoveLine(int from, int to)
+{
+    if (!m_recording) { return; }
+
+    appendOperation(LINE_MOVED, from, to, std::string_view());
+}
+
+void UndoJournal::forEachOperation(size_t index, bool reverse, const std::function<void(const UndoOperation&)>& visit) const
+{
+    const Entry& entry = m_entries[index];
+
+    std::vector<UndoOperation> operations;
+
+    int y = entry.cursorBefore.first;
+    size_t offset = entry.offset;
+
+    while (offset < entry.offset + entry.size)
+    {
+        UNDO_OPERATION type = static_cast<UNDO_OPERATION>(m_arena[offset++]);
+
+        uint64_t zigzagDeltaY = readVarint(m_arena.data(), offset);
+        y += static_cast<int>(static_cast<int64_t>(zigzagDeltaY >> 1) ^ -static_cast<int64_t>(zigzagDeltaY & 1));
+
+        int x = static_cast<int>(readVarint(m_arena.data(), offset));
+
+        uint32_t length;
+        memcpy(&length, m_arena.data() + offset, sizeof(length));
+        offset += sizeof(length);
+
+        operations.push_back(UndoOperation{ type, y, x, std::string_view(m_arena.data() + offset, length) });
+        offset += length;
+    }
+
+    if (reverse)
+    {
+        for (auto operation = operations.rbegin(); operation != operations.rend(); operation++) { visit(*operation); }
+    }
+    else
+    {
+        for (const UndoOperation& operation : operations) { visit(operation); }
+    }
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "Includes.h"
+#include "LineGapBuffer.h"
+
+enum UNDO_OPERATION
+{
+    TEXT_INSERTED,
+    TEXT_ERASED,
+    LINE_INSERTED,
+    LINE_REMOVED,
+    LINE_MOVED,
+};
+
+// One primitive change to the text. x is the column for text changes and the destination line for LINE_MOVED.
+struct UndoOperation
+{
+    UNDO_OPERATION type;
+    int y;
+    int x;
+    std::string_view text;
+};
+
+// Undo history kept as the primitive changes each command made, packed back to back in one byte arena instead of as
+// command objects. Every command that changed the buffer is an entry; consecutive entries of the same repetition are
+// merged into one with insertions at the end of the previous one appended to it, so typing a run of text costs about a
+// byte per character.
+//
+// Entries form a tree. Each is numbered by when it was made, and the state of the text after it is known by that number.
+// A change made after undoing branches off the state undone to instead of dropping what was undone, and every state
+// remembers which of its children redo goes to. States further back than the oldest entry kept are gone: the root of the
+// tree is the oldest state that can still be reached from the current one.
+//
+// Operations are packed as a type byte, the line as a zigzag varint delta from the previous operation's line, the column
+// as a varint, the text length as four bytes so runs can grow in place, then the text.
+class UndoJournal
+{
+
+public:
+
+    static inline const int64_t noState = std::numeric_limits<int64_t>::min();
+
+    struct Entry
+    {
+        size_t offset;
+        size_t size;
+        size_t repetition;
+        size_t edits;
+        std::pair<int, int> cursorBefore;
+        std::pair<int, int> cursorAfter;
+        bool insertModeBefore;
+        bool insertModeAfter;
+
+        // State the entry was made in, and the child of its own state that redo goes to
+        int64_t parent;
+        int64_t redoState;
+
+        // Milliseconds since the epoch when the entry was last recorded into
+        int64_t time;
+    };
+
+private:
+
+    std::vector<char> m_arena;
+    std::deque<Entry> m_entries;
+    size_t m_maxEntries;
+
+    // The entry at the front of m_entries is the one after m_firstState
+    int64_t m_firstState;
+    int64_t m_rootState;
+    int64_t m_rootRedoState;
+    int64_t m_rootTime;
+    int64_t m_currentState;
+
+    // Set between beginEntry and commitEntry. The entry itself is only started by the first operation recorded, so commands
+    // that change nothing leave no trace. It is either new at the end of the arena, or the last entry being extended.
+    bool m_recording;
+    bool m_entryStarted;
+    bool m_extendingLastEntry;
+    Entry m_recordingEntry;
+
+    // Only an entry this journal just recorded can be extended, not one that was travelled to or loaded
+    bool m_canExtendLastEntry;
+
+    // The last operation recorded, so a following insertion right after its text can be appended to it
+    struct LastOperation
+    {
+        size_t lengthOffset;
+        uint32_t length;
+        int y;
+        int textEnd;
+        bool extendable;
+    };
+
+    LastOperation m_lastOperation;
+
+    size_t m_editsInHistory;
+
+private:
+
+    void appendVarint(uint64_t value);
+    static uint64_t readVarint(const char* data, size_t& offset);
+
+    void appendOperation(UNDO_OPERATION type, int y, int x, std::string_view first, std::string_view second = std::string_view());
+    void startEntry();
+    void discardOldestEntry();
+
+    // Whether each entry's state still hangs off the root, found in one pass as parents are always older than children
+    void reachableStates(std::vector<bool>& reachable) const;
+
+    int64_t& redoStateOf(int64_t state) { return (state == m_rootState) ? m_rootRedoState : m_entries[indexOf(state)].redoState; }
+
+public:
+
+    UndoJournal(size_t maxEntries);
+
+    void beginEntry(const std::pair<int, int>& cursorBefore, size_t repetition, bool insertMode);
+    void commitEntry(const std::pair<int, int>& cursorAfter, bool insertMode, int64_t time = currentTime());
+
+    void recordInsertText(int y, int x, std::string_view text);
+    void recordEraseText(int y, int x, const std::pair<std::string_view, std::string_view>& text);
+    void recordInsertLine(int y, const LineGapBuffer& line);
+    void recordRemoveLine(int y, const LineGapBuffer& line);
+    void recordMoveLine(int from, int to);
+
+    // Calls visit with every operation of the entry, in the order they were made or in reverse
+    void forEachOperation(size_t index, bool reverse, const std::function<void(const UndoOperation&)>& visit) const;
+
+    // Whether the state still hangs off the root, rather than off an entry that was dropped
+    bool reachable(int64_t state) const;
+
+    // The entries to undo to get from the current state to the state, then the ones to redo, as states after the entries
+    std::pair<std::vector<int64_t>, std::vector<int64_t>> pathTo(int64_t state) const;
+
+    // Makes the state current once the caller has applied the path to it. Redo follows the path taken from then on.
+    void moveTo(int64_t state);
+
+    // The latest reachable state made at or before the time, or the root if there is none
+    int64_t stateAt(int64_t time) const;
+
+    // Reachable states in the order they were made, steps from the current one
+    int64_t chronologicalState(int64_t steps) const;
+
+    // Puts entries recorded earlier in front of the history, as a line of states ending at the current root. Their
+    // offsets are into operations. Only possible while nothing has dropped off the front.
+    void prependEntries(const std::vector<Entry>& entries, std::string_view operations);
+    std::string_view entryOperations(size_t index) const { return std::string_view(m_arena.data() + m_entries[index].offset, m_entries[index].size); }
+
+    static int64_t currentTime();
+
+    // Getters
+    bool recording() const { return m_recording; }
+    size_t numberOfEntries() const { return m_entries.size(); }
+    int64_t currentState() const { return m_currentState; }
+    int64_t rootState() const { return m_rootState; }
+    int64_t firstState() const { return m_firstState; }
+    int64_t lastState() const { return m_firstState + static_cast<int64_t>(m_entries.size()); }
+    size_t changeNumber() const { return static_cast<size_t>(m_currentState); }
+    size_t indexOf(int64_t state) const { return static_cast<size_t>(state - m_firstState - 1); }
+    const Entry& entry(size_t index) const { return m_entries[index]; }
+    int64_t parentState(int64_t state) const { return m_entries[indexOf(state)].parent; }
+    int64_t redoState(int64_t state) const { return (state == m_rootState) ? m_rootRedoState : m_entries[indexOf(state)].redoState; }
+    int64_t stateTime(int64_t state) const { return (state == m_rootState) ? m_rootTime : m_entries[indexOf(state)].time; }
+    size_t editsInHistory() const { return m_editsInHistory; }
+    size_t arenaSize() const { return m_arena.size(); }
+    size_t memoryUsage() const { return m_arena.capacity() + m_entries.size() * sizeof(Entry); }
+
+};
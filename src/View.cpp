@@ -4,171 +4,360 @@
 #include "Includes.h"
 #include "Editor.h"
 
+// Rough sizes of the escape sequences ncurses sends around the text, for estimating what a frame costs. A cursor move is
+// about "\e[row;colH", a change of colors and boldness about "\e[0;1;38;5;nn;48;5;nnm" and hiding or showing the cursor "\e[?25l".
+static const size_t ESTIMATED_CURSOR_MOVE_BYTES = 8;
+static const size_t ESTIMATED_ATTRIBUTE_BYTES = 20;
+static const size_t ESTIMATED_CURSOR_VISIBILITY_BYTES = 6;
+
+// ncurses would expand tabs and spell out control characters over several cells, which would put the terminal out of
+// step with the frame
+static char printableCharacter(char character)
+{
+    if (character == '\t') { return ' '; }
+
+    return (character >= ' ' && character <= '~') ? character : '?';
+}
+
 View::View(Editor* editor, Buffer* buffer)
-    : m_editor(editor), m_buffer(buffer)
+    : m_editor(editor)
 {
+    m_viewports.push_back(std::make_unique<Viewport>(editor, this, 0));
+
+    if (buffer) { m_viewports.back()->setBuffer(buffer, 0); }
 }
 
-void View::yankHighlightTimer(int milliseconds, YANK_TYPE yankType)
+Viewport& View::viewport(int id)
 {
-    m_previousYankType = yankType;
+    return **std::find_if(m_viewports.begin(), m_viewports.end(), [id](const std::unique_ptr<Viewport>& viewport) { return viewport->id() == id; });
+}
 
-    std::thread(&View::yankHighlight, this, milliseconds).detach();
+const Viewport& View::activeViewport() const
+{
+    return **std::find_if(m_viewports.begin(), m_viewports.end(), [this](const std::unique_ptr<Viewport>& viewport) { return viewport->id() == m_activeViewport; });
 }
 
-void View::yankHighlight(int milliseconds)
+void View::setBuffer(Buffer* buffer, int linesDown)
 {
-    m_displayHighlight.store(true);
+    std::lock_guard<std::mutex> lock(displayMutex);
 
-    display();
+    activeViewport().setBuffer(buffer, linesDown);
+}
 
-    std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+void View::layoutViewports()
+{
+    // The last two rows hold the buffer information line and the command line
+    m_splitLayout.areas(LINES - 2, COLS, m_areas, m_separators);
 
-    m_displayHighlight.store(false);
+    for (const std::pair<int, ViewportArea>& area : m_areas) { viewport(area.first).setArea(area.second); }
+}
 
-    display();
+bool View::splitViewport(bool sideBySide)
+{
+    std::lock_guard<std::mutex> lock(displayMutex);
+
+    layoutViewports();
+
+    Viewport& current = activeViewport();
+    const ViewportArea& area = current.area();
+
+    if ((sideBySide) ? (area.cols - 1) / 2 < MIN_VIEWPORT_COLUMNS : (area.rows - 1) / 2 < MIN_VIEWPORT_ROWS) { return false; }
+
+    int id = m_splitLayout.split(m_activeViewport, sideBySide);
+
+    std::unique_ptr<Viewport> newViewport = std::make_unique<Viewport>(m_editor, this, id);
+    newViewport->setBuffer(current.buffer(), current.linesDown());
+
+    current.setCursor(current.buffer()->getCursorPos());
+
+    m_viewports.push_back(std::move(newViewport));
+    m_activeViewport = id;
+
+    return true;
+}
+
+void View::activate(int id)
+{
+    m_activeViewport = id;
+
+    Viewport& target = viewport(id);
+    Buffer* buffer = target.buffer();
+
+    int lastLine = static_cast<int>(buffer->getFile().numberOfLines()) - 1;
+    buffer->moveCursor(std::min(target.cursor().first, lastLine), target.cursor().second);
+}
+
+bool View::closeViewport()
+{
+    std::lock_guard<std::mutex> lock(displayMutex);
+
+    int remainingViewport = m_splitLayout.close(m_activeViewport);
+
+    if (remainingViewport == -1) { return false; }
+
+    int closedViewport = m_activeViewport;
+    m_viewports.erase(std::find_if(m_viewports.begin(), m_viewports.end(),
+        [closedViewport](const std::unique_ptr<Viewport>& viewport) { return viewport->id() == closedViewport; }));
+
+    activate(remainingViewport);
+
+    return true;
 }
 
-void View::adjustLinesAfterScrolling(int relativeCursorPosY, int upperLineMoveThreshold, int lowerLineMoveThreshold)
+void View::onlyViewport()
 {
-    m_prevLinesDown = m_linesDown;
+    std::lock_guard<std::mutex> lock(displayMutex);
+
+    std::vector<int> closedViewports = m_splitLayout.only(m_activeViewport);
+
+    m_viewports.erase(std::remove_if(m_viewports.begin(), m_viewports.end(), [&closedViewports](const std::unique_ptr<Viewport>& viewport)
+        { return std::find(closedViewports.begin(), closedViewports.end(), viewport->id()) != closedViewports.end(); }), m_viewports.end());
+}
+
+void View::focusViewport(int id)
+{
+    std::lock_guard<std::mutex> lock(displayMutex);
+
+    if (id == m_activeViewport || m_splitLayout.numberOfViewports() == 1) { return; }
+
+    Viewport& current = activeViewport();
+    current.setCursor(current.buffer()->getCursorPos());
+
+    activate(id);
+}
+
+int View::neighborViewport(NEIGHBOR_DIRECTION direction)
+{
+    std::lock_guard<std::mutex> lock(displayMutex);
+
+    layoutViewports();
+
+    // Across a vertical separator the viewport next to the cursor row is preferred, across a horizontal one the one next
+    // to its column
+    int position = (direction == NEIGHBOR_LEFT || direction == NEIGHBOR_RIGHT) ? m_previousCursorY : m_previousCursorX;
+
+    return SplitLayout::neighbor(m_areas, m_activeViewport, direction, position);
+}
+
+int View::nextViewport()
+{
+    std::lock_guard<std::mutex> lock(displayMutex);
+
+    layoutViewports();
 
-    if (relativeCursorPosY <= upperLineMoveThreshold)
+    for (size_t i = 0; i < m_areas.size(); i++)
     {
-        m_linesDown = std::max(0, m_linesDown + relativeCursorPosY - upperLineMoveThreshold);
+        if (m_areas[i].first == m_activeViewport) { return m_areas[(i + 1) % m_areas.size()].first; }
     }
-    else if (relativeCursorPosY >= lowerLineMoveThreshold)
+
+    return -1;
+}
+
+bool View::showsBuffer(const Buffer* buffer) const
+{
+    for (const std::unique_ptr<Viewport>& viewport : m_viewports)
     {
-        m_linesDown += relativeCursorPosY - lowerLineMoveThreshold;
+        if (viewport->buffer() == buffer) { return true; }
     }
+
+    return false;
 }
 
-int View::numberOfDigits(int x)
+void View::startYankHighlight(int milliseconds, YANK_TYPE yankType)
 {
-    int count = 0;
+    m_previousYankType = yankType;
+    m_displayHighlight.store(true);
 
-    do
-    {
-        x /= 10;
-        count++;
-    }
-    while (x >= 1);
+    // Yanking again before the highlight ended only moves when it ends
+    m_editor->timerQueue().schedule(YANK_HIGHLIGHT_EXPIRY, milliseconds);
 
-    return count;
+    display();
 }
 
-int View::wrappedLinesBeforeCursor(const FileGapBuffer& fileGapBuffer, int numLines, int relativeCursorY)
+void View::endYankHighlight()
 {
-    int extraLinesFromWrapping = 0;
-    int maxRender = std::min(LINES, numLines - m_linesDown);
-    int maxRenderCopy = maxRender;
+    m_displayHighlight.store(false);
 
-    for (int row = 0; row < maxRender; row++)
-    {
-        if (row >= relativeCursorY) { return extraLinesFromWrapping; }
+    display();
+}
 
-        const std::shared_ptr<LineGapBuffer>& lineGapBuffer = fileGapBuffer[row + m_linesDown];
-        if (!lineGapBuffer)
-            break;
+bool View::deferFrame()
+{
+    if (m_renderSuppression.load() == 0) { return false; }
+
+    m_framePending.store(true);
+
+    return true;
+}
 
-        maxRender = maxRenderCopy - extraLinesFromWrapping;
+void View::drawPendingFrame()
+{
+    if (m_framePending.exchange(false)) { display(); }
 
-        int indexOfFirstNonSpace = m_buffer->indexOfFirstNonSpaceCharacter(lineGapBuffer);
+    // The command line held back is only still on screen if the command line was left open
+    int colorPair = m_pendingCommandBufferColorPair;
+    m_pendingCommandBufferColorPair = -1;
 
-        if (indexOfFirstNonSpace >= COLS)
-            continue;
+    if (colorPair != -1 && m_editor->mode() == COMMAND_MODE) { displayCommandBuffer(colorPair); }
+}
+
+void View::endRenderTransaction()
+{
+    if (--m_renderSuppression == 0) { drawPendingFrame(); }
+}
 
-        int lineSize = lineGapBuffer->lineSize();
+void View::flushRendering()
+{
+    resumeRenderTransactions(suspendRenderTransactions());
+}
 
-        if (lineSize + m_reservedColumnsForLineNumbering >= COLS)
-        {
-            extraLinesFromWrapping += (lineSize + m_reservedColumnsForLineNumbering - COLS) / (COLS - indexOfFirstNonSpace - m_reservedColumnsForLineNumbering) + 1;
-        }
+int View::suspendRenderTransactions()
+{
+    int renderSuppression = m_renderSuppression.exchange(0);
+
+    if (m_framePending.exchange(false)) { display(); }
+
+    if (m_pendingCommandBufferColorPair != -1)
+    {
+        displayCommandBuffer(m_pendingCommandBufferColorPair);
+        m_pendingCommandBufferColorPair = -1;
     }
 
-    return extraLinesFromWrapping;
+    return renderSuppression;
 }
 
 void View::display()
 {
+    if (deferFrame()) { return; }
+
     std::lock_guard<std::mutex> lock(displayMutex);
 
+    m_framesDrawn++;
+
     // Timer timer("display");
 
 
-    const FileGapBuffer& fileGapBuffer = m_buffer->getFileGapBuffer();
-    if (!fileGapBuffer.bufferSize())
+    if (!buffer()->getFile().numberOfLines())
         return;
 
-    int numLines = static_cast<int>(fileGapBuffer.numberOfLines());
-    m_reservedColumnsForLineNumbering = numberOfDigits(numLines) + 1;
+    resizeFrame();
+    layoutViewports();
 
-    const std::pair<int, int>& cursorPos = m_buffer->getCursorPos();
-    const int relativeCursorPosY = cursorPos.first - m_linesDown;
+    int cursorY = 0;
+    int cursorX = 0;
 
-    const int upperLineMoveThreshold = LINES / 4;
-    const int lowerLineMoveThreshold = upperLineMoveThreshold * 3;
+    for (const std::unique_ptr<Viewport>& viewport : m_viewports)
+    {
+        int viewportCursorY;
+        int viewportCursorX;
 
-    int preCursorWrappedLines = wrappedLinesBeforeCursor(fileGapBuffer, numLines, relativeCursorPosY);
-    adjustLinesAfterScrolling(relativeCursorPosY, upperLineMoveThreshold - preCursorWrappedLines, lowerLineMoveThreshold - preCursorWrappedLines);
+        viewport->draw(m_frame, viewport->id() == m_activeViewport, viewportCursorY, viewportCursorX);
 
-    move(0, 0);
-    curs_set(0);
+        if (viewport->id() == m_activeViewport)
+        {
+            cursorY = viewportCursorY;
+            cursorX = viewportCursorX;
+        }
+    }
 
+    printSeparators();
 
-    int extraLinesFromWrapping = 0;
-    int extraLinesFromWrappingBeforeCursor = 0;
-    int maxRender = std::clamp(numLines - m_linesDown, 0, LINES - 2);
+    // Only once every viewport showing a buffer has looked at its damage
+    for (const std::unique_ptr<Viewport>& viewport : m_viewports) { viewport->buffer()->clearDamage(); }
 
-    int maxRenderCopy = maxRender;
-    int cursorIndexOfFirstNonSpace = 0;
-    bool scrolledBuffer = (m_prevLinesDown != m_linesDown);
+    printBufferInformationLine(buffer()->getCursorPos());
+    printMessageLine();
+    printCircularInputBuffer();
 
-    for (int row = 0; row < maxRender; row++)
-    {
-        const std::shared_ptr<LineGapBuffer>& lineGapBuffer = m_buffer->getLineGapBuffer(row + m_linesDown);
-        if (!lineGapBuffer)
-            break;
+    m_previousCursorY = cursorY;
+    m_previousCursorX = cursorX;
 
-        int indexOfFirstNonSpace = m_buffer->indexOfFirstNonSpaceCharacter(lineGapBuffer);
+    flushFrame(cursorY, cursorX);
+}
 
-        if (indexOfFirstNonSpace >= COLS - 1)
-            continue;
+void View::resizeFrame()
+{
+    if (m_frame.rows() == LINES && m_frame.cols() == COLS) { return; }
 
-        int relativeY = cursorPos.first - m_linesDown;
+    // What the terminal showed before the resize is gone, so every cell is sent again
+    m_frame.resize(LINES, COLS);
+    m_screen.resize(LINES, COLS);
+    m_screen.invalidate();
 
-        move(row + extraLinesFromWrapping, 0);
-        if (scrolledBuffer)
-            clrtoeol();
+    clearok(curscr, TRUE);
+}
 
-        int newLinesCreatedByCurrentLine = printLine(lineGapBuffer, row, indexOfFirstNonSpace, extraLinesFromWrapping, relativeY);
+void View::flushFrame(int cursorY, int cursorX)
+{
+    m_frame.diff(m_screen, m_runs);
 
-        extraLinesFromWrapping += newLinesCreatedByCurrentLine;
+    size_t cells = 0;
+    size_t estimatedBytes = ESTIMATED_CURSOR_MOVE_BYTES;
 
-        if (row < relativeY) { extraLinesFromWrappingBeforeCursor += newLinesCreatedByCurrentLine; }
-        if (row == relativeY) { cursorIndexOfFirstNonSpace = indexOfFirstNonSpace; }
+    if (!m_runs.empty())
+    {
+        // Hidden while the cells are sent, so it is not seen jumping between them
+        curs_set(0);
+        estimatedBytes += 2 * ESTIMATED_CURSOR_VISIBILITY_BYTES;
 
-        if (numLines - m_linesDown >= LINES - 2)
+        for (const CellRun& run : m_runs)
         {
-            maxRender = maxRenderCopy - extraLinesFromWrapping;
+            move(run.row, run.column);
+            estimatedBytes += ESTIMATED_CURSOR_MOVE_BYTES;
+
+            int end = run.column + run.length;
+            int x = run.column;
+
+            // Cells of the same colors go out as one string
+            while (x < end)
+            {
+                const Cell& first = m_frame.at(run.row, x);
+                m_runText.clear();
+
+                for (; x < end && m_frame.at(run.row, x).colorPair == first.colorPair && m_frame.at(run.row, x).bold == first.bold; x++)
+                {
+                    m_runText.push_back(printableCharacter(m_frame.at(run.row, x).character));
+                }
+
+                attrset(COLOR_PAIR(first.colorPair) | ((first.bold) ? A_BOLD : A_NORMAL));
+                addnstr(m_runText.data(), static_cast<int>(m_runText.size()));
+                estimatedBytes += ESTIMATED_ATTRIBUTE_BYTES + m_runText.size();
+            }
+
+            cells += run.length;
         }
+
+        attrset(A_NORMAL);
     }
 
-    clearRemainingLines(maxRender, extraLinesFromWrapping);
+    move(cursorY, cursorX);
+    refresh();
 
-    printBufferInformationLine(cursorPos);
-    displayCircularInputBuffer();
+    if (!m_runs.empty()) { curs_set(1); }
 
-    moveCursor(cursorPos, cursorIndexOfFirstNonSpace, extraLinesFromWrappingBeforeCursor);
+    m_cellsOfLastFrame.store(cells);
+    m_runsOfLastFrame.store(m_runs.size());
+    m_estimatedBytesOfLastFrame.store(estimatedBytes);
+    m_cellsSent += cells;
+    m_estimatedBytesSent += estimatedBytes;
+}
 
-    refresh();
-    curs_set(1);
+void View::printSeparators()
+{
+    for (const ViewportArea& separator : m_separators)
+    {
+        if (separator.rows == 1) { m_frame.fill(separator.top, separator.left, separator.cols, '-', LINE_NUMBER_GREY); }
+        else
+        {
+            for (int y = separator.top; y < separator.top + separator.rows; y++) { m_frame.set(y, separator.left, '|', LINE_NUMBER_GREY); }
+        }
+    }
 }
 
 void View::printBufferInformationLine(const std::pair<int, int>& cursorPos)
 {
     MODE currentMode = m_editor->mode();
-    move(LINES - 2, 0);
+    int y = LINES - 2;
 
     int xPos = 0;
     std::string modeString;
@@ -214,15 +403,12 @@ void View::printBufferInformationLine(const std::pair<int, int>& cursorPos)
     }
 
     // Draw mode
-    attron(COLOR_PAIR(colorPair));
-    addstr(modeString.c_str());
-    attroff(COLOR_PAIR(colorPair));
+    int x = m_frame.print(y, 0, modeString, colorPair);
 
 
     // Draw path and extra spaces
-    attron(COLOR_PAIR(PATH_COLOR_PAIR));
 
-    const std::filesystem::path& filePath = m_buffer->filePath();
+    const std::filesystem::path& filePath = buffer()->filePath();
     std::string fileName;
 
     if (filePath == "NO_NAME")
@@ -231,442 +417,126 @@ void View::printBufferInformationLine(const std::pair<int, int>& cursorPos)
     }
     else
     {
-        fileName = " " + std::filesystem::absolute(m_buffer->filePath()).string() + " ";
+        fileName = " " + std::filesystem::absolute(buffer()->filePath()).string() + " ";
     }
 
-    addstr(fileName.c_str());
+    x = m_frame.print(y, x, fileName, PATH_COLOR_PAIR);
+
+    std::string status = m_status;
+    const BackgroundSave* backgroundSave = buffer()->backgroundSave();
 
-    int maxCursorIndicatorSize = numberOfDigits(cursorPos.first + 1) + 3 + numberOfDigits(cursorPos.second + 1);
-    for (int i = xPos; i < COLS - static_cast<int>(fileName.size()) - maxCursorIndicatorSize; i++)
+    if (backgroundSave && backgroundSave->numberOfLines())
     {
-        addch(' ');
+        status = "Saving " + std::to_string(backgroundSave->linesWritten() * 100 / backgroundSave->numberOfLines()) + "%";
     }
 
-    attroff(COLOR_PAIR(PATH_COLOR_PAIR));
-
-    // Draw cursor coordinates
-
-    std::string cursorPosition = " " + std::to_string(cursorPos.first + 1) + ":" + std::to_string(cursorPos.second + 1) + " ";
-
-    attron(COLOR_PAIR(colorPair));
-    addstr(cursorPosition.c_str());
-    attroff(COLOR_PAIR(colorPair));
-}
-
-void View::displayCommandBuffer(const int colorPair)
-{
-    move(LINES - 1, 0);
-    clrtoeol();
-
-    const std::string& commandBuffer = m_editor->inputController().commandBuffer();
-
-    attron(colorPair);
-    addch(':');
-    addstr(commandBuffer.c_str());
-    attroff(colorPair);
+    if (!status.empty()) { status = " " + status + " "; }
 
+    int maxCursorIndicatorSize = Viewport::numberOfDigits(cursorPos.first + 1) + 3 + Viewport::numberOfDigits(cursorPos.second + 1);
+    int spaces = COLS - static_cast<int>(fileName.size()) - static_cast<int>(status.size()) - maxCursorIndicatorSize - xPos;
 
-    refresh();
-}
-
-void View::displayCircularInputBuffer()
-{
-    curs_set(0);
-
-    attron(COLOR_PAIR(BACKGROUND));
-
-    for (size_t i = 0; i < INPUT_CONTROLLER_MAX_CIRCULAR_BUFFER_SIZE; i++)
+    if (spaces > 0)
     {
-        move(LINES - 1, COLS - i - 1);
-        int input = m_editor->inputController().circularBuffer()[i];
-        char character = ' ';
-        if (input != -1) { character = static_cast<char>(input); }
-
-        addch(character);
+        m_frame.fill(y, x, spaces, ' ', PATH_COLOR_PAIR);
+        x += spaces;
     }
 
-    attroff(COLOR_PAIR(BACKGROUND));
+    x = m_frame.print(y, x, status, PATH_COLOR_PAIR);
 
-    move(m_previousCursorY, m_previousCursorX);
+    // Draw cursor coordinates
 
-    refresh();
+    std::string cursorPosition = " " + std::to_string(cursorPos.first + 1) + ":" + std::to_string(cursorPos.second + 1) + " ";
 
-    curs_set(1);
+    m_frame.print(y, x, cursorPosition, colorPair);
 }
 
-int View::printLine(const std::shared_ptr<LineGapBuffer>& lineGapBuffer, int row, int indexOfFirstNonSpace, int extraLinesFromWrapping, int relativeCursorY)
+void View::displayBufferInformationLine()
 {
-    MODE currentMode = m_editor->mode();
-    bool inVisualMode = (currentMode == VISUAL_MODE || currentMode == VISUAL_LINE_MODE || currentMode == VISUAL_BLOCK_MODE);
-    const std::pair<int, int>& cursorPos = m_buffer->getCursorPos();
-
-    int lineSize = static_cast<int>(lineGapBuffer->lineSize());
-    int newLinesCreatedByCurrentLine = 0;
-
-    for (int column = 0; column < lineSize; column++)
-    {
-        char character = lineGapBuffer->at(column);
-
-        // Line colorings in visual modes
-        int colorPair = getColorPair(currentMode, row, column, cursorPos, relativeCursorY);
+    if (deferFrame()) { return; }
 
-        attron(COLOR_PAIR(colorPair));
-
-        if (column + m_reservedColumnsForLineNumbering >= COLS)
-        {
-            if (COLS - indexOfFirstNonSpace - m_reservedColumnsForLineNumbering == 0) { return newLinesCreatedByCurrentLine; }
-
-            newLinesCreatedByCurrentLine = (column  + m_reservedColumnsForLineNumbering - COLS) / (COLS - indexOfFirstNonSpace - m_reservedColumnsForLineNumbering) + 1;
-
-            int newCursorY = row + extraLinesFromWrapping + newLinesCreatedByCurrentLine;
-            int newCursorXWithoutOffset = (column + m_reservedColumnsForLineNumbering - COLS) % (COLS - indexOfFirstNonSpace - m_reservedColumnsForLineNumbering);
-
-            if (newCursorXWithoutOffset == 0)
-            {
-                move(newCursorY, 0);
-                clrtoeol();
-            }
-
-            printCharacter(newCursorY, newCursorXWithoutOffset + m_reservedColumnsForLineNumbering + indexOfFirstNonSpace, character);
-        }
-        else
-        {
-            printCharacter(row + extraLinesFromWrapping, column + m_reservedColumnsForLineNumbering, character);
-        }
-
-        attroff(COLOR_PAIR(colorPair));
-    }
-
-    if (!newLinesCreatedByCurrentLine)
-    {
-        move(row + extraLinesFromWrapping, lineSize + m_reservedColumnsForLineNumbering);
-        clrtoeol();
-    }
-
-    if (lineSize == 0)
-    {
-        if (currentMode == VISUAL_MODE || currentMode == VISUAL_LINE_MODE || currentMode == VISUAL_BLOCK_MODE)
-        {
-            const std::pair<int, int>& previousVisualPos = m_editor->inputController().initialVisualModeCursor();
-
-            if (row + m_linesDown >= std::min(previousVisualPos.first, cursorPos.first) && row + m_linesDown <= std::max(previousVisualPos.first, cursorPos.first))
-            {
-                attron(COLOR_PAIR(VISUAL_HIGHLIGHT_PAIR));
-                printCharacter(row + extraLinesFromWrapping, m_reservedColumnsForLineNumbering, ' ');
-                attroff(COLOR_PAIR(VISUAL_HIGHLIGHT_PAIR));
-            }
-        }
-    }
-
-    // Color the rest of the line the cursor is at
-
-    if (row == relativeCursorY && !inVisualMode)
-    {
-        attron(COLOR_PAIR(PATH_COLOR_PAIR));
-
-        int newCursorY = row + extraLinesFromWrapping + newLinesCreatedByCurrentLine;
-        int newCursorX = 0;
-
-        if (newLinesCreatedByCurrentLine)
-        {
-            newCursorX = (lineSize + m_reservedColumnsForLineNumbering - COLS) % (COLS - indexOfFirstNonSpace - m_reservedColumnsForLineNumbering) + m_reservedColumnsForLineNumbering + indexOfFirstNonSpace;
-        }
-        else { newCursorX = lineSize + m_reservedColumnsForLineNumbering; }
-
-        for (int i = newCursorX; i < COLS; i++)
-        {
-            move(newCursorY, i);
-            addch(' ');
-        }
-
-        attroff(COLOR_PAIR(PATH_COLOR_PAIR));
-    }
-
-    // Draw line number
-    for (int i = 0; i < m_reservedColumnsForLineNumbering; i++)
-    {
-        std::string lineNumber;
-        int numberDigits;
-
-        if (relativeCursorY == row)
-        {
-            move(relativeCursorY + extraLinesFromWrapping, i);
-            lineNumber = std::to_string(row + m_linesDown + 1);
-            numberDigits = numberOfDigits(row + m_linesDown + 1);
-        }
-        else
-        {
-            move(row + extraLinesFromWrapping, i);
-            lineNumber = std::to_string(abs(row - relativeCursorY));
-            numberDigits = numberOfDigits(abs(row - relativeCursorY));
-        }
-
-        if (i == m_reservedColumnsForLineNumbering - 1)
-        {
-            addch(' ');
-        }
-        else
-        {
-            if (i >= m_reservedColumnsForLineNumbering - numberDigits - 1)
-            {
-                if (relativeCursorY == row)
-                {
-                    attron(COLOR_PAIR(LINE_NUMBER_ORANGE));
-                    attron(A_BOLD);
-
-                    addch(lineNumber[i + numberDigits - m_reservedColumnsForLineNumbering + 1]);
+    std::lock_guard<std::mutex> lock(displayMutex);
 
-                    attroff(COLOR_PAIR(LINE_NUMBER_ORANGE));
-                    attroff(A_BOLD);
-                }
-                else
-                {
-                    attron(COLOR_PAIR(LINE_NUMBER_GREY));
+    m_framesDrawn++;
 
-                    addch(lineNumber[i + numberDigits - m_reservedColumnsForLineNumbering + 1]);
+    int cursorY, cursorX;
+    getyx(stdscr, cursorY, cursorX);
 
-                    // FIXME: Stupid fix; probably makes the rendering go slower
-                    //        it fixes the mouse flickering
-                    curs_set(0);
-                    refresh();
+    resizeFrame();
+    printBufferInformationLine(buffer()->getCursorPos());
 
-                    attroff(COLOR_PAIR(LINE_NUMBER_GREY));
-                }
-            }
-            else
-            {
-                addch(' ');
-            }
-        }
-    }
+    flushFrame(cursorY, cursorX);
+}
 
-    refresh();
+void View::printMessageLine()
+{
+    if (m_message.empty()) { return; }
 
-    return newLinesCreatedByCurrentLine;
+    m_frame.fill(LINES - 1, 0, COLS, ' ', BACKGROUND);
+    m_frame.print(LINES - 1, 0, std::string_view(m_message).substr(0, std::max(0, COLS - 1)), BACKGROUND);
 }
 
-int View::getColorPair(MODE currentMode, int row, int column, const std::pair<int, int>& cursorPos, int relativeCursorY) const
+void View::displayCommandBuffer(const int colorPair)
 {
-    if (m_displayHighlight)
+    if (m_renderSuppression.load() > 0)
     {
-        const std::pair<int, int>& initialYankPos = m_buffer->lastYankInitialCursor();
-        const std::pair<int, int>& finalYankPos = m_buffer->lastYankFinalCursor();
-
-        switch (m_previousYankType)
-        {
-            case VISUAL_YANK:
-            {
-                int lowerBoundY = std::min(initialYankPos.first, finalYankPos.first);
-                int upperBoundY = std::max(initialYankPos.first, finalYankPos.first);
-
-                int lowerBoundX = std::min(initialYankPos.second, finalYankPos.second);
-                int upperBoundX = std::max(initialYankPos.second, finalYankPos.second);
-
-                bool isWithinXBounds = (column >= lowerBoundX && column <= upperBoundX);
-
-                if (row + m_linesDown == lowerBoundY)
-                {
-                    if (lowerBoundY == upperBoundY)
-                    {
-                        if (isWithinXBounds) { return YANK_HIGHLIGHT_PAIR; }
-                    }
-                    else if ((lowerBoundY < initialYankPos.first && column >= finalYankPos.second) ||
-                             (lowerBoundY > initialYankPos.first && column >= initialYankPos.second) ||
-                             (lowerBoundY == initialYankPos.first && column >= initialYankPos.second))
-                    {
-                        return YANK_HIGHLIGHT_PAIR;
-                    }
-                }
-                else if (row + m_linesDown == upperBoundY)
-                {
-                    if ((upperBoundY > initialYankPos.first && column <= finalYankPos.second) ||
-                        (upperBoundY <= initialYankPos.first && column <= initialYankPos.second))
-                    {
-                        return YANK_HIGHLIGHT_PAIR;
-                    }
-                }
-                else if (row + m_linesDown > lowerBoundY && row + m_linesDown < upperBoundY)
-                {
-                    return YANK_HIGHLIGHT_PAIR;
-                }
-
-                break;
-            }
-            case LINE_YANK:
-            {
-                int lowerBound = std::min(initialYankPos.first, finalYankPos.first);
-                int upperBound = std::max(initialYankPos.first, finalYankPos.first);
-
-                if (row + m_linesDown >= lowerBound && row + m_linesDown <= upperBound)
-                {
-                    return YANK_HIGHLIGHT_PAIR;
-                }
-                break;
-            }
-            case BLOCK_YANK:
-            {
-                int lowerBoundY = std::min(initialYankPos.first, finalYankPos.first);
-                int upperBoundY = std::max(initialYankPos.first, finalYankPos.first);
-
-                int lowerBoundX = std::min(initialYankPos.second, finalYankPos.second);
-                int upperBoundX = std::max(initialYankPos.second, finalYankPos.second);
-
-                if (column >= lowerBoundX && column <= upperBoundX && row + m_linesDown >= lowerBoundY && row + m_linesDown <= upperBoundY)
-                {
-                    return YANK_HIGHLIGHT_PAIR;
-                }
-                break;
-            }
-            default:
-                return BACKGROUND;
-        }
+        m_pendingCommandBufferColorPair = colorPair;
+        return;
     }
-    else
-    {
-        const std::pair<int, int>& visualModeInitialCursor = m_editor->inputController().initialVisualModeCursor();
-
-        switch (currentMode)
-        {
-            case VISUAL_MODE:
-            {
-                int relativePreviousVisualY = visualModeInitialCursor.first - m_linesDown;
-                int lowerBoundY = std::min(relativeCursorY, relativePreviousVisualY);
-                int upperBoundY = std::max(relativeCursorY, relativePreviousVisualY);
-
-                int lowerBoundX = std::min(cursorPos.second, visualModeInitialCursor.second);
-                int upperBoundX = std::max(cursorPos.second, visualModeInitialCursor.second);
-
-                bool isWithinXBounds = (column >= lowerBoundX && column <= upperBoundX);
-
-                if (row == lowerBoundY)
-                {
-                    if (lowerBoundY == upperBoundY)
-                    {
-                        if (isWithinXBounds) { return VISUAL_HIGHLIGHT_PAIR; }
-                    }
-                    else if ((lowerBoundY < relativeCursorY && column >= visualModeInitialCursor.second) ||
-                             (lowerBoundY > relativeCursorY && column >= cursorPos.second) ||
-                             (lowerBoundY == relativeCursorY && column >= cursorPos.second))
-                    {
-                        return VISUAL_HIGHLIGHT_PAIR;
-                    }
-                }
-                else if (row == upperBoundY)
-                {
-                    if ((upperBoundY > relativeCursorY && column <= visualModeInitialCursor.second) ||
-                        (upperBoundY <= relativeCursorY && column <= cursorPos.second))
-                    {
-                        return VISUAL_HIGHLIGHT_PAIR;
-                    }
-                }
-                else if (row > lowerBoundY && row < upperBoundY)
-                {
-                    return VISUAL_HIGHLIGHT_PAIR;
-                }
 
-                break;
-            }
-            case VISUAL_LINE_MODE:
-            {
-                int relativePreviousVisualY = visualModeInitialCursor.first - m_linesDown;
+    std::lock_guard<std::mutex> lock(displayMutex);
 
-                int lowerBound = std::min(relativeCursorY, relativePreviousVisualY);
-                int upperBound = std::max(relativeCursorY, relativePreviousVisualY);
+    m_framesDrawn++;
 
-                if (row >= lowerBound && row <= upperBound)
-                {
-                    return VISUAL_HIGHLIGHT_PAIR;
-                }
-                break;
-            }
-            case VISUAL_BLOCK_MODE:
-            {
-                int relativePreviousVisualY = visualModeInitialCursor.first - m_linesDown;
-                int lowerBoundY = std::min(relativeCursorY, relativePreviousVisualY);
-                int upperBoundY = std::max(relativeCursorY, relativePreviousVisualY);
+    resizeFrame();
 
-                int lowerBoundX = std::min(cursorPos.second, visualModeInitialCursor.second);
-                int upperBoundX = std::max(cursorPos.second, visualModeInitialCursor.second);
+    const std::string& commandBuffer = m_editor->inputController().commandBuffer();
+    short pair = static_cast<short>(PAIR_NUMBER(colorPair));
 
-                if (column >= lowerBoundX && column <= upperBoundX && row >= lowerBoundY && row <= upperBoundY)
-                {
-                    return VISUAL_HIGHLIGHT_PAIR;
-                }
-                break;
-            }
-            default:
-                if (row == relativeCursorY)
-                {
-                    return PATH_COLOR_PAIR;
-                }
-                else
-                {
-                    return BACKGROUND;
-                }
-                break;
-        }
-    }
+    m_frame.fill(LINES - 1, 0, COLS, ' ', BACKGROUND);
+    m_frame.set(LINES - 1, 0, m_editor->inputController().commandLinePrompt(), pair);
 
+    int x = m_frame.print(LINES - 1, 1, commandBuffer, pair);
 
-    return BACKGROUND;
+    flushFrame(LINES - 1, std::min(x, COLS - 1));
 }
 
-void View::moveCursor(const std::pair<int, int>& cursorPos, int cursorIndexOfFirstNonSpace, int extraLinesFromWrappingBeforeCursor)
+void View::displayCircularInputBuffer()
 {
-    if (cursorPos.second + m_reservedColumnsForLineNumbering >= COLS)
-    {
-        int relativeXAfterWrap = cursorPos.second + m_reservedColumnsForLineNumbering - COLS;
-        int lineSizeWithoutIndent = COLS - cursorIndexOfFirstNonSpace - m_reservedColumnsForLineNumbering;
-
-        if (lineSizeWithoutIndent == 0) { return; }
+    if (deferFrame()) { return; }
 
-        int cursorY = cursorPos.first - m_linesDown + extraLinesFromWrappingBeforeCursor + relativeXAfterWrap / lineSizeWithoutIndent + 1;
-        int cursorX = relativeXAfterWrap % lineSizeWithoutIndent + cursorIndexOfFirstNonSpace + m_reservedColumnsForLineNumbering;
+    std::lock_guard<std::mutex> lock(displayMutex);
 
-        move(cursorY, cursorX);
+    m_framesDrawn++;
 
-        m_previousCursorY = cursorY;
-        m_previousCursorX = cursorX;
-    }
-    else
-    {
-        int cursorY = cursorPos.first - m_linesDown + extraLinesFromWrappingBeforeCursor + (cursorPos.second + m_reservedColumnsForLineNumbering) / COLS;
-        int cursorX = (cursorPos.second + m_reservedColumnsForLineNumbering) % COLS;
-        move(cursorY, cursorX);
+    resizeFrame();
+    printCircularInputBuffer();
 
-        m_previousCursorY = cursorY;
-        m_previousCursorX = cursorX;
-    }
+    flushFrame(m_previousCursorY, m_previousCursorX);
 }
 
-void View::printCharacter(int y, int x, char character)
+void View::printCircularInputBuffer()
 {
-    move(y, x);
-
-    if (mvinch(y, x) != static_cast<size_t>(character))
+    for (size_t i = 0; i < INPUT_CONTROLLER_MAX_CIRCULAR_BUFFER_SIZE; i++)
     {
-        addch(character);
-    }
-}
+        int input = m_editor->inputController().circularBuffer()[i];
+        char character = ' ';
+        if (input != -1) { character = static_cast<char>(input); }
 
-void View::clearRemainingLines(int maxRender, int extraLinesFromWrapping)
-{
-    for (int i = maxRender + extraLinesFromWrapping; i < LINES; i++)
-    {
-        move(i , 0);
-        clrtoeol();
+        m_frame.set(LINES - 1, COLS - static_cast<int>(i) - 1, character, BACKGROUND);
     }
 }
 
 void View::displayBackend()
 {
-    if (m_buffer->getFileGapBuffer().bufferSize())
+    const FileGapBuffer* fileGapBufferPointer = dynamic_cast<const FileGapBuffer*>(&buffer()->getFile());
+
+    if (fileGapBufferPointer && fileGapBufferPointer->bufferSize())
     {
         move(0, 0);
 
-        const std::pair<int, int>& cursorPos = m_buffer->getCursorPos();
+        const std::pair<int, int>& cursorPos = buffer()->getCursorPos();
 
-        const FileGapBuffer& fileGapBuffer = m_buffer->getFileGapBuffer();
+        const FileGapBuffer& fileGapBuffer = *fileGapBufferPointer;
         const std::vector<std::shared_ptr<LineGapBuffer>>& fileGapBufferVector = fileGapBuffer.getVectorOfSharedPtrsToLineGapBuffers();
 
         for (size_t row = 0; row < fileGapBuffer.bufferSize(); row++)
@@ -685,7 +555,11 @@ void View::displayBackend()
 
                 for (size_t column = 0; column < lineGapBuffer->bufferSize(); column++)
                 {
-                    if (column < linePreIndex || column >= linePostIndex)
+                    if (lineGapBuffer->isMapped())
+                    {
+                        addch(lineGapBuffer->at(column));
+                    }
+                    else if (column < linePreIndex || column >= linePostIndex)
                     {
                         addch(lineChars[column]);
                     }
@@ -714,17 +588,21 @@ void View::displayBackend()
 
 void View::displayCurrentLineGapBuffer(int y)
 {
-    const std::pair<int, int>& cursorPos = m_buffer->getCursorPos();
+    const std::pair<int, int>& cursorPos = buffer()->getCursorPos();
     move(40, 0);
     clrtoeol();
 
-    for (size_t column = 0; column < m_buffer->getLineGapBuffer(y)->bufferSize(); column++)
+    for (size_t column = 0; column < buffer()->getLineGapBuffer(y)->bufferSize(); column++)
     {
-        const std::vector<char>& line = m_buffer->getLineGapBuffer(y)->getLine();
-        size_t preIndex = m_buffer->getLineGapBuffer(y)->preGapIndex();
-        size_t postIndex = m_buffer->getLineGapBuffer(y)->postGapIndex();
+        const std::vector<char>& line = buffer()->getLineGapBuffer(y)->getLine();
+        size_t preIndex = buffer()->getLineGapBuffer(y)->preGapIndex();
+        size_t postIndex = buffer()->getLineGapBuffer(y)->postGapIndex();
 
-        if (column < preIndex || column >= postIndex)
+        if (buffer()->getLineGapBuffer(y)->isMapped())
+        {
+            addch(buffer()->getLineGapBuffer(y)->at(column));
+        }
+        else if (column < preIndex || column >= postIndex)
         {
             addch(line[column]);
         }
@@ -741,11 +619,14 @@ void View::displayCurrentLineGapBuffer(int y)
 
 void View::displayCurrentFileGapBuffer()
 {
-    const std::pair<int, int>& cursorPos = m_buffer->getCursorPos();
+    const std::pair<int, int>& cursorPos = buffer()->getCursorPos();
 
     move(40, 0);
 
-    const std::vector<std::shared_ptr<LineGapBuffer>>& ptrsToLines = m_buffer->getFileGapBuffer().getVectorOfSharedPtrsToLineGapBuffers();
+    const FileGapBuffer* fileGapBuffer = dynamic_cast<const FileGapBuffer*>(&buffer()->getFile());
+    if (!fileGapBuffer) { return; }
+
+    const std::vector<std::shared_ptr<LineGapBuffer>>& ptrsToLines = fileGapBuffer->getVectorOfSharedPtrsToLineGapBuffers();
 
     for (size_t i = 0; i < ptrsToLines.size(); i++)
     {
@@ -1,10 +1,9 @@
 #pragma once
 
-#include "LineGapBuffer.h"
+#include "Viewport.h"
 
 class Editor;
 class Buffer;
-class FileGapBuffer;
 
 class View
 {
@@ -12,12 +11,6 @@ class View
 private:
 
     Editor* m_editor;
-    Buffer* m_buffer;
-
-    int m_reservedColumnsForLineNumbering = 0;
-
-    int m_prevLinesDown = 0;
-    int m_linesDown = 0;
 
     int m_previousCursorY = 0;
     int m_previousCursorX = 0;
@@ -27,18 +20,59 @@ private:
 
     YANK_TYPE m_previousYankType = YANK_TYPE::LINE_YANK;
 
-    void adjustLinesAfterScrolling(int relativeCursorPosY, int upperLineMoveThreshold, int lowerLineMoveThreshold);
-    void printCharacter(int y, int x, char character);
-    void clearRemainingLines(int maxRender, int extraLinesFromWrapping);
-    int numberOfDigits(int x);
-    void moveCursor(const std::pair<int, int>& cursorPos, int cursorIndexOfFirstNonSpace, int extraLinesFromWrappingBeforeCursor);
-    int wrappedLinesBeforeCursor(const FileGapBuffer& fileGapBuffer, int numLines, int relativeCursorY);
+    std::string m_message;
+    std::string m_status;
+
+    // Matches of this pattern are highlighted, found line by line as the lines are drawn
+    std::shared_ptr<const SearchPattern> m_searchHighlight;
+
+    // The text area is split between viewports, one of them active. Viewports are kept in the order they were opened.
+    SplitLayout m_splitLayout;
+    std::vector<std::unique_ptr<Viewport>> m_viewports;
+    int m_activeViewport = 0;
+
+    // Areas of the viewports and separators for the current terminal size
+    std::vector<std::pair<int, ViewportArea>> m_areas;
+    std::vector<ViewportArea> m_separators;
+
+    // Frame drawn into, and what the terminal shows, so only the cells that differ are sent
+    CellGrid m_frame;
+    CellGrid m_screen;
+    std::vector<CellRun> m_runs;
+    std::string m_runText;
+
+    // Cells and runs handed to ncurses, and the bytes they should take with the escape sequences around them
+    std::atomic<size_t> m_cellsOfLastFrame = 0;
+    std::atomic<size_t> m_runsOfLastFrame = 0;
+    std::atomic<size_t> m_estimatedBytesOfLastFrame = 0;
+    std::atomic<size_t> m_cellsSent = 0;
+    std::atomic<size_t> m_estimatedBytesSent = 0;
+
+    // Drawing asked for inside a render transaction is only noted, and done once when the outermost transaction ends
+    std::atomic<int> m_renderSuppression = 0;
+    std::atomic<bool> m_framePending = false;
+    int m_pendingCommandBufferColorPair = -1;
+    std::atomic<size_t> m_framesDrawn = 0;
+
+    Viewport& viewport(int id);
+    Viewport& activeViewport() { return viewport(m_activeViewport); }
+    const Viewport& activeViewport() const;
+    void layoutViewports();
+    void activate(int id);
+    void printSeparators();
+    void printCircularInputBuffer();
+
+    // Makes the frame the size of the terminal
+    void resizeFrame();
+
+    // Sends the cells of the frame that differ from the screen, batched into runs, and leaves the cursor at cursorY, cursorX
+    void flushFrame(int cursorY, int cursorX);
 
-    int printLine(const std::shared_ptr<LineGapBuffer>& lineGapBuffer, int row, int indexOfFirstNonSpace, int extraLinesFromWrapping, int relativeCursorY);
     void printBufferInformationLine(const std::pair<int, int>& cursorPos);
-    int getColorPair(MODE currentMode, int row, int column, const std::pair<int, int>& cursorPos, int relativeCursorY) const;
+    void printMessageLine();
 
-    void yankHighlight(int milliseconds);
+    bool deferFrame();
+    void drawPendingFrame();
 
 public:
 
@@ -49,6 +83,39 @@ public:
     void displayCommandBuffer(const int colorPair = COLOR_PAIR(BACKGROUND));
     void displayCircularInputBuffer();
 
+    // Buffer drawn in the active viewport from the next frame on, scrolled down by linesDown
+    void setBuffer(Buffer* buffer, int linesDown);
+
+    // Splits the active viewport in two, above and below or side by side, both showing its buffer. The new viewport
+    // becomes the active one. False if a half would be too small.
+    bool splitViewport(bool sideBySide);
+
+    // Closes the active viewport, making the one that takes its area active. False for the last viewport.
+    bool closeViewport();
+
+    // Closes every viewport but the active one
+    void onlyViewport();
+
+    // Makes viewport id the active one, moving the cursor of its buffer to where it was left in that viewport
+    void focusViewport(int id);
+
+    // Viewport next to the active one in a direction, or after it in screen order. -1 if there is none.
+    int neighborViewport(NEIGHBOR_DIRECTION direction);
+    int nextViewport();
+
+    // Whether any viewport shows buffer
+    bool showsBuffer(const Buffer* buffer) const;
+
+    // Message shown in the command line until the next key press
+    void setMessage(const std::string& message) { m_message = message; }
+
+    // Pattern whose matches are highlighted, or null for none
+    void setSearchHighlight(std::shared_ptr<const SearchPattern> pattern) { m_searchHighlight = std::move(pattern); }
+
+    // Shown in the buffer information line when no save is running, like how a save went or how far a long edit is
+    void setStatus(const std::string& status) { m_status = status; }
+    void displayBufferInformationLine();
+
     void displayBackend();
     void displayCurrentLineGapBuffer(int y);
     void displayCurrentFileGapBuffer();
@@ -57,6 +124,60 @@ public:
     void insertCursor();
     void replaceCursor();
 
-    void yankHighlightTimer(int milliseconds, YANK_TYPE yankType);
+    // Highlights what was just yanked until the input loop ends it with endYankHighlight
+    void startYankHighlight(int milliseconds, YANK_TYPE yankType);
+    void endYankHighlight();
+
+    void beginRenderTransaction() { m_renderSuppression++; }
+    void endRenderTransaction();
+
+    // Draws what a render transaction has held back right away, for when the screen has to be seen before waiting on a key
+    void flushRendering();
+
+    // Lifts the open render transactions for a wait on a key, drawing what they held back, so what is drawn during the
+    // wait is seen. Resuming with what suspending returned holds drawing back again.
+    int suspendRenderTransactions();
+    void resumeRenderTransactions(int renderSuppression) { m_renderSuppression.store(renderSuppression); }
+
+    // Getters
+    size_t framesDrawn() const { return m_framesDrawn.load(std::memory_order_relaxed); }
+    size_t cellsOfLastFrame() const { return m_cellsOfLastFrame.load(); }
+    size_t runsOfLastFrame() const { return m_runsOfLastFrame.load(); }
+    size_t estimatedBytesOfLastFrame() const { return m_estimatedBytesOfLastFrame.load(); }
+    size_t cellsSent() const { return m_cellsSent.load(); }
+    size_t estimatedBytesSent() const { return m_estimatedBytesSent.load(); }
+    Buffer* buffer() const { return activeViewport().buffer(); }
+    int linesDown() const { return activeViewport().linesDown(); }
+    size_t numberOfViewports() const { return m_viewports.size(); }
+    bool displayHighlight() const { return m_displayHighlight.load(); }
+    YANK_TYPE previousYankType() const { return m_previousYankType; }
+    const std::shared_ptr<const SearchPattern>& searchHighlight() const { return m_searchHighlight; }
+
+};
+
+// Holds back drawing for as long as it lives, so the screen is drawn once however many commands run inside it
+class RenderTransaction
+{
+
+private:
+
+    View& m_view;
+    bool m_active;
+
+public:
+
+    RenderTransaction(View& view, bool active = true)
+        : m_view(view), m_active(active)
+    {
+        if (m_active) { m_view.beginRenderTransaction(); }
+    }
+
+    ~RenderTransaction()
+    {
+        if (m_active) { m_view.endRenderTransaction(); }
+    }
+
+    RenderTransaction(const RenderTransaction&) = delete;
+    RenderTransaction& operator=(const RenderTransaction&) = delete;
 
 };
@@ -0,0 +1,614 @@
+#include "Viewport.h"
+#include "Buffer.h"
+#include "Includes.h"
+#include "Editor.h"
+#include "View.h"
+
+// Pair of each token type, over the plain background and over the cursor line
+static const int syntaxColorPairs[][2] = {
+    { BACKGROUND, PATH_COLOR_PAIR },
+    { SYNTAX_KEYWORD_PAIR, SYNTAX_KEYWORD_CURSOR_LINE_PAIR },
+    { SYNTAX_TYPE_NAME_PAIR, SYNTAX_TYPE_NAME_CURSOR_LINE_PAIR },
+    { SYNTAX_STRING_PAIR, SYNTAX_STRING_CURSOR_LINE_PAIR },
+    { SYNTAX_NUMBER_PAIR, SYNTAX_NUMBER_CURSOR_LINE_PAIR },
+    { SYNTAX_COMMENT_PAIR, SYNTAX_COMMENT_CURSOR_LINE_PAIR },
+    { SYNTAX_PREPROCESSOR_PAIR, SYNTAX_PREPROCESSOR_CURSOR_LINE_PAIR } };
+
+// Moves a line number past lines inserted or removed before it. A line that was removed moves to where the removal was.
+static void followLine(int& line, const LineEdit& lineEdit)
+{
+    int index = static_cast<int>(lineEdit.index);
+    int count = static_cast<int>(lineEdit.count);
+
+    switch (lineEdit.type)
+    {
+        case LINES_INSERTED:
+            if (line >= index) { line += count; }
+            break;
+        case LINES_REMOVED:
+            if (line >= index + count) { line -= count; }
+            else if (line > index) { line = index; }
+            break;
+        default:
+            break;
+    }
+}
+
+Viewport::Viewport(Editor* editor, View* view, int id)
+    : m_editor(editor), m_view(view), m_id(id)
+{
+}
+
+void Viewport::setBuffer(Buffer* buffer, int linesDown)
+{
+    m_buffer = buffer;
+    m_linesDown = linesDown;
+    m_prevLinesDown = linesDown;
+
+    m_wrapLayout.reset(m_buffer->getFile().numberOfLines(), m_area.cols, m_reservedColumnsForLineNumbering);
+}
+
+void Viewport::adjustLinesAfterScrolling(int relativeCursorPosY, int upperLineMoveThreshold, int lowerLineMoveThreshold)
+{
+    m_prevLinesDown = m_linesDown;
+
+    if (relativeCursorPosY <= upperLineMoveThreshold)
+    {
+        m_linesDown = std::max(0, m_linesDown + relativeCursorPosY - upperLineMoveThreshold);
+    }
+    else if (relativeCursorPosY >= lowerLineMoveThreshold)
+    {
+        m_linesDown += relativeCursorPosY - lowerLineMoveThreshold;
+    }
+}
+
+int Viewport::numberOfDigits(int x)
+{
+    int count = 0;
+
+    do
+    {
+        x /= 10;
+        count++;
+    }
+    while (x >= 1);
+
+    return count;
+}
+
+void Viewport::followLineEdit(const LineEdit& lineEdit)
+{
+    followLine(m_cursor.first, lineEdit);
+    followLine(m_linesDown, lineEdit);
+
+    m_prevLinesDown = m_linesDown;
+}
+
+void Viewport::updateWrapLayout(int numLines, bool active)
+{
+    if (m_buffer->lineEditsOverflowed() || m_area.cols != m_wrapLayout.terminalColumns() || m_reservedColumnsForLineNumbering != m_wrapLayout.reservedColumns())
+    {
+        m_wrapLayout.reset(numLines, m_area.cols, m_reservedColumnsForLineNumbering);
+        return;
+    }
+
+    for (const LineEdit& lineEdit : m_buffer->lineEdits())
+    {
+        switch (lineEdit.type)
+        {
+            case LINE_CHANGED:
+                for (size_t i = 0; i < lineEdit.count; i++) { m_wrapLayout.invalidate(lineEdit.index + i); }
+                break;
+            case LINES_INSERTED:
+                m_wrapLayout.insertLines(lineEdit.index, lineEdit.count);
+                break;
+            case LINES_REMOVED:
+                m_wrapLayout.removeLines(lineEdit.index, lineEdit.count);
+                break;
+        }
+
+        // The active viewport scrolls after the buffer cursor, the others keep showing the text they showed
+        if (!active) { followLineEdit(lineEdit); }
+    }
+
+    if (m_wrapLayout.numberOfLines() != static_cast<size_t>(numLines))
+    {
+        m_wrapLayout.reset(numLines, m_area.cols, m_reservedColumnsForLineNumbering);
+    }
+}
+
+const WrapLayout::LineLayout& Viewport::lineLayout(size_t index)
+{
+    if (!m_wrapLayout.holds(index)) { m_wrapLayout.keepWindow(index, 1); }
+
+    if (!m_wrapLayout.line(index).measured)
+    {
+        const std::shared_ptr<LineGapBuffer>& line = m_buffer->getLineGapBuffer(index);
+
+        m_wrapLayout.measure(index, m_buffer->indexOfFirstNonSpaceCharacter(line), line->lineSize());
+    }
+
+    return m_wrapLayout.line(index);
+}
+
+int Viewport::wrappedLinesBeforeCursor(int numLines, int relativeCursorY)
+{
+    int maxRender = std::min(m_area.rows, numLines - m_linesDown);
+    int rowsBeforeCursor = std::min(relativeCursorY, maxRender);
+
+    if (rowsBeforeCursor <= 0) { return 0; }
+
+    for (int row = 0; row < rowsBeforeCursor; row++) { lineLayout(row + m_linesDown); }
+
+    // Row r is only reached while the rows before it leave room for it, r < maxRender - (extra rows of rows 0 to r - 2).
+    // The left side only grows with r, so the last row reached is found by binary search.
+    int reachedRows = 1;
+    int unreachedRow = rowsBeforeCursor;
+
+    while (reachedRows < unreachedRow)
+    {
+        int row = (reachedRows + unreachedRow) / 2;
+
+        if (row + m_wrapLayout.extraRowsBetween(m_linesDown, m_linesDown + row - 1) < maxRender) { reachedRows = row + 1; }
+        else { unreachedRow = row; }
+    }
+
+    return static_cast<int>(m_wrapLayout.extraRowsBetween(m_linesDown, m_linesDown + reachedRows));
+}
+
+void Viewport::draw(CellGrid& frame, bool active, int& cursorY, int& cursorX)
+{
+    m_frame = &frame;
+
+    cursorY = m_area.top;
+    cursorX = m_area.left;
+
+    const FileBackend& file = m_buffer->getFile();
+    if (!file.numberOfLines() || m_area.rows <= 0 || m_area.cols <= 0)
+        return;
+
+    int numLines = static_cast<int>(file.numberOfLines());
+    int previousReservedColumns = m_reservedColumnsForLineNumbering;
+    m_reservedColumnsForLineNumbering = numberOfDigits(numLines) + 1;
+
+    updateWrapLayout(numLines, active);
+
+    m_cursor.first = std::clamp(m_cursor.first, 0, numLines - 1);
+    m_linesDown = std::clamp(m_linesDown, 0, numLines - 1);
+
+    const std::pair<int, int> cursorPos = (active) ? m_buffer->getCursorPos() : m_cursor;
+    const int relativeCursorPosY = cursorPos.first - m_linesDown;
+
+    const int upperLineMoveThreshold = m_area.rows / 4;
+    const int lowerLineMoveThreshold = upperLineMoveThreshold * 3;
+
+    m_wrapLayout.keepWindow(m_linesDown, m_area.rows);
+
+    int preCursorWrappedLines = wrappedLinesBeforeCursor(numLines, relativeCursorPosY);
+    adjustLinesAfterScrolling(relativeCursorPosY, upperLineMoveThreshold - preCursorWrappedLines, lowerLineMoveThreshold - preCursorWrappedLines);
+
+    m_wrapLayout.keepWindow(m_linesDown, m_area.rows);
+
+    // Before the damage is looked at, as lines whose colors changed with an edit elsewhere are damaged here
+    m_buffer->updateSyntaxHighlighting(m_linesDown + m_area.rows);
+
+    int extraLinesFromWrapping = 0;
+    int extraLinesFromWrappingBeforeCursor = 0;
+    int maxRender = std::clamp(numLines - m_linesDown, 0, m_area.rows);
+
+    int maxRenderCopy = maxRender;
+    int cursorIndexOfFirstNonSpace = 0;
+    // Switching to another buffer or moving the viewport changes every row the same way scrolling does
+    bool scrolledBuffer = (m_prevLinesDown != m_linesDown) || m_buffer != m_previousBuffer || m_area != m_previousArea;
+
+    // Anything that changes more than the text of individual lines repaints every row. Otherwise only the lines the
+    // buffer reports as damaged, the rows the cursor line highlight moves between and rows pushed around by wrapping are.
+    // Viewports other than the active one are drawn as in normal mode.
+    MODE currentMode = (active) ? m_editor->mode() : NORMAL_MODE;
+    bool inVisualMode = (currentMode == VISUAL_MODE || currentMode == VISUAL_LINE_MODE || currentMode == VISUAL_BLOCK_MODE);
+    m_highlighted = active && m_view->displayHighlight();
+
+    bool fullRedraw = scrolledBuffer || inVisualMode || m_previousFrameVisual || m_highlighted || m_previousFrameHighlighted ||
+        m_view->searchHighlight() != m_previousSearchHighlight || m_reservedColumnsForLineNumbering != previousReservedColumns;
+
+    bool cursorLineMoved = (cursorPos.first != m_previousCursorLine);
+
+    std::vector<std::pair<int, int>> rowLayout(maxRender, std::pair<int, int>(-1, 0));
+
+    for (int row = 0; row < maxRender; row++)
+    {
+        const std::shared_ptr<LineGapBuffer>& lineGapBuffer = m_buffer->getLineGapBuffer(row + m_linesDown);
+        if (!lineGapBuffer)
+            break;
+
+        int indexOfFirstNonSpace = lineLayout(row + m_linesDown).indexOfFirstNonSpace;
+
+        if (indexOfFirstNonSpace >= m_area.cols - 1)
+            continue;
+
+        int relativeY = cursorPos.first - m_linesDown;
+        int fileRow = row + m_linesDown;
+
+        bool rowDamaged = fullRedraw || m_buffer->isLineDamaged(fileRow) || fileRow == cursorPos.first || fileRow == m_previousCursorLine ||
+            row >= static_cast<int>(m_previousRowLayout.size()) || m_previousRowLayout[row].first != row + extraLinesFromWrapping;
+
+        int newLinesCreatedByCurrentLine = 0;
+
+        if (rowDamaged)
+        {
+            if (scrolledBuffer)
+                fillRow(row + extraLinesFromWrapping, 0);
+
+            newLinesCreatedByCurrentLine = printLine(lineGapBuffer, row, indexOfFirstNonSpace, extraLinesFromWrapping, relativeY, currentMode, cursorPos);
+        }
+        else
+        {
+            // Same text at the same place, so only the relative line number can be stale
+            newLinesCreatedByCurrentLine = m_previousRowLayout[row].second;
+
+            if (cursorLineMoved) { printLineNumber(row, extraLinesFromWrapping, relativeY); }
+        }
+
+        rowLayout[row] = std::pair<int, int>(row + extraLinesFromWrapping, newLinesCreatedByCurrentLine);
+
+        extraLinesFromWrapping += newLinesCreatedByCurrentLine;
+
+        if (row < relativeY) { extraLinesFromWrappingBeforeCursor += newLinesCreatedByCurrentLine; }
+        if (row == relativeY) { cursorIndexOfFirstNonSpace = indexOfFirstNonSpace; }
+
+        if (numLines - m_linesDown >= m_area.rows)
+        {
+            maxRender = maxRenderCopy - extraLinesFromWrapping;
+        }
+    }
+
+    clearRemainingLines(maxRender, extraLinesFromWrapping);
+
+    m_previousRowLayout = std::move(rowLayout);
+    m_previousCursorLine = cursorPos.first;
+    m_previousArea = m_area;
+    m_previousFrameVisual = inVisualMode;
+    m_previousFrameHighlighted = m_highlighted;
+    m_previousSearchHighlight = m_view->searchHighlight();
+    m_previousBuffer = m_buffer;
+
+    screenCursor(cursorPos, cursorIndexOfFirstNonSpace, extraLinesFromWrappingBeforeCursor, cursorY, cursorX);
+}
+
+int Viewport::printLine(const std::shared_ptr<LineGapBuffer>& lineGapBuffer, int row, int indexOfFirstNonSpace, int extraLinesFromWrapping,
+    int relativeCursorY, MODE currentMode, const std::pair<int, int>& cursorPos)
+{
+    bool inVisualMode = (currentMode == VISUAL_MODE || currentMode == VISUAL_LINE_MODE || currentMode == VISUAL_BLOCK_MODE);
+
+    int lineSize = static_cast<int>(lineGapBuffer->lineSize());
+    int newLinesCreatedByCurrentLine = 0;
+
+    int column = 0;
+
+    const std::shared_ptr<const SearchPattern>& searchHighlight = m_view->searchHighlight();
+
+    m_lineMatches.clear();
+    if (searchHighlight) { searchHighlight->findAll(*lineGapBuffer, m_lineMatches, m_lineScratch); }
+
+    std::vector<std::pair<int, int>>::const_iterator lineMatch = m_lineMatches.cbegin();
+
+    const SyntaxHighlighter& syntaxHighlighter = m_buffer->syntaxHighlighter();
+
+    m_lineSpans.clear();
+    if (syntaxHighlighter.ready()) { syntaxHighlighter.lineSpans(*lineGapBuffer, row + m_linesDown, m_lineSpans, m_lineScratch); }
+
+    std::vector<ColorSpan>::const_iterator lineSpan = m_lineSpans.cbegin();
+
+    for (std::string_view span : { lineGapBuffer->preGapSpan(), lineGapBuffer->postGapSpan() })
+    {
+        for (char character : span)
+        {
+            // Line colorings in visual modes
+            int colorPair = getColorPair(currentMode, row, column, cursorPos, relativeCursorY);
+
+            // Search matches and syntax colors show through the plain colors, but not through visual or yank highlighting
+            while (lineMatch != m_lineMatches.cend() && lineMatch->first + lineMatch->second <= column) { ++lineMatch; }
+            while (lineSpan != m_lineSpans.cend() && lineSpan->start + lineSpan->length <= column) { ++lineSpan; }
+
+            if (colorPair == BACKGROUND || colorPair == PATH_COLOR_PAIR)
+            {
+                if (lineMatch != m_lineMatches.cend() && lineMatch->first <= column)
+                {
+                    colorPair = SEARCH_HIGHLIGHT_PAIR;
+                }
+                else if (lineSpan != m_lineSpans.cend() && lineSpan->start <= column)
+                {
+                    colorPair = syntaxColorPairs[lineSpan->token][colorPair == PATH_COLOR_PAIR];
+                }
+            }
+
+            if (column + m_reservedColumnsForLineNumbering >= m_area.cols)
+            {
+                if (m_area.cols - indexOfFirstNonSpace - m_reservedColumnsForLineNumbering == 0) { return newLinesCreatedByCurrentLine; }
+
+                newLinesCreatedByCurrentLine = (column  + m_reservedColumnsForLineNumbering - m_area.cols) / (m_area.cols - indexOfFirstNonSpace - m_reservedColumnsForLineNumbering) + 1;
+
+                int newCursorY = row + extraLinesFromWrapping + newLinesCreatedByCurrentLine;
+                int newCursorXWithoutOffset = (column + m_reservedColumnsForLineNumbering - m_area.cols) % (m_area.cols - indexOfFirstNonSpace - m_reservedColumnsForLineNumbering);
+
+                if (newCursorXWithoutOffset == 0) { fillRow(newCursorY, 0); }
+
+                printCharacter(newCursorY, newCursorXWithoutOffset + m_reservedColumnsForLineNumbering + indexOfFirstNonSpace, character, colorPair);
+            }
+            else
+            {
+                printCharacter(row + extraLinesFromWrapping, column + m_reservedColumnsForLineNumbering, character, colorPair);
+            }
+
+            column++;
+        }
+    }
+
+    if (!newLinesCreatedByCurrentLine) { fillRow(row + extraLinesFromWrapping, lineSize + m_reservedColumnsForLineNumbering); }
+
+    if (lineSize == 0)
+    {
+        if (inVisualMode)
+        {
+            const std::pair<int, int>& previousVisualPos = m_editor->inputController().initialVisualModeCursor();
+
+            if (row + m_linesDown >= std::min(previousVisualPos.first, cursorPos.first) && row + m_linesDown <= std::max(previousVisualPos.first, cursorPos.first))
+            {
+                printCharacter(row + extraLinesFromWrapping, m_reservedColumnsForLineNumbering, ' ', VISUAL_HIGHLIGHT_PAIR);
+            }
+        }
+    }
+
+    // Color the rest of the line the cursor is at
+
+    if (row == relativeCursorY && !inVisualMode)
+    {
+        int newCursorY = row + extraLinesFromWrapping + newLinesCreatedByCurrentLine;
+        int newCursorX = 0;
+
+        if (newLinesCreatedByCurrentLine)
+        {
+            newCursorX = (lineSize + m_reservedColumnsForLineNumbering - m_area.cols) % (m_area.cols - indexOfFirstNonSpace - m_reservedColumnsForLineNumbering) + m_reservedColumnsForLineNumbering + indexOfFirstNonSpace;
+        }
+        else { newCursorX = lineSize + m_reservedColumnsForLineNumbering; }
+
+        fillRow(newCursorY, newCursorX, PATH_COLOR_PAIR);
+    }
+
+    printLineNumber(row, extraLinesFromWrapping, relativeCursorY);
+
+    return newLinesCreatedByCurrentLine;
+}
+
+void Viewport::printLineNumber(int row, int extraLinesFromWrapping, int relativeCursorY)
+{
+    // The cursor line shows its own number, the other lines how far they are from it
+    bool cursorLine = (relativeCursorY == row);
+    int number = (cursorLine) ? row + m_linesDown + 1 : abs(row - relativeCursorY);
+
+    std::string lineNumber = std::to_string(number);
+    int numberDigits = numberOfDigits(number);
+
+    for (int i = 0; i < m_reservedColumnsForLineNumbering; i++)
+    {
+        if (i != m_reservedColumnsForLineNumbering - 1 && i >= m_reservedColumnsForLineNumbering - numberDigits - 1)
+        {
+            char digit = lineNumber[i + numberDigits - m_reservedColumnsForLineNumbering + 1];
+
+            if (cursorLine) { printCharacter(row + extraLinesFromWrapping, i, digit, LINE_NUMBER_ORANGE, true); }
+            else { printCharacter(row + extraLinesFromWrapping, i, digit, LINE_NUMBER_GREY); }
+        }
+        else
+        {
+            printCharacter(row + extraLinesFromWrapping, i, ' ', BACKGROUND);
+        }
+    }
+}
+
+int Viewport::getColorPair(MODE currentMode, int row, int column, const std::pair<int, int>& cursorPos, int relativeCursorY) const
+{
+    if (m_highlighted)
+    {
+        const std::pair<int, int>& initialYankPos = m_buffer->lastYankInitialCursor();
+        const std::pair<int, int>& finalYankPos = m_buffer->lastYankFinalCursor();
+
+        switch (m_view->previousYankType())
+        {
+            case VISUAL_YANK:
+            {
+                int lowerBoundY = std::min(initialYankPos.first, finalYankPos.first);
+                int upperBoundY = std::max(initialYankPos.first, finalYankPos.first);
+
+                int lowerBoundX = std::min(initialYankPos.second, finalYankPos.second);
+                int upperBoundX = std::max(initialYankPos.second, finalYankPos.second);
+
+                bool isWithinXBounds = (column >= lowerBoundX && column <= upperBoundX);
+
+                if (row + m_linesDown == lowerBoundY)
+                {
+                    if (lowerBoundY == upperBoundY)
+                    {
+                        if (isWithinXBounds) { return YANK_HIGHLIGHT_PAIR; }
+                    }
+                    else if ((lowerBoundY < initialYankPos.first && column >= finalYankPos.second) ||
+                             (lowerBoundY > initialYankPos.first && column >= initialYankPos.second) ||
+                             (lowerBoundY == initialYankPos.first && column >= initialYankPos.second))
+                    {
+                        return YANK_HIGHLIGHT_PAIR;
+                    }
+                }
+                else if (row + m_linesDown == upperBoundY)
+                {
+                    if ((upperBoundY > initialYankPos.first && column <= finalYankPos.second) ||
+                        (upperBoundY <= initialYankPos.first && column <= initialYankPos.second))
+                    {
+                        return YANK_HIGHLIGHT_PAIR;
+                    }
+                }
+                else if (row + m_linesDown > lowerBoundY && row + m_linesDown < upperBoundY)
+                {
+                    return YANK_HIGHLIGHT_PAIR;
+                }
+
+                break;
+            }
+            case LINE_YANK:
+            {
+                int lowerBound = std::min(initialYankPos.first, finalYankPos.first);
+                int upperBound = std::max(initialYankPos.first, finalYankPos.first);
+
+                if (row + m_linesDown >= lowerBound && row + m_linesDown <= upperBound)
+                {
+                    return YANK_HIGHLIGHT_PAIR;
+                }
+                break;
+            }
+            case BLOCK_YANK:
+            {
+                int lowerBoundY = std::min(initialYankPos.first, finalYankPos.first);
+                int upperBoundY = std::max(initialYankPos.first, finalYankPos.first);
+
+                int lowerBoundX = std::min(initialYankPos.second, finalYankPos.second);
+                int upperBoundX = std::max(initialYankPos.second, finalYankPos.second);
+
+                if (column >= lowerBoundX && column <= upperBoundX && row + m_linesDown >= lowerBoundY && row + m_linesDown <= upperBoundY)
+                {
+                    return YANK_HIGHLIGHT_PAIR;
+                }
+                break;
+            }
+            default:
+                return BACKGROUND;
+        }
+    }
+    else
+    {
+        const std::pair<int, int>& visualModeInitialCursor = m_editor->inputController().initialVisualModeCursor();
+
+        switch (currentMode)
+        {
+            case VISUAL_MODE:
+            {
+                int relativePreviousVisualY = visualModeInitialCursor.first - m_linesDown;
+                int lowerBoundY = std::min(relativeCursorY, relativePreviousVisualY);
+                int upperBoundY = std::max(relativeCursorY, relativePreviousVisualY);
+
+                int lowerBoundX = std::min(cursorPos.second, visualModeInitialCursor.second);
+                int upperBoundX = std::max(cursorPos.second, visualModeInitialCursor.second);
+
+                bool isWithinXBounds = (column >= lowerBoundX && column <= upperBoundX);
+
+                if (row == lowerBoundY)
+                {
+                    if (lowerBoundY == upperBoundY)
+                    {
+                        if (isWithinXBounds) { return VISUAL_HIGHLIGHT_PAIR; }
+                    }
+                    else if ((lowerBoundY < relativeCursorY && column >= visualModeInitialCursor.second) ||
+                             (lowerBoundY > relativeCursorY && column >= cursorPos.second) ||
+                             (lowerBoundY == relativeCursorY && column >= cursorPos.second))
+                    {
+                        return VISUAL_HIGHLIGHT_PAIR;
+                    }
+                }
+                else if (row == upperBoundY)
+                {
+                    if ((upperBoundY > relativeCursorY && column <= visualModeInitialCursor.second) ||
+                        (upperBoundY <= relativeCursorY && column <= cursorPos.second))
+                    {
+                        return VISUAL_HIGHLIGHT_PAIR;
+                    }
+                }
+                else if (row > lowerBoundY && row < upperBoundY)
+                {
+                    return VISUAL_HIGHLIGHT_PAIR;
+                }
+
+                break;
+            }
+            case VISUAL_LINE_MODE:
+            {
+                int relativePreviousVisualY = visualModeInitialCursor.first - m_linesDown;
+
+                int lowerBound = std::min(relativeCursorY, relativePreviousVisualY);
+                int upperBound = std::max(relativeCursorY, relativePreviousVisualY);
+
+                if (row >= lowerBound && row <= upperBound)
+                {
+                    return VISUAL_HIGHLIGHT_PAIR;
+                }
+                break;
+            }
+            case VISUAL_BLOCK_MODE:
+            {
+                int relativePreviousVisualY = visualModeInitialCursor.first - m_linesDown;
+                int lowerBoundY = std::min(relativeCursorY, relativePreviousVisualY);
+                int upperBoundY = std::max(relativeCursorY, relativePreviousVisualY);
+
+                int lowerBoundX = std::min(cursorPos.second, visualModeInitialCursor.second);
+                int upperBoundX = std::max(cursorPos.second, visualModeInitialCursor.second);
+
+                if (column >= lowerBoundX && column <= upperBoundX && row >= lowerBoundY && row <= upperBoundY)
+                {
+                    return VISUAL_HIGHLIGHT_PAIR;
+                }
+                break;
+            }
+            default:
+                if (row == relativeCursorY)
+                {
+                    return PATH_COLOR_PAIR;
+                }
+                else
+                {
+                    return BACKGROUND;
+                }
+                break;
+        }
+    }
+
+
+    return BACKGROUND;
+}
+
+void Viewport::screenCursor(const std::pair<int, int>& cursorPos, int cursorIndexOfFirstNonSpace, int extraLinesFromWrappingBeforeCursor, int& cursorY, int& cursorX) const
+{
+    if (cursorPos.second + m_reservedColumnsForLineNumbering >= m_area.cols)
+    {
+        int relativeXAfterWrap = cursorPos.second + m_reservedColumnsForLineNumbering - m_area.cols;
+        int lineSizeWithoutIndent = m_area.cols - cursorIndexOfFirstNonSpace - m_reservedColumnsForLineNumbering;
+
+        if (lineSizeWithoutIndent <= 0) { return; }
+
+        cursorY = cursorPos.first - m_linesDown + extraLinesFromWrappingBeforeCursor + relativeXAfterWrap / lineSizeWithoutIndent + 1;
+        cursorX = relativeXAfterWrap % lineSizeWithoutIndent + cursorIndexOfFirstNonSpace + m_reservedColumnsForLineNumbering;
+    }
+    else
+    {
+        cursorY = cursorPos.first - m_linesDown + extraLinesFromWrappingBeforeCursor + (cursorPos.second + m_reservedColumnsForLineNumbering) / m_area.cols;
+        cursorX = (cursorPos.second + m_reservedColumnsForLineNumbering) % m_area.cols;
+    }
+
+    cursorY = m_area.top + std::clamp(cursorY, 0, m_area.rows - 1);
+    cursorX = m_area.left + cursorX;
+}
+
+void Viewport::fillRow(int y, int x, short colorPair)
+{
+    // Rows wrapped past the bottom of the area belong to whatever is drawn below it
+    if (y >= m_area.rows) { return; }
+
+    m_frame->fill(m_area.top + y, m_area.left + x, m_area.cols - x, ' ', colorPair);
+}
+
+void Viewport::printCharacter(int y, int x, char character, short colorPair, bool bold)
+{
+    if (y >= m_area.rows || x >= m_area.cols) { return; }
+
+    m_frame->set(m_area.top + y, m_area.left + x, character, colorPair, bold);
+}
+
+void Viewport::clearRemainingLines(int maxRender, int extraLinesFromWrapping)
+{
+    for (int i = maxRender + extraLinesFromWrapping; i < m_area.rows; i++) { fillRow(i, 0); }
+}
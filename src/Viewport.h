@@ -0,0 +1,104 @@
+#pragma once
+
+#include "LineGapBuffer.h"
+#include "WrapLayout.h"
+#include "SearchPattern.h"
+#include "SyntaxHighlighter.h"
+#include "SplitLayout.h"
+#include "LineEditLog.h"
+#include "CellGrid.h"
+
+class Editor;
+class Buffer;
+class View;
+
+// One window onto a buffer, drawn into its own area of the screen. Every viewport keeps its own scroll offset, wrap
+// layout and record of the last frame, so viewports over the same buffer can show parts of it far apart. Only the
+// active viewport follows the buffer cursor, the others keep the cursor they were left with.
+class Viewport
+{
+
+private:
+
+    Editor* m_editor;
+    View* m_view;
+    Buffer* m_buffer = nullptr;
+
+    // Frame being drawn into
+    CellGrid* m_frame = nullptr;
+
+    int m_id;
+    ViewportArea m_area = { 0, 0, 0, 0 };
+
+    // Cursor of the buffer while another viewport is active
+    std::pair<int, int> m_cursor = { 0, 0 };
+
+    int m_reservedColumnsForLineNumbering = 0;
+
+    WrapLayout m_wrapLayout;
+
+    int m_prevLinesDown = 0;
+    int m_linesDown = 0;
+
+    // What the last frame looked like, to redraw only the rows that changed since. Every row keeps the screen row it
+    // starts at and how many extra rows its wrapping took.
+    std::vector<std::pair<int, int>> m_previousRowLayout;
+    int m_previousCursorLine = -1;
+    ViewportArea m_previousArea = { 0, 0, 0, 0 };
+    bool m_previousFrameVisual = false;
+    bool m_previousFrameHighlighted = false;
+    std::shared_ptr<const SearchPattern> m_previousSearchHighlight;
+    Buffer* m_previousBuffer = nullptr;
+
+    // Whether the yank highlight is drawn in this frame, which only the active viewport shows
+    bool m_highlighted = false;
+
+    // Matches of the search pattern and syntax colors of the line being drawn
+    std::vector<std::pair<int, int>> m_lineMatches;
+    std::vector<ColorSpan> m_lineSpans;
+    std::string m_lineScratch;
+
+    void adjustLinesAfterScrolling(int relativeCursorPosY, int upperLineMoveThreshold, int lowerLineMoveThreshold);
+
+    // Blanks a row of the area from x on
+    void fillRow(int y, int x, short colorPair = BACKGROUND);
+    void printCharacter(int y, int x, char character, short colorPair, bool bold = false);
+    void clearRemainingLines(int maxRender, int extraLinesFromWrapping);
+    void updateWrapLayout(int numLines, bool active);
+    const WrapLayout::LineLayout& lineLayout(size_t index);
+    int wrappedLinesBeforeCursor(int numLines, int relativeCursorY);
+
+    // Keeps the cursor of an inactive viewport on the same text when lines are inserted or removed above it
+    void followLineEdit(const LineEdit& lineEdit);
+
+    int printLine(const std::shared_ptr<LineGapBuffer>& lineGapBuffer, int row, int indexOfFirstNonSpace, int extraLinesFromWrapping,
+        int relativeCursorY, MODE currentMode, const std::pair<int, int>& cursorPos);
+    void printLineNumber(int row, int extraLinesFromWrapping, int relativeCursorY);
+    int getColorPair(MODE currentMode, int row, int column, const std::pair<int, int>& cursorPos, int relativeCursorY) const;
+    void screenCursor(const std::pair<int, int>& cursorPos, int cursorIndexOfFirstNonSpace, int extraLinesFromWrappingBeforeCursor, int& cursorY, int& cursorX) const;
+
+public:
+
+    Viewport(Editor* editor, View* view, int id);
+
+    static int numberOfDigits(int x);
+
+    // Buffer shown from the next frame on, scrolled down by linesDown
+    void setBuffer(Buffer* buffer, int linesDown);
+
+    // Draws the lines of the buffer into its area of frame. Rows that did not change since the last frame are left as
+    // they are. Returns where the cursor is on the screen, which only the active viewport shows.
+    void draw(CellGrid& frame, bool active, int& cursorY, int& cursorX);
+
+    // SETTERS
+    void setArea(const ViewportArea& area) { m_area = area; }
+    void setCursor(const std::pair<int, int>& cursor) { m_cursor = cursor; }
+
+    // GETTERS
+    int id() const { return m_id; }
+    Buffer* buffer() const { return m_buffer; }
+    const ViewportArea& area() const { return m_area; }
+    const std::pair<int, int>& cursor() const { return m_cursor; }
+    int linesDown() const { return m_linesDown; }
+
+};
@@ -0,0 +1,155 @@
+#include "WrapLayout.h"
+
+WrapLayout::WrapLayout()
+    : m_numberOfLines(0), m_firstLine(0), m_treeStale(false), m_columns(0), m_reservedColumns(0)
+{
+}
+
+void WrapLayout::reset(size_t numberOfLines, int terminalColumns, int reservedColumns)
+{
+    m_numberOfLines = numberOfLines;
+
+    m_lines.assign(m_lines.size(), LineLayout{ 0, 0, false });
+    m_tree.assign(m_lines.size() + 1, 0);
+    m_treeStale = false;
+
+    m_columns = terminalColumns;
+    m_reservedColumns = reservedColumns;
+}
+
+void WrapLayout::keepWindow(size_t first, size_t count)
+{
+    if (holds(first) && first + count <= m_firstLine + m_lines.size()) { return; }
+
+    size_t firstLine = first - std::min(first, WRAP_LAYOUT_MARGIN);
+    std::vector<LineLayout> window(first + count + WRAP_LAYOUT_MARGIN - firstLine, LineLayout{ 0, 0, false });
+
+    for (size_t index = std::max(firstLine, m_firstLine); index < std::min(firstLine + window.size(), m_firstLine + m_lines.size()); index++)
+    {
+        window[index - firstLine] = m_lines[index - m_firstLine];
+    }
+
+    m_firstLine = firstLine;
+    m_lines = std::move(window);
+    m_treeStale = true;
+}
+
+int WrapLayout::extraRows(const LineLayout& line) const
+{
+    int rowWidth = m_columns - line.indexOfFirstNonSpace - m_reservedColumns;
+
+    // Lines indented past the screen are not drawn, and a wrapped row without any room has nothing to wrap into
+    if (!line.measured || line.indexOfFirstNonSpace >= m_columns || rowWidth <= 0) { return 0; }
+
+    if (line.lineSize + m_reservedColumns < m_columns) { return 0; }
+
+    return (line.lineSize + m_reservedColumns - m_columns) / rowWidth + 1;
+}
+
+void WrapLayout::add(size_t index, long delta)
+{
+    if (m_treeStale || !delta) { return; }
+
+    for (size_t node = index + 1; node < m_tree.size(); node += node & (~node + 1))
+    {
+        m_tree[node] += delta;
+    }
+}
+
+void WrapLayout::rebuildTree()
+{
+    m_tree.assign(m_lines.size() + 1, 0);
+
+    // Linear construction: every node passes its partial sum up to its parent once
+    for (size_t node = 1; node < m_tree.size(); node++)
+    {
+        m_tree[node] += extraRows(m_lines[node - 1]);
+
+        size_t parent = node + (node & (~node + 1));
+        if (parent < m_tree.size()) { m_tree[parent] += m_tree[node]; }
+    }
+
+    m_treeStale = false;
+}
+
+void WrapLayout::insertLines(size_t index, size_t count)
+{
+    size_t windowEnd = m_firstLine + m_lines.size();
+
+    m_numberOfLines += count;
+
+    if (index >= windowEnd || !count) { return; }
+
+    if (index <= m_firstLine)
+    {
+        m_firstLine += count;
+        return;
+    }
+
+    // The window keeps its size, so only as many lines as fit are inserted and the ones pushed past its end are dropped
+    size_t inserted = std::min(count, windowEnd - index);
+
+    m_lines.insert(m_lines.begin() + (index - m_firstLine), inserted, LineLayout{ 0, 0, false });
+    m_lines.resize(windowEnd - m_firstLine);
+    m_treeStale = true;
+}
+
+void WrapLayout::removeLines(size_t index, size_t count)
+{
+    size_t windowEnd = m_firstLine + m_lines.size();
+    size_t removedEnd = index + count;
+
+    m_numberOfLines -= std::min(count, m_numberOfLines - std::min(index, m_numberOfLines));
+
+    if (index >= windowEnd || !count) { return; }
+
+    if (removedEnd <= m_firstLine)
+    {
+        m_firstLine -= count;
+        return;
+    }
+
+    // Lines after the window move into it in place of the removed ones, not measured yet
+    size_t start = std::max(index, m_firstLine) - m_firstLine;
+    size_t end = std::min(removedEnd, windowEnd) - m_firstLine;
+
+    m_lines.erase(m_lines.begin() + start, m_lines.begin() + end);
+    m_lines.resize(windowEnd - m_firstLine, LineLayout{ 0, 0, false });
+
+    m_firstLine = std::min(m_firstLine, index);
+    m_treeStale = true;
+}
+
+void WrapLayout::invalidate(size_t index)
+{
+    if (!holds(index) || !line(index).measured) { return; }
+
+    add(index - m_firstLine, -extraRows(line(index)));
+    m_lines[index - m_firstLine].measured = false;
+}
+
+void WrapLayout::measure(size_t index, int indexOfFirstNonSpace, int lineSize)
+{
+    if (!holds(index)) { return; }
+
+    invalidate(index);
+
+    m_lines[index - m_firstLine] = LineLayout{ indexOfFirstNonSpace, lineSize, true };
+
+    add(index - m_firstLine, extraRows(line(index)));
+}
+
+long WrapLayout::extraRowsBetween(size_t first, size_t last)
+{
+    if (m_treeStale) { rebuildTree(); }
+
+    first = std::clamp(first, m_firstLine, m_firstLine + m_lines.size()) - m_firstLine;
+    last = std::clamp(last, m_firstLine, m_firstLine + m_lines.size()) - m_firstLine;
+
+    long sum = 0;
+
+    for (size_t node = last; node > 0; node -= node & (~node + 1)) { sum += m_tree[node]; }
+    for (size_t node = first; node > 0; node -= node & (~node + 1)) { sum -= m_tree[node]; }
+
+    return sum;
+}
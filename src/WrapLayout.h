@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Includes.h"
+
+// Lines kept on either side of the ones shown, so scrolling a little does not measure them again
+const size_t WRAP_LAYOUT_MARGIN = 64;
+
+// How the lines around the ones shown wrap at the current terminal width, kept between frames. Only a window of lines is
+// kept, so memory does not grow with the file. Lines are measured lazily and a Fenwick tree over their extra rows answers
+// how many rows a range of lines wraps into in O(log n) of the window.
+class WrapLayout
+{
+
+public:
+
+    struct LineLayout
+    {
+        int indexOfFirstNonSpace;
+        int lineSize;
+        bool measured;
+    };
+
+private:
+
+    // Layout of the lines from m_firstLine on, of the m_numberOfLines of the file
+    size_t m_numberOfLines;
+    size_t m_firstLine;
+    std::vector<LineLayout> m_lines;
+    std::vector<long> m_tree;
+    bool m_treeStale;
+
+    int m_columns;
+    int m_reservedColumns;
+
+    void add(size_t index, long delta);
+    void rebuildTree();
+
+    // Rows the line takes beyond its first, counting a cursor placed right after its last character
+    int extraRows(const LineLayout& line) const;
+
+public:
+
+    WrapLayout();
+
+    // Forgets every measurement, for a new file, a resize or a line number gutter of a different width
+    void reset(size_t numberOfLines, int terminalColumns, int reservedColumns);
+
+    // Keeps the lines in [first, first + count) with a margin around them. Measurements of lines that stay in the window
+    // are kept and the rest are forgotten.
+    void keepWindow(size_t first, size_t count);
+
+    // Lines moving in or out of the window keep its size, as lines past its end move into it or out of it
+    void insertLines(size_t index, size_t count);
+    void removeLines(size_t index, size_t count);
+    void invalidate(size_t index);
+
+    // Only lines in the window can be measured
+    void measure(size_t index, int indexOfFirstNonSpace, int lineSize);
+
+    // Extra rows taken by the measured lines in [first, last)
+    long extraRowsBetween(size_t first, size_t last);
+
+    // Getters
+    bool holds(size_t index) const { return index >= m_firstLine && index - m_firstLine < m_lines.size(); }
+    const LineLayout& line(size_t index) const { return m_lines[index - m_firstLine]; }
+    size_t numberOfLines() const { return m_numberOfLines; }
+    size_t firstLine() const { return m_firstLine; }
+    size_t windowSize() const { return m_lines.size(); }
+    int terminalColumns() const { return m_columns; }
+    int reservedColumns() const { return m_reservedColumns; }
+
+};
@@ -2,7 +2,21 @@
 
 int main(int argc, char* argv[])
 {
-    Editor editor((argc > 1) ? argv[1] : "NO_NAME");
+    std::vector<std::string> fileNames;
+    FILE_BACKEND fileBackend = GAP_BUFFER_BACKEND;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string argument = argv[i];
+
+        // Big files favour the rope, which indexes, inserts and deletes lines anywhere in O(log n)
+        if (argument == "--rope") { fileBackend = ROPE_BACKEND; }
+        else if (argument == "--gap-buffer") { fileBackend = GAP_BUFFER_BACKEND; }
+        else { fileNames.push_back(argument); }
+    }
+
+    // Only the first file is read in now, the others when they are first switched to
+    Editor editor(fileNames, fileBackend);
 
     editor.run();
 
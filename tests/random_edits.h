@@ -0,0 +1,69 @@
+#pragma once
+
+#include "../src/FileBackend.h"
+#include "../src/LineEditLog.h"
+
+// A line of up to maxPieces - 1 pieces picked at random
+static std::shared_ptr<LineGapBuffer> randomLine(std::mt19937& randomGenerator, const std::vector<std::string>& pieces, size_t maxPieces)
+{
+    std::string text;
+    size_t numberOfPieces = randomGenerator() % maxPieces;
+
+    for (size_t i = 0; i < numberOfPieces; i++) { text += pieces[randomGenerator() % pieces.size()]; }
+
+    return std::make_shared<LineGapBuffer>(static_cast<int>(text.size()) + 1, text);
+}
+
+static std::vector<std::shared_ptr<LineGapBuffer>> randomLines(std::mt19937& randomGenerator, const std::vector<std::string>& pieces, size_t maxPieces,
+    size_t count)
+{
+    std::vector<std::shared_ptr<LineGapBuffer>> newLines;
+
+    for (size_t i = 0; i < count; i++) { newLines.push_back(randomLine(randomGenerator, pieces, maxPieces)); }
+
+    return newLines;
+}
+
+// Changes, inserts or removes random lines of file and records the edit with tracker, never leaving fewer than keptLines
+template <typename Tracker>
+static void randomEdit(std::mt19937& randomGenerator, FileBackend& file, Tracker& tracker, const std::vector<std::string>& pieces, size_t maxPieces,
+    size_t keptLines)
+{
+    size_t numberOfLines = file.numberOfLines();
+
+    switch (randomGenerator() % 3)
+    {
+        case 0:
+        {
+            if (numberOfLines == 0) { break; }
+
+            size_t y = randomGenerator() % numberOfLines;
+
+            file.replaceLine(y, randomLine(randomGenerator, pieces, maxPieces));
+            tracker.recordLineEdit(LINE_CHANGED, y, 1);
+            break;
+        }
+        case 1:
+        {
+            size_t y = randomGenerator() % (numberOfLines + 1);
+            std::vector<std::shared_ptr<LineGapBuffer>> insertedLines = randomLines(randomGenerator, pieces, maxPieces, 1 + randomGenerator() % 5);
+
+            file.insertLines(y, insertedLines);
+            tracker.recordLineEdit(LINES_INSERTED, y, insertedLines.size());
+            break;
+        }
+        default:
+        {
+            if (numberOfLines <= keptLines) { break; }
+
+            size_t y = randomGenerator() % numberOfLines;
+            size_t count = std::min(static_cast<size_t>(1 + randomGenerator() % 5), numberOfLines - y);
+
+            count = std::min(count, numberOfLines - keptLines);
+
+            file.deleteLines(y, count);
+            tracker.recordLineEdit(LINES_REMOVED, y, count);
+            break;
+        }
+    }
+}
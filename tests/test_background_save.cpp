@@ -0,0 +1,50 @@
+#include "test_main.cpp"
+#include "../src/BackgroundSave.h"
+
+TEST_CASE("snapshots are written while the lines keep changing", "[background_save]")
+{
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "razz_background_save_test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directory(directory);
+
+    std::vector<std::shared_ptr<LineGapBuffer>> fileLines;
+    std::vector<std::shared_ptr<const LineGapBuffer>> snapshot;
+    std::string expected;
+
+    for (int row = 0; row < 10000; row++)
+    {
+        fileLines.push_back(std::make_shared<LineGapBuffer>(1, "line " + std::to_string(row)));
+        snapshot.push_back(fileLines.back());
+        expected += (row ? "\n" : "") + ("line " + std::to_string(row));
+    }
+
+    uint64_t generation = LineGapBuffer::currentGeneration++;
+
+    BackgroundSave backgroundSave(directory / "saved.txt", std::move(snapshot), generation);
+
+    // Edits copy the lines of the snapshot generation, the way Buffer does
+    for (std::shared_ptr<LineGapBuffer>& line : fileLines)
+    {
+        REQUIRE(line->generation() <= generation);
+
+        line = line->clone();
+        line->insertChar('!');
+
+        REQUIRE(line->generation() > generation);
+    }
+
+    const SaveResult& result = backgroundSave.wait();
+
+    REQUIRE(result.succeeded);
+    REQUIRE(backgroundSave.finished());
+    REQUIRE(backgroundSave.linesWritten() == 10000);
+    REQUIRE(result.bytesWritten == expected.size());
+
+    std::ifstream savedFile(directory / "saved.txt");
+    std::stringstream contents;
+    contents << savedFile.rdbuf();
+
+    REQUIRE(contents.str() == expected);
+
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,158 @@
+#include "test_main.cpp"
+
+#include "../src/CellGrid.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+static void requireSameCells(const CellGrid& first, const CellGrid& second)
+{
+    REQUIRE(first.rows() == second.rows());
+    REQUIRE(first.cols() == second.cols());
+
+    for (int y = 0; y < first.rows(); y++)
+    {
+        for (int x = 0; x < first.cols(); x++) { REQUIRE(first.at(y, x) == second.at(y, x)); }
+    }
+}
+
+TEST_CASE("cell grid", "[cell_grid]")
+{
+    CellGrid frame;
+    CellGrid screen;
+    std::vector<CellRun> runs;
+
+    frame.resize(5, 20);
+    screen.resize(5, 20);
+
+    SECTION("a frame like the screen sends nothing")
+    {
+        frame.diff(screen, runs);
+
+        REQUIRE(runs.empty());
+
+        frame.print(2, 3, "abc", BACKGROUND);
+        frame.print(2, 3, "   ", BACKGROUND);
+        frame.diff(screen, runs);
+
+        REQUIRE(runs.empty());
+    }
+
+    SECTION("changed cells are sent as runs, with short gaps sent along")
+    {
+        frame.print(1, 2, "ab", BACKGROUND);
+        frame.set(1, 2 + 2 + CELL_RUN_MERGE_GAP, 'c', BACKGROUND);
+        frame.set(1, 19, 'd', PATH_COLOR_PAIR);
+        frame.set(3, 0, ' ', BACKGROUND, true);
+        frame.diff(screen, runs);
+
+        REQUIRE(runs.size() == 3);
+        REQUIRE((runs[0].row == 1 && runs[0].column == 2 && runs[0].length == 3 + CELL_RUN_MERGE_GAP));
+        REQUIRE((runs[1].row == 1 && runs[1].column == 19 && runs[1].length == 1));
+        REQUIRE((runs[2].row == 3 && runs[2].column == 0 && runs[2].length == 1));
+
+        requireSameCells(frame, screen);
+
+        // Rows are only looked at again once written to
+        frame.diff(screen, runs);
+
+        REQUIRE(runs.empty());
+    }
+
+    SECTION("writes outside the grid are ignored")
+    {
+        frame.set(-1, 0, 'x', BACKGROUND);
+        frame.set(0, 20, 'x', BACKGROUND);
+        frame.fill(4, 18, 10, 'x', BACKGROUND);
+        frame.fill(4, -3, 4, 'y', BACKGROUND);
+        REQUIRE(frame.print(0, 17, "abcdef", BACKGROUND) == 23);
+
+        frame.diff(screen, runs);
+
+        REQUIRE(runs.size() == 3);
+        REQUIRE((runs[0].row == 0 && runs[0].column == 17 && runs[0].length == 3));
+        REQUIRE(frame.at(4, 0).character == 'y');
+        REQUIRE(frame.at(4, 1).character == ' ');
+        REQUIRE(frame.at(4, 19).character == 'x');
+    }
+
+    SECTION("an invalidated screen gets every cell")
+    {
+        screen.invalidate();
+        frame.resize(5, 20);
+        frame.diff(screen, runs);
+
+        REQUIRE(runs.size() == 5);
+
+        for (const CellRun& run : runs) { REQUIRE((run.column == 0 && run.length == 20)); }
+
+        requireSameCells(frame, screen);
+    }
+
+    SECTION("random frames")
+    {
+        std::mt19937 randomGenerator(23);
+
+        for (int round = 0; round < 300; round++)
+        {
+            CellGrid before = screen;
+            int writes = randomGenerator() % 12;
+
+            for (int write = 0; write < writes; write++)
+            {
+                int y = randomGenerator() % 5;
+                int x = randomGenerator() % 20;
+                char character = "ab "[randomGenerator() % 3];
+                short colorPair = (randomGenerator() % 2) ? BACKGROUND : PATH_COLOR_PAIR;
+
+                if (randomGenerator() % 2) { frame.set(y, x, character, colorPair); }
+                else { frame.fill(y, x, randomGenerator() % 8, character, colorPair); }
+            }
+
+            frame.diff(screen, runs);
+
+            requireSameCells(frame, screen);
+
+            // Every changed cell is in a run, and runs start and end on changed cells
+            std::vector<std::vector<bool>> inRun(5, std::vector<bool>(20, false));
+
+            for (const CellRun& run : runs)
+            {
+                REQUIRE(before.at(run.row, run.column) != frame.at(run.row, run.column));
+                REQUIRE(before.at(run.row, run.column + run.length - 1) != frame.at(run.row, run.column + run.length - 1));
+
+                for (int x = run.column; x < run.column + run.length; x++) { inRun[run.row][x] = true; }
+            }
+
+            for (int y = 0; y < 5; y++)
+            {
+                for (int x = 0; x < 20; x++)
+                {
+                    if (before.at(y, x) != frame.at(y, x)) { REQUIRE(inRun[y][x]); }
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("cell grid benchmarks", "[.][benchmark]")
+{
+    CellGrid frame;
+    CellGrid screen;
+    std::vector<CellRun> runs;
+
+    frame.resize(60, 200);
+    screen.resize(60, 200);
+
+    int round = 0;
+
+    BENCHMARK("Comparing a frame with every row written to")
+    {
+        round++;
+
+        for (int y = 0; y < 60; y++) { frame.set(y, (y * 7 + round) % 200, static_cast<char>('a' + round % 26), BACKGROUND); }
+
+        frame.diff(screen, runs);
+
+        return runs.size();
+    };
+}
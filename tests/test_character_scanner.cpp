@@ -0,0 +1,125 @@
+#include "test_main.cpp"
+#include "../src/CharacterScanner.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <random>
+
+static std::string randomLine(std::mt19937& generator, size_t size)
+{
+    const char alphabet[] = "  ab_Z9.,(){}\x80\xff";
+
+    std::string line(size, ' ');
+    for (char& character : line) { character = alphabet[generator() % (sizeof(alphabet) - 1)]; }
+
+    return line;
+}
+
+TEST_CASE("character classes", "[character_scanner]")
+{
+    REQUIRE(CharacterScanner::characterClass('a') == WORD_CHARACTER);
+    REQUIRE(CharacterScanner::characterClass('Z') == WORD_CHARACTER);
+    REQUIRE(CharacterScanner::characterClass('7') == WORD_CHARACTER);
+    REQUIRE(CharacterScanner::characterClass('_') == WORD_CHARACTER);
+    REQUIRE(CharacterScanner::characterClass(' ') == SPACE_CHARACTER);
+    REQUIRE(CharacterScanner::characterClass('@') == PUNCTUATION_CHARACTER);
+    REQUIRE(CharacterScanner::characterClass('[') == PUNCTUATION_CHARACTER);
+    REQUIRE(CharacterScanner::characterClass('\0') == PUNCTUATION_CHARACTER);
+    REQUIRE(CharacterScanner::characterClass('\xc3') == PUNCTUATION_CHARACTER);
+}
+
+TEST_CASE("every implementation finds the same characters", "[character_scanner]")
+{
+    std::mt19937 generator(5);
+
+    SCANNER_IMPLEMENTATION original = CharacterScanner::implementation();
+
+    for (SCANNER_IMPLEMENTATION implementation : { SCALAR_SCANNER, SSE2_SCANNER, AVX2_SCANNER })
+    {
+        if (!CharacterScanner::supports(implementation)) { continue; }
+
+        for (int trial = 0; trial < 50; trial++)
+        {
+            std::string text = randomLine(generator, generator() % 150);
+
+            LineGapBuffer line(1, text);
+            line.moveGap(generator() % (text.size() + 1));
+
+            for (int classes = 1; classes <= (WORD_CHARACTER | SPACE_CHARACTER | PUNCTUATION_CHARACTER); classes++)
+            {
+                for (size_t from = 0; from <= text.size(); from++)
+                {
+                    size_t next = std::string_view::npos;
+                    for (size_t index = from; index < text.size() && next == std::string_view::npos; index++)
+                    {
+                        if (CharacterScanner::characterClass(text[index]) & classes) { next = index; }
+                    }
+
+                    size_t previous = std::string_view::npos;
+                    for (size_t index = std::min(from + 1, text.size()); index > 0 && previous == std::string_view::npos; index--)
+                    {
+                        if (CharacterScanner::characterClass(text[index - 1]) & classes) { previous = index - 1; }
+                    }
+
+                    CharacterScanner::use(implementation);
+
+                    REQUIRE(CharacterScanner::findNext(text, from, classes) == next);
+                    REQUIRE(CharacterScanner::findNext(line, from, classes) == next);
+                    REQUIRE(CharacterScanner::findPrevious(text, from, classes) == previous);
+                    REQUIRE(CharacterScanner::findPrevious(line, from, classes) == previous);
+                }
+            }
+        }
+    }
+
+    CharacterScanner::use(original);
+}
+
+TEST_CASE("scanning a long minified line", "[.][benchmark]")
+{
+    std::mt19937 generator(9);
+
+    // Long runs of word characters, like the base64 and identifier soup in minified code, with the gap in the middle
+    std::string text;
+    while (text.size() < 100000)
+    {
+        text += std::string(generator() % 2000 + 1, 'x');
+        text += "(){},"[generator() % 5];
+    }
+
+    LineGapBuffer line(1, text);
+    line.moveGap(text.size() / 2);
+
+    SCANNER_IMPLEMENTATION original = CharacterScanner::implementation();
+    const char* implementationNames[] = { "scalar scanner", "SSE2 scanner", "AVX2 scanner" };
+
+    // What the word motions did before the scanner, one at() call and one classification per character
+    BENCHMARK("per character")
+    {
+        size_t count = 0;
+        for (size_t index = 0; index < line.lineSize(); index++)
+        {
+            if (CharacterScanner::characterClass(line.at(index)) == PUNCTUATION_CHARACTER) { count++; }
+        }
+        return count;
+    };
+
+    for (SCANNER_IMPLEMENTATION implementation : { SCALAR_SCANNER, SSE2_SCANNER, AVX2_SCANNER })
+    {
+        if (!CharacterScanner::supports(implementation)) { continue; }
+
+        CharacterScanner::use(implementation);
+
+        BENCHMARK(implementationNames[implementation])
+        {
+            size_t count = 0;
+            for (size_t index = CharacterScanner::findNext(line, 0, PUNCTUATION_CHARACTER); index != std::string_view::npos;
+                index = CharacterScanner::findNext(line, index + 1, PUNCTUATION_CHARACTER))
+            {
+                count++;
+            }
+            return count;
+        };
+    }
+
+    CharacterScanner::use(original);
+}
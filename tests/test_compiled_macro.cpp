@@ -0,0 +1,102 @@
+#include "test_main.cpp"
+#include "../src/CompiledMacro.h"
+#include "../src/Editor.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+static std::vector<int> keysOf(const std::string& text)
+{
+    return std::vector<int>(text.begin(), text.end());
+}
+
+// Opens filePath in an editor without a terminal, types keys into it and returns the lines it is left with
+static std::vector<std::string> typeKeys(const std::filesystem::path& filePath, std::vector<int> keys, bool& macroCompiles,
+    const std::vector<int>& macroKeys)
+{
+    setenv("TERM", "xterm-256color", 1);
+
+    // What the editor draws goes nowhere
+    fflush(stdout);
+    int standardOutput = dup(STDOUT_FILENO);
+    int nullOutput = open("/dev/null", O_WRONLY);
+    dup2(nullOutput, STDOUT_FILENO);
+    close(nullOutput);
+
+    std::vector<std::string> editedLines;
+
+    {
+        Editor editor({ filePath.string() });
+
+        char findCharacter = 0;
+        bool searchedForward = true;
+        macroCompiles = CompiledMacro(&editor, macroKeys, findCharacter, searchedForward).compiled();
+
+        std::vector<int> quitKeys = keysOf("\x03:q!\n");
+        keys.insert(keys.end(), quitKeys.begin(), quitKeys.end());
+
+        // Keys pushed back are read last pushed first. ncurses keeps little more than a hundred, and the editor would wait for more if any were dropped.
+        bool keysFit = true;
+
+        for (auto key = keys.rbegin(); key != keys.rend(); key++) { keysFit = keysFit && ungetch(*key) == OK; }
+
+        if (keysFit) { editor.run(); }
+
+        editor.buffer().getFile().forEachLine([&editedLines](const std::shared_ptr<LineGapBuffer>& line)
+        {
+            editedLines.push_back(std::string(line->preGapSpan()) + std::string(line->postGapSpan()));
+        });
+    }
+
+    fflush(stdout);
+    dup2(standardOutput, STDOUT_FILENO);
+    close(standardOutput);
+
+    return editedLines;
+}
+
+TEST_CASE("compiled macros leave the buffer as their keys typed by hand", "[compiled_macro]")
+{
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "razz_compiled_macro_test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directory(directory);
+
+    std::filesystem::path typedPath = directory / "typed.txt";
+    std::filesystem::path replayedPath = directory / "replayed.txt";
+
+    {
+        std::ofstream file(typedPath);
+
+        for (int i = 0; i < 12; i++) { file << "    let value" << i << " = some(other, thing) + 42;\n"; }
+    }
+
+    std::filesystem::copy_file(typedPath, replayedPath);
+
+    const int REPETITION = 3;
+
+    // Bound keys, counts, d and f, and insert mode left by ctrl-c, which is bound like escape
+    std::vector<int> macro = keysOf("HJ> \x03" "A;\x03" "H2wfe;dw2x" "o(ab");
+    macro.push_back(BACKSPACE);
+    std::vector<int> macroEnd = keysOf("c\x03" "3p");
+    macro.insert(macro.end(), macroEnd.begin(), macroEnd.end());
+
+    std::vector<int> typedKeys;
+
+    for (int i = 0; i < REPETITION + 1; i++) { typedKeys.insert(typedKeys.end(), macro.begin(), macro.end()); }
+
+    std::vector<int> replayedKeys = keysOf("ma");
+    replayedKeys.insert(replayedKeys.end(), macro.begin(), macro.end());
+    std::vector<int> replayKeys = keysOf("m" + std::to_string(REPETITION) + "@a");
+    replayedKeys.insert(replayedKeys.end(), replayKeys.begin(), replayKeys.end());
+
+    bool macroCompiles = false;
+
+    std::vector<std::string> typedLines = typeKeys(typedPath, typedKeys, macroCompiles, macro);
+    std::vector<std::string> replayedLines = typeKeys(replayedPath, replayedKeys, macroCompiles, macro);
+
+    REQUIRE(macroCompiles);
+    REQUIRE(typedLines.size() > 12);
+    REQUIRE(replayedLines == typedLines);
+
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,91 @@
+#include "test_main.cpp"
+
+#include "../src/FileGapBuffer.h"
+#include "../src/FileRope.h"
+#include "test_lines.h"
+
+static void requireSameLines(const FileBackend& file, const std::vector<std::shared_ptr<LineGapBuffer>>& expected)
+{
+    REQUIRE(file.numberOfLines() == expected.size());
+
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        REQUIRE(file[i] == expected[i]);
+    }
+}
+
+static void checkRangeEdits(FileBackend& file, std::vector<std::shared_ptr<LineGapBuffer>> expected)
+{
+    std::mt19937 randomGenerator(42);
+
+    for (int operation = 0; operation < 2000; operation++)
+    {
+        switch (randomGenerator() % 3)
+        {
+            case 0:
+            {
+                size_t index = randomGenerator() % (expected.size() + 1);
+                std::vector<std::shared_ptr<LineGapBuffer>> insertedLines = makeLines(randomGenerator() % 300);
+
+                file.insertLines(index, insertedLines);
+                expected.insert(expected.begin() + index, insertedLines.begin(), insertedLines.end());
+                break;
+            }
+            case 1:
+            {
+                if (expected.empty()) { break; }
+
+                size_t index = randomGenerator() % expected.size();
+                size_t count = std::min(static_cast<size_t>(randomGenerator() % 300), expected.size() - index);
+
+                std::vector<std::shared_ptr<LineGapBuffer>> deletedLines = file.deleteLines(index, count);
+
+                REQUIRE(deletedLines == std::vector<std::shared_ptr<LineGapBuffer>>(expected.begin() + index, expected.begin() + index + count));
+                expected.erase(expected.begin() + index, expected.begin() + index + count);
+                break;
+            }
+            default:
+            {
+                if (expected.empty()) { break; }
+
+                size_t first = randomGenerator() % expected.size();
+                size_t last = std::min(first + randomGenerator() % 300, expected.size() - 1);
+                size_t index = first;
+
+                // Replaces every line of the range, which also checks the lines are visited in order
+                file.transformLines(first, last, [&expected, &index](std::shared_ptr<LineGapBuffer>& line)
+                {
+                    REQUIRE(line == expected[index]);
+
+                    line = std::make_shared<LineGapBuffer>(1);
+                    expected[index++] = line;
+                });
+
+                REQUIRE(index == last + 1);
+                break;
+            }
+        }
+    }
+
+    requireSameLines(file, expected);
+}
+
+TEST_CASE("range edits of the gap buffer", "[file_backend]")
+{
+    std::vector<std::shared_ptr<LineGapBuffer>> expected = makeLines(100);
+    std::vector<std::shared_ptr<LineGapBuffer>> loadedLines = expected;
+
+    FileGapBuffer gapBuffer(std::move(loadedLines));
+
+    checkRangeEdits(gapBuffer, expected);
+}
+
+TEST_CASE("range edits of the rope", "[file_backend]")
+{
+    std::vector<std::shared_ptr<LineGapBuffer>> expected = makeLines(100);
+    std::vector<std::shared_ptr<LineGapBuffer>> loadedLines = expected;
+
+    FileRope rope(std::move(loadedLines));
+
+    checkRangeEdits(rope, expected);
+}
@@ -0,0 +1,55 @@
+#include "test_main.cpp"
+
+#include "../src/FileRope.h"
+#include "test_lines.h"
+
+TEST_CASE("construction keeps line order", "[file_rope]")
+{
+    std::vector<std::shared_ptr<LineGapBuffer>> loadedLines = makeLines(1000);
+    std::vector<std::shared_ptr<LineGapBuffer>> expected = loadedLines;
+
+    FileRope rope(std::move(loadedLines));
+
+    REQUIRE(rope.numberOfLines() == expected.size());
+
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        REQUIRE(rope[i] == expected[i]);
+    }
+}
+
+TEST_CASE("inserts and deletes anywhere", "[file_rope]")
+{
+    std::vector<std::shared_ptr<LineGapBuffer>> expected = makeLines(100);
+    std::vector<std::shared_ptr<LineGapBuffer>> loadedLines = expected;
+
+    FileRope rope(std::move(loadedLines));
+
+    std::mt19937 randomGenerator(42);
+
+    for (int operation = 0; operation < 5000; operation++)
+    {
+        if (expected.empty() || randomGenerator() % 2)
+        {
+            size_t index = randomGenerator() % (expected.size() + 1);
+            std::shared_ptr<LineGapBuffer> line = std::make_shared<LineGapBuffer>(1);
+
+            rope.insertLine(index, line);
+            expected.insert(expected.begin() + index, line);
+        }
+        else
+        {
+            size_t index = randomGenerator() % expected.size();
+
+            REQUIRE(rope.deleteLine(index) == expected[index]);
+            expected.erase(expected.begin() + index);
+        }
+    }
+
+    REQUIRE(rope.numberOfLines() == expected.size());
+
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        REQUIRE(rope[i] == expected[i]);
+    }
+}
@@ -0,0 +1,123 @@
+#include "test_main.cpp"
+#include "../src/FileWriter.h"
+#include "../src/MappedFile.h"
+
+#include <sys/stat.h>
+
+static std::string readWholeFile(const std::filesystem::path& filePath)
+{
+    std::ifstream file(filePath);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+TEST_CASE("committed writes replace the target", "[file_writer]")
+{
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "razz_file_writer_test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directory(directory);
+
+    std::filesystem::path target = directory / "target.txt";
+    std::ofstream(target) << "old text";
+    chmod(target.c_str(), 0640);
+
+    FileWriter::writeBufferSize = 16;
+
+    {
+        FileWriter writer(target);
+        writer.write(std::string_view("short "));
+        writer.write(std::string_view("a span longer than the write buffer"));
+        writer.write('\n');
+
+        REQUIRE(readWholeFile(target) == "old text");
+        REQUIRE(writer.commit());
+        REQUIRE(writer.bytesWritten() == 42);
+    }
+
+    struct stat targetStatus;
+    stat(target.c_str(), &targetStatus);
+
+    REQUIRE(readWholeFile(target) == "short a span longer than the write buffer\n");
+    REQUIRE((targetStatus.st_mode & 07777) == 0640);
+    REQUIRE(std::distance(std::filesystem::directory_iterator(directory), std::filesystem::directory_iterator()) == 1);
+
+    FileWriter::writeBufferSize = 1 << 20;
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("abandoned writes leave the target untouched", "[file_writer]")
+{
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "razz_file_writer_test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directory(directory);
+
+    std::filesystem::path target = directory / "target.txt";
+    std::ofstream(target) << "old text";
+
+    {
+        FileWriter writer(target);
+        writer.write(std::string_view("new text"));
+    }
+
+    REQUIRE(readWholeFile(target) == "old text");
+    REQUIRE(std::distance(std::filesystem::directory_iterator(directory), std::filesystem::directory_iterator()) == 1);
+
+    FileWriter missingDirectoryWriter(directory / "missing" / "target.txt");
+    REQUIRE(missingDirectoryWriter.failed());
+    REQUIRE(!missingDirectoryWriter.commit());
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("hard linked files are overwritten in place", "[file_writer]")
+{
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "razz_file_writer_test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directory(directory);
+
+    std::filesystem::path target = directory / "target.txt";
+    std::filesystem::path link = directory / "link.txt";
+    std::ofstream(target) << "old text that is longer";
+    chmod(target.c_str(), 0604);
+    std::filesystem::create_hard_link(target, link);
+
+    REQUIRE(FileWriter::writesInPlace(target));
+    REQUIRE_FALSE(FileWriter::writesInPlace(directory / "new.txt"));
+
+    // A save that may not overwrite the file fails and leaves it alone
+    {
+        FileWriter writer(target, false);
+        writer.write(std::string_view("new text"));
+
+        REQUIRE_FALSE(writer.commit());
+        REQUIRE_FALSE(writer.error().empty());
+    }
+
+    REQUIRE(readWholeFile(target) == "old text that is longer");
+
+    // Lines read from a mapping of the file keep their text once it is detached
+    MappedFile mappedFile(target);
+    REQUIRE(mappedFile.detachFromFile());
+
+    {
+        FileWriter writer(target);
+        writer.write(std::string_view("new text"));
+
+        REQUIRE(writer.inPlace());
+        REQUIRE(writer.commit());
+    }
+
+    struct stat targetStatus;
+    stat(target.c_str(), &targetStatus);
+
+    REQUIRE(readWholeFile(target) == "new text");
+    REQUIRE(readWholeFile(link) == "new text");
+    REQUIRE(targetStatus.st_nlink == 2);
+    REQUIRE((targetStatus.st_mode & 07777) == 0604);
+    REQUIRE(std::distance(std::filesystem::directory_iterator(directory), std::filesystem::directory_iterator()) == 2);
+
+    REQUIRE(std::string_view(mappedFile.data(), mappedFile.size()) == "old text that is longer");
+
+    std::filesystem::remove_all(directory);
+}
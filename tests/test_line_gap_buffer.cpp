@@ -8,3 +8,144 @@ TEST_CASE("constructors", "[line_gap_buffer]")
 
     REQUIRE(buffer.bufferSize() == 0);
 }
+
+TEST_CASE("mapped lines materialize on first edit", "[line_gap_buffer]")
+{
+    const char* mapped = "hello\nworld";
+
+    LineGapBuffer buffer(mapped + 6, 5);
+
+    REQUIRE(buffer.isMapped());
+    REQUIRE(buffer.lineSize() == 5);
+    REQUIRE(buffer.at(0) == 'w');
+    REQUIRE(buffer[4] == 'd');
+
+    buffer.right();
+    buffer.insertChar('!');
+
+    REQUIRE(!buffer.isMapped());
+    REQUIRE(buffer.lineSize() == 6);
+    REQUIRE(buffer.at(0) == 'w');
+    REQUIRE(buffer.at(1) == '!');
+    REQUIRE(buffer.at(5) == 'd');
+}
+
+TEST_CASE("gap relocation keeps the text in order", "[line_gap_buffer]")
+{
+    LineGapBuffer buffer(1, "hello world");
+
+    buffer.moveGap(5);
+    REQUIRE(buffer.preGapIndex() == 5);
+
+    buffer.insertChar(',');
+    buffer.moveGap(0);
+    buffer.insertChar('>');
+    buffer.moveGap(buffer.lineSize());
+    buffer.insertChar('!');
+
+    std::string line;
+    for (size_t i = 0; i < buffer.lineSize(); i++) { line += buffer.at(i); }
+
+    REQUIRE(line == ">hello, world!");
+}
+
+TEST_CASE("gap spans cover the whole line", "[line_gap_buffer]")
+{
+    const char* mapped = "mapped line";
+
+    LineGapBuffer mappedBuffer(mapped, 11);
+
+    REQUIRE(mappedBuffer.preGapSpan().empty());
+    REQUIRE(mappedBuffer.postGapSpan() == "mapped line");
+
+    LineGapBuffer buffer(1, "hello world");
+    buffer.moveGap(5);
+
+    REQUIRE(buffer.preGapSpan() == "hello");
+    REQUIRE(buffer.postGapSpan() == " world");
+}
+
+TEST_CASE("cached metadata follows edits", "[line_gap_buffer]")
+{
+    std::mt19937 generator(11);
+
+    LineGapBuffer buffer(1, "    indented");
+    std::string reference = "    indented";
+
+    for (int edit = 0; edit < 2000; edit++)
+    {
+        uint64_t version = buffer.version();
+
+        if (reference.empty() || generator() % 3)
+        {
+            size_t index = generator() % (reference.size() + 1);
+            char character = (generator() % 2) ? ' ' : 'a' + generator() % 26;
+
+            buffer.moveGap(index);
+            buffer.insertChar(character);
+            reference.insert(reference.begin() + index, character);
+        }
+        else
+        {
+            size_t index = 1 + generator() % reference.size();
+
+            buffer.moveGap(index);
+            buffer.deleteChar();
+            reference.erase(reference.begin() + index - 1);
+        }
+
+        REQUIRE(buffer.version() == version + 1);
+
+        size_t firstNonSpace = reference.find_first_not_of(' ');
+        REQUIRE(buffer.firstNonSpaceIndex() == ((firstNonSpace == std::string::npos) ? reference.size() : firstNonSpace));
+
+        LineGapBuffer copy(1, reference);
+        REQUIRE(buffer.hash() == copy.hash());
+    }
+}
+
+TEST_CASE("bulk edits match character edits", "[line_gap_buffer]")
+{
+    std::mt19937 generator(23);
+
+    const char mapped[] = "  mapped text";
+    LineGapBuffer buffer(mapped, 13);
+    std::string reference = "  mapped text";
+
+    for (int edit = 0; edit < 2000; edit++)
+    {
+        if (reference.empty() || generator() % 2)
+        {
+            size_t index = generator() % (reference.size() + 1);
+            std::string text(generator() % 40, ' ');
+
+            for (char& character : text)
+            {
+                if (generator() % 3) { character = 'a' + generator() % 26; }
+            }
+
+            buffer.moveGap(index);
+            buffer.insertText(text);
+            reference.insert(index, text);
+        }
+        else
+        {
+            size_t index = generator() % reference.size();
+            size_t count = generator() % (reference.size() - index + 1);
+
+            buffer.eraseText(index, count);
+            reference.erase(index, count);
+        }
+
+        REQUIRE(buffer.lineSize() == reference.size());
+
+        size_t index = generator() % (reference.size() + 1);
+        size_t count = generator() % (reference.size() + 2);
+        std::pair<std::string_view, std::string_view> spans = buffer.spans(index, count);
+
+        REQUIRE(std::string(spans.first) + std::string(spans.second) == reference.substr(index, count));
+
+        size_t firstNonSpace = reference.find_first_not_of(' ');
+        REQUIRE(buffer.firstNonSpaceIndex() == ((firstNonSpace == std::string::npos) ? reference.size() : firstNonSpace));
+    }
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "../src/LineGapBuffer.h"
+
+// Empty lines, which tests tell apart by their addresses
+static std::vector<std::shared_ptr<LineGapBuffer>> makeLines(size_t count)
+{
+    std::vector<std::shared_ptr<LineGapBuffer>> newLines;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        newLines.push_back(std::make_shared<LineGapBuffer>(1));
+    }
+
+    return newLines;
+}
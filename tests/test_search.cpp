@@ -0,0 +1,305 @@
+#include "test_main.cpp"
+
+#include "../src/FileGapBuffer.h"
+#include "../src/SearchIndex.h"
+#include "random_edits.h"
+
+// Lines of up to 19 of these, so that patterns made of them match often
+static const std::vector<std::string> textPieces = { "a", "b", " ", "c" };
+static const size_t maxTextPieces = 20;
+
+static std::string randomText(std::mt19937& randomGenerator, size_t length)
+{
+    std::string text;
+
+    for (size_t i = 0; i < length; i++) { text += textPieces[randomGenerator() % textPieces.size()]; }
+
+    return text;
+}
+
+static void requireMatchesOfFullScan(const SearchIndex& index, const FileBackend& file, const SearchPattern& pattern)
+{
+    std::vector<std::pair<int, int>> lineMatches;
+    std::string scratch;
+
+    size_t match = 0;
+
+    for (size_t y = 0; y < file.numberOfLines(); y++)
+    {
+        lineMatches.clear();
+        pattern.findAll(*file[y], lineMatches, scratch);
+
+        for (const std::pair<int, int>& lineMatch : lineMatches)
+        {
+            REQUIRE(match < index.matches().size());
+            REQUIRE(index.matches()[match].line == static_cast<int>(y));
+            REQUIRE(index.matches()[match].column == lineMatch.first);
+            REQUIRE(index.matches()[match].length == lineMatch.second);
+            match++;
+        }
+    }
+
+    REQUIRE(match == index.matches().size());
+}
+
+TEST_CASE("search patterns", "[search_pattern]")
+{
+    std::vector<std::pair<int, int>> matches;
+
+    SECTION("literal patterns do not overlap")
+    {
+        SearchPattern pattern("aa");
+
+        REQUIRE(pattern.literal());
+
+        pattern.findAll(std::string_view("aaaaa"), matches);
+
+        REQUIRE(matches == std::vector<std::pair<int, int>>{ { 0, 2 }, { 2, 2 } });
+    }
+
+    SECTION("regular expressions")
+    {
+        SearchPattern pattern("b+c?");
+
+        REQUIRE_FALSE(pattern.literal());
+        REQUIRE(pattern.valid());
+
+        pattern.findAll(std::string_view("abbc b ac"), matches);
+
+        REQUIRE(matches == std::vector<std::pair<int, int>>{ { 1, 3 }, { 5, 1 } });
+    }
+
+    SECTION("invalid and empty patterns match nothing")
+    {
+        REQUIRE_FALSE(SearchPattern("a(b").valid());
+        REQUIRE_FALSE(SearchPattern("").valid());
+
+        SearchPattern("a(b").findAll(std::string_view("a(b"), matches);
+
+        REQUIRE(matches.empty());
+    }
+
+    SECTION("literal and regular expression searches agree")
+    {
+        std::mt19937 randomGenerator(7);
+
+        SearchPattern literal("ab c");
+        SearchPattern regex("ab[ ]c");
+
+        for (int line = 0; line < 1000; line++)
+        {
+            std::string text = randomText(randomGenerator, randomGenerator() % 60);
+            std::vector<std::pair<int, int>> regexMatches;
+
+            matches.clear();
+            literal.findAll(std::string_view(text), matches);
+            regex.findAll(std::string_view(text), regexMatches);
+
+            REQUIRE(matches == regexMatches);
+        }
+    }
+
+    SECTION("substitutions")
+    {
+        std::string replaced;
+        int start = -1;
+        int end = -1;
+
+        REQUIRE(SearchPattern("ab").substitute(std::string_view("xabyab"), "[&]", false, start, end, replaced) == 1);
+        REQUIRE((start == 1 && end == 3 && replaced == "[ab]"));
+
+        // Text between the matches is part of the replaced span
+        REQUIRE(SearchPattern("ab").substitute(std::string_view("xabyab"), "\\&", true, start, end, replaced) == 2);
+        REQUIRE((start == 1 && end == 6 && replaced == "&y&"));
+
+        REQUIRE(SearchPattern("(\\w)(\\d)").substitute(std::string_view("a1 b2"), "\\2\\1", true, start, end, replaced) == 2);
+        REQUIRE((start == 0 && end == 5 && replaced == "1a 2b"));
+
+        REQUIRE(SearchPattern("^").substitute(std::string_view("line"), "// ", true, start, end, replaced) == 1);
+        REQUIRE((start == 0 && end == 0 && replaced == "// "));
+
+        REQUIRE(SearchPattern("zz").substitute(std::string_view("line"), "x", true, start, end, replaced) == 0);
+        REQUIRE(replaced.empty());
+    }
+
+    SECTION("regular expressions over very long lines")
+    {
+        // Minified files have lines like this, and a backtracking engine runs out of stack on them
+        std::string text = "a" + std::string(150000, 'x') + "yb";
+
+        SearchPattern("x.*b").findAll(std::string_view(text), matches);
+
+        REQUIRE(matches == std::vector<std::pair<int, int>>{ { 1, 150002 } });
+
+        matches.clear();
+        SearchPattern("(x|y)+b").findAll(std::string_view(text), matches);
+
+        REQUIRE(matches == std::vector<std::pair<int, int>>{ { 1, 150002 } });
+
+        std::string replaced;
+        int start = -1;
+        int end = -1;
+
+        REQUIRE(SearchPattern("(x|y)+(b)").substitute(std::string_view(text), "<\\2>", true, start, end, replaced) == 1);
+        REQUIRE((start == 1 && end == 150003 && replaced == "<b>"));
+
+        REQUIRE(SearchPattern("x").substitute(std::string_view(text), "", true, start, end, replaced) == 150000);
+        REQUIRE((start == 1 && end == 150001 && replaced.empty()));
+    }
+
+    SECTION("lines split by their gap")
+    {
+        LineGapBuffer line(4, "xxabyy");
+        std::string scratch;
+
+        line.moveGap(3);
+        line.insertText("");
+
+        SearchPattern("ab").findAll(line, matches, scratch);
+
+        REQUIRE(matches == std::vector<std::pair<int, int>>{ { 2, 2 } });
+    }
+}
+
+TEST_CASE("search index", "[search_index]")
+{
+    std::mt19937 randomGenerator(42);
+
+    SECTION("matches are kept up to date by rescanning edited lines")
+    {
+        FileGapBuffer file(randomLines(randomGenerator, textPieces, maxTextPieces, 500));
+        std::shared_ptr<const SearchPattern> pattern = std::make_shared<const SearchPattern>("ab");
+        SearchIndex index;
+
+        index.setPattern(pattern, file);
+
+        REQUIRE(index.update(file));
+        requireMatchesOfFullScan(index, file, *pattern);
+
+        for (int round = 0; round < 300; round++)
+        {
+            int edits = randomGenerator() % 8;
+
+            for (int edit = 0; edit < edits; edit++) { randomEdit(randomGenerator, file, index, textPieces, maxTextPieces, 0); }
+
+            REQUIRE(index.update(file));
+            requireMatchesOfFullScan(index, file, *pattern);
+        }
+    }
+
+    SECTION("next and previous matches wrap around the file")
+    {
+        FileGapBuffer file(std::vector<std::shared_ptr<LineGapBuffer>>{ std::make_shared<LineGapBuffer>(8, "ab ab"),
+            std::make_shared<LineGapBuffer>(8, "cc"), std::make_shared<LineGapBuffer>(8, " ab") });
+        std::shared_ptr<const SearchPattern> pattern = std::make_shared<const SearchPattern>("ab");
+        SearchIndex index;
+
+        index.setPattern(pattern, file);
+
+        SearchMatch match;
+        bool wrapped;
+
+        REQUIRE(index.findNext(file, { 0, 0 }, true, match, wrapped));
+        REQUIRE((match.line == 0 && match.column == 3 && !wrapped));
+
+        REQUIRE(index.findNext(file, { 2, 1 }, true, match, wrapped));
+        REQUIRE((match.line == 0 && match.column == 0 && wrapped));
+
+        REQUIRE(index.findNext(file, { 0, 3 }, false, match, wrapped));
+        REQUIRE((match.line == 0 && match.column == 0 && !wrapped));
+
+        REQUIRE(index.findNext(file, { 0, 0 }, false, match, wrapped));
+        REQUIRE((match.line == 2 && match.column == 1 && wrapped));
+
+        // Looking through the lines finds the same matches as the index
+        REQUIRE(SearchIndex::scanFrom(file, *pattern, { 2, 1 }, true, match, wrapped));
+        REQUIRE((match.line == 0 && match.column == 0 && wrapped));
+
+        REQUIRE(SearchIndex::scanFrom(file, *pattern, { 0, 3 }, false, match, wrapped));
+        REQUIRE((match.line == 0 && match.column == 0 && !wrapped));
+
+        REQUIRE_FALSE(SearchIndex::scanFrom(file, SearchPattern("zz"), { 1, 0 }, true, match, wrapped));
+    }
+
+    SECTION("large files are scanned in the background while they are edited")
+    {
+        FileGapBuffer file(randomLines(randomGenerator, textPieces, maxTextPieces, SearchIndex::backgroundScanLines * 3));
+        std::shared_ptr<const SearchPattern> pattern = std::make_shared<const SearchPattern>("a+b");
+        SearchIndex index;
+
+        index.setPattern(pattern, file);
+
+        // Lines are replaced rather than edited in place, so the snapshot the scan reads stays as it was
+        for (int edit = 0; edit < 200; edit++) { randomEdit(randomGenerator, file, index, textPieces, maxTextPieces, 0); }
+
+        while (!index.update(file)) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+
+        requireMatchesOfFullScan(index, file, *pattern);
+    }
+}
+
+TEST_CASE("parallel scans", "[search_index]")
+{
+    std::mt19937 randomGenerator(3);
+
+    std::vector<std::shared_ptr<const LineGapBuffer>> scannedLines;
+
+    for (size_t y = 0; y < SearchIndex::scanChunkLines * 10 + 7; y++) { scannedLines.push_back(randomLine(randomGenerator, textPieces, maxTextPieces)); }
+
+    SearchPattern pattern("a b|c+a");
+    std::atomic<bool> cancelled = false;
+
+    std::vector<SearchMatch> singleThreaded = SearchIndex::scanLines(scannedLines, pattern, 1, cancelled);
+
+    for (size_t threads : { 2, 3, 8 })
+    {
+        std::vector<SearchMatch> parallel = SearchIndex::scanLines(scannedLines, pattern, threads, cancelled);
+
+        REQUIRE(parallel.size() == singleThreaded.size());
+
+        for (size_t i = 0; i < parallel.size(); i++)
+        {
+            REQUIRE((parallel[i].line == singleThreaded[i].line && parallel[i].column == singleThreaded[i].column && parallel[i].length == singleThreaded[i].length));
+        }
+    }
+
+    cancelled = true;
+
+    REQUIRE(SearchIndex::scanLines(scannedLines, pattern, 4, cancelled).empty());
+}
+
+// Reports lines per second rather than time, to be read against the number of threads
+TEST_CASE("scanning many lines on more threads", "[.][benchmark]")
+{
+    std::mt19937 randomGenerator(5);
+
+    std::vector<std::shared_ptr<const LineGapBuffer>> scannedLines;
+
+    for (size_t y = 0; y < 1000000; y++) { scannedLines.push_back(randomLine(randomGenerator, textPieces, maxTextPieces)); }
+
+    std::atomic<bool> cancelled = false;
+    size_t maximumThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<size_t> threadCounts;
+
+    for (size_t threads = 1; threads < maximumThreads; threads *= 2) { threadCounts.push_back(threads); }
+
+    threadCounts.push_back(maximumThreads);
+
+    for (const char* text : { "ab cab", "a+ b[c]" })
+    {
+        SearchPattern pattern(text);
+
+        for (size_t threads : threadCounts)
+        {
+            std::chrono::time_point<std::chrono::steady_clock> start = std::chrono::steady_clock::now();
+
+            size_t numberOfMatches = SearchIndex::scanLines(scannedLines, pattern, threads, cancelled).size();
+
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            std::cout << '"' << text << "\" on " << threads << " threads: " << std::fixed << std::setprecision(2) << scannedLines.size() / seconds / 1e6
+                << "M lines/s, " << numberOfMatches << " matches" << std::endl;
+        }
+    }
+}
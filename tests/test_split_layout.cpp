@@ -0,0 +1,137 @@
+#include "test_main.cpp"
+
+#include "../src/SplitLayout.h"
+
+static ViewportArea areaOf(const std::vector<std::pair<int, ViewportArea>>& areas, int viewport)
+{
+    for (const std::pair<int, ViewportArea>& area : areas)
+    {
+        if (area.first == viewport) { return area.second; }
+    }
+
+    FAIL("No area for viewport " << viewport);
+
+    return ViewportArea{ 0, 0, 0, 0 };
+}
+
+TEST_CASE("split layout", "[split_layout]")
+{
+    SplitLayout layout;
+    std::vector<std::pair<int, ViewportArea>> areas;
+    std::vector<ViewportArea> separators;
+
+    SECTION("one viewport takes the whole area")
+    {
+        layout.areas(22, 80, areas, separators);
+
+        REQUIRE(areas.size() == 1);
+        REQUIRE(areaOf(areas, 0) == ViewportArea{ 0, 0, 22, 80 });
+        REQUIRE(separators.empty());
+        REQUIRE(layout.close(0) == -1);
+    }
+
+    SECTION("splits cut an area in halves with a separator between them")
+    {
+        int top = layout.split(0, false);
+
+        REQUIRE(top == 1);
+        REQUIRE(layout.numberOfViewports() == 2);
+
+        layout.areas(22, 80, areas, separators);
+
+        REQUIRE(areaOf(areas, 1) == ViewportArea{ 0, 0, 11, 80 });
+        REQUIRE(areaOf(areas, 0) == ViewportArea{ 12, 0, 10, 80 });
+        REQUIRE(separators == std::vector<ViewportArea>{ { 11, 0, 1, 80 } });
+
+        int left = layout.split(0, true);
+
+        layout.areas(22, 80, areas, separators);
+
+        REQUIRE(areaOf(areas, left) == ViewportArea{ 12, 0, 10, 40 });
+        REQUIRE(areaOf(areas, 0) == ViewportArea{ 12, 41, 10, 39 });
+        REQUIRE(separators.size() == 2);
+
+        // Areas are listed from the top left
+        REQUIRE(areas[0].first == top);
+        REQUIRE(areas[1].first == left);
+        REQUIRE(areas[2].first == 0);
+    }
+
+    SECTION("closing a viewport gives its area to the other half")
+    {
+        int top = layout.split(0, false);
+        int left = layout.split(0, true);
+
+        REQUIRE(layout.close(top) == left);
+
+        layout.areas(22, 80, areas, separators);
+
+        REQUIRE(areas.size() == 2);
+        REQUIRE(areaOf(areas, left) == ViewportArea{ 0, 0, 22, 40 });
+        REQUIRE(areaOf(areas, 0) == ViewportArea{ 0, 41, 22, 39 });
+
+        REQUIRE(layout.close(0) == left);
+        REQUIRE(layout.close(left) == -1);
+        REQUIRE(layout.numberOfViewports() == 1);
+    }
+
+    SECTION("only keeps one viewport")
+    {
+        int first = layout.split(0, false);
+        int second = layout.split(first, true);
+        int third = layout.split(0, true);
+
+        std::vector<int> closed = layout.only(first);
+        std::sort(closed.begin(), closed.end());
+
+        REQUIRE(closed == std::vector<int>{ 0, second, third });
+        REQUIRE(layout.numberOfViewports() == 1);
+
+        layout.areas(22, 80, areas, separators);
+
+        REQUIRE(areaOf(areas, first) == ViewportArea{ 0, 0, 22, 80 });
+    }
+
+    SECTION("neighbors across separators")
+    {
+        // left | right
+        // ------------
+        //   bottom
+        int topRight = layout.split(0, false);
+        int topLeft = layout.split(topRight, true);
+
+        layout.areas(22, 80, areas, separators);
+
+        REQUIRE(SplitLayout::neighbor(areas, topLeft, NEIGHBOR_RIGHT, 0) == topRight);
+        REQUIRE(SplitLayout::neighbor(areas, topRight, NEIGHBOR_LEFT, 0) == topLeft);
+        REQUIRE(SplitLayout::neighbor(areas, topLeft, NEIGHBOR_DOWN, 5) == 0);
+        REQUIRE(SplitLayout::neighbor(areas, topRight, NEIGHBOR_DOWN, 60) == 0);
+        REQUIRE(SplitLayout::neighbor(areas, topLeft, NEIGHBOR_LEFT, 0) == -1);
+
+        // Going up from the bottom prefers the viewport above the given column
+        REQUIRE(SplitLayout::neighbor(areas, 0, NEIGHBOR_UP, 5) == topLeft);
+        REQUIRE(SplitLayout::neighbor(areas, 0, NEIGHBOR_UP, 60) == topRight);
+    }
+
+    SECTION("tiny areas")
+    {
+        layout.split(0, false);
+        layout.split(0, true);
+
+        for (int rows = 0; rows < 4; rows++)
+        {
+            for (int cols = 0; cols < 4; cols++)
+            {
+                layout.areas(rows, cols, areas, separators);
+
+                for (const std::pair<int, ViewportArea>& area : areas)
+                {
+                    REQUIRE(area.second.rows >= 0);
+                    REQUIRE(area.second.cols >= 0);
+                    REQUIRE(area.second.top + area.second.rows <= rows);
+                    REQUIRE(area.second.left + area.second.cols <= cols);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,188 @@
+#include "test_main.cpp"
+
+#include "../src/FileGapBuffer.h"
+#include "../src/SyntaxHighlighter.h"
+#include "random_edits.h"
+
+// Lines of up to 5 of these, so that comments and strings open and close across lines often
+static const std::vector<std::string> codePieces = { "/*", "*/", "//", "\"", "int", "x", " ", "1" };
+static const size_t maxCodePieces = 6;
+
+// Removing lines keeps one, like the buffer does
+static const size_t keptCodeLines = 1;
+
+static void requireStatesOfFullLex(const SyntaxHighlighter& highlighter, const FileBackend& file, size_t lastLine)
+{
+    LEXER_STATE state = LEXER_NORMAL;
+    std::string scratch;
+
+    REQUIRE(highlighter.lineStates().size() == file.numberOfLines() + 1);
+    REQUIRE(highlighter.lineStates()[0] == state);
+
+    for (size_t y = 0; y < file.numberOfLines() && y <= lastLine; y++)
+    {
+        state = SyntaxHighlighter::lexLine(*file[y], state, nullptr, scratch);
+
+        REQUIRE(highlighter.lineStates()[y + 1] == state);
+    }
+}
+
+TEST_CASE("lexing lines", "[syntax_highlighter]")
+{
+    std::vector<ColorSpan> spans;
+
+    auto tokens = [&spans]()
+    {
+        std::vector<std::tuple<int, int, TOKEN_TYPE>> result;
+
+        for (const ColorSpan& span : spans) { result.emplace_back(span.start, span.length, span.token); }
+
+        return result;
+    };
+
+    SECTION("tokens of a line")
+    {
+        REQUIRE(SyntaxHighlighter::lexLine(std::string_view("return x + 42; // done"), LEXER_NORMAL, &spans) == LEXER_NORMAL);
+        REQUIRE(tokens() == std::vector<std::tuple<int, int, TOKEN_TYPE>>{ { 0, 6, TOKEN_KEYWORD }, { 11, 2, TOKEN_NUMBER }, { 15, 7, TOKEN_COMMENT } });
+
+        spans.clear();
+        REQUIRE(SyntaxHighlighter::lexLine(std::string_view("  #include \"a.h\""), LEXER_NORMAL, &spans) == LEXER_NORMAL);
+        REQUIRE(tokens() == std::vector<std::tuple<int, int, TOKEN_TYPE>>{ { 2, 8, TOKEN_PREPROCESSOR }, { 11, 5, TOKEN_STRING } });
+
+        // Escaped quotes and comment markers inside strings do not end them
+        spans.clear();
+        REQUIRE(SyntaxHighlighter::lexLine(std::string_view("size_t s = \"\\\" /*\";"), LEXER_NORMAL, &spans) == LEXER_NORMAL);
+        REQUIRE(tokens() == std::vector<std::tuple<int, int, TOKEN_TYPE>>{ { 0, 6, TOKEN_TYPE_NAME }, { 11, 7, TOKEN_STRING } });
+
+        spans.clear();
+        REQUIRE(SyntaxHighlighter::lexLine(std::string_view("1'000 1.5e-3f x1"), LEXER_NORMAL, &spans) == LEXER_NORMAL);
+        REQUIRE(tokens() == std::vector<std::tuple<int, int, TOKEN_TYPE>>{ { 0, 5, TOKEN_NUMBER }, { 6, 7, TOKEN_NUMBER } });
+    }
+
+    SECTION("block comments carry over to the next lines")
+    {
+        REQUIRE(SyntaxHighlighter::lexLine(std::string_view("int a; /* start"), LEXER_NORMAL, &spans) == LEXER_BLOCK_COMMENT);
+        REQUIRE(tokens() == std::vector<std::tuple<int, int, TOKEN_TYPE>>{ { 0, 3, TOKEN_TYPE_NAME }, { 7, 8, TOKEN_COMMENT } });
+
+        spans.clear();
+        REQUIRE(SyntaxHighlighter::lexLine(std::string_view("middle // int"), LEXER_BLOCK_COMMENT, &spans) == LEXER_BLOCK_COMMENT);
+        REQUIRE(tokens() == std::vector<std::tuple<int, int, TOKEN_TYPE>>{ { 0, 13, TOKEN_COMMENT } });
+
+        spans.clear();
+        REQUIRE(SyntaxHighlighter::lexLine(std::string_view("end */ if"), LEXER_BLOCK_COMMENT, &spans) == LEXER_NORMAL);
+        REQUIRE(tokens() == std::vector<std::tuple<int, int, TOKEN_TYPE>>{ { 0, 6, TOKEN_COMMENT }, { 7, 2, TOKEN_KEYWORD } });
+    }
+
+    SECTION("lines split by their gap")
+    {
+        LineGapBuffer line(4, "/* a */ int");
+        std::string scratch;
+
+        line.moveGap(4);
+        line.insertText("");
+
+        REQUIRE(SyntaxHighlighter::lexLine(line, LEXER_NORMAL, &spans, scratch) == LEXER_NORMAL);
+        REQUIRE(tokens() == std::vector<std::tuple<int, int, TOKEN_TYPE>>{ { 0, 7, TOKEN_COMMENT }, { 8, 3, TOKEN_TYPE_NAME } });
+    }
+}
+
+TEST_CASE("syntax highlighter", "[syntax_highlighter]")
+{
+    std::mt19937 randomGenerator(11);
+
+    SECTION("only C-like files are highlighted")
+    {
+        FileGapBuffer file(randomLines(randomGenerator, codePieces, maxCodePieces, 10));
+        SyntaxHighlighter highlighter;
+
+        highlighter.start(file, "notes.txt");
+
+        REQUIRE_FALSE(highlighter.enabled());
+
+        highlighter.start(file, "main.cpp");
+
+        REQUIRE(highlighter.enabled());
+        REQUIRE(highlighter.ready());
+        requireStatesOfFullLex(highlighter, file, std::numeric_limits<size_t>::max());
+    }
+
+    SECTION("states are kept up to date by lexing edited lines again")
+    {
+        FileGapBuffer file(randomLines(randomGenerator, codePieces, maxCodePieces, 300));
+        SyntaxHighlighter highlighter;
+
+        highlighter.start(file, "main.cpp");
+
+        for (int round = 0; round < 300; round++)
+        {
+            int edits = randomGenerator() % 8;
+
+            for (int edit = 0; edit < edits; edit++) { randomEdit(randomGenerator, file, highlighter, codePieces, maxCodePieces, keptCodeLines); }
+
+            size_t firstRestyledLine;
+            size_t lastRestyledLine;
+
+            // Only the lines in view are lexed, and the rest once they come into view
+            size_t lastLine = randomGenerator() % file.numberOfLines();
+
+            REQUIRE(highlighter.update(file, lastLine, firstRestyledLine, lastRestyledLine));
+            requireStatesOfFullLex(highlighter, file, lastLine);
+        }
+
+        size_t firstRestyledLine;
+        size_t lastRestyledLine;
+
+        REQUIRE(highlighter.update(file, std::numeric_limits<size_t>::max(), firstRestyledLine, lastRestyledLine));
+        requireStatesOfFullLex(highlighter, file, std::numeric_limits<size_t>::max());
+    }
+
+    SECTION("lines after an edit are restyled until the states come out the same")
+    {
+        FileGapBuffer file(std::vector<std::shared_ptr<LineGapBuffer>>{ std::make_shared<LineGapBuffer>(8, "int a;"),
+            std::make_shared<LineGapBuffer>(8, "int b;"), std::make_shared<LineGapBuffer>(8, "int c;"),
+            std::make_shared<LineGapBuffer>(8, "*/"), std::make_shared<LineGapBuffer>(8, "int d;") });
+        SyntaxHighlighter highlighter;
+
+        highlighter.start(file, "main.c");
+
+        size_t firstRestyledLine;
+        size_t lastRestyledLine;
+
+        file.replaceLine(0, std::make_shared<LineGapBuffer>(8, "/* a;"));
+        highlighter.recordLineEdit(LINE_CHANGED, 0, 1);
+
+        REQUIRE(highlighter.update(file, std::numeric_limits<size_t>::max(), firstRestyledLine, lastRestyledLine));
+        REQUIRE((firstRestyledLine == 1 && lastRestyledLine == 3));
+        requireStatesOfFullLex(highlighter, file, std::numeric_limits<size_t>::max());
+
+        // An edit that leaves the state after the line as it was restyles nothing else
+        file.replaceLine(2, std::make_shared<LineGapBuffer>(8, "x"));
+        highlighter.recordLineEdit(LINE_CHANGED, 2, 1);
+
+        REQUIRE(highlighter.update(file, std::numeric_limits<size_t>::max(), firstRestyledLine, lastRestyledLine));
+        REQUIRE(firstRestyledLine > lastRestyledLine);
+    }
+
+    SECTION("large files are lexed in the background while they are edited")
+    {
+        FileGapBuffer file(randomLines(randomGenerator, codePieces, maxCodePieces, SyntaxHighlighter::backgroundLexLines * 3));
+        SyntaxHighlighter highlighter;
+
+        highlighter.start(file, "main.cpp");
+
+        REQUIRE_FALSE(highlighter.ready());
+
+        // Lines are replaced rather than edited in place, so the snapshot the pass reads stays as it was
+        for (int edit = 0; edit < 200; edit++) { randomEdit(randomGenerator, file, highlighter, codePieces, maxCodePieces, keptCodeLines); }
+
+        size_t firstRestyledLine;
+        size_t lastRestyledLine;
+
+        while (!highlighter.update(file, std::numeric_limits<size_t>::max(), firstRestyledLine, lastRestyledLine))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        requireStatesOfFullLex(highlighter, file, std::numeric_limits<size_t>::max());
+    }
+}
@@ -0,0 +1,77 @@
+#include "test_main.cpp"
+
+#include "../src/TimerQueue.h"
+
+TEST_CASE("timer queue", "[timer_queue]")
+{
+    TimerQueue timerQueue;
+    std::vector<TIMER_EVENT> due;
+
+    TimerQueue::Clock::time_point now = TimerQueue::Clock::now();
+
+    SECTION("nothing pending")
+    {
+        REQUIRE(timerQueue.empty());
+        REQUIRE(timerQueue.millisecondsUntilNext(now) == -1);
+
+        timerQueue.takeDue(now, due);
+
+        REQUIRE(due.empty());
+    }
+
+    SECTION("an event is due once its deadline has passed")
+    {
+        timerQueue.schedule(YANK_HIGHLIGHT_EXPIRY, now + std::chrono::milliseconds(100));
+
+        REQUIRE(timerQueue.pending(YANK_HIGHLIGHT_EXPIRY));
+        REQUIRE(timerQueue.millisecondsUntilNext(now) == 100);
+
+        // Partial milliseconds are rounded up so a wait of that long does not wake up too early
+        REQUIRE(timerQueue.millisecondsUntilNext(now + std::chrono::microseconds(99500)) == 1);
+
+        timerQueue.takeDue(now + std::chrono::milliseconds(99), due);
+
+        REQUIRE(due.empty());
+
+        timerQueue.takeDue(now + std::chrono::milliseconds(100), due);
+
+        REQUIRE(due == std::vector<TIMER_EVENT>{ YANK_HIGHLIGHT_EXPIRY });
+        REQUIRE(timerQueue.empty());
+
+        timerQueue.takeDue(now + std::chrono::milliseconds(200), due);
+
+        REQUIRE(due.empty());
+    }
+
+    SECTION("overdue events have no time left")
+    {
+        timerQueue.schedule(YANK_HIGHLIGHT_EXPIRY, now);
+
+        REQUIRE(timerQueue.millisecondsUntilNext(now + std::chrono::seconds(1)) == 0);
+    }
+
+    SECTION("scheduling an event again moves its deadline")
+    {
+        for (int i = 0; i < 1000; i++) { timerQueue.schedule(YANK_HIGHLIGHT_EXPIRY, now + std::chrono::milliseconds(i)); }
+
+        timerQueue.takeDue(now + std::chrono::milliseconds(500), due);
+
+        REQUIRE(due.empty());
+        REQUIRE(timerQueue.millisecondsUntilNext(now) == 999);
+
+        timerQueue.takeDue(now + std::chrono::milliseconds(999), due);
+
+        REQUIRE(due.size() == 1);
+    }
+
+    SECTION("cancelled events are not due")
+    {
+        timerQueue.schedule(YANK_HIGHLIGHT_EXPIRY, now);
+        timerQueue.cancel(YANK_HIGHLIGHT_EXPIRY);
+
+        timerQueue.takeDue(now + std::chrono::seconds(1), due);
+
+        REQUIRE(due.empty());
+        REQUIRE(timerQueue.empty());
+    }
+}
@@ -0,0 +1,130 @@
+#include "test_main.cpp"
+#include "../src/UndoFile.h"
+
+#include <fstream>
+
+static ContentHash hashOf(std::string_view text)
+{
+    ContentHash contentHash;
+    contentHash.update(text);
+
+    return contentHash;
+}
+
+static UndoJournal recordedJournal()
+{
+    UndoJournal journal(1000);
+
+    for (size_t repetition = 0; repetition < 200; repetition++)
+    {
+        int y = static_cast<int>(repetition % 7);
+
+        journal.beginEntry({ y, 3 }, repetition, repetition % 2);
+        journal.recordInsertText(y, 3, "text " + std::to_string(repetition));
+        journal.recordEraseText(y, 0, { "ab", "c" });
+        if (repetition % 5 == 0) { journal.recordMoveLine(y, y + 2); }
+        journal.commitEntry({ y + 1, 4 }, false);
+    }
+
+    return journal;
+}
+
+TEST_CASE("content hashes do not depend on how the text is split", "[undo_file]")
+{
+    std::string text;
+    for (int i = 0; i < 1000; i++) { text += static_cast<char>('a' + i % 26); }
+
+    ContentHash pieces;
+    for (size_t index = 0; index < text.size(); index += index % 13 + 1)
+    {
+        pieces.update(std::string_view(text).substr(index, index % 13 + 1));
+    }
+
+    REQUIRE(pieces.value() == hashOf(text).value());
+    REQUIRE(pieces.size() == text.size());
+    REQUIRE(hashOf(text).value() != hashOf(text.substr(1)).value());
+    REQUIRE(hashOf("").value() != hashOf(std::string(1, '\0')).value());
+}
+
+TEST_CASE("undo history survives a round trip through the undo file", "[undo_file]")
+{
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "razz_undo_file_test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directory(directory);
+
+    std::filesystem::path undoFilePath = UndoFile::undoFilePath(directory / "saved.txt");
+    REQUIRE(undoFilePath.filename() == ".saved.txt.razzundo");
+
+    UndoJournal saved = recordedJournal();
+    saved.moveTo(saved.parentState(saved.currentState()));
+
+    std::vector<char> serialized = UndoFile::serialize(saved);
+    REQUIRE(UndoFile::write(undoFilePath, serialized, hashOf("saved text")));
+
+    UndoFile undoFile(undoFilePath);
+    REQUIRE(undoFile.valid());
+    REQUIRE(undoFile.numberOfEntries() == 199);
+
+    UndoJournal loaded(1000);
+    REQUIRE(!undoFile.load(loaded, hashOf("other text")));
+    REQUIRE(loaded.numberOfEntries() == 0);
+
+    REQUIRE(undoFile.load(loaded, hashOf("saved text")));
+    REQUIRE(loaded.numberOfEntries() == 199);
+    REQUIRE(loaded.currentState() == 0);
+    REQUIRE(loaded.rootState() == -199);
+    REQUIRE(loaded.changeNumber() == 0);
+    REQUIRE(loaded.editsInHistory() == saved.editsInHistory() - saved.entry(199).edits);
+
+    for (size_t index = 0; index < loaded.numberOfEntries(); index++)
+    {
+        REQUIRE(loaded.entryOperations(index) == saved.entryOperations(index));
+        REQUIRE(loaded.entry(index).cursorBefore == saved.entry(index).cursorBefore);
+        REQUIRE(loaded.entry(index).cursorAfter == saved.entry(index).cursorAfter);
+        REQUIRE(loaded.entry(index).insertModeBefore == saved.entry(index).insertModeBefore);
+    }
+
+    // Loaded entries are never extended by the next change, whatever its repetition number
+    loaded.beginEntry({ 0, 0 }, loaded.entry(198).repetition, false);
+    loaded.recordInsertText(0, 0, "new");
+    loaded.commitEntry({ 0, 3 }, false);
+
+    REQUIRE(loaded.numberOfEntries() == 200);
+    REQUIRE(loaded.entryOperations(198) == saved.entryOperations(198));
+}
+
+TEST_CASE("damaged undo files are ignored", "[undo_file]")
+{
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "razz_undo_file_test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directory(directory);
+
+    std::filesystem::path undoFilePath = UndoFile::undoFilePath(directory / "saved.txt");
+
+    REQUIRE(!UndoFile(undoFilePath).valid());
+
+    UndoJournal saved = recordedJournal();
+    std::vector<char> serialized = UndoFile::serialize(saved);
+    REQUIRE(UndoFile::write(undoFilePath, serialized, hashOf("saved text")));
+
+    SECTION("a flipped byte fails the checksum")
+    {
+        std::fstream file(undoFilePath, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(static_cast<std::streamoff>(std::filesystem::file_size(undoFilePath) / 2));
+        file.put('\x7f');
+        file.close();
+
+        UndoFile undoFile(undoFilePath);
+        UndoJournal loaded(1000);
+
+        REQUIRE(undoFile.valid());
+        REQUIRE(!undoFile.load(loaded, hashOf("saved text")));
+    }
+
+    SECTION("a truncated file does not even open")
+    {
+        std::filesystem::resize_file(undoFilePath, std::filesystem::file_size(undoFilePath) - 1);
+
+        REQUIRE(!UndoFile(undoFilePath).valid());
+    }
+}
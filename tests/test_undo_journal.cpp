@@ -0,0 +1,355 @@
+#include "test_main.cpp"
+#include "../src/UndoJournal.h"
+
+#include <random>
+#include <map>
+
+static void applyOperation(std::vector<std::string>& fileLines, const UndoOperation& operation, bool inverse)
+{
+    bool inserting = (operation.type == TEXT_INSERTED || operation.type == LINE_INSERTED) != inverse;
+
+    switch (operation.type)
+    {
+        case TEXT_INSERTED:
+        case TEXT_ERASED:
+            if (inserting) { fileLines[operation.y].insert(operation.x, operation.text); }
+            else { fileLines[operation.y].erase(operation.x, operation.text.size()); }
+            break;
+        case LINE_INSERTED:
+        case LINE_REMOVED:
+            if (inserting) { fileLines.insert(fileLines.begin() + operation.y, std::string(operation.text)); }
+            else { fileLines.erase(fileLines.begin() + operation.y); }
+            break;
+        case LINE_MOVED:
+        {
+            int from = (inverse) ? operation.x : operation.y;
+            int to = (inverse) ? operation.y : operation.x;
+
+            std::string line = fileLines[from];
+            fileLines.erase(fileLines.begin() + from);
+            fileLines.insert(fileLines.begin() + to, line);
+            break;
+        }
+    }
+}
+
+static std::string randomText(std::mt19937& generator)
+{
+    std::string text(generator() % 6, ' ');
+    for (char& character : text) { character = "abc \n\0"[generator() % 6]; }
+
+    return text;
+}
+
+// Makes one random edit to the fileLines and records it, the way Buffer does
+static void randomEdit(std::mt19937& generator, UndoJournal& journal, std::vector<std::string>& fileLines)
+{
+    int y = generator() % fileLines.size();
+    std::string& line = fileLines[y];
+
+    switch (generator() % 5)
+    {
+        case 0:
+        {
+            int x = generator() % (line.size() + 1);
+            std::string text = randomText(generator);
+
+            line.insert(x, text);
+            journal.recordInsertText(y, x, text);
+            break;
+        }
+        case 1:
+        {
+            if (line.empty()) { return; }
+
+            int x = generator() % line.size();
+            int count = generator() % (line.size() - x) + 1;
+            int split = generator() % (count + 1);
+
+            // Erased text may straddle the gap of a line, so it comes in two pieces
+            std::string_view erased(line);
+            journal.recordEraseText(y, x, { erased.substr(x, split), erased.substr(x + split, count - split) });
+            line.erase(x, count);
+            break;
+        }
+        case 2:
+        {
+            int at = generator() % (fileLines.size() + 1);
+
+            fileLines.insert(fileLines.begin() + at, randomText(generator));
+            journal.recordInsertLine(at, LineGapBuffer(1, fileLines[at]));
+            break;
+        }
+        case 3:
+        {
+            if (fileLines.size() == 1) { return; }
+
+            journal.recordRemoveLine(y, LineGapBuffer(1, line));
+            fileLines.erase(fileLines.begin() + y);
+            break;
+        }
+        case 4:
+        {
+            int to = generator() % fileLines.size();
+
+            std::string moved = line;
+            fileLines.erase(fileLines.begin() + y);
+            fileLines.insert(fileLines.begin() + to, moved);
+            journal.recordMoveLine(y, to);
+            break;
+        }
+    }
+}
+
+// Applies the path from the current state to the state, the way CommandQueue does
+static void travel(UndoJournal& journal, std::vector<std::string>& fileLines, int64_t state)
+{
+    std::pair<std::vector<int64_t>, std::vector<int64_t>> path = journal.pathTo(state);
+
+    for (int64_t undone : path.first)
+    {
+        journal.forEachOperation(journal.indexOf(undone), true, [&fileLines](const UndoOperation& operation) { applyOperation(fileLines, operation, true); });
+    }
+
+    for (int64_t redone : path.second)
+    {
+        journal.forEachOperation(journal.indexOf(redone), false, [&fileLines](const UndoOperation& operation) { applyOperation(fileLines, operation, false); });
+    }
+
+    journal.moveTo(state);
+}
+
+TEST_CASE("undoing and redoing every entry restores each version", "[undo_journal]")
+{
+    std::mt19937 generator(11);
+
+    UndoJournal journal(1000);
+    std::vector<std::string> fileLines = { "first line", "", "third" };
+    std::vector<std::vector<std::string>> versions = { fileLines };
+
+    for (size_t repetition = 0; repetition < 300; repetition++)
+    {
+        journal.beginEntry({ static_cast<int>(generator() % fileLines.size()), 0 }, repetition, false);
+
+        int edits = generator() % 4 + 1;
+        for (int edit = 0; edit < edits; edit++) { randomEdit(generator, journal, fileLines); }
+
+        journal.commitEntry({ 0, 0 }, false);
+
+        if (journal.numberOfEntries() == versions.size()) { versions.push_back(fileLines); }
+    }
+
+    REQUIRE(journal.currentState() == journal.lastState());
+
+    while (journal.currentState() != journal.rootState())
+    {
+        travel(journal, fileLines, journal.parentState(journal.currentState()));
+
+        REQUIRE(fileLines == versions[journal.currentState()]);
+    }
+
+    while (journal.redoState(journal.currentState()) != UndoJournal::noState)
+    {
+        travel(journal, fileLines, journal.redoState(journal.currentState()));
+
+        REQUIRE(fileLines == versions[journal.currentState()]);
+    }
+
+    REQUIRE(journal.currentState() == journal.lastState());
+}
+
+TEST_CASE("a change after undoing starts a new branch", "[undo_journal]")
+{
+    UndoJournal journal(1000);
+    std::vector<std::string> fileLines = { "" };
+
+    for (size_t repetition = 0; repetition < 3; repetition++)
+    {
+        journal.beginEntry({ 0, 0 }, repetition, false);
+        fileLines[0].insert(0, "ab");
+        journal.recordInsertText(0, 0, "ab");
+        journal.commitEntry({ 0, 2 }, false);
+    }
+
+    travel(journal, fileLines, 1);
+    REQUIRE(fileLines[0] == "ab");
+
+    // Beginning an entry alone records nothing and keeps the redo history
+    journal.beginEntry({ 0, 0 }, 3, false);
+    journal.commitEntry({ 0, 0 }, false);
+
+    REQUIRE(journal.numberOfEntries() == 3);
+    REQUIRE(journal.redoState(1) == 2);
+
+    journal.beginEntry({ 0, 0 }, 4, false);
+    fileLines[0].erase(0, 1);
+    journal.recordEraseText(0, 0, { "a", "" });
+    journal.commitEntry({ 0, 0 }, false);
+
+    REQUIRE(journal.numberOfEntries() == 4);
+    REQUIRE(journal.currentState() == 4);
+    REQUIRE(journal.parentState(4) == 1);
+    REQUIRE(journal.redoState(1) == 4);
+    REQUIRE(journal.editsInHistory() == 4);
+
+    // The undone branch is still there, and going back to it makes redo follow it again
+    travel(journal, fileLines, 3);
+    REQUIRE(fileLines[0] == "ababab");
+    REQUIRE(journal.redoState(1) == 2);
+
+    REQUIRE(journal.pathTo(4) == std::pair<std::vector<int64_t>, std::vector<int64_t>>({ 3, 2 }, { 4 }));
+
+    travel(journal, fileLines, journal.chronologicalState(1));
+    REQUIRE(journal.currentState() == 4);
+    REQUIRE(fileLines[0] == "b");
+}
+
+TEST_CASE("jumping anywhere in the undo tree restores that state", "[undo_journal]")
+{
+    std::mt19937 generator(13);
+
+    UndoJournal journal(1000);
+    std::vector<std::string> fileLines = { "first line", "", "third" };
+    std::map<int64_t, std::vector<std::string>> versions = { { 0, fileLines } };
+
+    for (size_t repetition = 0; repetition < 400; repetition++)
+    {
+        switch (generator() % 4)
+        {
+            case 0:
+                if (journal.currentState() != journal.rootState()) { travel(journal, fileLines, journal.parentState(journal.currentState())); }
+                break;
+            case 1:
+                travel(journal, fileLines, journal.rootState() + static_cast<int64_t>(generator() % (journal.numberOfEntries() + 1)));
+                break;
+            default:
+            {
+                journal.beginEntry({ static_cast<int>(generator() % fileLines.size()), 0 }, repetition, false);
+
+                int edits = generator() % 4 + 1;
+                for (int edit = 0; edit < edits; edit++) { randomEdit(generator, journal, fileLines); }
+
+                journal.commitEntry({ 0, 0 }, false);
+                versions[journal.currentState()] = fileLines;
+                break;
+            }
+        }
+
+        REQUIRE(fileLines == versions[journal.currentState()]);
+    }
+
+    // The path only goes through the states between the two on the tree, never the whole way back
+    int64_t branchPoint = journal.parentState(journal.lastState());
+    travel(journal, fileLines, journal.lastState());
+
+    REQUIRE(journal.pathTo(branchPoint).first.size() == 1);
+}
+
+TEST_CASE("states are found by the time they were made", "[undo_journal]")
+{
+    UndoJournal journal(1000);
+    std::vector<std::string> fileLines = { "" };
+
+    for (int64_t second = 1; second <= 10; second++)
+    {
+        journal.beginEntry({ 0, 0 }, second, false);
+        journal.recordInsertText(0, 0, "x");
+        journal.commitEntry({ 0, 1 }, false, second * 1000);
+    }
+
+    REQUIRE(journal.stateAt(5500) == 5);
+    REQUIRE(journal.stateAt(10000) == 10);
+    REQUIRE(journal.stateAt(500) == journal.rootState());
+
+    journal.moveTo(2);
+
+    // A branch made later in time is found by time, though it hangs off an earlier state
+    journal.beginEntry({ 0, 0 }, 11, false);
+    journal.recordInsertText(0, 0, "y");
+    journal.commitEntry({ 0, 1 }, false, 20000);
+
+    REQUIRE(journal.stateAt(15000) == 10);
+    REQUIRE(journal.stateAt(25000) == 11);
+    REQUIRE(journal.chronologicalState(-3) == 8);
+    REQUIRE(journal.chronologicalState(5) == 11);
+}
+
+TEST_CASE("jumping many states back and forth is cheap on a long history", "[undo_journal]")
+{
+    UndoJournal journal(100000);
+
+    for (int64_t state = 1; state <= 50000; state++)
+    {
+        journal.beginEntry({ 0, 0 }, state, false);
+        journal.recordInsertText(0, 0, "x");
+        journal.commitEntry({ 0, 1 }, false, state * 1000);
+    }
+
+    // Walking the parents of every state passed over takes seconds here, while one pass over the history does not
+    auto start = std::chrono::steady_clock::now();
+
+    REQUIRE(journal.chronologicalState(-40000) == 10000);
+    REQUIRE(journal.stateAt(1500) == 1);
+
+    journal.moveTo(10000);
+
+    REQUIRE(journal.chronologicalState(40000) == 50000);
+
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+}
+
+TEST_CASE("typing is coalesced into one run of text", "[undo_journal]")
+{
+    UndoJournal journal(1000);
+
+    // Every keystroke is its own command, but typed as one batch they share a repetition number
+    for (int x = 0; x < 1000; x++)
+    {
+        journal.beginEntry({ 40, x }, 7, true);
+        journal.recordInsertText(40, x, "x");
+        journal.commitEntry({ 40, x + 1 }, true);
+    }
+
+    REQUIRE(journal.numberOfEntries() == 1);
+    REQUIRE(journal.editsInHistory() == 1000);
+    REQUIRE(journal.arenaSize() < 1010);
+
+    const UndoJournal::Entry& entry = journal.entry(0);
+    REQUIRE(entry.cursorBefore == std::pair<int, int>(40, 0));
+    REQUIRE(entry.cursorAfter == std::pair<int, int>(40, 1000));
+
+    size_t operations = 0;
+    journal.forEachOperation(0, false, [&operations](const UndoOperation& operation)
+    {
+        REQUIRE(operation.y == 40);
+        REQUIRE(operation.text == std::string(1000, 'x'));
+        operations++;
+    });
+
+    REQUIRE(operations == 1);
+}
+
+TEST_CASE("old entries fall off the front of the history", "[undo_journal]")
+{
+    UndoJournal journal(10);
+    std::vector<std::string> fileLines = { "" };
+    std::vector<std::vector<std::string>> versions = { fileLines };
+
+    for (size_t repetition = 0; repetition < 50; repetition++)
+    {
+        journal.beginEntry({ 0, 0 }, repetition, false);
+        fileLines[0] += std::to_string(repetition);
+        journal.recordInsertText(0, static_cast<int>(fileLines[0].size() - std::to_string(repetition).size()), std::to_string(repetition));
+        journal.commitEntry({ 0, 0 }, false);
+
+        versions.push_back(fileLines);
+    }
+
+    REQUIRE(journal.numberOfEntries() == 10);
+    REQUIRE(journal.changeNumber() == 50);
+
+    while (journal.currentState() != journal.rootState()) { travel(journal, fileLines, journal.parentState(journal.currentState())); }
+
+    REQUIRE(fileLines == versions[40]);
+    REQUIRE(journal.changeNumber() == 40);
+}
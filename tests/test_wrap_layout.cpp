@@ -0,0 +1,117 @@
+#include "test_main.cpp"
+#include "../src/WrapLayout.h"
+
+static int expectedExtraRows(int indexOfFirstNonSpace, int lineSize, int terminalColumns, int reservedColumns)
+{
+    int rowWidth = terminalColumns - indexOfFirstNonSpace - reservedColumns;
+
+    if (indexOfFirstNonSpace >= terminalColumns || rowWidth <= 0 || lineSize + reservedColumns < terminalColumns) { return 0; }
+
+    return (lineSize + reservedColumns - terminalColumns) / rowWidth + 1;
+}
+
+TEST_CASE("wrap rows of a range match a rescan after edits", "[wrap_layout]")
+{
+    const int terminalColumns = 40;
+    const int reservedColumns = 4;
+
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<int> lineSizeDistribution(0, 200);
+    std::uniform_int_distribution<int> indentDistribution(0, 12);
+
+    // Measurements of every line, or -1 for lines not measured yet
+    std::vector<std::pair<int, int>> reference(500, std::pair<int, int>(-1, 0));
+
+    WrapLayout layout;
+    layout.reset(reference.size(), terminalColumns, reservedColumns);
+    layout.keepWindow(100, 40);
+
+    for (int operation = 0; operation < 3000; operation++)
+    {
+        size_t index = generator() % reference.size();
+
+        switch (generator() % 5)
+        {
+            case 0:
+            {
+                int indent = indentDistribution(generator);
+                int lineSize = lineSizeDistribution(generator);
+
+                // Lines outside the window are not kept
+                layout.measure(index, indent, lineSize);
+                if (layout.holds(index)) { reference[index] = std::pair<int, int>(indent, lineSize); }
+                break;
+            }
+            case 1:
+                layout.invalidate(index);
+                reference[index].first = -1;
+                break;
+            case 2:
+                layout.insertLines(index, 1 + generator() % 200);
+                reference.insert(reference.begin() + index, layout.numberOfLines() - reference.size(), std::pair<int, int>(-1, 0));
+                break;
+            case 3:
+                if (reference.size() > 300)
+                {
+                    size_t count = std::min<size_t>(1 + generator() % 100, reference.size() - index);
+
+                    layout.removeLines(index, count);
+                    reference.erase(reference.begin() + index, reference.begin() + index + count);
+                }
+                break;
+            case 4:
+                layout.keepWindow(index, generator() % 40);
+                break;
+        }
+
+        REQUIRE(layout.numberOfLines() == reference.size());
+
+        // Whatever left the window is forgotten, and whatever is in it is kept where its line moved to
+        for (size_t line = 0; line < reference.size(); line++)
+        {
+            if (!layout.holds(line)) { reference[line].first = -1; }
+            else { REQUIRE(layout.line(line).measured == (reference[line].first != -1)); }
+        }
+
+        size_t first = generator() % reference.size();
+        size_t last = first + generator() % (reference.size() - first + 1);
+
+        long expected = 0;
+        for (size_t line = first; line < last; line++)
+        {
+            if (reference[line].first != -1)
+            {
+                expected += expectedExtraRows(reference[line].first, reference[line].second, terminalColumns, reservedColumns);
+            }
+        }
+
+        REQUIRE(layout.extraRowsBetween(first, last) == expected);
+    }
+}
+
+TEST_CASE("the layout only keeps the lines around the window", "[wrap_layout]")
+{
+    WrapLayout layout;
+    layout.reset(5000000, 80, 8);
+    layout.keepWindow(2000000, 50);
+
+    REQUIRE(layout.windowSize() == 50 + 2 * WRAP_LAYOUT_MARGIN);
+
+    layout.measure(2000010, 0, 200);
+
+    // Lines pasted into or deleted from the window do not grow or shrink it
+    layout.insertLines(2000005, 1000000);
+    layout.removeLines(1000000, 500000);
+
+    REQUIRE(layout.numberOfLines() == 5500000);
+    REQUIRE(layout.windowSize() == 50 + 2 * WRAP_LAYOUT_MARGIN);
+    REQUIRE(layout.extraRowsBetween(0, layout.numberOfLines()) == 0);
+
+    // Edits before the window move it along without touching what it measured
+    layout.measure(1500010, 0, 200);
+    layout.insertLines(10, 20);
+    layout.removeLines(0, 5);
+
+    REQUIRE(layout.line(1500025).measured);
+    REQUIRE(layout.extraRowsBetween(1500000, 1500050) == 2);
+}